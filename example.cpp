@@ -160,9 +160,9 @@ int main()
 		if (!users.Empty())
 		{
 			// for each user object
-			for (JSON_NODE* node = users.First(); node != NULL; node = node->next)
+			for (JSON_ITEM user : users)
 			{
-				JSON_OBJECT account = node;
+				JSON_OBJECT account = user.Object();
 				if (!account.Empty()) {
 					// Print user info
 					printf("username: %s balance: %f\n", account.String("username"), account.Number.Double("balance"));
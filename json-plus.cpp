@@ -14,8 +14,10 @@
 #include <stdio.h>
 #include <setjmp.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <memory.h>
 #include <cstring>
+#include <atomic>
 
 #include "json-plus.h"
 using namespace json_plus;
@@ -28,21 +30,23 @@ using namespace json_plus;
 // Increasing this number may result in faster encoding but will use more memory
 #define JSON_GENERATOR_BUFFER_INCREASE 32
 
-// JSON token types
-enum class JSON_TOKEN
-{
-	CURLY_OPEN,
-	CURLY_CLOSE,
-	COLON,
-	STRING,
-	NUMBER,
-	ARRAY_OPEN,
-	ARRAY_CLOSE,
-	COMMA,
-	LITERAL,
-	JSON_END,
-	UNRECOGNIZED_TOKEN
-};
+// The number of members an object must have before a hash index is built for key lookups
+// The index is built on the first lookup that scans this many members, smaller objects are scanned
+#ifndef JSON_OBJECT_INDEX_THRESHOLD
+#define JSON_OBJECT_INDEX_THRESHOLD 16
+#endif
+
+// The number of items an array must have before an item vector is built for access by index
+// The vector is built when this many items are walked to reach an item or count the items
+#ifndef JSON_ARRAY_ITEMS_THRESHOLD
+#define JSON_ARRAY_ITEMS_THRESHOLD 16
+#endif
+
+// The number of old members that JSON_ParseInto searches for a member with the same key and value type
+// Members that moved further are not found, the next old member is reused for them
+#ifndef JSON_PARSER_RECYCLE_LOOKAHEAD
+#define JSON_PARSER_RECYCLE_LOOKAHEAD 16
+#endif
 
 // JSON error strings
 static const char* JSON_ERROR_STRINGS[] =
@@ -64,6 +68,7 @@ static const char* JSON_ERROR_STRINGS[] =
 	"object syntax error, expected a ':' token before value.",
 	"object syntax error, key already defined, expected a ':' token and value.",
 	"object syntax error, key not defined.",
+	"object syntax error, unexpected value, use the comma ',' token to separate key-value pairs.",
 	"unexpected closing square bracket ']' token, use closing curly bracket '}' instead to close the object.",
 	"expected object closing curly bracket '}' token, encountered end of json instead.",
 	"expected key-value pair, encountered end of object instead.",
@@ -85,12 +90,106 @@ static const char* JSON_ERROR_STRINGS[] =
 
 	// parse literal name errors:
 
-	"invalid literal name, only 'false', 'null' and 'true' are valid (lowercase only)."
+	"invalid literal name, only 'false', 'null' and 'true' are valid (lowercase only).",
+
+	// parse memory errors:
+
+	"memory limit exceeded, the json needs more memory than the memory limit of the parser context."
+};
+
+// Node flag, the node has a JSON_NODE_HEADER in front of it
+#define JSON_NODE_FLAG_HEADER 0x01
+
+// Node flag, the keyLength and keyHash fields of the node are set for its key
+#define JSON_NODE_FLAG_KEY 0x02
+
+// Key to look up in an object, with its length in bytes and its hash
+struct JSON_LOOKUP_KEY
+{
+	const char* key;
+	size_t length;
+	unsigned int hash;
+};
+
+struct JSON_NODE_EXTRA;
+
+// Header in front of nodes that own an allocator
+// Object and array nodes always have a header, child nodes are allocated with the allocator of their parent -
+// other nodes only have a header when they are created with JSON_CreateNode
+struct JSON_NODE_HEADER
+{
+	const JSON_ALLOCATOR* allocator;
+	// First and last item of an object or array and the number of items, tail is NULL until the item list is walked
+	JSON_NODE* first;
+	JSON_NODE* tail;
+	size_t count;
+	// Side block with the index, the clone ring and the change stamp and hash, NULL until one of them is needed
+	JSON_NODE_EXTRA* extra;
+};
+
+// Side block of an object or array, allocated with the allocator of the header
+// It is allocated when the object or array gets a hash index or item vector, is cloned, is on the path of a
+// JSON_POINTER or is hashed, and it is kept until the node is freed
+struct JSON_NODE_EXTRA
+{
+	// Hash index of an object (JSON_OBJECT_INDEX) or item vector of an array (JSON_ARRAY_ITEMS), NULL until it is needed
+	void* index;
+	// Change stamp, unique in the process, a new stamp is taken every time the item list changes
+	unsigned long long stamp;
+	// Ring of the headers of clones that share the item list, both point to the header itself when it is not shared
+	JSON_NODE_HEADER* sharedNext;
+	JSON_NODE_HEADER* sharedPrev;
+	// Cached hash of the object or array, valid while the stamps of the object or array and its children are unchanged
+	// `hashStamp` is the stamp it was computed at, `hashEpoch` the last stamp taken in the process when it was checked
+	unsigned long long hash;
+	unsigned long long hashStamp;
+	unsigned long long hashEpoch;
+};
+
+// Slot in an object hash index
+struct JSON_INDEX_SLOT
+{
+	JSON_NODE* node;
+	unsigned int hash;
+};
+
+// Open addressing hash index over the keys of an object, built when the object is large
+// `first` is the first member when the index was last updated, the index is rebuilt if the member list changed without it
+// Objects with duplicate keys are not indexed, the first matching member must be found in order
+struct JSON_OBJECT_INDEX
+{
+	JSON_NODE* first;
+	size_t count;
+	size_t capacity;
+	bool hasDuplicateKeys;
+	JSON_INDEX_SLOT slots[1];
+};
+
+// Vector of the item pointers of an array, built when the array is large
+// The items are kept in the middle of the vector so items can be added at both ends
+// `first` is the first item when the vector was last updated, the vector is rebuilt if the item list changed without it
+struct JSON_ARRAY_ITEMS
+{
+	JSON_NODE* first;
+	size_t count;
+	size_t capacity;
+	size_t start;
+	JSON_NODE* items[1];
+};
+
+// Member of an object in the canonical generator, `position` keeps members with the same key in order
+struct JSON_CANONICAL_MEMBER
+{
+	const char* key;
+	size_t length;
+	size_t position;
+	JSON_NODE* node;
 };
 
 // JSON generator context
 struct JSON_GENERATOR_CONTEXT
 {
+	const JSON_ALLOCATOR* allocator;
 	bool error;
 	char* buffer;
 	size_t bufferLength;
@@ -99,6 +198,10 @@ struct JSON_GENERATOR_CONTEXT
 	const char* format;
 	long indentation;
 	jmp_buf env;
+	// Members of the objects that are written by the canonical generator, used as a stack that is sorted one object at a time
+	JSON_CANONICAL_MEMBER* members;
+	size_t memberCount;
+	size_t memberCapacity;
 };
 
 // JSON parser context initializer
@@ -111,2501 +214,10796 @@ JSON_PARSER_CONTEXT::JSON_PARSER_CONTEXT()
 	this->lineNumber = 0;
 	this->beginIndex = 0;
 	this->errorLength = 0;
+	this->allocator = NULL;
+	this->positions = NULL;
+	this->memoryLimit = 0;
+	this->allocations = 0;
+	this->bytesAllocated = 0;
+	this->peakMemory = 0;
+	this->memoryUsed = 0;
 }
 
-// ---------------------------- //
-// **   _JSON_NODE methods   ** //
-// ---------------------------- //
+// ----------------------------- //
+// **   Allocator functions   ** //
+// ----------------------------- //
 
-const char* _JSON_NODE::String()
+void* json_DefaultAllocate(void* /*userData*/, size_t size)
 {
-	if (this->type == JSON_TYPE::STRING) {
-		return (const char*)this->value;
-	}
+	return malloc(size);
+}
 
-	return NULL;
+void* json_DefaultReallocate(void* /*userData*/, void* block, size_t size)
+{
+	return realloc(block, size);
 }
 
-bool _JSON_NODE::Boolean()
+void json_DefaultDeallocate(void* /*userData*/, void* block)
 {
-	if (this->type == JSON_TYPE::BOOLEAN) {
-		return (bool)this->value;
+	free(block);
+}
+
+// Allocator used when no allocator is provided
+static const JSON_ALLOCATOR json_DefaultAllocator =
+{
+	json_DefaultAllocate,
+	json_DefaultReallocate,
+	json_DefaultDeallocate,
+	NULL
+};
+
+// Allocate a memory block, `allocator` can be NULL for the default allocator
+void* json_Allocate(const JSON_ALLOCATOR* allocator, size_t size)
+{
+	if (allocator == NULL) {
+		allocator = &json_DefaultAllocator;
 	}
 
-	return false;
+	return allocator->allocate(allocator->userData, size);
 }
 
-double _JSON_NODE::Double()
+// Resize a memory block, `allocator` can be NULL for the default allocator
+void* json_Reallocate(const JSON_ALLOCATOR* allocator, void* block, size_t size)
 {
-	if (this->type == JSON_TYPE::NUMBER) {
-		return atof((char*)this->value);
+	if (allocator == NULL) {
+		allocator = &json_DefaultAllocator;
 	}
 
-	return 0.0f;
+	if (block == NULL) {
+		return allocator->allocate(allocator->userData, size);
+	}
+
+	return allocator->reallocate(allocator->userData, block, size);
 }
 
-int _JSON_NODE::Int()
+// Free a memory block, `allocator` can be NULL for the default allocator
+void json_Deallocate(const JSON_ALLOCATOR* allocator, void* block)
 {
-	if (this->type == JSON_TYPE::NUMBER) {
-		return atoi((char*)this->value);
+	if (allocator == NULL) {
+		allocator = &json_DefaultAllocator;
 	}
 
-	return 0;
+	if (block != NULL) {
+		allocator->deallocate(allocator->userData, block);
+	}
 }
 
-long _JSON_NODE::Long()
+// Source of the change stamps of objects and arrays
+std::atomic<unsigned long long> json_stamps(0);
+
+// Take a new change stamp, no other node has had this stamp before
+unsigned long long json_NewStamp()
 {
-	if (this->type == JSON_TYPE::NUMBER) {
-		return atol((char*)this->value);
-	}
+	return json_stamps.fetch_add(1, std::memory_order_relaxed) + 1;
+}
 
-	return 0;
+// Get the header in front of a node
+JSON_NODE_HEADER* json_NodeHeader(JSON_NODE* node)
+{
+	return (JSON_NODE_HEADER*)node - 1;
 }
 
-long long _JSON_NODE::Int64()
+// Get the allocator that owns a node, `parentAllocator` is the allocator of the parent object or array
+const JSON_ALLOCATOR* json_NodeAllocator(JSON_NODE* node, const JSON_ALLOCATOR* parentAllocator)
 {
-	if (this->type == JSON_TYPE::NUMBER) {
-		return atoll((char*)this->value);
+	if ((node != NULL) && (node->flags & JSON_NODE_FLAG_HEADER)) {
+		return json_NodeHeader(node)->allocator;
 	}
 
-	return 0;
+	return parentAllocator;
 }
 
-void json_free_node(JSON_NODE* node)
+// Allocate a zeroed node, objects and arrays (or when `hasHeader` is true) get a header that stores the allocator
+JSON_NODE* json_AllocateNode(const JSON_ALLOCATOR* allocator, JSON_TYPE type, bool hasHeader)
 {
-	if (node->type == JSON_TYPE::OBJECT) {
-		JSON_Free((JSON_NODE*)node->value);
+	JSON_NODE_HEADER* header;
+	JSON_NODE* node;
+
+	if ((type == JSON_TYPE::OBJECT) || (type == JSON_TYPE::ARRAY)) {
+		hasHeader = true;
 	}
-	else if (node->type == JSON_TYPE::ARRAY) {
-		JSON_Free((JSON_NODE*)node->value);
+
+	if (hasHeader)
+	{
+		header = (JSON_NODE_HEADER*)json_Allocate(allocator, sizeof(JSON_NODE_HEADER) + sizeof(JSON_NODE));
+		if (header == NULL) {
+			return NULL;
+		}
+
+		header->allocator = allocator;
+		header->first = NULL;
+		header->tail = NULL;
+		header->count = 0;
+		header->extra = NULL;
+		node = (JSON_NODE*)(header + 1);
+		memset(node, 0, sizeof(JSON_NODE));
+		node->flags = JSON_NODE_FLAG_HEADER;
 	}
 	else
 	{
-		if (node->type != JSON_TYPE::BOOLEAN) {
-			if (node->value) {
-				free(node->value);
-			}
+		node = (JSON_NODE*)json_Allocate(allocator, sizeof(JSON_NODE));
+		if (node == NULL) {
+			return NULL;
 		}
+
+		memset(node, 0, sizeof(JSON_NODE));
 	}
 
-	if (node->key) {
-		free(node->key);
+	node->type = type;
+
+	return node;
+}
+
+// Get the side block of a node with a header, NULL if it has none
+// With `create` a missing side block is allocated, NULL is returned if there is not enough memory
+JSON_NODE_EXTRA* json_NodeExtra(JSON_NODE* node, bool create)
+{
+	JSON_NODE_HEADER* header;
+	JSON_NODE_EXTRA* extra;
+
+	if ((node->flags & JSON_NODE_FLAG_HEADER) == 0) {
+		return NULL;
 	}
 
-	if (node->format) {
-		free((void*)node->format);
+	header = json_NodeHeader(node);
+	if ((header->extra != NULL) || (!create)) {
+		return header->extra;
+	}
+
+	extra = (JSON_NODE_EXTRA*)json_Allocate(header->allocator, sizeof(JSON_NODE_EXTRA));
+	if (extra == NULL) {
+		return NULL;
 	}
 
-	free(node);
+	extra->index = NULL;
+	extra->stamp = json_NewStamp();
+	extra->sharedNext = header;
+	extra->sharedPrev = header;
+	extra->hash = 0;
+	extra->hashStamp = 0;
+	extra->hashEpoch = 0;
+	header->extra = extra;
+
+	return extra;
 }
 
-// ------------------------ //
-// **   JSON generator   ** //
-// ------------------------ //
+// Get the hash index or item vector in the side block of a node, NULL if it has none
+void* json_NodeIndex(JSON_NODE* node)
+{
+	JSON_NODE_EXTRA* extra;
 
-// Forward declaration of json_GeneratorIndentation
-// Output tabs for a line, this is automatically enabled when a format string is provided
-void json_GeneratorIndentation(JSON_GENERATOR_CONTEXT* context);
+	extra = json_NodeExtra(node, false);
 
-// ---------------------------------- //
-// **   JSON generator functions   ** //
-// ---------------------------------- //
+	return (extra != NULL) ? extra->index : NULL;
+}
 
-// Append a new character to the JSON string buffer
-// If `bFormat` is true then the function checks formatting parameters
-void json_GeneratorAppend(JSON_GENERATOR_CONTEXT* context, unsigned long CodePoint, bool bFormat)
+// Take a new change stamp after the item list of an object or array changed
+// The stamp is always taken, so cached hashes see the change, it is only kept when the node has a side block
+void json_TakeStamp(JSON_NODE_HEADER* header)
 {
-	unsigned char CharUnits;
-	unsigned long newLines;
-	const char* pFormat = NULL;
+	unsigned long long stamp;
 
-	if ((bFormat) && (context->format))
+	stamp = json_NewStamp();
+	if (header->extra != NULL) {
+		header->extra->stamp = stamp;
+	}
+}
+
+// Free the memory block of a node, `parentAllocator` is the allocator of the parent object or array
+// The side block is freed with it, the index must be freed and the node must not share its items anymore
+void json_DeallocateNode(JSON_NODE* node, const JSON_ALLOCATOR* parentAllocator)
+{
+	if (node->flags & JSON_NODE_FLAG_HEADER)
 	{
-		if (CodePoint == '}') {
-			context->indentation--;
+		if (json_NodeHeader(node)->extra != NULL) {
+			json_Deallocate(json_NodeHeader(node)->allocator, json_NodeHeader(node)->extra);
 		}
+		json_Deallocate(json_NodeHeader(node)->allocator, json_NodeHeader(node));
+	}
+	else {
+		json_Deallocate(parentAllocator, node);
+	}
+}
 
-		newLines = 0;
+// Check if a node type has child nodes
+bool json_IsContainer(JSON_TYPE type)
+{
+	return (type == JSON_TYPE::OBJECT) || (type == JSON_TYPE::ARRAY);
+}
 
-		pFormat = context->format;
-		while (*pFormat != '\0')
-		{
-			if (*pFormat == '\n') {
-				newLines++;
-			}
-			else if (*pFormat == CodePoint) {
-				for (unsigned long i = 0; i < newLines; i++) {
-					json_GeneratorAppend(context, '\n', false);
-					json_GeneratorIndentation(context);
-				}
-				pFormat++;
-				break;
-			}
-			else {
-				newLines = 0;
-			}
-			pFormat++;
-		}
-	}
+// Free a node list, `parentAllocator` is the allocator of the parent object or array
+void json_FreeList(JSON_NODE* node, const JSON_ALLOCATOR* parentAllocator);
 
-	CharUnits = UTF8_Encoding::EncodeUnsafe(NULL, CodePoint);
+// Give an object or array its own item list before it is changed, when it shares the item list with a clone
+bool json_Unshare(JSON_NODE* container);
 
-	// buffer big enough for CodePoint + NULL character ?
-	if ((context->index + CharUnits + 1) >= context->bufferLength)
+// ----------------------- //
+// **   Key functions   ** //
+// ----------------------- //
+
+// Hash a key of `length` bytes (FNV-1a), this must be the same hash as JSON_KEY::Hash
+unsigned int json_HashKey(const char* key, size_t length)
+{
+	unsigned int hash;
+	size_t i;
+
+	hash = 2166136261U;
+	for (i = 0; i < length; i++)
 	{
-		context->bufferLength += JSON_GENERATOR_BUFFER_INCREASE;
-		char* pNewBuffer = (char*)realloc(context->buffer, context->bufferLength);
-		if (pNewBuffer != NULL) {
-			context->buffer = pNewBuffer;
-		}
-		else {
-			context->error = true;
-			longjmp(context->env, 1);
-		}
+		hash ^= (unsigned char)key[i];
+		hash *= 16777619U;
 	}
 
-	context->index += UTF8_Encoding::EncodeUnsafe(&context->buffer[context->index], CodePoint);
+	return hash;
+}
 
-	if ((bFormat) && (pFormat != NULL))
+// Set the key of a node with its length and hash, so lookups can compare the hash and length before the bytes
+// Keys of 64 KB or longer do not fit in the key length of the node, their length is counted when they are compared
+void json_SetKey(JSON_NODE* node, char* key)
+{
+	size_t length;
+
+	node->key = key;
+	node->keyLength = 0;
+	node->keyHash = 0;
+	node->flags &= ~JSON_NODE_FLAG_KEY;
+
+	if (key == NULL) {
+		return;
+	}
+
+	length = strlen(key);
+	if (length <= USHRT_MAX)
 	{
-		if (CodePoint == '{') {
-			context->indentation++;
-		}
+		node->keyLength = (unsigned short)length;
+		node->keyHash = json_HashKey(key, length);
+		node->flags |= JSON_NODE_FLAG_KEY;
+	}
+}
 
-		while ((*pFormat != '\0') && (*pFormat != 'e'))
-		{
-			json_GeneratorAppend(context, *pFormat, false);
-			if (*pFormat == '\n') {
-				json_GeneratorIndentation(context);
-			}
-			pFormat++;
-		}
+// Get the length of a null terminated key, 0 if there is no key
+size_t json_KeyLength(const char* key)
+{
+	return (key != NULL) ? strlen(key) : 0;
+}
+
+// Make a lookup key from a key of `length` bytes
+void json_LookupKey(JSON_LOOKUP_KEY* lookupKey, const char* key, size_t length)
+{
+	lookupKey->key = key;
+	lookupKey->length = length;
+	lookupKey->hash = json_HashKey(key, length);
+}
+
+// Make a lookup key from the key of a node, returns false if the node has no key
+// Nodes that were not given their key by json-plus have no key length and hash, they are computed here
+bool json_NodeKey(JSON_NODE* node, JSON_LOOKUP_KEY* lookupKey)
+{
+	if (node->key == NULL) {
+		return false;
+	}
+
+	if (node->flags & JSON_NODE_FLAG_KEY)
+	{
+		lookupKey->key = node->key;
+		lookupKey->length = node->keyLength;
+		lookupKey->hash = node->keyHash;
+	}
+	else {
+		json_LookupKey(lookupKey, node->key, strlen(node->key));
 	}
+
+	return true;
 }
 
-void json_GeneratorIndentation(JSON_GENERATOR_CONTEXT* context)
+// Check if the key of a node is equal to a lookup key
+// Valid UTF8 strings are equal when their bytes are equal, so the bytes are compared after the hash and length
+bool json_KeyEquals(JSON_NODE* node, const JSON_LOOKUP_KEY* lookupKey)
 {
-	for (long i = 0; i < context->indentation; i++)
+	if (node->key == NULL) {
+		return false;
+	}
+
+	if (node->flags & JSON_NODE_FLAG_KEY)
 	{
-		json_GeneratorAppend(context, '\t', false);
+		if ((node->keyHash != lookupKey->hash) || (node->keyLength != lookupKey->length)) {
+			return false;
+		}
 	}
+	else if (strlen(node->key) != lookupKey->length) {
+		return false;
+	}
+
+	return (memcmp(node->key, lookupKey->key, lookupKey->length) == 0);
 }
 
-// Recursive JSON text generator (from node)
-char* json_GenerateText(JSON_NODE* json_node, JSON_GENERATOR_CONTEXT* context)
+// ---------------------------------- //
+// **   Inline storage functions   ** //
+// ---------------------------------- //
+
+// Get the inline storage of a node, NULL when nodes are compiled without it (JSON_NODE_INLINE_SIZE is 0)
+char* json_InlineData(JSON_NODE* node)
 {
-	unsigned char CharUnits;
-	unsigned long CodePoint;
-	JSON_NODE* node;
-	const char* format;
-	long p = -1, n = 0;
-	const char* extraChars;
+#if JSON_NODE_INLINE_SIZE > 0
+	return node->inlineData;
+#else
+	(void)node;
+	return NULL;
+#endif
+}
 
-	format = NULL;
+// Check if a key or value is stored in the inline storage of the node, it has no allocation of its own then
+bool json_IsInline(JSON_NODE* node, const void* string)
+{
+#if JSON_NODE_INLINE_SIZE > 0
+	return ((const char*)string >= node->inlineData) && ((const char*)string < node->inlineData + JSON_NODE_INLINE_SIZE);
+#else
+	(void)node;
+	(void)string;
+	return false;
+#endif
+}
 
-	// Look for special 'p' formatting character
-	if (context->format != NULL)
+// Get the free inline bytes of a node for its key or value, `pSize` receives the number of bytes
+// The value is stored after an inline key, a key is only stored in the node when the value is not, so keys are set first
+char* json_InlineSpace(JSON_NODE* node, bool isKey, size_t* pSize)
+{
+	char* start;
+
+	start = json_InlineData(node);
+	if (start == NULL)
 	{
-		format = context->format;
+		*pSize = 0;
+		return NULL;
+	}
 
-		while (*format != '\0')
+	if (isKey)
+	{
+		if (json_IsInline(node, node->value))
 		{
-			if (*format == 'p') {
-				p = 0;
-				format++;
-
-				// Get number of key-value pairs for a single line
-				while ((*format >= '0') && (*format <= '9')) {
-					p *= 10;
-					p += (*format - '0');
-					format++;
-				}
-				break;
-			}
-			format++;
+			*pSize = 0;
+			return NULL;
 		}
 	}
+	else if (json_IsInline(node, node->key)) {
+		start = node->key + ((node->flags & JSON_NODE_FLAG_KEY) ? node->keyLength : strlen(node->key)) + 1;
+	}
 
-	node = json_node;
-	while (node != NULL)
-	{
-		if (node->key != NULL)
+	*pSize = (size_t)((json_InlineData(node) + JSON_NODE_INLINE_SIZE) - start);
+
+	return start;
+}
+
+// Get a buffer of `size` bytes for the key or value of a node, in the node when it fits, allocated otherwise
+char* json_NodeBuffer(JSON_NODE* node, size_t size, bool isKey, const JSON_ALLOCATOR* allocator)
+{
+	char* buffer;
+	size_t space;
+
+	buffer = json_InlineSpace(node, isKey, &space);
+	if (size <= space) {
+		return buffer;
+	}
+
+	return (char*)json_Allocate(allocator, size);
+}
+
+// Free the key or value of a node, unless it is stored in the node
+void json_FreeString(JSON_NODE* node, void* string, const JSON_ALLOCATOR* allocator)
+{
+	if ((string != NULL) && (!json_IsInline(node, string))) {
+		json_Deallocate(allocator, string);
+	}
+}
+
+// Copy a key into a node and set it, returns false if there is not enough memory
+bool json_CopyKey(JSON_NODE* node, const char* key, const JSON_ALLOCATOR* allocator)
+{
+	size_t length;
+	char* buffer;
+
+	length = UTF8_Encoding::GetStringUnits(key) + 1;
+	buffer = json_NodeBuffer(node, length, true, allocator);
+	if (buffer == NULL) {
+		return false;
+	}
+
+	UTF8_Encoding::StringCopy(buffer, length, key);
+	json_SetKey(node, buffer);
+
+	return true;
+}
+
+// Copy a string or number value into a node and set it, returns false if there is not enough memory
+bool json_CopyValue(JSON_NODE* node, const char* value, const JSON_ALLOCATOR* allocator)
+{
+	size_t length;
+	char* buffer;
+
+	length = UTF8_Encoding::GetStringUnits(value) + 1;
+	buffer = json_NodeBuffer(node, length, false, allocator);
+	if (buffer == NULL) {
+		return false;
+	}
+
+	UTF8_Encoding::StringCopy(buffer, length, value);
+	node->value = buffer;
+
+	return true;
+}
+
+// ------------------------------------- //
+// **   Object hash index functions   ** //
+// ------------------------------------- //
+
+// Free the hash index of an object or the item vector of an array, it is built again when it is needed
+void json_DropIndex(JSON_NODE* object)
+{
+	JSON_NODE_EXTRA* extra;
+
+	extra = json_NodeExtra(object, false);
+	if ((extra != NULL) && (extra->index != NULL)) {
+		json_Deallocate(json_NodeHeader(object)->allocator, extra->index);
+		extra->index = NULL;
+	}
+}
+
+// Add a member to the slots of an index
+// Returns false if the member has no key or a member with the same key is already in the index
+bool json_IndexAdd(JSON_OBJECT_INDEX* index, JSON_NODE* node)
+{
+	JSON_LOOKUP_KEY lookupKey;
+	size_t i;
+
+	if (!json_NodeKey(node, &lookupKey)) {
+		return false;
+	}
+
+	i = lookupKey.hash & (index->capacity - 1);
+	while (index->slots[i].node != NULL)
+	{
+		if ((index->slots[i].hash == lookupKey.hash) && (json_KeyEquals(index->slots[i].node, &lookupKey))) {
+			return false;
+		}
+		i = (i + 1) & (index->capacity - 1);
+	}
+
+	index->slots[i].node = node;
+	index->slots[i].hash = lookupKey.hash;
+	index->count++;
+
+	return true;
+}
+
+// Build the hash index of an object
+JSON_OBJECT_INDEX* json_BuildIndex(JSON_NODE* object)
+{
+	JSON_NODE_EXTRA* extra;
+	JSON_OBJECT_INDEX* index;
+	JSON_NODE* node;
+	size_t capacity;
+	size_t count;
+
+	extra = json_NodeExtra(object, true);
+	if (extra == NULL) {
+		return NULL;
+	}
+
+	count = 0;
+	for (node = (JSON_NODE*)object->value; node != NULL; node = node->next) {
+		count++;
+	}
+
+	// Keep the index at most half full
+	capacity = 32;
+	while (capacity < count * 2) {
+		capacity *= 2;
+	}
+
+	index = (JSON_OBJECT_INDEX*)json_Allocate(json_NodeHeader(object)->allocator, sizeof(JSON_OBJECT_INDEX) + (capacity - 1) * sizeof(JSON_INDEX_SLOT));
+	if (index == NULL) {
+		return NULL;
+	}
+
+	memset(index->slots, 0, capacity * sizeof(JSON_INDEX_SLOT));
+	index->first = (JSON_NODE*)object->value;
+	index->count = 0;
+	index->capacity = capacity;
+	index->hasDuplicateKeys = false;
+
+	for (node = (JSON_NODE*)object->value; node != NULL; node = node->next)
+	{
+		if (!json_IndexAdd(index, node)) {
+			index->hasDuplicateKeys = true;
+			break;
+		}
+	}
+
+	extra->index = index;
+
+	return index;
+}
+
+// Get the hash index of an object, NULL if the object has no index
+// An index that is out of date because the member list was changed directly is freed
+JSON_OBJECT_INDEX* json_GetIndex(JSON_NODE* object)
+{
+	JSON_OBJECT_INDEX* index;
+
+	if ((object->type != JSON_TYPE::OBJECT) || ((object->flags & JSON_NODE_FLAG_HEADER) == 0)) {
+		return NULL;
+	}
+
+	index = (JSON_OBJECT_INDEX*)json_NodeIndex(object);
+	if ((index != NULL) && (index->first != (JSON_NODE*)object->value))
+	{
+		json_DropIndex(object);
+		index = NULL;
+	}
+
+	return index;
+}
+
+// Scan a member list in order for the first member with `lookupKey`, `pType` is the type of the member or NULL for any type
+JSON_NODE* json_ScanMembers(JSON_NODE* node, const JSON_LOOKUP_KEY* lookupKey, const JSON_TYPE* pType)
+{
+	while (node != NULL)
+	{
+		if ((pType == NULL) || (node->type == *pType))
+		{
+			if (json_KeyEquals(node, lookupKey)) {
+				return node;
+			}
+		}
+		node = node->next;
+	}
+
+	return NULL;
+}
+
+// Find the first member of an object with `lookupKey`, `pType` is the type of the member or NULL for any type
+// Small objects are scanned, large objects build a hash index on the first lookup
+JSON_NODE* json_FindKey(JSON_NODE* object, const JSON_LOOKUP_KEY* lookupKey, const JSON_TYPE* pType)
+{
+	JSON_OBJECT_INDEX* index;
+	JSON_NODE* node;
+	size_t count;
+	size_t i;
+
+	if (object == NULL) {
+		return NULL;
+	}
+
+	index = json_GetIndex(object);
+	if (index == NULL)
+	{
+		count = 0;
+		for (node = (JSON_NODE*)object->value; node != NULL; node = node->next)
+		{
+			if ((pType == NULL) || (node->type == *pType))
+			{
+				if (json_KeyEquals(node, lookupKey)) {
+					return node;
+				}
+			}
+
+			count++;
+			if (count == JSON_OBJECT_INDEX_THRESHOLD) {
+				break;
+			}
+		}
+
+		if (node == NULL) {
+			return NULL;
+		}
+
+		if ((object->type == JSON_TYPE::OBJECT) && (object->flags & JSON_NODE_FLAG_HEADER)) {
+			index = json_BuildIndex(object);
+		}
+
+		if (index == NULL) {
+			return json_ScanMembers(node->next, lookupKey, pType);
+		}
+	}
+
+	if (index->hasDuplicateKeys) {
+		return json_ScanMembers((JSON_NODE*)object->value, lookupKey, pType);
+	}
+
+	i = lookupKey->hash & (index->capacity - 1);
+	while (index->slots[i].node != NULL)
+	{
+		node = index->slots[i].node;
+		if ((index->slots[i].hash == lookupKey->hash) && (json_KeyEquals(node, lookupKey)))
+		{
+			if ((pType == NULL) || (node->type == *pType)) {
+				return node;
+			}
+			return NULL;
+		}
+		i = (i + 1) & (index->capacity - 1);
+	}
+
+	return NULL;
+}
+
+// Find the first member of an object with a key of `keyLength` bytes, `pType` is the type of the member or NULL for any type
+JSON_NODE* json_FindMember(JSON_NODE* object, const char* key, size_t keyLength, const JSON_TYPE* pType)
+{
+	JSON_LOOKUP_KEY lookupKey;
+
+	if ((object == NULL) || (key == NULL)) {
+		return NULL;
+	}
+
+	json_LookupKey(&lookupKey, key, keyLength);
+
+	return json_FindKey(object, &lookupKey, pType);
+}
+
+#ifdef JSON_PLUS_CONSTEXPR_KEY
+
+// Find the first member of an object with a JSON_KEY, its hash is already computed
+JSON_NODE* json_FindMember(JSON_NODE* object, const JSON_KEY& key, const JSON_TYPE* pType)
+{
+	JSON_LOOKUP_KEY lookupKey;
+
+	if ((object == NULL) || (key.key == NULL)) {
+		return NULL;
+	}
+
+	lookupKey.key = key.key;
+	lookupKey.length = key.length;
+	lookupKey.hash = key.hash;
+
+	return json_FindKey(object, &lookupKey, pType);
+}
+
+#endif // JSON_PLUS_CONSTEXPR_KEY
+
+// Update the hash index of an object after `node` was inserted in front of the members
+void json_IndexInsert(JSON_NODE* object, JSON_NODE* node)
+{
+	JSON_OBJECT_INDEX* index;
+
+	if ((object->type != JSON_TYPE::OBJECT) || ((object->flags & JSON_NODE_FLAG_HEADER) == 0)) {
+		return;
+	}
+
+	index = (JSON_OBJECT_INDEX*)json_NodeIndex(object);
+	if (index == NULL) {
+		return;
+	}
+
+	// The index is built again when it is out of date or full
+	if ((index->first != node->next) || ((index->count + 1) * 2 > index->capacity)) {
+		json_DropIndex(object);
+		return;
+	}
+
+	// An object with duplicate keys keeps its index, so it is not indexed again on every lookup
+	if ((!index->hasDuplicateKeys) &&
+		(!json_IndexAdd(index, node))) {
+		index->hasDuplicateKeys = true;
+	}
+
+	index->first = node;
+}
+
+// Update the hash index of an object before `node` is removed from the members
+void json_IndexRemove(JSON_NODE* object, JSON_NODE* node)
+{
+	JSON_OBJECT_INDEX* index;
+	JSON_LOOKUP_KEY lookupKey;
+	size_t i, j, k;
+
+	index = json_GetIndex(object);
+	if (index == NULL) {
+		return;
+	}
+
+	if (node == index->first) {
+		index->first = node->next;
+	}
+
+	if ((index->hasDuplicateKeys) || (!json_NodeKey(node, &lookupKey))) {
+		return;
+	}
+
+	i = lookupKey.hash & (index->capacity - 1);
+	while ((index->slots[i].node != NULL) && (index->slots[i].node != node)) {
+		i = (i + 1) & (index->capacity - 1);
+	}
+
+	if (index->slots[i].node == NULL) {
+		return;
+	}
+
+	// Move the following slots back so no lookup stops at the removed slot
+	index->slots[i].node = NULL;
+	index->count--;
+
+	j = i;
+	while (true)
+	{
+		j = (j + 1) & (index->capacity - 1);
+		if (index->slots[j].node == NULL) {
+			break;
+		}
+
+		// A slot can move back to `i` when its home slot `k` is not cyclically in (i, j]
+		k = index->slots[j].hash & (index->capacity - 1);
+		if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) {
+			continue;
+		}
+
+		index->slots[i] = index->slots[j];
+		index->slots[j].node = NULL;
+		i = j;
+	}
+}
+
+// Update the hash index of an object before `node` is added after the last member
+void json_IndexAppend(JSON_NODE* object, JSON_NODE* node)
+{
+	JSON_OBJECT_INDEX* index;
+
+	index = json_GetIndex(object);
+	if (index == NULL) {
+		return;
+	}
+
+	// The index is built again when it is full
+	if ((index->count + 1) * 2 > index->capacity) {
+		json_DropIndex(object);
+		return;
+	}
+
+	if ((!index->hasDuplicateKeys) &&
+		(!json_IndexAdd(index, node))) {
+		index->hasDuplicateKeys = true;
+	}
+
+	if (index->first == NULL) {
+		index->first = node;
+	}
+}
+
+// ------------------------------------- //
+// **   Array item vector functions   ** //
+// ------------------------------------- //
+
+// Allocate an item vector for `count` items with free space at both ends
+JSON_ARRAY_ITEMS* json_AllocateItems(const JSON_ALLOCATOR* allocator, size_t count)
+{
+	JSON_ARRAY_ITEMS* items;
+	size_t capacity;
+
+	capacity = count + (count / 2) + 16;
+
+	items = (JSON_ARRAY_ITEMS*)json_Allocate(allocator, sizeof(JSON_ARRAY_ITEMS) + (capacity - 1) * sizeof(JSON_NODE*));
+	if (items == NULL) {
+		return NULL;
+	}
+
+	items->count = count;
+	items->capacity = capacity;
+	items->start = (capacity - count) / 2;
+
+	return items;
+}
+
+// Build the item vector of an array
+JSON_ARRAY_ITEMS* json_BuildItems(JSON_NODE* array)
+{
+	JSON_NODE_EXTRA* extra;
+	JSON_ARRAY_ITEMS* items;
+	JSON_NODE* node;
+	size_t count;
+	size_t i;
+
+	extra = json_NodeExtra(array, true);
+	if (extra == NULL) {
+		return NULL;
+	}
+
+	count = 0;
+	for (node = (JSON_NODE*)array->value; node != NULL; node = node->next) {
+		count++;
+	}
+
+	items = json_AllocateItems(json_NodeHeader(array)->allocator, count);
+	if (items == NULL) {
+		return NULL;
+	}
+
+	items->first = (JSON_NODE*)array->value;
+
+	i = items->start;
+	for (node = (JSON_NODE*)array->value; node != NULL; node = node->next) {
+		items->items[i++] = node;
+	}
+
+	extra->index = items;
+
+	return items;
+}
+
+// Get the item vector of an array, NULL if the array has no item vector
+// A vector that is out of date because the item list was changed directly is freed
+JSON_ARRAY_ITEMS* json_GetItems(JSON_NODE* array)
+{
+	JSON_ARRAY_ITEMS* items;
+
+	if ((array->type != JSON_TYPE::ARRAY) || ((array->flags & JSON_NODE_FLAG_HEADER) == 0)) {
+		return NULL;
+	}
+
+	items = (JSON_ARRAY_ITEMS*)json_NodeIndex(array);
+	if ((items != NULL) && (items->first != (JSON_NODE*)array->value))
+	{
+		json_DropIndex(array);
+		items = NULL;
+	}
+
+	return items;
+}
+
+// Check if an item vector should be built after `steps` nodes were walked in an array
+bool json_ShouldBuildItems(JSON_NODE* array, size_t steps)
+{
+	return ((steps >= JSON_ARRAY_ITEMS_THRESHOLD) && (array->type == JSON_TYPE::ARRAY) && (array->flags & JSON_NODE_FLAG_HEADER));
+}
+
+// Get the item of an array at `i`, NULL if there is no item at `i`
+// Large arrays build an item vector, so the next calls don't walk the item list
+JSON_NODE* json_GetItem(JSON_NODE* array, unsigned long i)
+{
+	JSON_ARRAY_ITEMS* items;
+	JSON_NODE* node;
+	unsigned long ci;
+
+	if (array == NULL) {
+		return NULL;
+	}
+
+	items = json_GetItems(array);
+	if (items != NULL)
+	{
+		if (i < items->count) {
+			return items->items[items->start + i];
+		}
+		return NULL;
+	}
+
+	node = (JSON_NODE*)array->value;
+	for (ci = 0; (node != NULL) && (ci < i); ci++) {
+		node = node->next;
+	}
+
+	if (json_ShouldBuildItems(array, ci)) {
+		json_BuildItems(array);
+	}
+
+	return node;
+}
+
+// Move the items of an array to the middle of a vector with twice the capacity
+// Returns the new vector, or NULL if it could not be allocated and the vector was freed
+JSON_ARRAY_ITEMS* json_GrowItems(JSON_NODE* array, JSON_ARRAY_ITEMS* items)
+{
+	JSON_NODE_HEADER* header;
+	JSON_ARRAY_ITEMS* pNewItems;
+
+	header = json_NodeHeader(array);
+
+	pNewItems = json_AllocateItems(header->allocator, items->count * 2);
+	if (pNewItems == NULL) {
+		json_DropIndex(array);
+		return NULL;
+	}
+
+	pNewItems->first = items->first;
+	pNewItems->count = items->count;
+	pNewItems->start = (pNewItems->capacity - items->count) / 2;
+	memcpy(&pNewItems->items[pNewItems->start], &items->items[items->start], items->count * sizeof(JSON_NODE*));
+
+	json_Deallocate(header->allocator, items);
+	header->extra->index = pNewItems;
+
+	return pNewItems;
+}
+
+// Update the item vector of an array after `node` was inserted in front of the items
+void json_ItemsInsert(JSON_NODE* array, JSON_NODE* node)
+{
+	JSON_ARRAY_ITEMS* items;
+
+	if ((array->type != JSON_TYPE::ARRAY) || ((array->flags & JSON_NODE_FLAG_HEADER) == 0)) {
+		return;
+	}
+
+	items = (JSON_ARRAY_ITEMS*)json_NodeIndex(array);
+	if (items == NULL) {
+		return;
+	}
+
+	if (items->first != node->next) {
+		json_DropIndex(array);
+		return;
+	}
+
+	if (items->start == 0)
+	{
+		items = json_GrowItems(array, items);
+		if (items == NULL) {
+			return;
+		}
+	}
+
+	items->start--;
+	items->items[items->start] = node;
+	items->count++;
+	items->first = node;
+}
+
+// Update the item vector of an array before the item at `i` is removed from the items
+void json_ItemsRemove(JSON_NODE* array, size_t i)
+{
+	JSON_ARRAY_ITEMS* items;
+	JSON_NODE** pItems;
+
+	items = json_GetItems(array);
+	if ((items == NULL) || (i >= items->count)) {
+		return;
+	}
+
+	pItems = &items->items[items->start];
+
+	// Move the smaller side of the vector over the removed item
+	if (i < items->count / 2)
+	{
+		memmove(&pItems[1], &pItems[0], i * sizeof(JSON_NODE*));
+		items->start++;
+	}
+	else {
+		memmove(&pItems[i], &pItems[i + 1], (items->count - i - 1) * sizeof(JSON_NODE*));
+	}
+
+	items->count--;
+
+	if (i == 0) {
+		items->first = (items->count != 0) ? items->items[items->start] : NULL;
+	}
+}
+
+// Update the item vector of an array before `node` is added after the last item
+void json_ItemsAppend(JSON_NODE* array, JSON_NODE* node)
+{
+	JSON_ARRAY_ITEMS* items;
+
+	items = json_GetItems(array);
+	if (items == NULL) {
+		return;
+	}
+
+	if (items->start + items->count == items->capacity)
+	{
+		items = json_GrowItems(array, items);
+		if (items == NULL) {
+			return;
+		}
+	}
+
+	items->items[items->start + items->count] = node;
+	items->count++;
+
+	if (items->count == 1) {
+		items->first = node;
+	}
+}
+
+// Update the item vector of an array after `node` was linked in at `i`, behind the 1st item
+void json_ItemsInsertAt(JSON_NODE* array, size_t i, JSON_NODE* node)
+{
+	JSON_ARRAY_ITEMS* items;
+	JSON_NODE** pItems;
+
+	items = json_GetItems(array);
+	if (items == NULL) {
+		return;
+	}
+
+	if ((i == 0) || (i > items->count)) {
+		json_DropIndex(array);
+		return;
+	}
+
+	if ((items->start == 0) && (items->start + items->count == items->capacity))
+	{
+		items = json_GrowItems(array, items);
+		if (items == NULL) {
+			return;
+		}
+	}
+
+	// Move the smaller side of the vector to make room, unless there is no room on that side
+	if ((items->start > 0) && ((i < items->count / 2) || (items->start + items->count == items->capacity)))
+	{
+		pItems = &items->items[items->start - 1];
+		memmove(&pItems[0], &pItems[1], i * sizeof(JSON_NODE*));
+		items->start--;
+	}
+	else
+	{
+		pItems = &items->items[items->start];
+		memmove(&pItems[i + 1], &pItems[i], (items->count - i) * sizeof(JSON_NODE*));
+	}
+
+	pItems[i] = node;
+	items->count++;
+}
+
+// ----------------------------- //
+// **   Item list functions   ** //
+// ----------------------------- //
+
+// Forget the last item and the number of items of an object or array, after its item list was replaced
+void json_ForgetTail(JSON_NODE* container)
+{
+	JSON_NODE_HEADER* header;
+
+	if ((container->flags & JSON_NODE_FLAG_HEADER) == 0) {
+		return;
+	}
+
+	header = json_NodeHeader(container);
+	header->first = NULL;
+	header->tail = NULL;
+	header->count = 0;
+	json_TakeStamp(header);
+}
+
+// Check if the header of an object or array has its last item and number of items
+// They are out of date when the 1st item changed or an item was added after the last item directly
+bool json_HasTail(JSON_NODE_HEADER* header, JSON_NODE* container)
+{
+	return ((header->tail != NULL) && (header->first == (JSON_NODE*)container->value) && (header->tail->next == NULL));
+}
+
+// Get the last item of an object or array, NULL if it has no items
+// The last item and the number of items are kept in the header, so the item list is only walked once
+JSON_NODE* json_GetTail(JSON_NODE* container)
+{
+	JSON_NODE_HEADER* header;
+	JSON_NODE* node;
+	size_t count;
+
+	node = (JSON_NODE*)container->value;
+	if (node == NULL) {
+		return NULL;
+	}
+
+	header = ((container->flags & JSON_NODE_FLAG_HEADER) != 0) ? json_NodeHeader(container) : NULL;
+
+	if ((header != NULL) && (json_HasTail(header, container))) {
+		return header->tail;
+	}
+
+	count = 1;
+	while (node->next != NULL)
+	{
+		node = node->next;
+		count++;
+	}
+
+	if (header != NULL)
+	{
+		header->first = (JSON_NODE*)container->value;
+		header->tail = node;
+		header->count = count;
+	}
+
+	return node;
+}
+
+// Get the number of items in an object or array
+unsigned long json_CountList(JSON_NODE* container)
+{
+	JSON_NODE* node;
+	unsigned long count;
+
+	if (json_GetTail(container) == NULL) {
+		return 0;
+	}
+
+	if (container->flags & JSON_NODE_FLAG_HEADER) {
+		return (unsigned long)json_NodeHeader(container)->count;
+	}
+
+	count = 0;
+	for (node = (JSON_NODE*)container->value; node != NULL; node = node->next) {
+		count++;
+	}
+
+	return count;
+}
+
+// Get the number of items in an array
+unsigned long json_CountItems(JSON_NODE* array)
+{
+	JSON_ARRAY_ITEMS* items;
+	unsigned long count;
+
+	if (array == NULL) {
+		return 0;
+	}
+
+	items = json_GetItems(array);
+	if (items != NULL) {
+		return (unsigned long)items->count;
+	}
+
+	count = json_CountList(array);
+
+	if (json_ShouldBuildItems(array, count)) {
+		json_BuildItems(array);
+	}
+
+	return count;
+}
+
+// Link a new item into an object or array, in front of the items or after the last item when `append` is true
+// Returns false if the object or array shares its items with a clone and there is not enough memory to copy them
+bool json_LinkNode(JSON_NODE* container, JSON_NODE* node, bool append)
+{
+	JSON_NODE_HEADER* header;
+	JSON_NODE* tail;
+
+	if (!json_Unshare(container)) {
+		return false;
+	}
+
+	header = ((container->flags & JSON_NODE_FLAG_HEADER) != 0) ? json_NodeHeader(container) : NULL;
+
+	if (append)
+	{
+		tail = json_GetTail(container);
+
+		json_IndexAppend(container, node);
+		json_ItemsAppend(container, node);
+
+		node->next = NULL;
+		if (tail == NULL) {
+			container->value = node;
+		}
+		else {
+			tail->next = node;
+		}
+
+		if (header != NULL)
+		{
+			if (tail == NULL)
+			{
+				header->first = node;
+				header->count = 0;
+			}
+			header->tail = node;
+			header->count++;
+			json_TakeStamp(header);
+		}
+	}
+	else
+	{
+		if ((header != NULL) && (!json_HasTail(header, container))) {
+			json_ForgetTail(container);
+			header = NULL;
+		}
+
+		node->next = (JSON_NODE*)container->value;
+		container->value = node;
+
+		json_IndexInsert(container, node);
+		json_ItemsInsert(container, node);
+
+		if (header != NULL)
+		{
+			header->first = node;
+			header->count++;
+			json_TakeStamp(header);
+		}
+	}
+
+	return true;
+}
+
+// Update the last item and the number of items of an object or array before `node` is removed from the items
+// `prev_node` is the item in front of `node`, or NULL if it is the 1st item
+void json_TailRemove(JSON_NODE* container, JSON_NODE* node, JSON_NODE* prev_node)
+{
+	JSON_NODE_HEADER* header;
+
+	if ((container->flags & JSON_NODE_FLAG_HEADER) == 0) {
+		return;
+	}
+
+	header = json_NodeHeader(container);
+	if (!json_HasTail(header, container))
+	{
+		json_ForgetTail(container);
+		return;
+	}
+
+	if (node == header->first) {
+		header->first = node->next;
+	}
+	if (node == header->tail) {
+		header->tail = prev_node;
+	}
+	header->count--;
+	json_TakeStamp(header);
+}
+
+// Remove an item from an object or array without freeing it, the object or array must not share its items
+// `prev_node` is the item in front of `node`, or NULL if it is the 1st item, `i` is the index of the item in an array
+void json_UnlinkNode(JSON_NODE* container, JSON_NODE* node, JSON_NODE* prev_node, size_t i)
+{
+	json_IndexRemove(container, node);
+	json_ItemsRemove(container, i);
+	json_TailRemove(container, node, prev_node);
+
+	if (prev_node == NULL) {
+		container->value = node->next;
+	}
+	else {
+		prev_node->next = node->next;
+	}
+
+	node->next = NULL;
+}
+
+// Link an item into an object or array behind `prev_node`, in front of the items when `prev_node` is NULL
+// `i` is the index the item gets in an array, the object or array must not share its items
+void json_LinkAfter(JSON_NODE* container, JSON_NODE* node, JSON_NODE* prev_node, size_t i)
+{
+	JSON_NODE_HEADER* header;
+
+	header = ((container->flags & JSON_NODE_FLAG_HEADER) != 0) ? json_NodeHeader(container) : NULL;
+
+	if ((header != NULL) && (!json_HasTail(header, container))) {
+		json_ForgetTail(container);
+		header = NULL;
+	}
+
+	if (prev_node == NULL)
+	{
+		node->next = (JSON_NODE*)container->value;
+		container->value = node;
+
+		json_IndexInsert(container, node);
+		json_ItemsInsert(container, node);
+
+		if (header != NULL) {
+			header->first = node;
+		}
+	}
+	else
+	{
+		node->next = prev_node->next;
+		prev_node->next = node;
+
+		json_IndexAppend(container, node);
+		json_ItemsInsertAt(container, i, node);
+
+		if ((header != NULL) && (header->tail == prev_node)) {
+			header->tail = node;
+		}
+	}
+
+	if (header != NULL)
+	{
+		header->count++;
+		json_TakeStamp(header);
+	}
+}
+
+// ----------------------------------- //
+// **   Shared item list functions   ** //
+// ----------------------------------- //
+
+// Check if an object or array shares its item list with a clone
+bool json_IsShared(JSON_NODE* container)
+{
+	JSON_NODE_EXTRA* extra;
+
+	extra = json_NodeExtra(container, false);
+
+	return ((extra != NULL) && (extra->sharedNext != json_NodeHeader(container)));
+}
+
+// Share the item list of an object or array with its clone, both must have a header
+// Returns false if there is not enough memory for their side blocks, the clone gets no items then
+bool json_ShareItems(JSON_NODE* container, JSON_NODE* clone)
+{
+	JSON_NODE_HEADER* header;
+	JSON_NODE_HEADER* cloneHeader;
+	JSON_NODE_EXTRA* extra;
+	JSON_NODE_EXTRA* cloneExtra;
+
+	extra = json_NodeExtra(container, true);
+	cloneExtra = json_NodeExtra(clone, true);
+	if ((extra == NULL) || (cloneExtra == NULL)) {
+		return false;
+	}
+
+	header = json_NodeHeader(container);
+	cloneHeader = json_NodeHeader(clone);
+
+	cloneExtra->sharedNext = extra->sharedNext;
+	cloneExtra->sharedPrev = header;
+	extra->sharedNext->extra->sharedPrev = cloneHeader;
+	extra->sharedNext = cloneHeader;
+
+	clone->value = container->value;
+
+	// The last item, the number of items and the hash are the same, they are checked before they are used
+	cloneHeader->first = header->first;
+	cloneHeader->tail = header->tail;
+	cloneHeader->count = header->count;
+	if (extra->hashStamp == extra->stamp)
+	{
+		cloneExtra->hash = extra->hash;
+		cloneExtra->hashStamp = cloneExtra->stamp;
+	}
+
+	return true;
+}
+
+// Stop sharing the item list of an object or array, its items are left to the clones that still share them
+// Returns false if the item list was not shared, the items are not changed then
+bool json_LeaveShared(JSON_NODE* container)
+{
+	JSON_NODE_HEADER* header;
+	JSON_NODE_EXTRA* extra;
+
+	if (!json_IsShared(container)) {
+		return false;
+	}
+
+	header = json_NodeHeader(container);
+	extra = header->extra;
+	extra->sharedPrev->extra->sharedNext = extra->sharedNext;
+	extra->sharedNext->extra->sharedPrev = extra->sharedPrev;
+	extra->sharedNext = header;
+	extra->sharedPrev = header;
+
+	json_DropIndex(container);
+	json_ForgetTail(container);
+	container->value = NULL;
+
+	return true;
+}
+
+// Copy a node for a clone, the copy of an object or array shares the item list of the node
+// Objects and arrays without a header are copied with their items, `hasHeader` gives the copy a header
+JSON_NODE* json_CloneNode(JSON_NODE* node, const JSON_ALLOCATOR* allocator, bool hasHeader)
+{
+	JSON_NODE* clone;
+	JSON_NODE* item;
+	JSON_NODE* copy;
+	JSON_NODE* tail;
+	char* buffer;
+	size_t length;
+
+	clone = json_AllocateNode(allocator, node->type, hasHeader);
+	if (clone == NULL) {
+		return NULL;
+	}
+
+	if (node->key != NULL)
+	{
+		length = (node->flags & JSON_NODE_FLAG_KEY) ? node->keyLength : strlen(node->key);
+		buffer = json_NodeBuffer(clone, length + 1, true, allocator);
+		if (buffer == NULL) {
+			json_FreeList(clone, allocator);
+			return NULL;
+		}
+		memcpy(buffer, node->key, length + 1);
+		json_SetKey(clone, buffer);
+	}
+
+	if (node->format != NULL)
+	{
+		length = strlen(node->format) + 1;
+		buffer = (char*)json_Allocate(allocator, length);
+		if (buffer == NULL) {
+			json_FreeList(clone, allocator);
+			return NULL;
+		}
+		memcpy(buffer, node->format, length);
+		clone->format = buffer;
+	}
+
+	if (json_IsContainer(node->type))
+	{
+		if (node->flags & JSON_NODE_FLAG_HEADER)
+		{
+			if (!json_ShareItems(node, clone)) {
+				json_FreeList(clone, allocator);
+				return NULL;
+			}
+			return clone;
+		}
+
+		tail = NULL;
+		for (item = (JSON_NODE*)node->value; item != NULL; item = item->next)
+		{
+			copy = json_CloneNode(item, allocator, false);
+			if (copy == NULL) {
+				json_FreeList(clone, allocator);
+				return NULL;
+			}
+			if (tail == NULL) {
+				clone->value = copy;
+			}
+			else {
+				tail->next = copy;
+			}
+			tail = copy;
+		}
+	}
+	else if (((node->type == JSON_TYPE::STRING) || (node->type == JSON_TYPE::NUMBER)) && (node->value != NULL))
+	{
+		length = strlen((const char*)node->value) + 1;
+		clone->value = json_NodeBuffer(clone, length, false, allocator);
+		if (clone->value == NULL) {
+			json_FreeList(clone, allocator);
+			return NULL;
+		}
+		memcpy(clone->value, node->value, length);
+	}
+	else {
+		clone->value = node->value;
+	}
+
+	return clone;
+}
+
+// Give an object or array its own item list before it is changed, when it shares the item list with a clone
+// Only the items are copied, the objects and arrays in the copy share their item lists with the old items
+// Returns false if there is not enough memory, the object or array still shares its items then
+bool json_Unshare(JSON_NODE* container)
+{
+	const JSON_ALLOCATOR* allocator;
+	JSON_NODE* first;
+	JSON_NODE* tail;
+	JSON_NODE* item;
+	JSON_NODE* copy;
+
+	if (!json_IsShared(container)) {
+		return true;
+	}
+
+	allocator = json_NodeHeader(container)->allocator;
+
+	first = tail = NULL;
+	for (item = (JSON_NODE*)container->value; item != NULL; item = item->next)
+	{
+		copy = json_CloneNode(item, allocator, false);
+		if (copy == NULL) {
+			json_FreeList(first, allocator);
+			return false;
+		}
+		if (tail == NULL) {
+			first = copy;
+		}
+		else {
+			tail->next = copy;
+		}
+		tail = copy;
+	}
+
+	json_LeaveShared(container);
+	container->value = first;
+
+	return true;
+}
+
+// Give an object or array its own item list and find the copy of `item` in it
+// Returns NULL if the item is not in the object or array, or there is not enough memory
+JSON_NODE* json_UnshareItem(JSON_NODE* container, JSON_NODE* item)
+{
+	JSON_NODE* node;
+	size_t i;
+
+	if (!json_IsShared(container)) {
+		return item;
+	}
+
+	i = 0;
+	for (node = (JSON_NODE*)container->value; (node != NULL) && (node != item); node = node->next) {
+		i++;
+	}
+
+	if ((node == NULL) || (!json_Unshare(container))) {
+		return NULL;
+	}
+
+	for (node = (JSON_NODE*)container->value; i > 0; i--) {
+		node = node->next;
+	}
+
+	return node;
+}
+
+// -------------------------------- //
+// **   Compact tree functions   ** //
+// -------------------------------- //
+
+// Single memory block of a compacted tree, followed by the nodes in depth-first order and then their strings
+// The block is the allocator of the tree, so the free functions don't need to know about it: every node and string
+// in the block is a piece that is counted down when it is freed, allocations made later go to the allocator of the old
+// tree and are counted too, and the block is freed with the last piece
+struct JSON_COMPACT_BLOCK
+{
+	JSON_ALLOCATOR allocator;
+	const JSON_ALLOCATOR* parent;
+	const char* end;
+	size_t pieces;
+};
+
+// Check if a memory block is a piece of a compact block
+bool json_InCompactBlock(JSON_COMPACT_BLOCK* block, void* piece)
+{
+	return ((const char*)piece > (const char*)block) && ((const char*)piece < block->end);
+}
+
+void* json_CompactAllocate(void* userData, size_t size)
+{
+	JSON_COMPACT_BLOCK* block;
+	void* piece;
+
+	block = (JSON_COMPACT_BLOCK*)userData;
+
+	piece = json_Allocate(block->parent, size);
+	if (piece != NULL) {
+		block->pieces++;
+	}
+
+	return piece;
+}
+
+// A piece of the block is moved out of the block, the bytes after it in the block can be copied with it
+void* json_CompactReallocate(void* userData, void* piece, size_t size)
+{
+	JSON_COMPACT_BLOCK* block;
+	void* newPiece;
+	size_t length;
+
+	block = (JSON_COMPACT_BLOCK*)userData;
+
+	if (!json_InCompactBlock(block, piece)) {
+		return json_Reallocate(block->parent, piece, size);
+	}
+
+	newPiece = json_Allocate(block->parent, size);
+	if (newPiece != NULL)
+	{
+		length = (size_t)(block->end - (const char*)piece);
+		memcpy(newPiece, piece, (length < size) ? length : size);
+	}
+
+	return newPiece;
+}
+
+void json_CompactDeallocate(void* userData, void* piece)
+{
+	JSON_COMPACT_BLOCK* block;
+
+	block = (JSON_COMPACT_BLOCK*)userData;
+
+	if (!json_InCompactBlock(block, piece)) {
+		json_Deallocate(block->parent, piece);
+	}
+
+	block->pieces--;
+	if (block->pieces == 0) {
+		json_Deallocate(block->parent, block);
+	}
+}
+
+// Get the number of bytes of a node and its child nodes in a compact block, `hasHeader` is true when the node gets a header
+void json_CompactSize(JSON_NODE* node, bool hasHeader, size_t* pNodeBytes, size_t* pStringBytes)
+{
+	JSON_NODE* child;
+
+	*pNodeBytes += sizeof(JSON_NODE);
+	if ((hasHeader) || (json_IsContainer(node->type)) || (node->flags & JSON_NODE_FLAG_HEADER)) {
+		*pNodeBytes += sizeof(JSON_NODE_HEADER);
+	}
+
+	if ((node->key != NULL) && (!json_IsInline(node, node->key))) {
+		*pStringBytes += ((node->flags & JSON_NODE_FLAG_KEY) ? node->keyLength : strlen(node->key)) + 1;
+	}
+
+	if (node->format != NULL) {
+		*pStringBytes += strlen(node->format) + 1;
+	}
+
+	if (json_IsContainer(node->type))
+	{
+		for (child = (JSON_NODE*)node->value; child != NULL; child = child->next) {
+			json_CompactSize(child, false, pNodeBytes, pStringBytes);
+		}
+	}
+	else if (((node->type == JSON_TYPE::STRING) || (node->type == JSON_TYPE::NUMBER)) && (node->value != NULL) && (!json_IsInline(node, node->value))) {
+		*pStringBytes += strlen((const char*)node->value) + 1;
+	}
+}
+
+// Copy a string of `length` bytes into the strings of a compact block
+char* json_CompactString(JSON_COMPACT_BLOCK* block, const char* string, size_t length, char** pStrings)
+{
+	char* copy;
+
+	copy = (char*)memcpy(*pStrings, string, length);
+	*pStrings += length;
+	block->pieces++;
+
+	return copy;
+}
+
+// Copy a node and its child nodes into a compact block, the nodes are written at `pNodes` and the strings at `pStrings`
+// The copy of an object or array has its own items, also when the node shares its items with a clone
+JSON_NODE* json_CompactNode(JSON_COMPACT_BLOCK* block, JSON_NODE* node, bool hasHeader, char** pNodes, char** pStrings)
+{
+	JSON_NODE_HEADER* header;
+	JSON_NODE* copy;
+	JSON_NODE* child;
+	JSON_NODE* tail;
+	size_t count;
+
+	header = NULL;
+	if ((hasHeader) || (json_IsContainer(node->type)) || (node->flags & JSON_NODE_FLAG_HEADER))
+	{
+		header = (JSON_NODE_HEADER*)*pNodes;
+		header->allocator = &block->allocator;
+		header->first = NULL;
+		header->tail = NULL;
+		header->count = 0;
+		header->extra = NULL;
+		*pNodes += sizeof(JSON_NODE_HEADER);
+	}
+
+	// The type, key length and hash and the inline storage are copied with the node
+	copy = (JSON_NODE*)memcpy(*pNodes, node, sizeof(JSON_NODE));
+	*pNodes += sizeof(JSON_NODE);
+	block->pieces++;
+
+	copy->next = NULL;
+	copy->flags = (header != NULL) ? (node->flags | JSON_NODE_FLAG_HEADER) : (node->flags & ~JSON_NODE_FLAG_HEADER);
+
+	if ((node->key != NULL) && (json_IsInline(node, node->key))) {
+		copy->key = json_InlineData(copy) + (node->key - json_InlineData(node));
+	}
+	else if (node->key != NULL) {
+		copy->key = json_CompactString(block, node->key, ((node->flags & JSON_NODE_FLAG_KEY) ? node->keyLength : strlen(node->key)) + 1, pStrings);
+	}
+
+	if (node->format != NULL) {
+		copy->format = json_CompactString(block, node->format, strlen(node->format) + 1, pStrings);
+	}
+
+	if (json_IsContainer(node->type))
+	{
+		copy->value = NULL;
+		tail = NULL;
+		count = 0;
+		for (child = (JSON_NODE*)node->value; child != NULL; child = child->next)
+		{
+			if (tail == NULL) {
+				tail = json_CompactNode(block, child, false, pNodes, pStrings);
+				copy->value = tail;
+			}
+			else {
+				tail->next = json_CompactNode(block, child, false, pNodes, pStrings);
+				tail = tail->next;
+			}
+			count++;
+		}
+
+		// The last item and the number of items are known, so they are not counted again
+		if (tail != NULL)
+		{
+			header->first = (JSON_NODE*)copy->value;
+			header->tail = tail;
+			header->count = count;
+		}
+	}
+	else if (((node->type == JSON_TYPE::STRING) || (node->type == JSON_TYPE::NUMBER)) && (node->value != NULL))
+	{
+		if (json_IsInline(node, node->value)) {
+			copy->value = json_InlineData(copy) + ((const char*)node->value - json_InlineData(node));
+		}
+		else {
+			copy->value = json_CompactString(block, (const char*)node->value, strlen((const char*)node->value) + 1, pStrings);
+		}
+	}
+
+	return copy;
+}
+
+// ---------------------------- //
+// **   _JSON_NODE methods   ** //
+// ---------------------------- //
+
+const char* _JSON_NODE::String()
+{
+	if (this->type == JSON_TYPE::STRING) {
+		return (const char*)this->value;
+	}
+
+	return NULL;
+}
+
+bool _JSON_NODE::Boolean()
+{
+	if (this->type == JSON_TYPE::BOOLEAN) {
+		return (bool)this->value;
+	}
+
+	return false;
+}
+
+double _JSON_NODE::Double()
+{
+	if (this->type == JSON_TYPE::NUMBER) {
+		return atof((char*)this->value);
+	}
+
+	return 0.0f;
+}
+
+int _JSON_NODE::Int()
+{
+	if (this->type == JSON_TYPE::NUMBER) {
+		return atoi((char*)this->value);
+	}
+
+	return 0;
+}
+
+long _JSON_NODE::Long()
+{
+	if (this->type == JSON_TYPE::NUMBER) {
+		return atol((char*)this->value);
+	}
+
+	return 0;
+}
+
+long long _JSON_NODE::Int64()
+{
+	if (this->type == JSON_TYPE::NUMBER) {
+		return atoll((char*)this->value);
+	}
+
+	return 0;
+}
+
+#ifdef JSON_PLUS_STRING_VIEW
+
+// Get a string or number value as a string view, values don't store their length so it is counted with strlen on every call
+std::string_view json_ValueView(JSON_NODE* node)
+{
+	if (node->value == NULL) {
+		return std::string_view();
+	}
+
+	return std::string_view((const char*)node->value);
+}
+
+std::string_view _JSON_NODE::KeyView()
+{
+	if (this->key == NULL) {
+		return std::string_view();
+	}
+
+	// Keys set by json-plus store their length
+	if (this->flags & JSON_NODE_FLAG_KEY) {
+		return std::string_view(this->key, this->keyLength);
+	}
+
+	return std::string_view(this->key);
+}
+
+std::string_view _JSON_NODE::StringView()
+{
+	if (this->type == JSON_TYPE::STRING) {
+		return json_ValueView(this);
+	}
+
+	return std::string_view();
+}
+
+#endif // JSON_PLUS_STRING_VIEW
+
+// Free the value of a node, the node itself and its key are kept
+// `parentAllocator` is the allocator of the parent object or array
+void json_free_value(JSON_NODE* node, const JSON_ALLOCATOR* parentAllocator)
+{
+	const JSON_ALLOCATOR* allocator;
+
+	allocator = json_NodeAllocator(node, parentAllocator);
+
+	if (json_IsContainer(node->type))
+	{
+		// Items that are shared with a clone are freed by the last clone
+		if (!json_LeaveShared(node)) {
+			json_FreeList((JSON_NODE*)node->value, allocator);
+		}
+		json_DropIndex(node);
+		json_ForgetTail(node);
+	}
+	else
+	{
+		if (node->type != JSON_TYPE::BOOLEAN) {
+			json_FreeString(node, node->value, allocator);
+		}
+	}
+
+	node->value = NULL;
+}
+
+// Free a node, `parentAllocator` is the allocator of the parent object or array
+void json_free_node(JSON_NODE* node, const JSON_ALLOCATOR* parentAllocator)
+{
+	const JSON_ALLOCATOR* allocator;
+
+	allocator = json_NodeAllocator(node, parentAllocator);
+
+	json_free_value(node, parentAllocator);
+
+	json_FreeString(node, node->key, allocator);
+
+	if (node->format) {
+		json_Deallocate(allocator, (void*)node->format);
+	}
+
+	json_DeallocateNode(node, parentAllocator);
+}
+
+void json_FreeList(JSON_NODE* node, const JSON_ALLOCATOR* parentAllocator)
+{
+	JSON_NODE* nextNode;
+
+	while (node)
+	{
+		nextNode = node->next;
+		json_free_node(node, parentAllocator);
+		node = nextNode;
+	}
+}
+
+// ------------------------ //
+// **   JSON generator   ** //
+// ------------------------ //
+
+// Forward declaration of json_GeneratorIndentation
+// Output tabs for a line, this is automatically enabled when a format string is provided
+void json_GeneratorIndentation(JSON_GENERATOR_CONTEXT* context);
+
+// ---------------------------------- //
+// **   JSON generator functions   ** //
+// ---------------------------------- //
+
+// Append a new character to the JSON string buffer
+// If `bFormat` is true then the function checks formatting parameters
+void json_GeneratorAppend(JSON_GENERATOR_CONTEXT* context, unsigned long CodePoint, bool bFormat)
+{
+	unsigned char CharUnits;
+	unsigned long newLines;
+	const char* pFormat = NULL;
+
+	if ((bFormat) && (context->format))
+	{
+		if (CodePoint == '}') {
+			context->indentation--;
+		}
+
+		newLines = 0;
+
+		pFormat = context->format;
+		while (*pFormat != '\0')
+		{
+			if (*pFormat == '\n') {
+				newLines++;
+			}
+			else if (*pFormat == CodePoint) {
+				for (unsigned long i = 0; i < newLines; i++) {
+					json_GeneratorAppend(context, '\n', false);
+					json_GeneratorIndentation(context);
+				}
+				pFormat++;
+				break;
+			}
+			else {
+				newLines = 0;
+			}
+			pFormat++;
+		}
+	}
+
+	CharUnits = UTF8_Encoding::EncodeUnsafe(NULL, CodePoint);
+
+	// buffer big enough for CodePoint + NULL character ?
+	if ((context->index + CharUnits + 1) >= context->bufferLength)
+	{
+		context->bufferLength += JSON_GENERATOR_BUFFER_INCREASE;
+		char* pNewBuffer = (char*)json_Reallocate(context->allocator, context->buffer, context->bufferLength);
+		if (pNewBuffer != NULL) {
+			context->buffer = pNewBuffer;
+		}
+		else {
+			context->error = true;
+			longjmp(context->env, 1);
+		}
+	}
+
+	context->index += UTF8_Encoding::EncodeUnsafe(&context->buffer[context->index], CodePoint);
+
+	if ((bFormat) && (pFormat != NULL))
+	{
+		if (CodePoint == '{') {
+			context->indentation++;
+		}
+
+		while ((*pFormat != '\0') && (*pFormat != 'e'))
+		{
+			json_GeneratorAppend(context, *pFormat, false);
+			if (*pFormat == '\n') {
+				json_GeneratorIndentation(context);
+			}
+			pFormat++;
+		}
+	}
+}
+
+void json_GeneratorIndentation(JSON_GENERATOR_CONTEXT* context)
+{
+	for (long i = 0; i < context->indentation; i++)
+	{
+		json_GeneratorAppend(context, '\t', false);
+	}
+}
+
+// Append `length` bytes to the JSON string buffer, the buffer grows to twice its size so long strings are copied once
+void json_GeneratorWrite(JSON_GENERATOR_CONTEXT* context, const char* bytes, size_t length)
+{
+	size_t bufferLength;
+	char* pNewBuffer;
+
+	if ((context->index + length + 1) >= context->bufferLength)
+	{
+		bufferLength = (context->bufferLength * 2) + length + JSON_GENERATOR_BUFFER_INCREASE;
+		pNewBuffer = (char*)json_Reallocate(context->allocator, context->buffer, bufferLength);
+		if (pNewBuffer == NULL) {
+			context->error = true;
+			longjmp(context->env, 1);
+		}
+		context->buffer = pNewBuffer;
+		context->bufferLength = bufferLength;
+	}
+
+	memcpy(&context->buffer[context->index], bytes, length);
+	context->index += length;
+}
+
+// Recursive JSON text generator (from node)
+char* json_GenerateText(JSON_NODE* json_node, JSON_GENERATOR_CONTEXT* context)
+{
+	unsigned char CharUnits;
+	unsigned long CodePoint;
+	JSON_NODE* node;
+	const char* format;
+	long p = -1, n = 0;
+	const char* extraChars;
+
+	format = NULL;
+
+	// Look for special 'p' formatting character
+	if (context->format != NULL)
+	{
+		format = context->format;
+
+		while (*format != '\0')
+		{
+			if (*format == 'p') {
+				p = 0;
+				format++;
+
+				// Get number of key-value pairs for a single line
+				while ((*format >= '0') && (*format <= '9')) {
+					p *= 10;
+					p += (*format - '0');
+					format++;
+				}
+				break;
+			}
+			format++;
+		}
+	}
+
+	node = json_node;
+	while (node != NULL)
+	{
+		if (node->key != NULL)
+		{
+			json_GeneratorAppend(context, '"', true);
+
+			const char* pKey = node->key;
+			CharUnits = UTF8_Encoding::GetCharacterUnits(*pKey);
+			CodePoint = UTF8_Encoding::Decode(CharUnits, pKey);
+
+			while (CodePoint != '\0')
+			{
+				// Escape special characters
+				switch (CodePoint)
+				{
+				case 0x22: // " quotation mark
+				case 0x5C: // \ reverse solidus
+					json_GeneratorAppend(context, '\\', false);
+					json_GeneratorAppend(context, CodePoint, false);
+					break;
+				case 0x08: // b backspace
+					json_GeneratorAppend(context, '\\', false);
+					if (context->visualEscape) {
+						json_GeneratorAppend(context, 'b', false);
+					}
+					else {
+						json_GeneratorAppend(context, CodePoint, false);
+					}
+					break;
+				case 0x0C: // f form feed
+					json_GeneratorAppend(context, '\\', false);
+					if (context->visualEscape) {
+						json_GeneratorAppend(context, 'f', false);
+					}
+					else {
+						json_GeneratorAppend(context, CodePoint, false);
+					}
+					break;
+				case 0x0A: // n line feed
+					json_GeneratorAppend(context, '\\', false);
+					if (context->visualEscape) {
+						json_GeneratorAppend(context, 'n', false);
+					}
+					else {
+						json_GeneratorAppend(context, CodePoint, false);
+					}
+					break;
+				case 0x0D: // r carriage return
+					json_GeneratorAppend(context, '\\', false);
+					if (context->visualEscape) {
+						json_GeneratorAppend(context, 'r', false);
+					}
+					else {
+						json_GeneratorAppend(context, CodePoint, false);
+					}
+					break;
+				case 0x09: // t tab
+					json_GeneratorAppend(context, '\\', false);
+					if (context->visualEscape) {
+						json_GeneratorAppend(context, 't', false);
+					}
+					else {
+						json_GeneratorAppend(context, CodePoint, false);
+					}
+					break;
+				default:
+					json_GeneratorAppend(context, CodePoint, false);
+					break;
+				}
+
+				pKey += CharUnits;
+
+				CharUnits = UTF8_Encoding::GetCharacterUnits(*pKey);
+				CodePoint = UTF8_Encoding::Decode(CharUnits, pKey);
+			}
+
+			json_GeneratorAppend(context, '"', true);
+			json_GeneratorAppend(context, ':', true);
+		}
+
+		if (node->type == JSON_TYPE::OBJECT)
+		{
+			format = NULL;
+			if (node->format) {
+				format = context->format;
+				context->format = node->format;
+			}
+
+			json_GeneratorAppend(context, '{', true);
+			json_GenerateText((JSON_NODE*)node->value, context);
+			json_GeneratorAppend(context, '}', true);
+
+			if (format) {
+				context->format = format;
+			}
+		}
+		else if (node->type == JSON_TYPE::ARRAY)
+		{
+			format = NULL;
+			if (node->format) {
+				format = context->format;
+				context->format = node->format;
+			}
+
+			json_GeneratorAppend(context, '[', true);
+			json_GenerateText((JSON_NODE*)node->value, context);
+			json_GeneratorAppend(context, ']', true);
+
+			if (format) {
+				context->format = format;
+			}
+		}
+		else if (node->type == JSON_TYPE::STRING)
+		{
+			json_GeneratorAppend(context, '"', true);
+
+			const char* pValue = (const char*)node->value;
+			CharUnits = UTF8_Encoding::GetCharacterUnits(*pValue);
+			CodePoint = UTF8_Encoding::Decode(CharUnits, pValue);
+
+			while (CodePoint != '\0')
+			{
+				// Escape special characters
+				switch (CodePoint)
+				{
+				case 0x22: // " quotation mark
+				case 0x5C: // \ reverse solidus
+					json_GeneratorAppend(context, '\\', false);
+					json_GeneratorAppend(context, CodePoint, false);
+					break;
+				case 0x08: // b backspace
+					json_GeneratorAppend(context, '\\', false);
+					if (context->visualEscape) {
+						json_GeneratorAppend(context, 'b', false);
+					}
+					else {
+						json_GeneratorAppend(context, CodePoint, false);
+					}
+					break;
+				case 0x0C: // f form feed
+					json_GeneratorAppend(context, '\\', false);
+					if (context->visualEscape) {
+						json_GeneratorAppend(context, 'f', false);
+					}
+					else {
+						json_GeneratorAppend(context, CodePoint, false);
+					}
+					break;
+				case 0x0A: // n line feed
+					json_GeneratorAppend(context, '\\', false);
+					if (context->visualEscape) {
+						json_GeneratorAppend(context, 'n', false);
+					}
+					else {
+						json_GeneratorAppend(context, CodePoint, false);
+					}
+					break;
+				case 0x0D: // r carriage return
+					json_GeneratorAppend(context, '\\', false);
+					if (context->visualEscape) {
+						json_GeneratorAppend(context, 'r', false);
+					}
+					else {
+						json_GeneratorAppend(context, CodePoint, false);
+					}
+					break;
+				case 0x09: // t tab
+					json_GeneratorAppend(context, '\\', false);
+					if (context->visualEscape) {
+						json_GeneratorAppend(context, 't', false);
+					}
+					else {
+						json_GeneratorAppend(context, CodePoint, false);
+					}
+					break;
+				default:
+					json_GeneratorAppend(context, CodePoint, false);
+					break;
+				}
+
+				pValue += CharUnits;
+
+				CharUnits = UTF8_Encoding::GetCharacterUnits(*pValue);
+				CodePoint = UTF8_Encoding::Decode(CharUnits, pValue);
+			}
+
+			json_GeneratorAppend(context, '"', true);
+		}
+		else if (node->type == JSON_TYPE::NUMBER)
+		{
+			const char* pValue = (const char*)node->value;
+			CharUnits = UTF8_Encoding::GetCharacterUnits(*pValue);
+			CodePoint = UTF8_Encoding::Decode(CharUnits, pValue);
+
+			while (CodePoint != '\0')
+			{
+				json_GeneratorAppend(context, CodePoint, false);
+
+				pValue += CharUnits;
+
+				CharUnits = UTF8_Encoding::GetCharacterUnits(*pValue);
+				CodePoint = UTF8_Encoding::Decode(CharUnits, pValue);
+			}
+		}
+		else if (node->type == JSON_TYPE::BOOLEAN)
+		{
+			bool bValue = (bool)node->value;
+
+			if (bValue) {
+				json_GeneratorAppend(context, 't', false);
+				json_GeneratorAppend(context, 'r', false);
+				json_GeneratorAppend(context, 'u', false);
+				json_GeneratorAppend(context, 'e', false);
+			}
+			else {
+				json_GeneratorAppend(context, 'f', false);
+				json_GeneratorAppend(context, 'a', false);
+				json_GeneratorAppend(context, 'l', false);
+				json_GeneratorAppend(context, 's', false);
+				json_GeneratorAppend(context, 'e', false);
+			}
+		}
+		else if (node->type == JSON_TYPE::NULL_TYPE)
+		{
+			json_GeneratorAppend(context, 'n', false);
+			json_GeneratorAppend(context, 'u', false);
+			json_GeneratorAppend(context, 'l', false);
+			json_GeneratorAppend(context, 'l', false);
+		}
+
+		node = node->next;
+		if (node != NULL)
+		{
+			json_GeneratorAppend(context, ',', true);
+
+			if (p != -1) {
+				n++;
+				if (n >= p) {
+					json_GeneratorAppend(context, '\n', true);
+					json_GeneratorIndentation(context);
+
+					extraChars = format;
+					while ((*extraChars != '\0') && (*extraChars != 'e')) {
+						json_GeneratorAppend(context, *extraChars, true);
+						extraChars++;
+					}
+					n = 0;
+				}
+			}
+		}
+	}
+
+	return NULL;
+}
+
+// Write a string with the escapes of RFC 8785, only `"`, `\` and control characters are escaped
+void json_CanonicalString(JSON_GENERATOR_CONTEXT* context, const char* string, size_t length)
+{
+	static const char hexDigits[] = "0123456789abcdef";
+	char escape[6];
+	size_t start, i;
+	unsigned char c;
+
+	json_GeneratorWrite(context, "\"", 1);
+
+	start = 0;
+	for (i = 0; i < length; i++)
+	{
+		c = (unsigned char)string[i];
+		if ((c >= 0x20) && (c != '"') && (c != '\\')) {
+			continue;
+		}
+
+		// The characters in front of the escape are copied at once
+		json_GeneratorWrite(context, &string[start], i - start);
+		start = i + 1;
+
+		escape[0] = '\\';
+		switch (c)
+		{
+		case '"':
+		case '\\':
+			escape[1] = (char)c;
+			break;
+		case 0x08:
+			escape[1] = 'b';
+			break;
+		case 0x09:
+			escape[1] = 't';
+			break;
+		case 0x0A:
+			escape[1] = 'n';
+			break;
+		case 0x0C:
+			escape[1] = 'f';
+			break;
+		case 0x0D:
+			escape[1] = 'r';
+			break;
+		default:
+			escape[1] = 'u';
+			escape[2] = '0';
+			escape[3] = '0';
+			escape[4] = hexDigits[c >> 4];
+			escape[5] = hexDigits[c & 0xF];
+			json_GeneratorWrite(context, escape, 6);
+			continue;
+		}
+		json_GeneratorWrite(context, escape, 2);
+	}
+
+	json_GeneratorWrite(context, &string[start], length - start);
+	json_GeneratorWrite(context, "\"", 1);
+}
+
+// Split a number into its significant digits and decimal exponent, the value is 0.ddd * 10^exponent
+// Returns false when the number has more than 15 significant digits, they don't always read back as the same double
+bool json_CanonicalDigits(const char* number, char* digits, int* pCount, int* pExponent, bool* pNegative)
+{
+	const char* p;
+	int count, exponent, power;
+	bool point, negativePower;
+
+	p = number;
+	*pNegative = (*p == '-');
+	if (*pNegative) {
+		p++;
+	}
+
+	count = 0;
+	exponent = 0;
+	point = false;
+	for (;; p++)
+	{
+		if ((*p >= '0') && (*p <= '9'))
+		{
+			// Leading zeros only move the decimal point
+			if ((count == 0) && (*p == '0'))
+			{
+				if (point) {
+					exponent--;
+				}
+				continue;
+			}
+			if (count == 40) {
+				return false;
+			}
+			digits[count++] = *p;
+			if (!point) {
+				exponent++;
+			}
+		}
+		else if ((*p == '.') && !point) {
+			point = true;
+		}
+		else {
+			break;
+		}
+	}
+
+	if ((*p == 'e') || (*p == 'E'))
+	{
+		p++;
+		negativePower = (*p == '-');
+		if ((*p == '-') || (*p == '+')) {
+			p++;
+		}
+		for (power = 0; (*p >= '0') && (*p <= '9'); p++)
+		{
+			if (power < 10000) {
+				power = (power * 10) + (*p - '0');
+			}
+		}
+		exponent += negativePower ? -power : power;
+	}
+
+	while ((count > 0) && (digits[count - 1] == '0')) {
+		count--;
+	}
+
+	// Exponents near the limits of a double are left to strtod
+	if ((*p != '\0') || (count > 15) || (exponent > 300) || (exponent < -300)) {
+		return false;
+	}
+
+	*pCount = count;
+	*pExponent = exponent;
+	return true;
+}
+
+// Write a number as the shortest string that reads back as the same double, in the notation of ECMAScript (RFC 8785)
+void json_CanonicalNumber(JSON_GENERATOR_CONTEXT* context, const char* number)
+{
+	char buffer[48];
+	char digits[40];
+	const char* p;
+	double value;
+	int precision, exponent, count, i;
+	size_t length;
+	bool negative;
+
+	if (number == NULL) {
+		number = "0";
+	}
+
+	// Up to 15 significant digits are the shortest form already, no other decimal of 15 digits reads back as the same double
+	if (!json_CanonicalDigits(number, digits, &count, &exponent, &negative))
+	{
+		value = strtod(number, NULL);
+
+		// Numbers that are too large for a double have no canonical form
+		if ((value - value) != 0.0)
+		{
+			context->error = true;
+			longjmp(context->env, 1);
+		}
+
+		for (precision = 1; precision < 17; precision++)
+		{
+			snprintf(buffer, 48, "%.*e", precision - 1, value);
+			if (strtod(buffer, NULL) == value) {
+				break;
+			}
+		}
+		if (precision == 17) {
+			snprintf(buffer, 48, "%.16e", value);
+		}
+
+		// Split "-d.ddde+x" into the digits and the exponent
+		count = 0;
+		for (p = buffer; (*p != 'e') && (*p != '\0'); p++)
+		{
+			if ((*p >= '0') && (*p <= '9')) {
+				digits[count++] = *p;
+			}
+		}
+		exponent = (*p == 'e') ? atoi(p + 1) + 1 : 1;
+		while ((count > 1) && (digits[count - 1] == '0')) {
+			count--;
+		}
+		negative = (value < 0.0);
+		if (value == 0.0) {
+			count = 0;
+		}
+	}
+
+	// -0 is written as 0
+	if (count == 0)
+	{
+		json_GeneratorWrite(context, "0", 1);
+		return;
+	}
+
+	length = 0;
+	if (negative) {
+		buffer[length++] = '-';
+	}
+
+	if ((count <= exponent) && (exponent <= 21))
+	{
+		for (i = 0; i < exponent; i++) {
+			buffer[length++] = (i < count) ? digits[i] : '0';
+		}
+	}
+	else if ((0 < exponent) && (exponent <= 21))
+	{
+		for (i = 0; i < count; i++)
+		{
+			if (i == exponent) {
+				buffer[length++] = '.';
+			}
+			buffer[length++] = digits[i];
+		}
+	}
+	else if ((-6 < exponent) && (exponent <= 0))
+	{
+		buffer[length++] = '0';
+		buffer[length++] = '.';
+		for (i = exponent; i < 0; i++) {
+			buffer[length++] = '0';
+		}
+		for (i = 0; i < count; i++) {
+			buffer[length++] = digits[i];
+		}
+	}
+	else
+	{
+		buffer[length++] = digits[0];
+		if (count > 1)
+		{
+			buffer[length++] = '.';
+			for (i = 1; i < count; i++) {
+				buffer[length++] = digits[i];
+			}
+		}
+		length += (size_t)snprintf(&buffer[length], 48 - length, "e%c%d", (exponent - 1 >= 0) ? '+' : '-', (exponent - 1 >= 0) ? exponent - 1 : 1 - exponent);
+	}
+
+	json_GeneratorWrite(context, buffer, length);
+}
+
+// Compare the keys of 2 members in the order of their UTF-16 code units, as RFC 8785 sorts them
+// UTF-8 bytes sort in the order of the code points, which is the same except for code points above U+FFFF,
+// their surrogates come before U+E000 to U+FFFF
+int json_CanonicalCompare(const void* a, const void* b)
+{
+	const JSON_CANONICAL_MEMBER* memberA;
+	const JSON_CANONICAL_MEMBER* memberB;
+	const unsigned char* keyA;
+	const unsigned char* keyB;
+	size_t length, start, i;
+
+	memberA = (const JSON_CANONICAL_MEMBER*)a;
+	memberB = (const JSON_CANONICAL_MEMBER*)b;
+	keyA = (const unsigned char*)memberA->key;
+	keyB = (const unsigned char*)memberB->key;
+
+	length = (memberA->length < memberB->length) ? memberA->length : memberB->length;
+	for (i = 0; (i < length) && (keyA[i] == keyB[i]); i++) {
+	}
+
+	if (i == length)
+	{
+		if (memberA->length != memberB->length) {
+			return (memberA->length < memberB->length) ? -1 : 1;
+		}
+		return (memberA->position < memberB->position) ? -1 : 1;
+	}
+
+	// Find the 1st byte of the character that differs, it is the same in both keys when it is in front of `i`
+	start = i;
+	while ((start > 0) && ((keyA[start] & 0xC0) == 0x80)) {
+		start--;
+	}
+
+	if ((keyA[start] >= 0xF0) && (keyB[start] >= 0xEE) && (keyB[start] < 0xF0)) {
+		return -1;
+	}
+	if ((keyB[start] >= 0xF0) && (keyA[start] >= 0xEE) && (keyA[start] < 0xF0)) {
+		return 1;
+	}
+
+	return (keyA[i] < keyB[i]) ? -1 : 1;
+}
+
+// Canonical JSON generator (RFC 8785), the members of objects are written sorted by key without changing the tree
+void json_GenerateCanonical(JSON_NODE* node, JSON_GENERATOR_CONTEXT* context)
+{
+	JSON_CANONICAL_MEMBER* members;
+	JSON_CANONICAL_MEMBER* member;
+	JSON_NODE* item;
+	size_t base, count, capacity, i;
+
+	switch (node->type)
+	{
+	case JSON_TYPE::OBJECT:
+		// The members are pushed on the member stack and sorted there, the stack is shared by the objects in the object
+		base = context->memberCount;
+		for (item = (JSON_NODE*)node->value; item != NULL; item = item->next)
+		{
+			if (context->memberCount == context->memberCapacity)
+			{
+				capacity = (context->memberCapacity != 0) ? context->memberCapacity * 2 : 64;
+				members = (JSON_CANONICAL_MEMBER*)json_Reallocate(context->allocator, context->members, capacity * sizeof(JSON_CANONICAL_MEMBER));
+				if (members == NULL) {
+					context->error = true;
+					longjmp(context->env, 1);
+				}
+				context->members = members;
+				context->memberCapacity = capacity;
+			}
+
+			member = &context->members[context->memberCount];
+			member->key = (item->key != NULL) ? item->key : "";
+			member->length = (item->flags & JSON_NODE_FLAG_KEY) ? item->keyLength : strlen(member->key);
+			member->position = context->memberCount - base;
+			member->node = item;
+			context->memberCount++;
+		}
+
+		// An empty object may have no member stack yet, qsort must not get a NULL base
+		count = context->memberCount - base;
+		if (count > 1) {
+			qsort(&context->members[base], count, sizeof(JSON_CANONICAL_MEMBER), json_CanonicalCompare);
+		}
+
+		json_GeneratorWrite(context, "{", 1);
+		for (i = 0; i < count; i++)
+		{
+			if (i != 0) {
+				json_GeneratorWrite(context, ",", 1);
+			}
+
+			// The stack can move while the value is written
+			member = &context->members[base + i];
+			json_CanonicalString(context, member->key, member->length);
+			json_GeneratorWrite(context, ":", 1);
+			json_GenerateCanonical(context->members[base + i].node, context);
+		}
+		json_GeneratorWrite(context, "}", 1);
+
+		context->memberCount = base;
+		break;
+	case JSON_TYPE::ARRAY:
+		json_GeneratorWrite(context, "[", 1);
+		for (item = (JSON_NODE*)node->value; item != NULL; item = item->next)
+		{
+			if (item != (JSON_NODE*)node->value) {
+				json_GeneratorWrite(context, ",", 1);
+			}
+			json_GenerateCanonical(item, context);
+		}
+		json_GeneratorWrite(context, "]", 1);
+		break;
+	case JSON_TYPE::STRING:
+		json_CanonicalString(context, (node->value != NULL) ? (const char*)node->value : "", (node->value != NULL) ? strlen((const char*)node->value) : 0);
+		break;
+	case JSON_TYPE::NUMBER:
+		json_CanonicalNumber(context, (const char*)node->value);
+		break;
+	case JSON_TYPE::BOOLEAN:
+		if (node->value != NULL) {
+			json_GeneratorWrite(context, "true", 4);
+		}
+		else {
+			json_GeneratorWrite(context, "false", 5);
+		}
+		break;
+	default:
+		json_GeneratorWrite(context, "null", 4);
+		break;
+	}
+}
+
+// ------------------------------ //
+// **   Forward declarations   ** //
+// ------------------------------ //
+
+// Get the number of bytes of a JSON string before its closing double quotes, escape sequences are not decoded
+size_t json_StringBytes(const char* pJson);
+
+// Parse JSON string, `reuse` is an optional buffer to write the string into
+// Without a buffer to reuse, a string that fits in the `inlineSize` bytes of `inlineBuffer` is written there
+char* json_ParseString(char** pp_json, JSON_PARSER_CONTEXT* context, char* reuse, char* inlineBuffer, size_t inlineSize);
+
+// Parse JSON number, `reuse` is an optional buffer to write the number into
+// A number that doesn't fit in `reuse` is written into the `inlineSize` bytes of `inlineBuffer` when it fits there
+char* json_ParseNumber(char** pp_json, JSON_PARSER_CONTEXT* context, char* reuse, char* inlineBuffer, size_t inlineSize);
+
+// Parse JSON literal
+bool json_ParseLiteral(char** pp_json, JSON_PARSER_CONTEXT* context, JSON_TYPE* pType);
+
+// Parse JSON array, `reuse` is an optional node list to recycle
+JSON_NODE* json_ParseArray(char** pp_json, JSON_PARSER_CONTEXT* context, JSON_NODE* reuse);
+
+// Parse JSON object, `reuse` is an optional node list to recycle
+JSON_NODE* json_ParseObject(char** pp_json, JSON_PARSER_CONTEXT* context, JSON_NODE* reuse);
+
+// --------------------------- //
+// **   Memory accounting   ** //
+// --------------------------- //
+
+// Add the memory of a node and its child nodes to `usage`
+// Keys and values in the inline storage of a node are part of the node
+void json_AddMemoryUsage(JSON_NODE* node, JSON_MEMORY_USAGE* usage)
+{
+	JSON_NODE_EXTRA* extra;
+	JSON_NODE* child;
+
+	usage->nodes += sizeof(JSON_NODE);
+
+	if (node->flags & JSON_NODE_FLAG_HEADER) {
+		usage->nodes += sizeof(JSON_NODE_HEADER);
+	}
+
+	extra = json_NodeExtra(node, false);
+	if (extra != NULL)
+	{
+		usage->indexes += sizeof(JSON_NODE_EXTRA);
+		if ((extra->index != NULL) && (node->type == JSON_TYPE::OBJECT)) {
+			usage->indexes += sizeof(JSON_OBJECT_INDEX) + (((JSON_OBJECT_INDEX*)extra->index)->capacity - 1) * sizeof(JSON_INDEX_SLOT);
+		}
+		else if ((extra->index != NULL) && (node->type == JSON_TYPE::ARRAY)) {
+			usage->indexes += sizeof(JSON_ARRAY_ITEMS) + (((JSON_ARRAY_ITEMS*)extra->index)->capacity - 1) * sizeof(JSON_NODE*);
+		}
+	}
+
+	if ((node->key != NULL) && (!json_IsInline(node, node->key))) {
+		usage->keys += ((node->flags & JSON_NODE_FLAG_KEY) ? node->keyLength : strlen(node->key)) + 1;
+	}
+
+	if (node->format != NULL) {
+		usage->formats += strlen(node->format) + 1;
+	}
+
+	if ((node->value == NULL) || (json_IsInline(node, node->value))) {
+		return;
+	}
+
+	switch (node->type)
+	{
+	case JSON_TYPE::STRING:
+		usage->strings += strlen((char*)node->value) + 1;
+		break;
+	case JSON_TYPE::NUMBER:
+		usage->numbers += strlen((char*)node->value) + 1;
+		break;
+	case JSON_TYPE::OBJECT:
+	case JSON_TYPE::ARRAY:
+		for (child = (JSON_NODE*)node->value; child != NULL; child = child->next) {
+			json_AddMemoryUsage(child, usage);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+// Add up the parts of a memory usage
+size_t json_MemoryTotal(const JSON_MEMORY_USAGE* usage)
+{
+	return usage->nodes + usage->indexes + usage->keys + usage->strings + usage->numbers + usage->formats;
+}
+
+// Get the memory of a node and its child nodes, or of the node and the nodes after it when `list` is true
+size_t json_NodeMemory(JSON_NODE* node, bool list)
+{
+	JSON_MEMORY_USAGE usage;
+
+	memset(&usage, 0, sizeof(usage));
+
+	for (; node != NULL; node = (list) ? node->next : NULL) {
+		json_AddMemoryUsage(node, &usage);
+	}
+
+	return json_MemoryTotal(&usage);
+}
+
+// Start counting the memory of a parse
+void json_ParserResetMemory(JSON_PARSER_CONTEXT* context)
+{
+	context->allocations = 0;
+	context->bytesAllocated = 0;
+	context->peakMemory = 0;
+	context->memoryUsed = 0;
+}
+
+// Count `size` bytes that the parser is about to allocate, a reallocation counts the bytes it adds
+// Returns false and sets the MEMORY_LIMIT_EXCEEDED error when the bytes would go over the memory limit
+bool json_ParserReserve(JSON_PARSER_CONTEXT* context, size_t size)
+{
+	if ((context->memoryLimit != 0) && (context->memoryUsed + (long long)size > (long long)context->memoryLimit))
+	{
+		context->errorCode = JSON_ERROR_CODE::MEMORY_LIMIT_EXCEEDED;
+		return false;
+	}
+
+	context->allocations++;
+	context->bytesAllocated += size;
+	context->memoryUsed += (long long)size;
+
+	if (context->memoryUsed > (long long)context->peakMemory) {
+		context->peakMemory = (size_t)context->memoryUsed;
+	}
+
+	return true;
+}
+
+// Count `size` bytes that the parser freed
+void json_ParserRelease(JSON_PARSER_CONTEXT* context, size_t size)
+{
+	context->memoryUsed -= (long long)size;
+}
+
+// Set the out of memory error when an allocation failed, unless the memory limit was reached
+void json_ParserOutOfMemory(JSON_PARSER_CONTEXT* context)
+{
+	if (context->errorCode == JSON_ERROR_CODE::NONE) {
+		context->errorCode = JSON_ERROR_CODE::OUT_OF_MEMORY;
+	}
+}
+
+// Free a list of old nodes that the parser did not recycle
+void json_ParserFreeList(JSON_PARSER_CONTEXT* context, JSON_NODE* node)
+{
+	if (node != NULL)
+	{
+		json_ParserRelease(context, json_NodeMemory(node, true));
+		json_FreeList(node, context->allocator);
+	}
+}
+
+// ------------------------ //
+// **   Node recycling   ** //
+// ------------------------ //
+
+// Take the next node from a list of old nodes, NULL when the list is empty
+// The old node keeps its key and value so the parser can write into the existing buffers
+JSON_NODE* json_RecycleNode(JSON_NODE** p_reuse, JSON_PARSER_CONTEXT* context, bool keepKey)
+{
+	JSON_NODE* node;
+	const JSON_ALLOCATOR* nodeAllocator;
+
+	node = *p_reuse;
+	if (node == NULL) {
+		return NULL;
+	}
+
+	*p_reuse = node->next;
+	node->next = NULL;
+
+	nodeAllocator = json_NodeAllocator(node, context->allocator);
+
+	if ((!keepKey) && (node->key != NULL))
+	{
+		if (!json_IsInline(node, node->key)) {
+			json_ParserRelease(context, ((node->flags & JSON_NODE_FLAG_KEY) ? node->keyLength : strlen(node->key)) + 1);
+		}
+		json_FreeString(node, node->key, nodeAllocator);
+		json_SetKey(node, NULL);
+	}
+
+	if (node->format != NULL) {
+		json_ParserRelease(context, strlen(node->format) + 1);
+		json_Deallocate(nodeAllocator, (void*)node->format);
+		node->format = NULL;
+	}
+
+	return node;
+}
+
+// Get the type of the value after a key in a JSON string from its first character, `pJson` is after the key
+// Returns false if there is no colon and value after the key
+bool json_PeekValueType(const char* pJson, JSON_TYPE* pType)
+{
+	while ((*pJson == ' ') || (*pJson == '\t') || (*pJson == '\r') || (*pJson == '\n')) {
+		pJson++;
+	}
+	if (*pJson++ != ':') {
+		return false;
+	}
+	while ((*pJson == ' ') || (*pJson == '\t') || (*pJson == '\r') || (*pJson == '\n')) {
+		pJson++;
+	}
+
+	switch (*pJson)
+	{
+	case '{':
+		*pType = JSON_TYPE::OBJECT;
+		return true;
+	case '[':
+		*pType = JSON_TYPE::ARRAY;
+		return true;
+	case '\"':
+		*pType = JSON_TYPE::STRING;
+		return true;
+	case 't':
+	case 'f':
+		*pType = JSON_TYPE::BOOLEAN;
+		return true;
+	case 'n':
+		*pType = JSON_TYPE::NULL_TYPE;
+		return true;
+	default:
+		*pType = JSON_TYPE::NUMBER;
+		return ((*pJson == '-') || ((*pJson >= '0') && (*pJson <= '9')));
+	}
+}
+
+// Take the old member to reuse for a member of an object, `pJson` is the key in the JSON string after its double quotes
+// The old member with the same key and value type is taken when it is one of the next JSON_PARSER_RECYCLE_LOOKAHEAD
+// old members, so members that are unchanged keep their buffers and child nodes when members are added, removed or moved
+// Returns NULL when there is no such member or the key has escape sequences, a new node is created then
+JSON_NODE* json_RecycleMember(JSON_NODE** p_reuse, JSON_PARSER_CONTEXT* context, const char* pJson)
+{
+	JSON_LOOKUP_KEY lookupKey;
+	JSON_NODE** p_node;
+	JSON_NODE* node;
+	JSON_TYPE type;
+	size_t length;
+	size_t i;
+
+	length = json_StringBytes(pJson);
+	if ((*p_reuse == NULL) || (pJson[length] != '\"') || (!json_PeekValueType(pJson + length + 1, &type))) {
+		return NULL;
+	}
+
+	// Keys with escape sequences are not compared
+	if (memchr(pJson, '\\', length) == NULL)
+	{
+		json_LookupKey(&lookupKey, pJson, length);
+
+		p_node = p_reuse;
+		for (i = 0; (i < JSON_PARSER_RECYCLE_LOOKAHEAD) && (*p_node != NULL); i++)
+		{
+			node = *p_node;
+			if ((node->type == type) && (json_KeyEquals(node, &lookupKey)))
+			{
+				// The old members in front of it stay in the list for the next members
+				*p_node = node->next;
+				node->next = NULL;
+				return json_RecycleNode(&node, context, true);
+			}
+			p_node = &node->next;
+		}
+	}
+
+	return NULL;
+}
+
+// Get a node for a new value of `type`, the recycled node is reused when it can hold the value
+// `p_oldValue` receives the old string buffer or child node list that can be reused for the new value
+// Objects and arrays can recycle each other's child nodes
+JSON_NODE* json_ValueNode(JSON_NODE* recycled, JSON_TYPE type, JSON_PARSER_CONTEXT* context, void** p_oldValue)
+{
+	JSON_NODE* node;
+	size_t size;
+
+	*p_oldValue = NULL;
+
+	if (recycled != NULL)
+	{
+		if (json_IsContainer(recycled->type) == json_IsContainer(type))
+		{
+			if ((recycled->type == type) || (json_IsContainer(type)))
+			{
+				// Items that are shared with a clone are not recycled, values in the inline storage are written again
+				if ((type != JSON_TYPE::BOOLEAN) && (type != JSON_TYPE::NULL_TYPE) && (!json_LeaveShared(recycled)) &&
+					(!json_IsInline(recycled, recycled->value))) {
+					*p_oldValue = recycled->value;
+				}
+				if (json_IsContainer(type)) {
+					json_DropIndex(recycled);
+					json_ForgetTail(recycled);
+				}
+				recycled->value = NULL;
+			}
+			else
+			{
+				size = json_NodeMemory(recycled, false);
+				json_free_value(recycled, context->allocator);
+				json_ParserRelease(context, size - json_NodeMemory(recycled, false));
+			}
+
+			recycled->type = type;
+			return recycled;
+		}
+
+		// Objects and arrays have a header, other nodes don't
+		json_ParserRelease(context, json_NodeMemory(recycled, false));
+		json_free_node(recycled, context->allocator);
+	}
+
+	size = json_IsContainer(type) ? sizeof(JSON_NODE_HEADER) + sizeof(JSON_NODE) : sizeof(JSON_NODE);
+	if (!json_ParserReserve(context, size)) {
+		return NULL;
+	}
+
+	node = json_AllocateNode(context->allocator, type, false);
+	if (node == NULL) {
+		json_ParserRelease(context, size);
+	}
+
+	return node;
+}
+
+// --------------------------------------- //
+// **   Internal JSON parse functions   ** //
+// --------------------------------------- //
+
+// Get the next token in the JSON string
+JSON_TOKEN json_GetToken(char** pp_json, JSON_PARSER_CONTEXT* context)
+{
+	const char* pJson;
+	unsigned char CharUnits;
+	unsigned long CodePoint;
+	JSON_TOKEN token;
+
+	pJson = *pp_json;
+	token = JSON_TOKEN::UNRECOGNIZED_TOKEN;
+
+getCodePoint:
+
+	CharUnits = UTF8_Encoding::GetCharacterUnits(*pJson);
+	CodePoint = UTF8_Encoding::Decode(CharUnits, pJson);
+
+	if (CodePoint == ' ')
+	{
+		pJson += CharUnits;
+		context->charNumber++;
+		goto getCodePoint;
+	}
+
+	if (CodePoint == '\t')
+	{
+		pJson += CharUnits;
+		context->charNumber++;
+		goto getCodePoint;
+	}
+
+	if (CodePoint == '\n')
+	{
+		pJson += CharUnits;
+		context->lineNumber++;
+		context->charNumber++;
+		goto getCodePoint;
+	}
+
+	if (CodePoint == '\r')
+	{
+		pJson += CharUnits;
+		context->charNumber++;
+		goto getCodePoint;
+	}
+
+	if (CodePoint == '\"')
+	{
+		token = JSON_TOKEN::STRING;
+		pJson += CharUnits;
+		context->charNumber++;
+	}
+	else if (CodePoint == '{')
+	{
+		token = JSON_TOKEN::CURLY_OPEN;
+		pJson += CharUnits;
+		context->charNumber++;
+	}
+	else if (CodePoint == '}')
+	{
+		token = JSON_TOKEN::CURLY_CLOSE;
+		pJson += CharUnits;
+		context->charNumber++;
+	}
+	else if ((CodePoint == '-') || ((CodePoint >= '0') && (CodePoint <= '9')))
+	{
+		token = JSON_TOKEN::NUMBER;
+	}
+	else if (((CodePoint >= 'A') && (CodePoint <= 'Z')) || ((CodePoint >= 'a') && (CodePoint <= 'z')))
+	{
+		token = JSON_TOKEN::LITERAL;
+	}
+	else if (CodePoint == '[')
+	{
+		token = JSON_TOKEN::ARRAY_OPEN;
+		pJson += CharUnits;
+		context->charNumber++;
+	}
+	else if (CodePoint == ']')
+	{
+		token = JSON_TOKEN::ARRAY_CLOSE;
+		pJson += CharUnits;
+		context->charNumber++;
+	}
+	else if (CodePoint == ':')
+	{
+		token = JSON_TOKEN::COLON;
+		pJson += CharUnits;
+		context->charNumber++;
+	}
+	else if (CodePoint == ',')
+	{
+		token = JSON_TOKEN::COMMA;
+		pJson += CharUnits;
+		context->charNumber++;
+	}
+	else if (CodePoint == 0)
+	{
+		token = JSON_TOKEN::JSON_END;
+	}
+	else
+	{
+		context->charNumber++;
+	}
+
+	*pp_json = (char*)pJson;
+
+	return token;
+}
+
+// Word-at-a-time scanning, 8 bytes of the JSON string are tested at once
+#define JSON_SCAN_ONES 0x0101010101010101ULL
+#define JSON_SCAN_HIGHS 0x8080808080808080ULL
+#define JSON_SCAN_SPACES 0x2020202020202020ULL
+
+// Check if any byte of the word is `byte`
+inline bool json_ScanHasByte(unsigned long long word, unsigned char byte)
+{
+	word ^= JSON_SCAN_ONES * byte;
+	return (((word - JSON_SCAN_ONES) & ~word & JSON_SCAN_HIGHS) != 0);
+}
+
+// Scan the next token without decoding it, strings, numbers and literals are skipped as a whole
+// The JSON string ends at `pEnd` or at the first null character
+// `p_begin` receives the first character of the token, the return value points after the token
+// `pLines` is incremented for every line feed before the token, it can be NULL
+const char* json_ScanToken(const char* pJson, const char* pEnd, JSON_TOKEN* pToken, const char** p_begin, unsigned long* pLines)
+{
+	unsigned long long word;
+
+	while (pJson < pEnd)
+	{
+		// Skip indentation 8 spaces at a time
+		if ((size_t)(pEnd - pJson) >= sizeof(word))
+		{
+			memcpy(&word, pJson, sizeof(word));
+			if (word == JSON_SCAN_SPACES) {
+				pJson += sizeof(word);
+				continue;
+			}
+		}
+
+		if (*pJson == '\n')
+		{
+			if (pLines != NULL) {
+				(*pLines)++;
+			}
+		}
+		else if ((*pJson != ' ') && (*pJson != '\t') && (*pJson != '\r')) {
+			break;
+		}
+		pJson++;
+	}
+
+	*p_begin = pJson;
+
+	if ((pJson >= pEnd) || (*pJson == '\0'))
+	{
+		*pToken = JSON_TOKEN::JSON_END;
+		return pJson;
+	}
+
+	switch (*pJson)
+	{
+	case '{':
+		*pToken = JSON_TOKEN::CURLY_OPEN;
+		return pJson + 1;
+	case '}':
+		*pToken = JSON_TOKEN::CURLY_CLOSE;
+		return pJson + 1;
+	case '[':
+		*pToken = JSON_TOKEN::ARRAY_OPEN;
+		return pJson + 1;
+	case ']':
+		*pToken = JSON_TOKEN::ARRAY_CLOSE;
+		return pJson + 1;
+	case ':':
+		*pToken = JSON_TOKEN::COLON;
+		return pJson + 1;
+	case ',':
+		*pToken = JSON_TOKEN::COMMA;
+		return pJson + 1;
+	case '\"':
+		// An unterminated string ends at the end of the JSON string, it is an UNTERMINATED_STRING token
+		*pToken = JSON_TOKEN::STRING;
+		pJson++;
+		while (true)
+		{
+			// Skip 8 bytes at a time until a quotation mark, reverse solidus or null character
+			while ((size_t)(pEnd - pJson) >= sizeof(word))
+			{
+				memcpy(&word, pJson, sizeof(word));
+				if (json_ScanHasByte(word, '\"') || json_ScanHasByte(word, '\\') || json_ScanHasByte(word, '\0')) {
+					break;
+				}
+				pJson += sizeof(word);
+			}
+
+			while ((pJson < pEnd) && (*pJson != '\"') && (*pJson != '\\') && (*pJson != '\0')) {
+				pJson++;
+			}
+
+			if ((pJson >= pEnd) || (*pJson == '\0'))
+			{
+				*pToken = JSON_TOKEN::UNTERMINATED_STRING;
+				break;
+			}
+
+			pJson++;
+			if (pJson[-1] == '\"') {
+				break;
+			}
+
+			// Skip the escaped character
+			if ((pJson < pEnd) && (*pJson != '\0')) {
+				pJson++;
+			}
+		}
+		return pJson;
+	default:
+		break;
+	}
+
+	// Numbers and literals use the same characters as json_ParseNumber and json_ParseLiteral
+	if ((*pJson == '-') || ((*pJson >= '0') && (*pJson <= '9')))
+	{
+		*pToken = JSON_TOKEN::NUMBER;
+		while ((pJson < pEnd) && ((*pJson == '-') || ((*pJson >= '0') && (*pJson <= '9')) || (*pJson == '.'))) {
+			pJson++;
+		}
+	}
+	else if (((*pJson >= 'A') && (*pJson <= 'Z')) || ((*pJson >= 'a') && (*pJson <= 'z')))
+	{
+		*pToken = JSON_TOKEN::LITERAL;
+		while ((pJson < pEnd) && (((*pJson >= 'A') && (*pJson <= 'Z')) || ((*pJson >= 'a') && (*pJson <= 'z')) ||
+			((*pJson >= '0') && (*pJson <= '9')) || (*pJson == '_'))) {
+			pJson++;
+		}
+	}
+	else
+	{
+		// Skip the whole UTF8 character, the continuation units are 10xxxxxx
+		*pToken = JSON_TOKEN::UNRECOGNIZED_TOKEN;
+		pJson++;
+		while ((pJson < pEnd) && ((*pJson & 0xC0) == 0x80)) {
+			pJson++;
+		}
+	}
+
+	return pJson;
+}
+
+// Record the source position of a value node when the parser context has a position map
+// `pToken` points after the first token of the value and `pEnd` after the whole value
+void json_RecordPosition(JSON_PARSER_CONTEXT* context, JSON_NODE* node, JSON_TOKEN token, const char* pToken, const char* pEnd, unsigned long lineNumber)
+{
+	const char* pBegin;
+
+	if ((context->positions == NULL) || (node == NULL)) {
+		return;
+	}
+
+	// Numbers and literals are not skipped by json_GetToken
+	pBegin = pToken;
+	if ((token == JSON_TOKEN::CURLY_OPEN) || (token == JSON_TOKEN::ARRAY_OPEN) || (token == JSON_TOKEN::STRING)) {
+		pBegin--;
+	}
+
+	if (!context->positions->Insert(node, (size_t)(pBegin - context->positions->json), (size_t)(pEnd - pBegin), lineNumber)) {
+		context->errorCode = JSON_ERROR_CODE::OUT_OF_MEMORY;
+	}
+}
+
+// Get the number of bytes from `pJson` to the closing double quotes of a string, or to the end of the JSON string
+// The parsed string is never longer, escape sequences only make it shorter
+size_t json_StringBytes(const char* pJson)
+{
+	const char* p;
+
+	p = pJson;
+	while ((*p != '\"') && (*p != '\0'))
+	{
+		if ((*p == '\\') && (p[1] != '\0')) {
+			p++;
+		}
+		p++;
+	}
+
+	return (size_t)(p - pJson);
+}
+
+// Parse a JSON string (key or value)
+char* json_ParseString(char** pp_json, JSON_PARSER_CONTEXT* context, char* reuse, char* inlineBuffer, size_t inlineSize)
+{
+	size_t i;
+	unsigned char CharUnits;
+	unsigned long CodePoint;
+	const char* pJson;
+	bool bEscape;
+	char* buffer;
+	size_t bufferLength;
+	size_t oldLength;
+	char* pNewBuffer;
+
+	pJson = *pp_json;
+	bEscape = false;
+
+	// bufferLength = 0;
+	// buffer = NULL;
+
+	if (reuse != NULL)
+	{
+		// Write into the old buffer, it is grown below if the new string is longer
+		bufferLength = strlen(reuse) + 1;
+		buffer = reuse;
+	}
+	else if (inlineSize != 0)
+	{
+		// Write into the inline storage of the node, the string is moved to an allocated buffer below if it is longer
+		bufferLength = inlineSize;
+		buffer = inlineBuffer;
+	}
+	else
+	{
+		// Size the buffer for the whole string, escape sequences leave a byte or more unused
+		bufferLength = json_StringBytes(pJson) + 1;
+		buffer = json_ParserReserve(context, bufferLength) ? (char*)json_Allocate(context->allocator, bufferLength) : NULL;
+		if (buffer == NULL) {
+			json_ParserOutOfMemory(context);
+			context->errorDescription = JSON_ERROR_STRINGS[(int)context->errorCode];
+			return NULL;
+		}
+	}
+
+	i = 0;
+
+	while (true)
+	{
+		context->beginIndex = context->charNumber;
+
+		CharUnits = UTF8_Encoding::GetCharacterUnits(*pJson);
+		CodePoint = UTF8_Encoding::Decode(CharUnits, pJson);
+
+		if (!bEscape)
+		{
+			// Escape character?
+			if (CodePoint == '\\')
+			{
+				bEscape = true;
+				pJson += CharUnits;
+				context->charNumber++;
+				continue;
+			}
+
+			// End of string?
+			if (CodePoint == '\"')
+			{
+				pJson += CharUnits;
+				context->charNumber++;
+				break;
+			}
+
+			// All Unicode characters may be placed within the
+			//	 quotation marks, except for the characters that MUST be escaped :
+			// quotation mark, reverse solidus, and the control characters(U + 0000
+			//	 through U + 001F).
+
+			if (((CodePoint >= 0x0000) && (CodePoint <= 0x001F)) ||
+				(CodePoint == '"') || (CodePoint == '\\'))
+			{
+				context->errorCode = JSON_ERROR_CODE::STRING_CHARACTERS_MUST_BE_ESCAPED;
+				context->charNumber++;
+				break;
+			}
+		}
+		else
+		{
+			// Convert visual representation of control characters
+			if (CodePoint == 'n') {
+				CodePoint = 0x0A; // line feed
+			}
+			else if (CodePoint == 'r') {
+				CodePoint = 0x0D; // carriage return
+			}
+			else if (CodePoint == 't') {
+				CodePoint = 0x09; // tab
+			}
+			else if (CodePoint == 'f') {
+				CodePoint = 0x0C; // form feed
+			}
+			else if (CodePoint == 'b') {
+				CodePoint = 0x08; // backspace
+			}
+			else
+			{
+				// Force strict string escaping for code editor?
+				if (context->visualEscapeOnly == true)
+				{
+					if ((CodePoint == 0x0A) || (CodePoint == 0x0D) ||
+						(CodePoint == 0x09) || (CodePoint == 0x0C) || (CodePoint == 0x08)) {
+						context->errorCode = JSON_ERROR_CODE::STRING_FORCED_STRICT_ESCAPING;
+						context->charNumber++;
+						break;
+					}
+				}
+				// Must be a quotation mark, reverse solidus, or control character
+				if ((CodePoint > 0x001F) && (CodePoint != '"') && (CodePoint != '\\')) {
+					context->errorCode = JSON_ERROR_CODE::STRING_UNUSED_ESCAPE_CHARACTER;
+					context->charNumber++;
+					break;
+				}
+			}
+			bEscape = false;
+		}
+
+		if (CodePoint == '\0') {
+			context->errorCode = JSON_ERROR_CODE::EXPECTED_DOUBLE_QUOTES_ENCOUNTERED_JSON_END;
+			context->charNumber++;
+			break;
+		}
+
+		// buffer big enough for CodePoint + NULL character ?
+		if ((i + CharUnits + 1) > bufferLength)
+		{
+			// Size the buffer for the rest of the string at once, so the buffer is grown once and has no unused bytes
+			oldLength = (buffer == inlineBuffer) ? 0 : bufferLength;
+			bufferLength = i + CharUnits + json_StringBytes(pJson + CharUnits) + 1;
+			if (!json_ParserReserve(context, bufferLength - oldLength)) {
+				bufferLength = oldLength;
+				break;
+			}
+			if (buffer == inlineBuffer)
+			{
+				pNewBuffer = (char*)json_Allocate(context->allocator, bufferLength);
+				if (pNewBuffer != NULL) {
+					memcpy(pNewBuffer, buffer, i);
+				}
+			}
+			else {
+				pNewBuffer = (char*)json_Reallocate(context->allocator, buffer, bufferLength);
+			}
+			if (pNewBuffer != NULL) {
+				buffer = pNewBuffer;
+			}
+			else {
+				json_ParserRelease(context, bufferLength - oldLength);
+				bufferLength = oldLength;
+				json_ParserOutOfMemory(context);
+				break;
+			}
+		}
+
+		UTF8_Encoding::EncodeUnsafe(&buffer[i], CodePoint);
+
+		pJson += CharUnits;
+		context->charNumber++;
+		i += CharUnits;
+	}
+
+	if (context->errorCode != JSON_ERROR_CODE::NONE) {
+		if ((buffer != NULL) && (buffer != inlineBuffer)) {
+			json_ParserRelease(context, bufferLength);
+			json_Deallocate(context->allocator, buffer);
+		}
+		return NULL;
+	}
+
+	buffer[i] = '\0';
+	*pp_json = (char*)pJson;
+
+	return buffer;
+}
+
+// Parse a JSON number, we return the number as an individual string to avoid type assumptions
+char* json_ParseNumber(char** pp_json, JSON_PARSER_CONTEXT* context, char* reuse, char* inlineBuffer, size_t inlineSize)
+{
+	unsigned char CharUnits;
+	unsigned long CodePoint;
+	const char* pJson;
+	size_t strLen;
+	size_t reuseLength;
+	char* result;
+
+	pJson = *pp_json;
+	context->beginIndex = context->charNumber;
+
+	CharUnits = UTF8_Encoding::GetCharacterUnits(*pJson);
+	CodePoint = UTF8_Encoding::Decode(CharUnits, pJson);
+
+	strLen = 0;
+	while ((CodePoint == '-') || ((CodePoint >= '0') && (CodePoint <= '9')) || (CodePoint == '.'))
+	{
+		pJson += CharUnits;
+		CharUnits = UTF8_Encoding::GetCharacterUnits(*pJson);
+		CodePoint = UTF8_Encoding::Decode(CharUnits, pJson);
+		strLen += CharUnits;
+		context->charNumber++;
+	}
+
+	// The old buffer counts as strlen + 1 bytes, like in JSON_MemoryUsage
+	reuseLength = (reuse != NULL) ? strlen(reuse) + 1 : 0;
+
+	if ((reuse != NULL) && (reuseLength > strLen)) {
+		result = reuse;
+	}
+	else if (strLen < inlineSize)
+	{
+		if (reuse != NULL) {
+			json_ParserRelease(context, reuseLength);
+			json_Deallocate(context->allocator, reuse);
+		}
+		result = inlineBuffer;
+	}
+	else
+	{
+		result = json_ParserReserve(context, strLen + 1 - reuseLength) ? (char*)json_Reallocate(context->allocator, reuse, strLen + 1) : NULL;
+		if (result == 0) {
+			if (context->errorCode == JSON_ERROR_CODE::NONE) {
+				json_ParserRelease(context, strLen + 1 - reuseLength);
+			}
+			if (reuse != NULL) {
+				json_ParserRelease(context, reuseLength);
+				json_Deallocate(context->allocator, reuse);
+			}
+			json_ParserOutOfMemory(context);
+			return 0;
+		}
+	}
+
+	memcpy(result, *pp_json, strLen);
+	result[strLen] = 0;
+
+	*pp_json += strLen;
+
+	return result;
+}
+
+// JSON literal names are: "false", "null" and "true"
+// The literal names MUST be lowercase.  No other literal names are allowed.
+bool json_ParseLiteral(char** pp_json, JSON_PARSER_CONTEXT* context, JSON_TYPE* pType)
+{
+	const char* pJson;
+	unsigned char CharUnits;
+	unsigned long CodePoint;
+	size_t wordLength;
+
+	pJson = *pp_json;
+	context->beginIndex = context->charNumber;
+
+	wordLength = 0;
+	bool bValue = false;
+
+	while (true)
+	{
+		CharUnits = UTF8_Encoding::GetCharacterUnits(*pJson);
+		CodePoint = UTF8_Encoding::Decode(CharUnits, pJson);
+
+		if (((CodePoint >= 'A') && (CodePoint <= 'Z')) ||
+			((CodePoint >= 'a') && (CodePoint <= 'z')) ||
+			((CodePoint >= '0') && (CodePoint <= '9')) ||
+			(CodePoint == '_'))
+		{
+			wordLength += CharUnits;
+
+			context->charNumber++;
+			pJson += CharUnits;
+		}
+		else {
+			break;
+		}
+	}
+
+	if (strncmp(*pp_json, "false", wordLength) == 0) {
+		*pType = JSON_TYPE::BOOLEAN;
+	}
+	else if (strncmp(*pp_json, "true", wordLength) == 0) {
+		*pType = JSON_TYPE::BOOLEAN;
+		bValue = true;
+	}
+	else if (strncmp(*pp_json, "null", wordLength) == 0) {
+		*pType = JSON_TYPE::NULL_TYPE;
+	}
+	else {
+		context->errorCode = JSON_ERROR_CODE::INVALID_LITERAL_NAME;
+	}
+
+	*pp_json = (char*)pJson;
+
+	return bValue;
+}
+
+// Parse a JSON array
+JSON_NODE* json_ParseArray(char** pp_json, JSON_PARSER_CONTEXT* context, JSON_NODE* reuse)
+{
+	JSON_TOKEN token;
+	JSON_NODE* root, * node, * prev_node;
+	const char* pJson;
+	const char* pToken;
+	unsigned long lineNumber;
+	void* oldValue;
+	char* inlineBuffer;
+	size_t inlineSize;
+	bool hasCompleted;
+
+	root = node = prev_node = 0;
+	hasCompleted = false;
+
+	pJson = *pp_json;
+
+	while (!hasCompleted)
+	{
+		context->beginIndex = context->charNumber;
+		token = json_GetToken((char**)&pJson, context);
+		pToken = pJson;
+		lineNumber = context->lineNumber;
+
+		switch (token)
+		{
+		case JSON_TOKEN::CURLY_CLOSE:
+			context->errorCode = JSON_ERROR_CODE::UNEXPECTED_CLOSING_CURLY_BRACKET;
+			break;
+		case JSON_TOKEN::COLON:
+			context->errorCode = JSON_ERROR_CODE::UNEXPECTED_PAIR_COLON_TOKEN;
+			break;
+		case JSON_TOKEN::CURLY_OPEN:
+			if (node)
+			{
+				context->errorCode = JSON_ERROR_CODE::UNEXPECTED_ARRAY_VALUE;
+				break;
+			}
+			else
+			{
+				node = json_ValueNode(json_RecycleNode(&reuse, context, false), JSON_TYPE::OBJECT, context, &oldValue);
+				if (!node)
+				{
+					json_ParserOutOfMemory(context);
+					break;
+				}
+
+				node->value = json_ParseObject((char**)&pJson, context, (JSON_NODE*)oldValue);
+				json_RecordPosition(context, node, token, pToken, pJson, lineNumber);
+
+				if (prev_node) {
+					prev_node->next = node;
+				}
+			}
+			break;
+		case JSON_TOKEN::STRING:
+			if (node)
+			{
+				context->errorCode = JSON_ERROR_CODE::UNEXPECTED_ARRAY_VALUE;
+				break;
+			}
+			else
+			{
+				node = json_ValueNode(json_RecycleNode(&reuse, context, false), JSON_TYPE::STRING, context, &oldValue);
+				if (!node)
+				{
+					json_ParserOutOfMemory(context);
+					break;
+				}
+
+				inlineBuffer = json_InlineSpace(node, false, &inlineSize);
+				node->value = json_ParseString((char**)&pJson, context, (char*)oldValue, inlineBuffer, inlineSize);
+				json_RecordPosition(context, node, token, pToken, pJson, lineNumber);
+
+				if (prev_node) {
+					prev_node->next = node;
+				}
+			}
+			break;
+		case JSON_TOKEN::NUMBER:
+			if (node)
+			{
+				context->errorCode = JSON_ERROR_CODE::UNEXPECTED_ARRAY_VALUE;
+				break;
+			}
+			else
+			{
+				node = json_ValueNode(json_RecycleNode(&reuse, context, false), JSON_TYPE::NUMBER, context, &oldValue);
+				if (!node)
+				{
+					json_ParserOutOfMemory(context);
+					break;
+				}
+
+				inlineBuffer = json_InlineSpace(node, false, &inlineSize);
+				node->value = json_ParseNumber((char**)&pJson, context, (char*)oldValue, inlineBuffer, inlineSize);
+				json_RecordPosition(context, node, token, pToken, pJson, lineNumber);
+
+				if (prev_node) {
+					prev_node->next = node;
+				}
+			}
+			break;
+		case JSON_TOKEN::LITERAL:
+			if (node)
+			{
+				context->errorCode = JSON_ERROR_CODE::UNEXPECTED_ARRAY_VALUE;
+				break;
+			}
+			else
+			{
+				node = json_ValueNode(json_RecycleNode(&reuse, context, false), JSON_TYPE::BOOLEAN, context, &oldValue);
+				if (!node)
+				{
+					json_ParserOutOfMemory(context);
+					break;
+				}
+
+				node->value = (void*)json_ParseLiteral((char**)&pJson, context, &node->type);
+				json_RecordPosition(context, node, token, pToken, pJson, lineNumber);
+
+				if (prev_node) {
+					prev_node->next = node;
+				}
+			}
+			break;
+		case JSON_TOKEN::ARRAY_OPEN:
+			if (node)
+			{
+				context->errorCode = JSON_ERROR_CODE::UNEXPECTED_ARRAY_VALUE;
+				break;
+			}
+			else
+			{
+				node = json_ValueNode(json_RecycleNode(&reuse, context, false), JSON_TYPE::ARRAY, context, &oldValue);
+				if (!node)
+				{
+					json_ParserOutOfMemory(context);
+					break;
+				}
+
+				node->value = json_ParseArray((char**)&pJson, context, (JSON_NODE*)oldValue);
+				json_RecordPosition(context, node, token, pToken, pJson, lineNumber);
+
+				if (prev_node) {
+					prev_node->next = node;
+				}
+			}
+			break;
+		case JSON_TOKEN::ARRAY_CLOSE:
+			hasCompleted = true;
+			break;
+		case JSON_TOKEN::COMMA:
+			if (node) {
+				prev_node = node;
+			}
+			node = 0;
+			break;
+		case JSON_TOKEN::JSON_END:
+			context->errorCode = JSON_ERROR_CODE::EXPECTED_SQUARE_BRACKET_ENCOUNTERED_JSON_END;
+			break;
+		case JSON_TOKEN::UNRECOGNIZED_TOKEN:
+			context->errorCode = JSON_ERROR_CODE::UNRECOGNIZED_TOKEN;
+			break;
+		default:
+			break;
+		}
+
+		if ((!root) && (node)) {
+			root = node;
+		}
+
+		if (context->errorCode != JSON_ERROR_CODE::NONE) {
+			context->errorDescription = JSON_ERROR_STRINGS[(int)context->errorCode];
+			context->errorLength = context->charNumber - context->beginIndex;
+			break;
+		}
+	}
+
+	// Free the old nodes that were not recycled
+	json_ParserFreeList(context, reuse);
+
+	*pp_json = (char*)pJson;
+
+	return root;
+}
+
+// Set the parsed key of a node, a key that was parsed into the `keyBuffer` of the parser is copied into the node
+// The value of the node is not set yet, so the key fits in the inline storage
+void json_SetParsedKey(JSON_NODE* node, char* key, const char* keyBuffer)
+{
+	size_t space;
+
+	if ((key != NULL) && (key == keyBuffer))
+	{
+		key = (char*)memcpy(json_InlineSpace(node, true, &space), keyBuffer, strlen(keyBuffer) + 1);
+	}
+
+	json_SetKey(node, key);
+}
+
+// Free a parsed key that was not given to a node
+void json_FreeParsedKey(JSON_PARSER_CONTEXT* context, char* key, const char* keyBuffer)
+{
+	if ((key != NULL) && (key != keyBuffer)) {
+		json_ParserRelease(context, strlen(key) + 1);
+		json_Deallocate(context->allocator, key);
+	}
+}
+
+// Create the node for a key-value pair and parse the value
+// `recycled` is the old node for the pair or NULL, `key` is the parsed key, both are consumed
+// `keyBuffer` is the buffer of the parser that short keys are parsed into
+JSON_NODE* json_ParseMember(char** pp_json, JSON_PARSER_CONTEXT* context, JSON_TOKEN token, JSON_NODE* recycled, char* key, const char* keyBuffer)
+{
+	JSON_NODE* node;
+	JSON_TYPE type;
+	void* oldValue;
+	char* inlineBuffer;
+	size_t inlineSize;
+	const char* pToken;
+	unsigned long lineNumber;
+
+	pToken = *pp_json;
+	lineNumber = context->lineNumber;
+
+	if (token == JSON_TOKEN::CURLY_OPEN) {
+		type = JSON_TYPE::OBJECT;
+	}
+	else if (token == JSON_TOKEN::ARRAY_OPEN) {
+		type = JSON_TYPE::ARRAY;
+	}
+	else if (token == JSON_TOKEN::STRING) {
+		type = JSON_TYPE::STRING;
+	}
+	else if (token == JSON_TOKEN::NUMBER) {
+		type = JSON_TYPE::NUMBER;
+	}
+	else {
+		type = JSON_TYPE::BOOLEAN;
+	}
+
+	node = json_ValueNode(recycled, type, context, &oldValue);
+	if (!node)
+	{
+		json_FreeParsedKey(context, key, keyBuffer);
+		json_ParserOutOfMemory(context);
+		return NULL;
+	}
+
+	json_SetParsedKey(node, key, keyBuffer);
+	inlineBuffer = json_InlineSpace(node, false, &inlineSize);
+
+	if (token == JSON_TOKEN::CURLY_OPEN) {
+		node->value = json_ParseObject(pp_json, context, (JSON_NODE*)oldValue);
+	}
+	else if (token == JSON_TOKEN::ARRAY_OPEN) {
+		node->value = json_ParseArray(pp_json, context, (JSON_NODE*)oldValue);
+	}
+	else if (token == JSON_TOKEN::STRING) {
+		node->value = json_ParseString(pp_json, context, (char*)oldValue, inlineBuffer, inlineSize);
+	}
+	else if (token == JSON_TOKEN::NUMBER) {
+		node->value = json_ParseNumber(pp_json, context, (char*)oldValue, inlineBuffer, inlineSize);
+	}
+	else {
+		node->value = (void*)json_ParseLiteral(pp_json, context, &node->type);
+	}
+
+	json_RecordPosition(context, node, token, pToken, *pp_json, lineNumber);
+
+	return node;
+}
+
+// Create the node for a key without a value, the value becomes an empty object
+JSON_NODE* json_KeyOnlyNode(JSON_PARSER_CONTEXT* context, JSON_NODE* recycled, char* key, const char* keyBuffer)
+{
+	JSON_NODE* node;
+	void* oldValue;
+
+	node = json_ValueNode(recycled, JSON_TYPE::OBJECT, context, &oldValue);
+	if (!node)
+	{
+		json_FreeParsedKey(context, key, keyBuffer);
+		json_ParserOutOfMemory(context);
+		return NULL;
+	}
+
+	json_ParserFreeList(context, (JSON_NODE*)oldValue);
+	json_SetParsedKey(node, key, keyBuffer);
+
+	return node;
+}
+
+// Parse a JSON object
+JSON_NODE* json_ParseObject(char** pp_json, JSON_PARSER_CONTEXT* context, JSON_NODE* reuse)
+{
+	JSON_TOKEN token;
+	JSON_NODE* root, * node, * prev_node;
+	JSON_NODE* recycled;
+	const char* pJson;
+	char* key;
+	char keyBuffer[JSON_NODE_INLINE_SIZE + 1];
+	JSON_TYPE literalType;
+	bool isKey;
+	bool hasKey;
+	bool isValue;
+	bool hasCompleted;
+
+	root = node = prev_node = 0;
+	recycled = NULL;
+	key = NULL;
+	isKey = true;
+	hasKey = false;
+	hasCompleted = false;
+
+	pJson = *pp_json;
+
+	while (!hasCompleted)
+	{
+		context->beginIndex = context->charNumber;
+		token = json_GetToken((char**)&pJson, context);
+		isValue = false;
+
+		switch (token)
+		{
+		case JSON_TOKEN::CURLY_CLOSE:
+			hasCompleted = true;
+			break;
+		case JSON_TOKEN::COLON:
+			isKey = false;
+			break;
+		case JSON_TOKEN::CURLY_OPEN:
+			isValue = true;
+			break;
+		case JSON_TOKEN::STRING:
+			if (!isKey)
+			{
+				isValue = true;
+				break;
+			}
+			else
+			{
+				if (hasKey)
+				{
+					context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_KEY_ALREADY_DEFINED;
+					break;
+				}
+				else
+				{
+					// The node is created when the value is parsed, the key is parsed into the key buffer of the old member
+					// Short keys without an old buffer are parsed into `keyBuffer` and copied into the node
+					recycled = json_RecycleMember(&reuse, context, pJson);
+					if (recycled != NULL)
+					{
+						if (!json_IsInline(recycled, recycled->key)) {
+							key = recycled->key;
+						}
+						json_SetKey(recycled, NULL);
+					}
+
+					key = json_ParseString((char**)&pJson, context, key, keyBuffer, JSON_NODE_INLINE_SIZE);
+					hasKey = true;
+				}
+			}
+			break;
+		case JSON_TOKEN::NUMBER:
+			isValue = true;
+			break;
+		case JSON_TOKEN::LITERAL:
+			isValue = true;
+			break;
+		case JSON_TOKEN::ARRAY_OPEN:
+			isValue = true;
+			break;
+		case JSON_TOKEN::ARRAY_CLOSE:
+			context->errorCode = JSON_ERROR_CODE::UNEXPECTED_CLOSING_SQUARE_BRACKET;
+			break;
+		case JSON_TOKEN::COMMA:
+			if ((hasKey) && (!node))
+			{
+				node = json_KeyOnlyNode(context, recycled, key, keyBuffer);
+				recycled = NULL;
+				key = NULL;
+
+				if ((node) && (prev_node)) {
+					prev_node->next = node;
+				}
+
+				if ((!root) && (node)) {
+					root = node;
+				}
+			}
+			if (node) {
+				prev_node = node;
+			}
+			node = 0;
+			hasKey = false;
+			isKey = true;
+			break;
+		case JSON_TOKEN::JSON_END:
+			context->errorCode = JSON_ERROR_CODE::EXPECTED_CURLY_BRACKET_ENCOUNTERED_JSON_END;
+			break;
+		case JSON_TOKEN::UNRECOGNIZED_TOKEN:
+			context->errorCode = JSON_ERROR_CODE::UNRECOGNIZED_TOKEN;
+			break;
+		default:
+			break;
+		}
+
+		if (isValue)
+		{
+			if (!hasKey) {
+				context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_KEY_NOT_DEFINED;
+			}
+			else if (isKey) {
+				context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_EXPECTED_COLON;
+			}
+			else if (node)
+			{
+				// A value after the value of the member, a literal that is not valid keeps its own error
+				if (token == JSON_TOKEN::LITERAL) {
+					json_ParseLiteral((char**)&pJson, context, &literalType);
+				}
+				if (context->errorCode == JSON_ERROR_CODE::NONE) {
+					context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_UNEXPECTED_VALUE;
+				}
+			}
+			else
+			{
+				node = json_ParseMember((char**)&pJson, context, token, recycled, key, keyBuffer);
+				recycled = NULL;
+				key = NULL;
+
+				if ((node) && (prev_node)) {
+					prev_node->next = node;
+				}
+			}
+		}
+
+		if ((!root) && (node)) {
+			root = node;
+		}
+
+		if (context->errorCode != JSON_ERROR_CODE::NONE) {
+			context->errorDescription = JSON_ERROR_STRINGS[(int)context->errorCode];
+			context->errorLength = context->charNumber - context->beginIndex;
+			break;
+		}
+	}
+
+	// A key without a value before the end of the object
+	if ((hasKey) && (!node) && (context->errorCode == JSON_ERROR_CODE::NONE))
+	{
+		node = json_KeyOnlyNode(context, recycled, key, keyBuffer);
+		recycled = NULL;
+		key = NULL;
+
+		if ((node) && (prev_node)) {
+			prev_node->next = node;
+		}
+
+		if (!root) {
+			root = node;
+		}
+	}
+
+	json_FreeParsedKey(context, key, keyBuffer);
+
+	if (recycled != NULL) {
+		json_ParserRelease(context, json_NodeMemory(recycled, false));
+		json_free_node(recycled, context->allocator);
+	}
+
+	// Free the old nodes that were not recycled
+	json_ParserFreeList(context, reuse);
+
+	*pp_json = (char*)pJson;
+
+	return root;
+}
+
+// ----------------------------------------- //
+// **   Internal JSON reparse functions   ** //
+// ----------------------------------------- //
+
+// Object or array that is open at the current position of the old JSON string
+struct JSON_REPARSE_LEVEL
+{
+	JSON_NODE* node;
+	JSON_NODE* child;
+	size_t begin;
+	bool isObject;
+	bool isKey;
+	bool hasKey;
+	bool hasValue;
+};
+
+// Check that a value token of the old JSON string matches the node that was parsed from it
+bool json_TokenMatchesNode(JSON_TOKEN token, JSON_NODE* node)
+{
+	switch (token)
+	{
+	case JSON_TOKEN::CURLY_OPEN:
+		return (node->type == JSON_TYPE::OBJECT);
+	case JSON_TOKEN::ARRAY_OPEN:
+		return (node->type == JSON_TYPE::ARRAY);
+	case JSON_TOKEN::STRING:
+		return (node->type == JSON_TYPE::STRING);
+	case JSON_TOKEN::NUMBER:
+		return (node->type == JSON_TYPE::NUMBER);
+	case JSON_TOKEN::LITERAL:
+		return ((node->type == JSON_TYPE::BOOLEAN) || (node->type == JSON_TYPE::NULL_TYPE));
+	default:
+		return false;
+	}
+}
+
+// Match the next child node of a level with a value of the old JSON string, NULL if the tree does not match
+JSON_NODE* json_ReparseMatch(JSON_NODE** p_child, JSON_TOKEN token)
+{
+	JSON_NODE* node;
+
+	node = *p_child;
+	if ((node == NULL) || (!json_TokenMatchesNode(token, node))) {
+		return NULL;
+	}
+
+	*p_child = node->next;
+
+	return node;
+}
+
+// A key without a value was parsed as an empty object, match it before the next member
+bool json_ReparseKeyOnly(JSON_REPARSE_LEVEL* level)
+{
+	bool result;
+
+	result = true;
+
+	if ((level->isObject) && (level->hasKey) && (!level->hasValue)) {
+		result = (json_ReparseMatch(&level->child, JSON_TOKEN::CURLY_OPEN) != NULL);
+	}
+
+	level->isKey = level->isObject;
+	level->hasKey = false;
+	level->hasValue = false;
+
+	return result;
+}
+
+// Parse the new text of an object or array that encloses the edit, `begin` and `end` are the bracket offsets in the old JSON string
+// The old child nodes are recycled, the container always keeps a valid child node list
+// Returns false when the new text is not exactly one valid object or array
+bool json_ReparseContainer(JSON_NODE* container, const char* old_json, size_t begin, size_t end,
+	size_t offset, size_t removedLength, const char* insertedText, size_t insertedLength, JSON_PARSER_CONTEXT* context)
+{
+	char* buffer;
+	const char* pJson;
+	size_t headLength;
+	size_t tailLength;
+	size_t length;
+	bool result;
+
+	// The new text starts after the opening bracket and includes the closing bracket
+	headLength = offset - (begin + 1);
+	tailLength = (end + 1) - (offset + removedLength);
+	length = headLength + insertedLength + tailLength;
+
+	buffer = json_ParserReserve(context, length + 1) ? (char*)json_Allocate(context->allocator, length + 1) : NULL;
+	if (buffer == NULL) {
+		return false;
+	}
+
+	memcpy(buffer, old_json + begin + 1, headLength);
+	memcpy(buffer + headLength, insertedText, insertedLength);
+	memcpy(buffer + headLength + insertedLength, old_json + offset + removedLength, tailLength);
+	buffer[length] = 0;
+
+	context->lineNumber = 1;
+	context->charNumber = 0;
+	context->beginIndex = 0;
+	context->errorLength = 0;
+	context->errorCode = JSON_ERROR_CODE::NONE;
+	context->errorDescription = JSON_ERROR_STRINGS[(int)JSON_ERROR_CODE::NONE];
+
+	pJson = buffer;
+
+	json_DropIndex(container);
+	json_ForgetTail(container);
+
+	if (container->type == JSON_TYPE::OBJECT) {
+		container->value = json_ParseObject((char**)&pJson, context, (JSON_NODE*)container->value);
+	}
+	else {
+		container->value = json_ParseArray((char**)&pJson, context, (JSON_NODE*)container->value);
+	}
+
+	result = ((context->errorCode == JSON_ERROR_CODE::NONE) && (pJson == buffer + length));
+
+	json_ParserRelease(context, length + 1);
+	json_Deallocate(context->allocator, buffer);
+
+	return result;
+}
+
+// Check if an object or array on the levels shares its item list with a clone
+bool json_ReparseShared(JSON_REPARSE_LEVEL* levels, size_t depth)
+{
+	size_t i;
+
+	for (i = 0; i < depth; i++)
+	{
+		if (json_IsShared(levels[i].node)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Scan the old JSON string alongside the tree and reparse the smallest object or array that encloses the edit
+// When the new text of a container is not valid by itself the enclosing container is tried next
+// Returns false when no container could be reparsed, the tree is still valid but must be parsed again
+bool json_ReparseEnclosing(JSON_NODE* json_root, const char* old_json, size_t oldLength, size_t offset, size_t removedLength,
+	const char* insertedText, size_t insertedLength, JSON_PARSER_CONTEXT* context)
+{
+	JSON_REPARSE_LEVEL* levels;
+	JSON_REPARSE_LEVEL* level;
+	JSON_REPARSE_LEVEL* pNewLevels;
+	size_t depth;
+	size_t capacity;
+	size_t candidates;
+	size_t position;
+	size_t editEnd;
+	JSON_NODE* rootChild;
+	JSON_NODE* node;
+	const char* pJson;
+	const char* pEnd;
+	const char* pBegin;
+	JSON_TOKEN token;
+	bool isAtEdit;
+	bool isValue;
+	bool hasCompleted;
+	bool result;
+
+	levels = NULL;
+	depth = 0;
+	capacity = 0;
+	candidates = 0;
+	editEnd = offset + removedLength;
+	rootChild = json_root;
+	pJson = old_json;
+	pEnd = old_json + oldLength;
+	isAtEdit = false;
+	hasCompleted = false;
+	result = false;
+
+	while (!hasCompleted)
+	{
+		pJson = json_ScanToken(pJson, pEnd, &token, &pBegin, NULL);
+		position = (size_t)(pBegin - old_json);
+		level = (depth > 0) ? &levels[depth - 1] : NULL;
+
+		// The containers that are open at the start of the edit are the candidates
+		if ((!isAtEdit) && (position >= offset)) {
+			isAtEdit = true;
+			candidates = depth;
+		}
+
+		isValue = ((token == JSON_TOKEN::CURLY_OPEN) || (token == JSON_TOKEN::ARRAY_OPEN) ||
+			(token == JSON_TOKEN::NUMBER) || (token == JSON_TOKEN::LITERAL) ||
+			((token == JSON_TOKEN::STRING) && ((level == NULL) || (!level->isKey))));
+
+		node = NULL;
+		if (isValue)
+		{
+			node = json_ReparseMatch((level != NULL) ? &level->child : &rootChild, token);
+			if (node == NULL) {
+				break;
+			}
+			if (level != NULL) {
+				level->hasValue = true;
+			}
+		}
+
+		switch (token)
+		{
+		case JSON_TOKEN::CURLY_OPEN:
+		case JSON_TOKEN::ARRAY_OPEN:
+			if (depth == capacity)
+			{
+				if (!json_ParserReserve(context, JSON_PARSER_BUFFER_INCREASE * sizeof(JSON_REPARSE_LEVEL))) {
+					hasCompleted = true;
+					break;
+				}
+				capacity += JSON_PARSER_BUFFER_INCREASE;
+				pNewLevels = (JSON_REPARSE_LEVEL*)json_Reallocate(context->allocator, levels, capacity * sizeof(JSON_REPARSE_LEVEL));
+				if (pNewLevels == NULL) {
+					capacity -= JSON_PARSER_BUFFER_INCREASE;
+					json_ParserRelease(context, JSON_PARSER_BUFFER_INCREASE * sizeof(JSON_REPARSE_LEVEL));
+					hasCompleted = true;
+					break;
+				}
+				levels = pNewLevels;
+			}
+			level = &levels[depth++];
+			level->node = node;
+			level->child = (JSON_NODE*)node->value;
+			level->begin = position;
+			level->isObject = (token == JSON_TOKEN::CURLY_OPEN);
+			level->isKey = level->isObject;
+			level->hasKey = false;
+			level->hasValue = false;
+			break;
+		case JSON_TOKEN::CURLY_CLOSE:
+		case JSON_TOKEN::ARRAY_CLOSE:
+			if ((level == NULL) || (level->isObject != (token == JSON_TOKEN::CURLY_CLOSE)) ||
+				(!json_ReparseKeyOnly(level)) || (level->child != NULL))
+			{
+				hasCompleted = true;
+				break;
+			}
+			depth--;
+			if (isAtEdit)
+			{
+				if (position < editEnd)
+				{
+					// The closing bracket is removed or replaced
+					if (depth < candidates) {
+						candidates = depth;
+					}
+				}
+				else if (depth < candidates)
+				{
+					// Items shared with a clone can't be changed in place, the whole tree is parsed again
+					if (json_ReparseShared(levels, depth + 1))
+					{
+						hasCompleted = true;
+						break;
+					}
+
+					if (json_ReparseContainer(level->node, old_json, level->begin, position,
+						offset, removedLength, insertedText, insertedLength, context))
+					{
+						result = true;
+						hasCompleted = true;
+						break;
+					}
+
+					// Try the enclosing container
+					candidates = depth;
+				}
+			}
+			break;
+		case JSON_TOKEN::COLON:
+			if (level != NULL) {
+				level->isKey = false;
+			}
+			break;
+		case JSON_TOKEN::COMMA:
+			if ((level != NULL) && (!json_ReparseKeyOnly(level))) {
+				hasCompleted = true;
+			}
+			break;
+		case JSON_TOKEN::STRING:
+			if ((level != NULL) && (level->isKey)) {
+				level->hasKey = true;
+			}
+			break;
+		case JSON_TOKEN::NUMBER:
+		case JSON_TOKEN::LITERAL:
+			break;
+		default:
+			hasCompleted = true;
+			break;
+		}
+	}
+
+	json_ParserRelease(context, capacity * sizeof(JSON_REPARSE_LEVEL));
+	json_Deallocate(context->allocator, levels);
+
+	return result;
+}
+
+// ------------------------------------- //
+// **   Equality and hash functions   ** //
+// ------------------------------------- //
+
+// Seeds that keep the hashes of different value types apart
+#define JSON_HASH_STRING 0x9AE16A3B2F90404FULL
+#define JSON_HASH_NUMBER 0xC3A5C85C97CB3127ULL
+#define JSON_HASH_KEY 0xB492B66FBE98F273ULL
+#define JSON_HASH_OBJECT 0x8EBC6AF09C88C6E3ULL
+#define JSON_HASH_ARRAY 0x589965CC75374CC3ULL
+#define JSON_HASH_TRUE 0x1D8E4E27C47D124FULL
+#define JSON_HASH_FALSE 0xEB44ACCAB455D165ULL
+#define JSON_HASH_NULL 0x7A646E4D9A1C5C3BULL
+
+// Mix the bits of a 64-bit value
+unsigned long long json_Mix64(unsigned long long x)
+{
+	x ^= x >> 32;
+	x *= 0xD6E8FEB86659FD93ULL;
+	x ^= x >> 32;
+	x *= 0xD6E8FEB86659FD93ULL;
+	x ^= x >> 32;
+
+	return x;
+}
+
+// Hash `length` bytes 8 bytes at a time, the bytes are read in little endian order so the hash is the same on every platform
+unsigned long long json_HashBytes(const char* bytes, size_t length, unsigned long long seed)
+{
+	const unsigned char* p;
+	unsigned long long hash, k;
+	size_t i, shift;
+
+	p = (const unsigned char*)bytes;
+	hash = seed ^ ((unsigned long long)length * 0x9E3779B97F4A7C15ULL);
+
+	for (i = 0; i + 8 <= length; i += 8)
+	{
+		k = (unsigned long long)p[i] | ((unsigned long long)p[i + 1] << 8) |
+			((unsigned long long)p[i + 2] << 16) | ((unsigned long long)p[i + 3] << 24) |
+			((unsigned long long)p[i + 4] << 32) | ((unsigned long long)p[i + 5] << 40) |
+			((unsigned long long)p[i + 6] << 48) | ((unsigned long long)p[i + 7] << 56);
+		hash = json_Mix64(hash ^ k);
+	}
+
+	k = 0;
+	for (shift = 0; i < length; i++, shift += 8) {
+		k |= (unsigned long long)p[i] << shift;
+	}
+
+	return json_Mix64(hash ^ k);
+}
+
+// Get the value of a number node, numbers with up to 15 digits and no exponent are converted without strtod
+// The digits are read into an integer that is divided by a power of 10, both are exact doubles so the result is rounded like strtod
+double json_NumberValue(const char* number)
+{
+	static const double powers[16] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+	const char* p;
+	unsigned long long integer;
+	size_t digits, fraction;
+	double value;
+
+	if (number == NULL) {
+		return 0.0;
+	}
+
+	p = (*number == '-') ? number + 1 : number;
+
+	integer = 0;
+	for (digits = 0; (*p >= '0') && (*p <= '9') && (digits < 16); digits++, p++) {
+		integer = (integer * 10) + (unsigned long long)(*p - '0');
+	}
+
+	fraction = 0;
+	if ((*p == '.') && (digits != 0))
+	{
+		for (p++; (*p >= '0') && (*p <= '9') && (digits < 16); digits++, fraction++, p++) {
+			integer = (integer * 10) + (unsigned long long)(*p - '0');
+		}
+	}
+
+	if ((digits != 0) && (digits < 16) && (*p == '\0'))
+	{
+		value = (double)integer / powers[fraction];
+		return (*number == '-') ? -value : value;
+	}
+
+	return strtod(number, NULL);
+}
+
+// Get the integer part of a number node like atoll, numbers with up to 18 integer digits are converted without atoll
+long long json_NumberInt64(const char* number)
+{
+	const char* p;
+	unsigned long long integer;
+	size_t digits;
+
+	if (number == NULL) {
+		return 0;
+	}
+
+	p = (*number == '-') ? number + 1 : number;
+
+	integer = 0;
+	for (digits = 0; (p[digits] >= '0') && (p[digits] <= '9') && (digits < 19); digits++) {
+		integer = (integer * 10) + (unsigned long long)(p[digits] - '0');
+	}
+
+	if ((digits < 19) && ((p[digits] < '0') || (p[digits] > '9'))) {
+		return (*number == '-') ? -(long long)integer : (long long)integer;
+	}
+
+	return atoll(number);
+}
+
+// Get the last stamp taken in the process, no item list changed anywhere while it is the same
+unsigned long long json_HashEpoch()
+{
+	return json_stamps.load(std::memory_order_relaxed);
+}
+
+// Check if the cached hash of an object or array is valid, its stamp and the stamps of the objects and arrays in it are unchanged
+// A valid hash is marked with `epoch`, so it is not checked again until another stamp is taken
+bool json_HashValid(JSON_NODE* container, unsigned long long epoch)
+{
+	JSON_NODE_EXTRA* extra;
+	JSON_NODE* node;
+
+	extra = json_NodeExtra(container, false);
+	if (extra == NULL) {
+		return false;
+	}
+
+	if (extra->hashEpoch == epoch) {
+		return true;
+	}
+	if (extra->hashStamp != extra->stamp) {
+		return false;
+	}
+
+	for (node = (JSON_NODE*)container->value; node != NULL; node = node->next)
+	{
+		if ((json_IsContainer(node->type)) && (!json_HashValid(node, epoch))) {
+			return false;
+		}
+	}
+
+	extra->hashEpoch = epoch;
+
+	return true;
+}
+
+// Get the hash of a value, objects and arrays keep their hash in their side block
+// Members of objects are hashed in any order, items of arrays in order
+unsigned long long json_HashValue(JSON_NODE* node, unsigned long long epoch)
+{
+	JSON_NODE_EXTRA* extra;
+	JSON_LOOKUP_KEY lookupKey;
+	JSON_NODE* item;
+	unsigned long long hash, count;
+	double number;
+
+	switch (node->type)
+	{
+	case JSON_TYPE::STRING:
+		return json_HashBytes((const char*)node->value, (node->value != NULL) ? strlen((const char*)node->value) : 0, JSON_HASH_STRING);
+	case JSON_TYPE::NUMBER:
+		number = json_NumberValue((const char*)node->value);
+		if (number == 0.0) {
+			number = 0.0;
+		}
+		memcpy(&hash, &number, sizeof(hash));
+		return json_Mix64(hash ^ JSON_HASH_NUMBER);
+	case JSON_TYPE::BOOLEAN:
+		return (node->value != NULL) ? JSON_HASH_TRUE : JSON_HASH_FALSE;
+	case JSON_TYPE::NULL_TYPE:
+		return JSON_HASH_NULL;
+	default:
+		break;
+	}
+
+	if (json_HashValid(node, epoch)) {
+		return json_NodeExtra(node, false)->hash;
+	}
+
+	count = 0;
+	if (node->type == JSON_TYPE::OBJECT)
+	{
+		// The member hashes are added, so the order of the members does not change the hash
+		hash = 0;
+		for (item = (JSON_NODE*)node->value; item != NULL; item = item->next)
+		{
+			if (!json_NodeKey(item, &lookupKey)) {
+				json_LookupKey(&lookupKey, "", 0);
+			}
+			hash += json_Mix64(json_HashBytes(lookupKey.key, lookupKey.length, JSON_HASH_KEY) + json_HashValue(item, epoch));
+			count++;
+		}
+		hash = json_Mix64(hash ^ JSON_HASH_OBJECT ^ count);
+	}
+	else
+	{
+		hash = JSON_HASH_ARRAY;
+		for (item = (JSON_NODE*)node->value; item != NULL; item = item->next)
+		{
+			hash = json_Mix64(hash + json_HashValue(item, epoch));
+			count++;
+		}
+		hash = json_Mix64(hash ^ count);
+	}
+
+	// The hash is not kept when there is not enough memory for the side block
+	extra = json_NodeExtra(node, true);
+	if (extra != NULL)
+	{
+		extra->hash = hash;
+		extra->hashStamp = extra->stamp;
+		extra->hashEpoch = epoch;
+	}
+
+	return hash;
+}
+
+// Get the cached hash of an object or array without checking the objects and arrays in it, returns false if it is not known
+bool json_CachedHash(JSON_NODE* container, unsigned long long epoch, unsigned long long* hash)
+{
+	JSON_NODE_EXTRA* extra;
+
+	extra = json_NodeExtra(container, false);
+	if ((extra == NULL) || (extra->hashEpoch != epoch)) {
+		return false;
+	}
+
+	*hash = extra->hash;
+
+	return true;
+}
+
+// Check if 2 values are equal, numbers are equal when their values are equal
+bool json_Equal(JSON_NODE* a, JSON_NODE* b, bool ignoreKeyOrder, unsigned long long epoch)
+{
+	JSON_LOOKUP_KEY lookupKey;
+	JSON_NODE* itemA;
+	JSON_NODE* itemB;
+	unsigned long long hashA, hashB;
+	bool hasKeyA, hasKeyB;
+
+	if (a == b) {
+		return true;
+	}
+	if ((a == NULL) || (b == NULL) || (a->type != b->type)) {
+		return false;
+	}
+
+	switch (a->type)
+	{
+	case JSON_TYPE::STRING:
+		return (strcmp((a->value != NULL) ? (const char*)a->value : "", (b->value != NULL) ? (const char*)b->value : "") == 0);
+	case JSON_TYPE::NUMBER:
+		if ((a->value != NULL) && (b->value != NULL) && (strcmp((const char*)a->value, (const char*)b->value) == 0)) {
+			return true;
+		}
+		return (json_NumberValue((const char*)a->value) == json_NumberValue((const char*)b->value));
+	case JSON_TYPE::BOOLEAN:
+		return ((a->value != NULL) == (b->value != NULL));
+	case JSON_TYPE::NULL_TYPE:
+		return true;
+	default:
+		break;
+	}
+
+	// Clones share their items
+	if (a->value == b->value) {
+		return true;
+	}
+
+	// Values with different hashes are not equal
+	if ((json_CachedHash(a, epoch, &hashA)) && (json_CachedHash(b, epoch, &hashB)) && (hashA != hashB)) {
+		return false;
+	}
+
+	if ((a->type == JSON_TYPE::OBJECT) && (ignoreKeyOrder))
+	{
+		if (json_CountList(a) != json_CountList(b)) {
+			return false;
+		}
+
+		// Every member of `a` is in `b` with an equal value, and every key of `b` is in `a`
+		for (itemA = (JSON_NODE*)a->value; itemA != NULL; itemA = itemA->next)
+		{
+			if (!json_NodeKey(itemA, &lookupKey)) {
+				return false;
+			}
+			itemB = json_FindKey(b, &lookupKey, NULL);
+			if ((itemB == NULL) || (!json_Equal(itemA, itemB, ignoreKeyOrder, epoch))) {
+				return false;
+			}
+		}
+		for (itemB = (JSON_NODE*)b->value; itemB != NULL; itemB = itemB->next)
+		{
+			if ((!json_NodeKey(itemB, &lookupKey)) || (json_FindKey(a, &lookupKey, NULL) == NULL)) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	itemA = (JSON_NODE*)a->value;
+	itemB = (JSON_NODE*)b->value;
+	while ((itemA != NULL) && (itemB != NULL))
+	{
+		if (a->type == JSON_TYPE::OBJECT)
+		{
+			hasKeyA = json_NodeKey(itemA, &lookupKey);
+			hasKeyB = (itemB->key != NULL);
+			if ((hasKeyA != hasKeyB) || ((hasKeyA) && (!json_KeyEquals(itemB, &lookupKey)))) {
+				return false;
+			}
+		}
+		if (!json_Equal(itemA, itemB, ignoreKeyOrder, epoch)) {
+			return false;
+		}
+		itemA = itemA->next;
+		itemB = itemB->next;
+	}
+
+	return ((itemA == NULL) && (itemB == NULL));
+}
+
+// ------------------------ //
+// **   JSON functions   ** //
+// ------------------------ //
+
+char* json_plus::JSON_Generate(JSON_NODE* json_root, const char* format, const JSON_ALLOCATOR* allocator)
+{
+	JSON_GENERATOR_CONTEXT context = {};
+
+	if (json_root == NULL) {
+		return NULL;
+	}
+
+	context.allocator = allocator;
+	context.error = false;
+	context.buffer = NULL;
+	context.bufferLength = 0;
+	context.index = 0;
+	context.visualEscape = false;
+	context.format = format;
+	context.indentation = 0;
+
+	if (format != NULL) {
+		if (*format == 'c') {
+			context.visualEscape = true;
+		}
+	}
+
+	if (setjmp(context.env) == 0)
+	{
+		if (json_root->type == JSON_TYPE::OBJECT)
+		{
+			json_GeneratorAppend(&context, '{', true);
+			json_GenerateText((JSON_NODE*)json_root->value, &context);
+			json_GeneratorAppend(&context, '}', true);
+			json_GeneratorAppend(&context, '\0', false);
+		}
+		else if (json_root->type == JSON_TYPE::ARRAY)
+		{
+			json_GeneratorAppend(&context, '[', true);
+			json_GenerateText((JSON_NODE*)json_root->value, &context);
+			json_GeneratorAppend(&context, ']', true);
+			json_GeneratorAppend(&context, '\0', false);
+		}
+	}
+
+	return context.buffer;
+}
+
+char* json_plus::JSON_GenerateCanonical(JSON_NODE* json_root, const JSON_ALLOCATOR* allocator)
+{
+	JSON_GENERATOR_CONTEXT context = {};
+
+	if (json_root == NULL) {
+		return NULL;
+	}
+
+	context.allocator = allocator;
+	context.error = false;
+	context.buffer = NULL;
+	context.bufferLength = 0;
+	context.index = 0;
+	context.members = NULL;
+	context.memberCount = 0;
+	context.memberCapacity = 0;
+
+	if (setjmp(context.env) == 0)
+	{
+		json_GenerateCanonical(json_root, &context);
+		json_GeneratorWrite(&context, "", 1);
+	}
+
+	json_Deallocate(allocator, context.members);
+
+	if (context.error)
+	{
+		json_Deallocate(allocator, context.buffer);
+		return NULL;
+	}
+
+	return context.buffer;
+}
+
+// Parse the top level JSON values, `reuse` is an optional node list to recycle
+JSON_NODE* json_ParseRoot(const char* pJson, JSON_PARSER_CONTEXT* context, JSON_NODE* reuse)
+{
+	JSON_TOKEN token;
+	JSON_NODE* root, * node, * prev_node;
+	const char* pToken;
+	unsigned long lineNumber;
+	void* oldValue;
+	bool hasCompleted;
+
+	if (context == 0) {
+		return 0;
+	}
+
+	context->lineNumber = 1;
+	context->charNumber = 0;
+	context->beginIndex = 0;
+	context->errorLength = 0;
+
+	if (pJson == 0)
+	{
+		context->errorCode = JSON_ERROR_CODE::INVALID_PARAMETER;
+		context->errorDescription = JSON_ERROR_STRINGS[(int)JSON_ERROR_CODE::INVALID_PARAMETER];
+		return 0;
+	}
+
+	context->errorCode = JSON_ERROR_CODE::NONE;
+	context->errorDescription = JSON_ERROR_STRINGS[(int)JSON_ERROR_CODE::NONE];
+
+	// Positions are byte offsets in this JSON string
+	if (context->positions != NULL) {
+		context->positions->Clear();
+		context->positions->json = pJson;
+	}
+
+	root = node = prev_node = 0;
+	hasCompleted = false;
+
+	while (!hasCompleted)
+	{
+		context->beginIndex = context->charNumber;
+		token = json_GetToken((char**)&pJson, context);
+		pToken = pJson;
+		lineNumber = context->lineNumber;
+
+		switch (token)
+		{
+		case JSON_TOKEN::CURLY_OPEN:
+			node = json_ValueNode(json_RecycleNode(&reuse, context, false), JSON_TYPE::OBJECT, context, &oldValue);
+			if (!node)
+			{
+				json_ParserOutOfMemory(context);
+				break;
+			}
+
+			node->value = json_ParseObject((char**)&pJson, context, (JSON_NODE*)oldValue);
+			json_RecordPosition(context, node, token, pToken, pJson, lineNumber);
+
+			if (prev_node) {
+				prev_node->next = node;
+			}
+			break;
+		case JSON_TOKEN::ARRAY_OPEN:
+			node = json_ValueNode(json_RecycleNode(&reuse, context, false), JSON_TYPE::ARRAY, context, &oldValue);
+			if (!node)
+			{
+				json_ParserOutOfMemory(context);
+				break;
+			}
+
+			node->value = json_ParseArray((char**)&pJson, context, (JSON_NODE*)oldValue);
+			json_RecordPosition(context, node, token, pToken, pJson, lineNumber);
+
+			if (prev_node) {
+				prev_node->next = node;
+			}
+			break;
+		case JSON_TOKEN::JSON_END:
+			hasCompleted = true;
+			break;
+		case JSON_TOKEN::UNRECOGNIZED_TOKEN:
+			context->errorCode = JSON_ERROR_CODE::UNRECOGNIZED_TOKEN;
+			break;
+		default:
+			context->errorCode = JSON_ERROR_CODE::UNEXPECTED_START_TOKEN;
+			break;
+		}
+
+		if ((!root) && (node)) {
+			root = node;
+		}
+
+		if (node) {
+			prev_node = node;
+			node = 0;
+		}
+
+		if (context->errorCode != JSON_ERROR_CODE::NONE) {
+			context->errorDescription = JSON_ERROR_STRINGS[(int)context->errorCode];
+			context->errorLength = context->charNumber - context->beginIndex;
+			break;
+		}
+	}
+
+	// Free the old nodes that were not recycled
+	json_ParserFreeList(context, reuse);
+
+	return root;
+}
+
+JSON_NODE* json_plus::JSON_Parse(const char* pJson, JSON_PARSER_CONTEXT* context)
+{
+	if (context != 0) {
+		json_ParserResetMemory(context);
+	}
+
+	return json_ParseRoot(pJson, context, NULL);
+}
+
+JSON_NODE* json_plus::JSON_ParseInto(JSON_NODE* json_root, const char* pJson, JSON_PARSER_CONTEXT* context)
+{
+	// Keep the old tree when the parameters are invalid
+	if ((context == 0) || (pJson == 0))
+	{
+		if (context != 0) {
+			context->errorCode = JSON_ERROR_CODE::INVALID_PARAMETER;
+			context->errorDescription = JSON_ERROR_STRINGS[(int)JSON_ERROR_CODE::INVALID_PARAMETER];
+		}
+		return json_root;
+	}
+
+	JSON_NODE* root;
+	const JSON_ALLOCATOR* allocator;
+
+	// The memory of the old tree is not counted, only how much the tree grows or shrinks
+	json_ParserResetMemory(context);
+
+	// The old nodes are recycled, so the new tree must use the allocator of the old tree
+	allocator = context->allocator;
+	if (json_root != NULL) {
+		context->allocator = json_NodeAllocator(json_root, allocator);
+	}
+
+	root = json_ParseRoot(pJson, context, json_root);
+
+	context->allocator = allocator;
+
+	return root;
+}
+
+JSON_NODE* json_plus::JSON_Reparse(JSON_NODE* json_root, const char* old_json, size_t offset, size_t removedLength, const char* insertedText, JSON_PARSER_CONTEXT* context)
+{
+	size_t oldLength;
+	size_t insertedLength;
+
+	oldLength = (old_json != 0) ? strlen(old_json) : 0;
+	insertedLength = (insertedText != 0) ? strlen(insertedText) : 0;
+
+	// Keep the old tree when the parameters are invalid or the edit is outside of the old JSON string
+	if ((context == 0) || (old_json == 0) || (offset > oldLength) || (removedLength > oldLength - offset))
+	{
+		if (context != 0) {
+			context->errorCode = JSON_ERROR_CODE::INVALID_PARAMETER;
+			context->errorDescription = JSON_ERROR_STRINGS[(int)JSON_ERROR_CODE::INVALID_PARAMETER];
+		}
+		return json_root;
+	}
+
+	if (insertedText == 0) {
+		insertedText = "";
+	}
+
+	JSON_NODE* root;
+	const JSON_ALLOCATOR* allocator;
+	size_t new_length;
+	char* new_json;
+
+	json_ParserResetMemory(context);
+
+	// The old nodes are recycled, so the new tree must use the allocator of the old tree
+	allocator = context->allocator;
+	if (json_root != NULL) {
+		context->allocator = json_NodeAllocator(json_root, allocator);
+	}
+
+	root = json_root;
+
+	// Positions after the edit would move, so they are recorded again by parsing the whole new JSON string
+	if ((json_root == NULL) || (context->positions != NULL) || (!json_ReparseEnclosing(json_root, old_json, oldLength, offset, removedLength, insertedText, insertedLength, context)))
+	{
+		// Parse the whole new JSON string
+		new_length = oldLength - removedLength + insertedLength + 1;
+		context->errorCode = JSON_ERROR_CODE::NONE;
+		new_json = json_ParserReserve(context, new_length) ? (char*)json_Allocate(context->allocator, new_length) : NULL;
+		if (new_json == NULL)
+		{
+			json_ParserOutOfMemory(context);
+			context->errorDescription = JSON_ERROR_STRINGS[(int)context->errorCode];
+		}
+		else
+		{
+			memcpy(new_json, old_json, offset);
+			memcpy(new_json + offset, insertedText, insertedLength);
+			memcpy(new_json + offset + insertedLength, old_json + offset + removedLength, oldLength - offset - removedLength + 1);
+
+			root = json_ParseRoot(new_json, context, json_root);
+
+			// The positions are relative to the edited JSON string, which is freed here
+			if (context->positions != NULL) {
+				context->positions->json = NULL;
+			}
+
+			json_ParserRelease(context, new_length);
+			json_Deallocate(context->allocator, new_json);
+		}
+	}
+
+	context->allocator = allocator;
+
+	return root;
+}
+
+void json_plus::JSON_Free(JSON_NODE* json_root)
+{
+	if (json_root == NULL) {
+		return;
+	}
+
+	// Root nodes have a header with their allocator
+	json_FreeList(json_root, NULL);
+}
+
+JSON_NODE* json_plus::JSON_Clone(JSON_NODE* json_root)
+{
+	if (json_root == NULL) {
+		return NULL;
+	}
+
+	// The clone shares the items of the root, they are copied one level at a time when they are changed
+	return json_CloneNode(json_root, json_NodeAllocator(json_root, NULL), true);
+}
+
+JSON_NODE* json_plus::JSON_Compact(JSON_NODE* json_root)
+{
+	const JSON_ALLOCATOR* allocator;
+	JSON_COMPACT_BLOCK* block;
+	JSON_NODE* root;
+	JSON_NODE* tail;
+	JSON_NODE* node;
+	size_t nodeBytes;
+	size_t stringBytes;
+	char* pNodes;
+	char* pStrings;
+
+	if (json_root == NULL) {
+		return NULL;
+	}
+
+	// A tree that is compacted again gets a block from the allocator of its old block
+	allocator = json_NodeAllocator(json_root, NULL);
+	if ((allocator != NULL) && (allocator->allocate == json_CompactAllocate)) {
+		allocator = ((JSON_COMPACT_BLOCK*)allocator->userData)->parent;
+	}
+
+	// The nodes after the root are freed with it, so they are compacted with it and need a header for the allocator
+	nodeBytes = 0;
+	stringBytes = 0;
+	for (node = json_root; node != NULL; node = node->next) {
+		json_CompactSize(node, true, &nodeBytes, &stringBytes);
+	}
+
+	// Keep the old tree when there is not enough memory
+	block = (JSON_COMPACT_BLOCK*)json_Allocate(allocator, sizeof(JSON_COMPACT_BLOCK) + nodeBytes + stringBytes);
+	if (block == NULL) {
+		return json_root;
+	}
+
+	block->allocator.allocate = json_CompactAllocate;
+	block->allocator.reallocate = json_CompactReallocate;
+	block->allocator.deallocate = json_CompactDeallocate;
+	block->allocator.userData = block;
+	block->parent = allocator;
+	block->end = (const char*)(block + 1) + nodeBytes + stringBytes;
+	block->pieces = 0;
+
+	pNodes = (char*)(block + 1);
+	pStrings = pNodes + nodeBytes;
+
+	root = tail = NULL;
+	for (node = json_root; node != NULL; node = node->next)
+	{
+		if (tail == NULL) {
+			root = tail = json_CompactNode(block, node, true, &pNodes, &pStrings);
+		}
+		else {
+			tail->next = json_CompactNode(block, node, true, &pNodes, &pStrings);
+			tail = tail->next;
+		}
+	}
+
+	JSON_Free(json_root);
+
+	return root;
+}
+
+bool json_plus::JSON_Equal(JSON_NODE* a, JSON_NODE* b, bool ignoreKeyOrder)
+{
+	return json_Equal(a, b, ignoreKeyOrder, json_HashEpoch());
+}
+
+unsigned long long json_plus::JSON_Hash(JSON_NODE* node)
+{
+	if (node == NULL) {
+		return 0;
+	}
+
+	return json_HashValue(node, json_HashEpoch());
+}
+
+JSON_NODE* json_plus::JSON_GetObject(JSON_NODE* object, const char* key)
+{
+	return JSON_GetObject(object, key, json_KeyLength(key));
+}
+
+JSON_NODE* json_plus::JSON_GetObject(JSON_NODE* object, const char* key, size_t keyLength)
+{
+	JSON_TYPE type;
+
+	type = JSON_TYPE::OBJECT;
+
+	return json_FindMember(object, key, keyLength, &type);
+}
+
+JSON_NODE* json_plus::JSON_GetArray(JSON_NODE* object, const char* key)
+{
+	return JSON_GetArray(object, key, json_KeyLength(key));
+}
+
+JSON_NODE* json_plus::JSON_GetArray(JSON_NODE* object, const char* key, size_t keyLength)
+{
+	JSON_TYPE type;
+
+	type = JSON_TYPE::ARRAY;
+
+	return json_FindMember(object, key, keyLength, &type);
+}
+
+char* json_plus::JSON_GetString(JSON_NODE* object, const char* key)
+{
+	return JSON_GetString(object, key, json_KeyLength(key));
+}
+
+char* json_plus::JSON_GetString(JSON_NODE* object, const char* key, size_t keyLength)
+{
+	JSON_NODE* node;
+	JSON_TYPE type;
+
+	type = JSON_TYPE::STRING;
+
+	node = json_FindMember(object, key, keyLength, &type);
+	if (node != NULL) {
+		return (char*)node->value;
+	}
+
+	return NULL;
+}
+
+char* json_plus::JSON_GetNumber(JSON_NODE* object, const char* key)
+{
+	return JSON_GetNumber(object, key, json_KeyLength(key));
+}
+
+char* json_plus::JSON_GetNumber(JSON_NODE* object, const char* key, size_t keyLength)
+{
+	JSON_NODE* node;
+	JSON_TYPE type;
+
+	type = JSON_TYPE::NUMBER;
+
+	node = json_FindMember(object, key, keyLength, &type);
+	if (node != NULL) {
+		return (char*)node->value;
+	}
+
+	return NULL;
+}
+
+bool json_plus::JSON_GetBoolean(JSON_NODE* object, const char* key)
+{
+	return JSON_GetBoolean(object, key, json_KeyLength(key));
+}
+
+bool json_plus::JSON_GetBoolean(JSON_NODE* object, const char* key, size_t keyLength)
+{
+	JSON_NODE* node;
+	JSON_TYPE type;
+
+	type = JSON_TYPE::BOOLEAN;
+
+	node = json_FindMember(object, key, keyLength, &type);
+	if (node != NULL) {
+		return (bool)node->value;
+	}
+
+	return false;
+}
+
+#ifdef JSON_PLUS_STRING_VIEW
+
+JSON_NODE* json_plus::JSON_GetObject(JSON_NODE* object, std::string_view key)
+{
+	return JSON_GetObject(object, key.data(), key.size());
+}
+
+JSON_NODE* json_plus::JSON_GetArray(JSON_NODE* object, std::string_view key)
+{
+	return JSON_GetArray(object, key.data(), key.size());
+}
+
+char* json_plus::JSON_GetString(JSON_NODE* object, std::string_view key)
+{
+	return JSON_GetString(object, key.data(), key.size());
+}
+
+char* json_plus::JSON_GetNumber(JSON_NODE* object, std::string_view key)
+{
+	return JSON_GetNumber(object, key.data(), key.size());
+}
+
+bool json_plus::JSON_GetBoolean(JSON_NODE* object, std::string_view key)
+{
+	return JSON_GetBoolean(object, key.data(), key.size());
+}
+
+#endif // JSON_PLUS_STRING_VIEW
+
+#ifdef JSON_PLUS_CONSTEXPR_KEY
+
+JSON_NODE* json_plus::JSON_GetObject(JSON_NODE* object, const JSON_KEY& key)
+{
+	JSON_TYPE type;
+
+	type = JSON_TYPE::OBJECT;
+
+	return json_FindMember(object, key, &type);
+}
+
+JSON_NODE* json_plus::JSON_GetArray(JSON_NODE* object, const JSON_KEY& key)
+{
+	JSON_TYPE type;
+
+	type = JSON_TYPE::ARRAY;
+
+	return json_FindMember(object, key, &type);
+}
+
+char* json_plus::JSON_GetString(JSON_NODE* object, const JSON_KEY& key)
+{
+	JSON_NODE* node;
+	JSON_TYPE type;
+
+	type = JSON_TYPE::STRING;
+
+	node = json_FindMember(object, key, &type);
+	if (node != NULL) {
+		return (char*)node->value;
+	}
+
+	return NULL;
+}
+
+char* json_plus::JSON_GetNumber(JSON_NODE* object, const JSON_KEY& key)
+{
+	JSON_NODE* node;
+	JSON_TYPE type;
+
+	type = JSON_TYPE::NUMBER;
+
+	node = json_FindMember(object, key, &type);
+	if (node != NULL) {
+		return (char*)node->value;
+	}
+
+	return NULL;
+}
+
+bool json_plus::JSON_GetBoolean(JSON_NODE* object, const JSON_KEY& key)
+{
+	JSON_NODE* node;
+	JSON_TYPE type;
+
+	type = JSON_TYPE::BOOLEAN;
+
+	node = json_FindMember(object, key, &type);
+	if (node != NULL) {
+		return (bool)node->value;
+	}
+
+	return false;
+}
+
+#endif // JSON_PLUS_CONSTEXPR_KEY
+
+JSON_NODE* json_plus::JSON_CreateNode(JSON_TYPE type, const char* key, void* value, const JSON_ALLOCATOR* allocator)
+{
+	JSON_NODE* node;
+
+	// The node gets a header, so it can be freed on its own with the right allocator
+	node = json_AllocateNode(allocator, type, true);
+	if (node != NULL)
+	{
+		if ((key != NULL) && (!json_CopyKey(node, key, allocator))) {
+			json_DeallocateNode(node, allocator);
+			return NULL;
+		}
+
+		if ((type == JSON_TYPE::STRING) && (value != NULL))
+		{
+			if (!json_CopyValue(node, (const char*)value, allocator)) {
+				json_free_node(node, allocator);
+				return NULL;
+			}
+		}
+		else {
+			node->value = value;
+		}
+
+		node->next = NULL;
+		node->type = type;
+		node->format = NULL;
+	}
+
+	return node;
+}
+
+const JSON_ALLOCATOR* json_plus::JSON_GetAllocator(JSON_NODE* node)
+{
+	const JSON_ALLOCATOR* allocator;
+
+	allocator = json_NodeAllocator(node, NULL);
+	if (allocator == NULL) {
+		allocator = &json_DefaultAllocator;
+	}
+
+	return allocator;
+}
+
+JSON_MEMORY_USAGE json_plus::JSON_MemoryUsage(JSON_NODE* json_root)
+{
+	JSON_MEMORY_USAGE usage;
+	JSON_NODE* node;
+
+	memset(&usage, 0, sizeof(usage));
+
+	// JSON_Free frees the nodes after the root too
+	for (node = json_root; node != NULL; node = node->next) {
+		json_AddMemoryUsage(node, &usage);
+	}
+
+	usage.total = json_MemoryTotal(&usage);
+
+	return usage;
+}
+
+// ------------------------------- //
+// **   UTF8_Encoding methods   ** //
+// ------------------------------- //
+
+unsigned char UTF8_Encoding::GetCharacterUnits(char Code)
+{
+	if ((Code & 0x80) == 0) {
+		return 1;
+	}
+	else if ((Code & 0xE0) == 0xC0) {
+		return 2;
+	}
+	else if ((Code & 0xF0) == 0xE0) {
+		return 3;
+	}
+	else if ((Code & 0xF8) == 0xF0) {
+		return 4;
+	}
+	else {
+		return 0;
+	}
+}
+
+unsigned char UTF8_Encoding::Encode(char* pBuffer, size_t Length, unsigned long CodePoint)
+{
+	if (CodePoint < 0x80)
+	{
+		if ((pBuffer != NULL) && (Length >= 2))
+		{
+			pBuffer[0] = (char)CodePoint & 0x7F;
+			pBuffer[1] = 0;
+		}
+		return 1;
+	}
+	else if (CodePoint < 0x800)
+	{
+		if ((pBuffer != NULL) && (Length >= 3))
+		{
+			pBuffer[0] = (char)(CodePoint >> 6) | 0xC0;
+			pBuffer[1] = (char)(CodePoint & 0x3F) | 0x80;
+			pBuffer[2] = 0;
+		}
+		return 2;
+	}
+	else if (CodePoint < 0x10000)
+	{
+		if ((pBuffer != NULL) && (Length >= 4))
+		{
+			pBuffer[0] = (char)(CodePoint >> 12) | 0xE0;
+			pBuffer[1] = (char)((CodePoint >> 6) & 0x3F) | 0x80;
+			pBuffer[2] = (char)(CodePoint & 0x3F) | 0x80;
+			pBuffer[3] = 0;
+		}
+		return 3;
+	}
+	else if (CodePoint < 0x110000)
+	{
+		if ((pBuffer != NULL) && (Length >= 5))
+		{
+			pBuffer[0] = (char)(CodePoint >> 18) | 0xF0;
+			pBuffer[1] = (char)((CodePoint >> 12) & 0x3F) | 0x80;
+			pBuffer[2] = (char)((CodePoint >> 6) & 0x3F) | 0x80;
+			pBuffer[3] = (char)(CodePoint & 0x3F) | 0x80;
+			pBuffer[4] = 0;
+		}
+		return 4;
+	}
+
+	return 0;
+}
+
+unsigned char UTF8_Encoding::EncodeUnsafe(char* pBuffer, unsigned long CodePoint)
+{
+	if (CodePoint < 0x80)
+	{
+		if (pBuffer != NULL)
+		{
+			pBuffer[0] = (char)CodePoint & 0x7F;
+		}
+		return 1;
+	}
+	else if (CodePoint < 0x800)
+	{
+		if (pBuffer != NULL)
+		{
+			pBuffer[0] = (char)(CodePoint >> 6) | 0xC0;
+			pBuffer[1] = (char)(CodePoint & 0x3F) | 0x80;
+		}
+		return 2;
+	}
+	else if (CodePoint < 0x10000)
+	{
+		if (pBuffer != NULL)
+		{
+			pBuffer[0] = (char)(CodePoint >> 12) | 0xE0;
+			pBuffer[1] = (char)((CodePoint >> 6) & 0x3F) | 0x80;
+			pBuffer[2] = (char)(CodePoint & 0x3F) | 0x80;
+		}
+		return 3;
+	}
+	else if (CodePoint < 0x110000)
+	{
+		if (pBuffer != NULL)
+		{
+			pBuffer[0] = (char)(CodePoint >> 18) | 0xF0;
+			pBuffer[1] = (char)((CodePoint >> 12) & 0x3F) | 0x80;
+			pBuffer[2] = (char)((CodePoint >> 6) & 0x3F) | 0x80;
+			pBuffer[3] = (char)(CodePoint & 0x3F) | 0x80;
+		}
+		return 4;
+	}
+
+	return 0;
+}
+
+unsigned long UTF8_Encoding::Decode(unsigned char Units, const char* String)
+{
+	unsigned long CodePoint;
+
+	switch (Units)
+	{
+	case 1:
+		CodePoint = (unsigned char)String[0];
+		break;
+	case 2:
+		CodePoint = ((unsigned char)String[0] << 6 | (String[1] & 0x3F)) & 0x7FF;
+		break;
+	case 3:
+		CodePoint = ((unsigned char)String[0] << 12 | ((String[1] & 0x3F) << 6) | (String[2] & 0x3F)) & 0xFFFF;
+		break;
+	case 4:
+		CodePoint = ((unsigned char)String[0] << 18 | ((String[1] & 0x3F) << 12) | ((String[2] & 0x3F) << 6) | (String[3] & 0x3F)) & 0x1FFFFF;
+		break;
+	default:
+		return 0;
+	}
+
+	return CodePoint;
+}
+
+size_t UTF8_Encoding::GetStringUnits(const char* String)
+{
+	size_t TotalUnits, CharUnits;
+
+	if (String == NULL) return -1;
+	TotalUnits = 0;
+
+	while (*String != 0)
+	{
+		CharUnits = UTF8_Encoding::GetCharacterUnits(*String);
+		if (CharUnits == 0) return TotalUnits;
+		String += CharUnits;
+		TotalUnits += CharUnits;
+	}
+
+	return TotalUnits;
+}
+
+size_t UTF8_Encoding::StringCopy(char* Destination, size_t Length, const char* Source)
+{
+	unsigned char CharUnits;
+	size_t Len;
+
+	if ((Destination == NULL) || (Source == NULL) || (Length == 0)) return -1;
+	Len = 0;
+
+	while (*Source != 0)
+	{
+		CharUnits = UTF8_Encoding::GetCharacterUnits(*Source);
+		if (CharUnits == 0) break;
+		Len += CharUnits;
+		if (Len >= Length)
+		{
+			*Destination = 0;
+			return Length;
+		}
+		switch (CharUnits)
+		{
+		case 1:
+			Destination[0] = Source[0];
+			break;
+		case 2:
+			Destination[0] = Source[0];
+			Destination[1] = Source[1];
+			break;
+		case 3:
+			Destination[0] = Source[0];
+			Destination[1] = Source[1];
+			Destination[2] = Source[2];
+			break;
+		case 4:
+			Destination[0] = Source[0];
+			Destination[1] = Source[1];
+			Destination[2] = Source[2];
+			Destination[3] = Source[3];
+			break;
+		default:
+			break;
+		}
+		Destination += CharUnits;
+		Source += CharUnits;
+	}
+	*Destination = 0;
+
+	return Len;
+}
+
+long UTF8_Encoding::CompareStrings(const char* String1, const char* String2)
+{
+	unsigned char CharUnits1, CharUnits2;
+	unsigned long CodePoint1, CodePoint2;
+
+	if ((String1 == 0) || (String2 == 0)) {
+		return 0x7FFFFFFF;
+	}
+
+	while ((*String1 != 0) && (*String2 != 0))
+	{
+		CharUnits1 = UTF8_Encoding::GetCharacterUnits(*String1);
+		CharUnits2 = UTF8_Encoding::GetCharacterUnits(*String2);
+
+		if (CharUnits1 == 0) {
+			return 0x7FFFFFFF;
+		}
+
+		if (CharUnits2 == 0) {
+			return 0x7FFFFFFF;
+		}
+
+		CodePoint1 = UTF8_Encoding::Decode(CharUnits1, String1);
+		CodePoint2 = UTF8_Encoding::Decode(CharUnits2, String2);
+
+		if (CodePoint1 != CodePoint2)
+		{
+			if (CodePoint1 > CodePoint2) {
+				return 1;
+			}
+			else {
+				return -1;
+			}
+		}
+		String1 += CharUnits1;
+		String2 += CharUnits2;
+	}
+	if ((*String1 == 0) && (*String2 == 0)) {
+		return 0;
+	}
+	else
+	{
+		if (*String1 != 0) {
+			return 1;
+		}
+		else {
+			return -1;
+		}
+	}
+}
+
+long UTF8_Encoding::CompareStringsInsensitive(const char* String1, const char* String2)
+{
+	unsigned char CharUnits1, CharUnits2;
+	unsigned long CodePoint1, CodePoint2;
+
+	if ((String1 == 0) || (String2 == 0)) {
+		return 0x7FFFFFFF;
+	}
+
+	while ((*String1 != 0) && (*String2 != 0))
+	{
+		CharUnits1 = UTF8_Encoding::GetCharacterUnits(*String1);
+		CharUnits2 = UTF8_Encoding::GetCharacterUnits(*String2);
+
+		if (CharUnits1 == 0) {
+			return 0x7FFFFFFF;
+		}
+
+		if (CharUnits2 == 0) {
+			return 0x7FFFFFFF;
+		}
+
+		CodePoint1 = UTF8_Encoding::Decode(CharUnits1, String1);
+		CodePoint2 = UTF8_Encoding::Decode(CharUnits2, String2);
+
+		if ((CodePoint1 > 0x40) && (CodePoint1 < 0x5B)) {
+			CodePoint1 += 0x20;
+		}
+		else if ((CodePoint1 > 0xFF20) && (CodePoint1 < 0xFF3B)) {
+			CodePoint1 -= 0xFEE0;
+		}
+		else if ((CodePoint1 > 0xFF40) && (CodePoint1 < 0xFF5B)) {
+			CodePoint1 -= 0xFF00;
+		}
+
+		if ((CodePoint2 > 0x40) && (CodePoint2 < 0x5B)) {
+			CodePoint2 += 0x20;
+		}
+		else if ((CodePoint2 > 0xFF20) && (CodePoint2 < 0xFF3B)) {
+			CodePoint2 -= 0xFEE0;
+		}
+		else if ((CodePoint2 > 0xFF40) && (CodePoint2 < 0xFF5B)) {
+			CodePoint2 -= 0xFF00;
+		}
+
+		if (CodePoint1 != CodePoint2)
+		{
+			if (CodePoint1 > CodePoint2) {
+				return 1;
+			}
+			else {
+				return -1;
+			}
+		}
+		String1 += CharUnits1;
+		String2 += CharUnits2;
+	}
+	if ((*String1 == 0) && (*String2 == 0)) {
+		return 0;
+	}
+	else
+	{
+		if (*String1 != 0) {
+			return 1;
+		}
+		else {
+			return -1;
+		}
+	}
+}
+
+// ---------------------------- //
+// **   JSON_LEXER methods   ** //
+// ---------------------------- //
+
+JSON_LEXER::JSON_LEXER(const char* json)
+{
+	this->json = (json != NULL) ? json : "";
+	this->end = this->json + strlen(this->json);
+	this->Reset();
+}
+
+JSON_LEXER::JSON_LEXER(const char* json, size_t length)
+{
+	if (json == NULL) {
+		json = "";
+		length = 0;
+	}
+
+	this->json = json;
+	this->end = json + length;
+	this->Reset();
+}
+
+bool JSON_LEXER::Next(JSON_LEXER_TOKEN* token)
+{
+	const char* pBegin;
+	const char* pNext;
+	const char* pLineFeed;
+
+	pNext = json_ScanToken(this->position, this->end, &token->type, &pBegin, &this->lineNumber);
+
+	token->offset = (size_t)(pBegin - this->json);
+	token->length = (size_t)(pNext - pBegin);
+	token->lineNumber = this->lineNumber;
+
+	// Line feeds must be escaped in strings, but count them for invalid JSON
+	if ((token->type == JSON_TOKEN::STRING) || (token->type == JSON_TOKEN::UNTERMINATED_STRING))
+	{
+		pLineFeed = (const char*)memchr(pBegin, '\n', token->length);
+		while (pLineFeed != NULL) {
+			this->lineNumber++;
+			pLineFeed = (const char*)memchr(pLineFeed + 1, '\n', (size_t)(pNext - (pLineFeed + 1)));
+		}
+	}
+
+	this->position = pNext;
+
+	return (token->type != JSON_TOKEN::JSON_END);
+}
+
+void JSON_LEXER::Reset()
+{
+	this->position = this->json;
+	this->lineNumber = 1;
+}
+
+// ----------------------------------- //
+// **   JSON_POSITION_MAP methods   ** //
+// ----------------------------------- //
+
+// Initial number of entries in a position hash table, the table grows when it is more than half full
+#define JSON_POSITION_MAP_MIN_CAPACITY 64
+
+struct JSON_POSITION_MAP::ENTRY
+{
+	JSON_NODE* node;
+	JSON_POSITION position;
+};
+
+// Hash a node pointer, nodes are allocated at aligned addresses so the low bits are mixed in
+size_t json_PositionHash(JSON_NODE* node)
+{
+	unsigned long long hash;
+
+	hash = (unsigned long long)(size_t)node * 0x9E3779B97F4A7C15ULL;
+
+	return (size_t)(hash ^ (hash >> 32));
+}
+
+JSON_POSITION_MAP::JSON_POSITION_MAP(const JSON_ALLOCATOR* allocator)
+{
+	this->entries = NULL;
+	this->capacity = 0;
+	this->count = 0;
+	this->allocator = allocator;
+	this->json = NULL;
+}
+
+JSON_POSITION_MAP::~JSON_POSITION_MAP()
+{
+	json_Deallocate(this->allocator, this->entries);
+}
+
+const JSON_POSITION* JSON_POSITION_MAP::Find(JSON_NODE* node)
+{
+	size_t i;
+
+	if ((node == NULL) || (this->count == 0)) {
+		return NULL;
+	}
+
+	i = json_PositionHash(node) & (this->capacity - 1);
+	while (this->entries[i].node != NULL)
+	{
+		if (this->entries[i].node == node) {
+			return &this->entries[i].position;
+		}
+		i = (i + 1) & (this->capacity - 1);
+	}
+
+	return NULL;
+}
+
+bool JSON_POSITION_MAP::Insert(JSON_NODE* node, size_t offset, size_t length, unsigned long lineNumber)
+{
+	ENTRY* entries;
+	size_t capacity;
+	size_t i, j;
+
+	if (node == NULL) {
+		return false;
+	}
+
+	if ((this->count + 1) * 2 > this->capacity)
+	{
+		capacity = (this->capacity != 0) ? this->capacity * 2 : JSON_POSITION_MAP_MIN_CAPACITY;
+
+		entries = (ENTRY*)json_Allocate(this->allocator, capacity * sizeof(ENTRY));
+		if (entries == NULL) {
+			return false;
+		}
+		memset(entries, 0, capacity * sizeof(ENTRY));
+
+		// Move the entries to the new hash table
+		for (i = 0; i < this->capacity; i++)
+		{
+			if (this->entries[i].node != NULL)
+			{
+				j = json_PositionHash(this->entries[i].node) & (capacity - 1);
+				while (entries[j].node != NULL) {
+					j = (j + 1) & (capacity - 1);
+				}
+				entries[j] = this->entries[i];
+			}
+		}
+
+		json_Deallocate(this->allocator, this->entries);
+		this->entries = entries;
+		this->capacity = capacity;
+	}
+
+	i = json_PositionHash(node) & (this->capacity - 1);
+	while ((this->entries[i].node != NULL) && (this->entries[i].node != node)) {
+		i = (i + 1) & (this->capacity - 1);
+	}
+
+	if (this->entries[i].node == NULL) {
+		this->entries[i].node = node;
+		this->count++;
+	}
+
+	this->entries[i].position.offset = offset;
+	this->entries[i].position.length = length;
+	this->entries[i].position.lineNumber = lineNumber;
+
+	return true;
+}
+
+void JSON_POSITION_MAP::Clear()
+{
+	if (this->count != 0) {
+		memset(this->entries, 0, this->capacity * sizeof(ENTRY));
+		this->count = 0;
+	}
+}
+
+size_t JSON_POSITION_MAP::Count()
+{
+	return this->count;
+}
+
+// ------------------------------ //
+// **   JSON_POINTER methods   ** //
+// ------------------------------ //
+
+// Value of JSON_POINTER::TOKEN::index when the reference token is not an array index
+#define JSON_POINTER_NO_INDEX ((unsigned long)-1)
+
+struct JSON_POINTER::TOKEN
+{
+	// Unescaped key
+	const char* key;
+	size_t length;
+	unsigned int hash;
+	// Array index, JSON_POINTER_NO_INDEX if the token is not a number without leading zeros
+	unsigned long index;
+};
+
+// Get the array index of a reference token, JSON_POINTER_NO_INDEX if it is not an array index
+unsigned long json_PointerIndex(const char* key, size_t length)
+{
+	unsigned long index;
+	size_t i;
+
+	// "0" or a number without leading zeros, "-" (after the last item) is never found
+	if ((length == 0) || ((key[0] == '0') && (length > 1))) {
+		return JSON_POINTER_NO_INDEX;
+	}
+
+	index = 0;
+	for (i = 0; i < length; i++)
+	{
+		if ((key[i] < '0') || (key[i] > '9')) {
+			return JSON_POINTER_NO_INDEX;
+		}
+		if (index > (JSON_POINTER_NO_INDEX - 1 - (unsigned long)(key[i] - '0')) / 10) {
+			return JSON_POINTER_NO_INDEX;
+		}
+		index = (index * 10) + (unsigned long)(key[i] - '0');
+	}
+
+	return index;
+}
+
+JSON_POINTER::JSON_POINTER(const JSON_ALLOCATOR* allocator)
+{
+	this->tokens = NULL;
+	this->count = 0;
+	this->compiled = false;
+	this->path = NULL;
+	this->stamps = NULL;
+	this->pathLength = 0;
+	this->result = NULL;
+	this->allocator = allocator;
+}
+
+JSON_POINTER::JSON_POINTER(const char* pointer, const JSON_ALLOCATOR* allocator) : JSON_POINTER(allocator)
+{
+	this->Compile(pointer);
+}
+
+JSON_POINTER::~JSON_POINTER()
+{
+	json_Deallocate(this->allocator, this->tokens);
+}
+
+bool JSON_POINTER::Compile(const char* pointer)
+{
+	return this->Compile(pointer, (pointer != NULL) ? strlen(pointer) : 0);
+}
+
+bool JSON_POINTER::Compile(const char* pointer, size_t length)
+{
+	TOKEN* tokens;
+	char* keys;
+	size_t count;
+	size_t i, k;
+	unsigned char* block;
+
+	json_Deallocate(this->allocator, this->tokens);
+	this->tokens = NULL;
+	this->count = 0;
+	this->compiled = false;
+	this->path = NULL;
+	this->stamps = NULL;
+	this->pathLength = 0;
+	this->result = NULL;
+
+	if ((pointer == NULL) || ((length != 0) && (pointer[0] != '/'))) {
+		return false;
+	}
+
+	count = 0;
+	for (i = 0; i < length; i++)
+	{
+		if (pointer[i] == '/') {
+			count++;
+		}
+		else if ((pointer[i] == '~') && ((i + 1 == length) || ((pointer[i + 1] != '0') && (pointer[i + 1] != '1')))) {
+			return false;
+		}
+	}
+
+	// One block for the tokens, the resolve path, the stamps of the path and the unescaped keys
+	block = (unsigned char*)json_Allocate(this->allocator,
+		count * (sizeof(TOKEN) + sizeof(JSON_NODE*) + sizeof(unsigned long long)) + length + 1);
+	if (block == NULL) {
+		return false;
+	}
+
+	tokens = (TOKEN*)block;
+	this->stamps = (unsigned long long*)(block + count * sizeof(TOKEN));
+	this->path = (JSON_NODE**)(block + count * (sizeof(TOKEN) + sizeof(unsigned long long)));
+	keys = (char*)(block + count * (sizeof(TOKEN) + sizeof(unsigned long long) + sizeof(JSON_NODE*)));
+
+	k = 0;
+	i = 0;
+	while (i < length)
+	{
+		// Skip the '/' in front of the token
+		i++;
+
+		tokens[k].key = keys;
+		tokens[k].length = 0;
+
+		while ((i < length) && (pointer[i] != '/'))
+		{
+			if (pointer[i] == '~')
+			{
+				keys[tokens[k].length++] = (pointer[i + 1] == '0') ? '~' : '/';
+				i += 2;
+			}
+			else {
+				keys[tokens[k].length++] = pointer[i++];
+			}
+		}
+
+		tokens[k].hash = json_HashKey(tokens[k].key, tokens[k].length);
+		tokens[k].index = json_PointerIndex(tokens[k].key, tokens[k].length);
+
+		keys += tokens[k].length;
+		k++;
+	}
+
+	this->tokens = tokens;
+	this->count = count;
+	this->compiled = true;
+
+	return true;
+}
+
+JSON_NODE* JSON_POINTER::Resolve(JSON_NODE* root, bool useCache)
+{
+	JSON_LOOKUP_KEY lookupKey;
+	JSON_NODE_EXTRA* extra;
+	JSON_NODE* node;
+	bool cacheable;
+	size_t i;
+
+	if ((!this->compiled) || (root == NULL)) {
+		return NULL;
+	}
+
+	// The objects and arrays on the path still have the same items if their stamps did not change
+	// The first one is the root, so every other one is still an item of the one before it
+	if ((useCache) && (this->pathLength != 0) && (this->path[0] == root))
+	{
+		for (i = 0; i < this->pathLength; i++)
+		{
+			// A root that was freed and allocated again at the same memory may have no side block
+			extra = json_NodeExtra(this->path[i], false);
+			if ((extra == NULL) || (extra->stamp != this->stamps[i])) {
+				break;
+			}
+		}
+		if (i == this->pathLength) {
+			return this->result;
+		}
+	}
+
+	this->pathLength = 0;
+	cacheable = true;
+
+	node = root;
+	for (i = 0; (i < this->count) && (node != NULL); i++)
+	{
+		if (json_IsContainer(node->type))
+		{
+			// Only objects and arrays with a side block have a change stamp, it is allocated for them here
+			extra = json_NodeExtra(node, true);
+			if (extra != NULL)
+			{
+				this->path[this->pathLength] = node;
+				this->stamps[this->pathLength] = extra->stamp;
+				this->pathLength++;
+			}
+			else {
+				cacheable = false;
+			}
+		}
+
+		if (node->type == JSON_TYPE::OBJECT)
+		{
+			lookupKey.key = this->tokens[i].key;
+			lookupKey.length = this->tokens[i].length;
+			lookupKey.hash = this->tokens[i].hash;
+			node = json_FindKey(node, &lookupKey, NULL);
+		}
+		else if ((node->type == JSON_TYPE::ARRAY) && (this->tokens[i].index != JSON_POINTER_NO_INDEX)) {
+			node = json_GetItem(node, this->tokens[i].index);
+		}
+		else {
+			node = NULL;
+		}
+	}
+
+	if (!cacheable) {
+		this->pathLength = 0;
+	}
+
+	this->result = node;
+
+	return node;
+}
+
+size_t JSON_POINTER::Count()
+{
+	return this->count;
+}
+
+// ------------------------------ //
+// **   JSON patch functions   ** //
+// ------------------------------ //
+
+// Change made to a tree by a patch, the changes are undone in reverse order when an operation fails
+enum class JSON_PATCH_CHANGE_TYPE
+{
+	LINK,
+	UNLINK,
+	KEY,
+	ROOT
+};
+
+struct JSON_PATCH_CHANGE
+{
+	JSON_PATCH_CHANGE_TYPE type;
+	// Object or array of the item, the item in front of it and its index in an array, when it was linked or unlinked
+	// When the root was replaced, `node` is the root and `prev_node` the node that holds the old value of the root
+	JSON_NODE* container;
+	JSON_NODE* node;
+	JSON_NODE* prev_node;
+	size_t index;
+	// The patch created the linked node or removed the unlinked node, it is freed when the change is undone or kept
+	bool owned;
+	// Key of the node before it was moved
+	char* key;
+};
+
+struct JSON_PATCH_STATE
+{
+	// Allocator of the tree
+	const JSON_ALLOCATOR* allocator;
+	JSON_PATCH_CHANGE* changes;
+	size_t count;
+	size_t capacity;
+	// Unescaped reference tokens of a pointer
+	char* buffer;
+	size_t bufferSize;
+};
+
+// Location a JSON Pointer refers to in a tree
+struct JSON_PATCH_LOCATION
+{
+	// Object or array with the node, NULL when the pointer refers to the root
+	JSON_NODE* parent;
+	// Node the pointer refers to, NULL if there is no such node
+	JSON_NODE* node;
+	// Last reference token
+	const char* key;
+	size_t keyLength;
+	// Index of the node in an array, the number of items for "-"
+	size_t index;
+};
+
+// Copy a string of `length` bytes, NULL if there is not enough memory
+char* json_PatchDuplicate(const JSON_ALLOCATOR* allocator, const char* text, size_t length)
+{
+	char* copy;
+
+	copy = (char*)json_Allocate(allocator, length + 1);
+	if (copy == NULL) {
+		return NULL;
+	}
+
+	memcpy(copy, text, length);
+	copy[length] = '\0';
+
+	return copy;
+}
+
+// Copy a value from a patch with all of its child nodes, the copy has no key
+// `dropNulls` leaves out the members of objects with a null value, as a JSON Merge Patch does
+// `hasHeader` gives the copy a header, objects and arrays always have one
+JSON_NODE* json_PatchCopy(JSON_NODE* node, const JSON_ALLOCATOR* allocator, bool dropNulls, bool hasHeader)
+{
+	JSON_NODE* copy;
+	JSON_NODE* item;
+	JSON_NODE* itemCopy;
+	JSON_NODE* tail;
+	char* key;
+
+	copy = json_AllocateNode(allocator, node->type, hasHeader);
+	if (copy == NULL) {
+		return NULL;
+	}
+
+	if (json_IsContainer(node->type))
+	{
+		tail = NULL;
+		for (item = (JSON_NODE*)node->value; item != NULL; item = item->next)
+		{
+			if ((dropNulls) && (node->type == JSON_TYPE::OBJECT) && (item->type == JSON_TYPE::NULL_TYPE)) {
+				continue;
+			}
+
+			itemCopy = json_PatchCopy(item, allocator, (dropNulls) && (node->type == JSON_TYPE::OBJECT), false);
+			if (itemCopy == NULL) {
+				json_free_node(copy, allocator);
+				return NULL;
+			}
+
+			if (item->key != NULL)
+			{
+				key = json_PatchDuplicate(allocator, item->key, strlen(item->key));
+				if (key == NULL) {
+					json_free_node(itemCopy, allocator);
+					json_free_node(copy, allocator);
+					return NULL;
+				}
+				json_SetKey(itemCopy, key);
+			}
+
+			if (tail == NULL) {
+				copy->value = itemCopy;
+			}
+			else {
+				tail->next = itemCopy;
+			}
+			tail = itemCopy;
+		}
+	}
+	else if (((node->type == JSON_TYPE::STRING) || (node->type == JSON_TYPE::NUMBER)) && (node->value != NULL))
+	{
+		copy->value = json_PatchDuplicate(allocator, (const char*)node->value, strlen((const char*)node->value));
+		if (copy->value == NULL) {
+			json_free_node(copy, allocator);
+			return NULL;
+		}
+	}
+	else {
+		copy->value = node->value;
+	}
+
+	return copy;
+}
+
+// Record a change before it is made, returns false if there is not enough memory and the change must not be made
+bool json_PatchRecord(JSON_PATCH_STATE* state, JSON_PATCH_CHANGE_TYPE type, JSON_NODE* container, JSON_NODE* node, JSON_NODE* prev_node, size_t index, bool owned)
+{
+	JSON_PATCH_CHANGE* changes;
+	JSON_PATCH_CHANGE* change;
+	size_t capacity;
+
+	if (state->count == state->capacity)
+	{
+		capacity = (state->capacity != 0) ? state->capacity * 2 : 16;
+		changes = (JSON_PATCH_CHANGE*)json_Reallocate(state->allocator, state->changes, capacity * sizeof(JSON_PATCH_CHANGE));
+		if (changes == NULL) {
+			return false;
+		}
+		state->changes = changes;
+		state->capacity = capacity;
+	}
+
+	change = &state->changes[state->count++];
+	change->type = type;
+	change->container = container;
+	change->node = node;
+	change->prev_node = prev_node;
+	change->index = index;
+	change->owned = owned;
+	change->key = node->key;
+
+	return true;
+}
+
+// Get the value of a node to give it to `target`, a value in the inline storage of the node is copied into `target`
+// Only one of the 2 nodes that swap their values can have a value in the inline storage
+void* json_PatchMoveValue(JSON_NODE* node, JSON_NODE* target)
+{
+	size_t space;
+
+	if ((node->value == NULL) || (!json_IsInline(node, node->value))) {
+		return node->value;
+	}
+
+	return memcpy(json_InlineSpace(target, false, &space), node->value, strlen((const char*)node->value) + 1);
+}
+
+// Swap the types and values of 2 nodes, the items of an object or array move with it
+// Both nodes have a header when one of the values is an object or array, they don't share their items with a clone
+void json_PatchSwapValues(JSON_NODE* node1, JSON_NODE* node2)
+{
+	JSON_TYPE type;
+	void* value;
+
+	json_DropIndex(node1);
+	json_ForgetTail(node1);
+	json_DropIndex(node2);
+	json_ForgetTail(node2);
+
+	type = node1->type;
+	value = json_PatchMoveValue(node1, node2);
+	node1->value = json_PatchMoveValue(node2, node1);
+	node1->type = node2->type;
+	node2->value = value;
+	node2->type = type;
+}
+
+// Undo the changes of a patch in reverse order, the tree is the same as before the patch
+void json_PatchUndo(JSON_PATCH_STATE* state)
+{
+	JSON_PATCH_CHANGE* change;
+	size_t i;
+
+	for (i = state->count; i > 0; i--)
+	{
+		change = &state->changes[i - 1];
+
+		switch (change->type)
+		{
+		case JSON_PATCH_CHANGE_TYPE::LINK:
+			json_UnlinkNode(change->container, change->node, change->prev_node, change->index);
+			if (change->owned) {
+				json_free_node(change->node, json_NodeAllocator(change->container, state->allocator));
+			}
+			break;
+		case JSON_PATCH_CHANGE_TYPE::UNLINK:
+			json_LinkAfter(change->container, change->node, change->prev_node, change->index);
+			break;
+		case JSON_PATCH_CHANGE_TYPE::KEY:
+			json_FreeString(change->node, change->node->key, json_NodeAllocator(change->node, state->allocator));
+			json_SetKey(change->node, change->key);
+			break;
+		case JSON_PATCH_CHANGE_TYPE::ROOT:
+			json_PatchSwapValues(change->node, change->prev_node);
+			json_free_node(change->prev_node, state->allocator);
+			break;
+		}
+	}
+
+	state->count = 0;
+}
+
+// Keep the changes of a patch, the removed nodes and the old keys of moved nodes are freed
+void json_PatchCommit(JSON_PATCH_STATE* state)
+{
+	JSON_PATCH_CHANGE* change;
+	size_t i;
+
+	for (i = 0; i < state->count; i++)
+	{
+		change = &state->changes[i];
+
+		if ((change->type == JSON_PATCH_CHANGE_TYPE::UNLINK) && (change->owned)) {
+			json_free_node(change->node, json_NodeAllocator(change->container, state->allocator));
+		}
+		else if (change->type == JSON_PATCH_CHANGE_TYPE::KEY) {
+			json_FreeString(change->node, change->key, json_NodeAllocator(change->node, state->allocator));
+		}
+		else if (change->type == JSON_PATCH_CHANGE_TYPE::ROOT) {
+			json_free_node(change->prev_node, state->allocator);
+		}
+	}
+
+	state->count = 0;
+}
+
+// Find the location of a JSON Pointer in a tree
+// With `change` the objects and arrays on the path get their own item lists when they share them with a clone, so they can be changed
+bool json_PatchLocate(JSON_PATCH_STATE* state, JSON_NODE* root, const char* pointer, bool change, JSON_PATCH_LOCATION* location)
+{
+	JSON_LOOKUP_KEY lookupKey;
+	const char* p;
+	const char* end;
+	char* buffer;
+	size_t length;
+
+	length = strlen(pointer);
+	if ((length != 0) && (pointer[0] != '/')) {
+		return false;
+	}
+
+	// The tokens are unescaped one after another, they are never longer than the pointer
+	if (state->bufferSize < length + 1)
+	{
+		buffer = (char*)json_Reallocate(state->allocator, state->buffer, length + 1);
+		if (buffer == NULL) {
+			return false;
+		}
+		state->buffer = buffer;
+		state->bufferSize = length + 1;
+	}
+
+	location->parent = NULL;
+	location->node = root;
+	location->key = NULL;
+	location->keyLength = 0;
+	location->index = 0;
+
+	p = pointer;
+	end = pointer + length;
+	while (p < end)
+	{
+		if ((location->node == NULL) || (!json_IsContainer(location->node->type))) {
+			return false;
+		}
+		if ((change) && (!json_Unshare(location->node))) {
+			return false;
+		}
+
+		// Skip the '/' in front of the token
+		p++;
+
+		length = 0;
+		while ((p < end) && (*p != '/'))
+		{
+			if (*p == '~')
+			{
+				if ((p + 1 == end) || ((p[1] != '0') && (p[1] != '1'))) {
+					return false;
+				}
+				state->buffer[length++] = (p[1] == '0') ? '~' : '/';
+				p += 2;
+			}
+			else {
+				state->buffer[length++] = *p++;
+			}
+		}
+
+		location->parent = location->node;
+		location->key = state->buffer;
+		location->keyLength = length;
+
+		if (location->parent->type == JSON_TYPE::OBJECT)
+		{
+			json_LookupKey(&lookupKey, state->buffer, length);
+			location->node = json_FindKey(location->parent, &lookupKey, NULL);
+		}
+		else if ((length == 1) && (state->buffer[0] == '-'))
+		{
+			location->index = json_CountItems(location->parent);
+			location->node = NULL;
+		}
+		else
+		{
+			location->index = json_PointerIndex(state->buffer, length);
+			if (location->index == JSON_POINTER_NO_INDEX) {
+				return false;
+			}
+			location->node = json_GetItem(location->parent, (unsigned long)location->index);
+		}
+	}
+
+	return true;
+}
+
+// Get the item in front of the node at a location, NULL if it is the 1st item
+JSON_NODE* json_PatchPrevious(JSON_PATCH_LOCATION* location)
+{
+	JSON_NODE* node;
+	JSON_NODE* prev_node;
+
+	if (location->parent->type == JSON_TYPE::ARRAY) {
+		return (location->index > 0) ? json_GetItem(location->parent, (unsigned long)(location->index - 1)) : NULL;
+	}
+
+	prev_node = NULL;
+	for (node = (JSON_NODE*)location->parent->value; (node != NULL) && (node != location->node); node = node->next) {
+		prev_node = node;
+	}
+
+	return prev_node;
+}
+
+// Remove the node at a location, `owned` is false when the node is linked in again by a move
+// `pPrevNode` receives the item that was in front of the node
+bool json_PatchRemove(JSON_PATCH_STATE* state, JSON_PATCH_LOCATION* location, bool owned, JSON_NODE** pPrevNode)
+{
+	JSON_NODE* prev_node;
+
+	if ((location->parent == NULL) || (location->node == NULL)) {
+		return false;
+	}
+
+	prev_node = json_PatchPrevious(location);
+
+	if (!json_PatchRecord(state, JSON_PATCH_CHANGE_TYPE::UNLINK, location->parent, location->node, prev_node, location->index, owned)) {
+		return false;
+	}
+
+	json_UnlinkNode(location->parent, location->node, prev_node, location->index);
+
+	if (pPrevNode != NULL) {
+		*pPrevNode = prev_node;
+	}
+
+	return true;
+}
+
+// Give a node the key of a location, or no key in an array
+// A node that is `owned` is new, the key of a moved node is recorded so it can be restored
+bool json_PatchKey(JSON_PATCH_STATE* state, JSON_PATCH_LOCATION* location, JSON_NODE* node, bool owned)
+{
+	const JSON_ALLOCATOR* allocator;
+	char* key;
+
+	allocator = json_NodeAllocator(node, json_NodeAllocator(location->parent, state->allocator));
+
+	key = NULL;
+	if (location->parent->type == JSON_TYPE::OBJECT)
+	{
+		key = json_PatchDuplicate(allocator, location->key, location->keyLength);
+		if (key == NULL) {
+			return false;
+		}
+	}
+	else if ((owned) || (node->key == NULL)) {
+		return true;
+	}
+
+	if ((!owned) && (!json_PatchRecord(state, JSON_PATCH_CHANGE_TYPE::KEY, location->parent, node, NULL, 0, false)))
+	{
+		json_Deallocate(allocator, key);
+		return false;
+	}
+
+	json_SetKey(node, key);
+
+	return true;
+}
+
+// Add a node at a location, a member of an object with the same key is replaced in its place
+// `owned` is false when the node was removed by a move, the caller frees a node that is owned if it can't be added
+bool json_PatchAdd(JSON_PATCH_STATE* state, JSON_PATCH_LOCATION* location, JSON_NODE* node, bool owned)
+{
+	JSON_NODE* prev_node;
+
+	if (location->parent == NULL) {
+		return false;
+	}
+
+	if (location->parent->type == JSON_TYPE::OBJECT)
+	{
+		if (!json_PatchKey(state, location, node, owned)) {
+			return false;
+		}
+
+		if (location->node == NULL) {
+			prev_node = json_GetTail(location->parent);
+		}
+		else if (!json_PatchRemove(state, location, true, &prev_node)) {
+			return false;
+		}
+	}
+	else
+	{
+		if ((location->index > json_CountItems(location->parent)) ||
+			(!json_PatchKey(state, location, node, owned))) {
+			return false;
+		}
+
+		prev_node = (location->index > 0) ? json_GetItem(location->parent, (unsigned long)(location->index - 1)) : NULL;
+	}
+
+	if (!json_PatchRecord(state, JSON_PATCH_CHANGE_TYPE::LINK, location->parent, node, prev_node, location->index, owned)) {
+		return false;
+	}
+
+	json_LinkAfter(location->parent, node, prev_node, location->index);
+
+	return true;
+}
+
+// Replace the value of the root with `node` in place, the root keeps its key and format and its place in memory
+// `node` gets the old value of the root, it is freed when the patch is kept, the caller frees it if this fails
+// `node` must have a header when the root has one, a root without a header can't get an object or array
+bool json_PatchReplaceRoot(JSON_PATCH_STATE* state, JSON_NODE* root, JSON_NODE* node)
+{
+	if ((((root->flags & JSON_NODE_FLAG_HEADER) == 0) && (json_IsContainer(node->type))) || (!json_Unshare(root))) {
+		return false;
+	}
+
+	if (!json_PatchRecord(state, JSON_PATCH_CHANGE_TYPE::ROOT, NULL, root, node, 0, true)) {
+		return false;
+	}
+
+	json_PatchSwapValues(root, node);
+
+	return true;
+}
+
+// Replace the value of the root with a copy of `value`, `dropNulls` is passed to json_PatchCopy
+bool json_PatchReplaceRootCopy(JSON_PATCH_STATE* state, JSON_NODE* root, JSON_NODE* value, bool dropNulls)
+{
+	JSON_NODE* node;
+
+	node = json_PatchCopy(value, state->allocator, dropNulls, (root->flags & JSON_NODE_FLAG_HEADER) != 0);
+	if (node == NULL) {
+		return false;
+	}
+
+	if (!json_PatchReplaceRoot(state, root, node))
+	{
+		json_free_node(node, state->allocator);
+		return false;
+	}
+
+	return true;
+}
+
+// Get a string member of a patch operation, NULL if the operation has no such string
+const char* json_PatchString(JSON_NODE* operation, const char* key)
+{
+	JSON_TYPE type;
+	JSON_NODE* node;
+
+	type = JSON_TYPE::STRING;
+	node = json_FindMember(operation, key, strlen(key), &type);
+
+	return (node != NULL) ? (const char*)node->value : NULL;
+}
+
+// Apply a JSON Patch operation (RFC 6902) to a tree, returns false if it fails
+bool json_PatchOperation(JSON_PATCH_STATE* state, JSON_NODE* root, JSON_NODE* operation)
+{
+	JSON_PATCH_LOCATION location;
+	const JSON_ALLOCATOR* allocator;
+	const char* op;
+	const char* path;
+	const char* from;
+	JSON_NODE* value;
+	JSON_NODE* node;
+	size_t length;
+
+	if (operation->type != JSON_TYPE::OBJECT) {
+		return false;
+	}
+
+	op = json_PatchString(operation, "op");
+	path = json_PatchString(operation, "path");
+	if ((op == NULL) || (path == NULL)) {
+		return false;
+	}
+
+	from = json_PatchString(operation, "from");
+	value = json_FindMember(operation, "value", 5, NULL);
+
+	if (strcmp(op, "test") == 0)
+	{
+		return ((value != NULL) && (json_PatchLocate(state, root, path, false, &location)) && (location.node != NULL) &&
+			(json_Equal(location.node, value, true, json_HashEpoch())));
+	}
+
+	if (strcmp(op, "remove") == 0) {
+		return ((json_PatchLocate(state, root, path, true, &location)) && (json_PatchRemove(state, &location, true, NULL)));
+	}
+
+	if ((strcmp(op, "add") == 0) || (strcmp(op, "replace") == 0) || (strcmp(op, "copy") == 0))
+	{
+		if (op[0] == 'c')
+		{
+			if ((from == NULL) || (!json_PatchLocate(state, root, from, false, &location)) || (location.node == NULL)) {
+				return false;
+			}
+			value = location.node;
+		}
+		else if (value == NULL) {
+			return false;
+		}
+
+		if ((!json_PatchLocate(state, root, path, true, &location)) || ((op[0] == 'r') && (location.node == NULL))) {
+			return false;
+		}
+
+		// A path of "" replaces the whole tree, the root is changed in place
+		if (location.parent == NULL) {
+			return json_PatchReplaceRootCopy(state, root, value, false);
+		}
+
+		// The value of the operation is copied with the allocator of the tree
+		allocator = json_NodeAllocator(location.parent, state->allocator);
+
+		node = json_PatchCopy(value, allocator, false, false);
+		if (node == NULL) {
+			return false;
+		}
+
+		// A replaced item of an array is removed, the new item gets its index
+		if ((op[0] == 'r') && (location.parent->type == JSON_TYPE::ARRAY) && (!json_PatchRemove(state, &location, true, NULL)))
+		{
+			json_free_node(node, allocator);
+			return false;
+		}
+
+		if (!json_PatchAdd(state, &location, node, true))
+		{
+			json_free_node(node, allocator);
+			return false;
+		}
+
+		return true;
+	}
+
+	if (strcmp(op, "move") == 0)
+	{
+		if (from == NULL) {
+			return false;
+		}
+
+		// A value can't be moved into one of its children
+		length = strlen(from);
+		if ((strncmp(path, from, length) == 0) && (path[length] == '/')) {
+			return false;
+		}
+
+		if ((!json_PatchLocate(state, root, from, true, &location)) || (location.node == NULL)) {
+			return false;
+		}
+		if (strcmp(path, from) == 0) {
+			return true;
+		}
+
+		// Moving a value to the root replaces the tree with the value, the rest of the tree is removed with the old root
+		if (path[0] == '\0') {
+			return json_PatchReplaceRootCopy(state, root, location.node, false);
+		}
+
+		node = location.node;
+
+		return ((json_PatchRemove(state, &location, false, NULL)) &&
+			(json_PatchLocate(state, root, path, true, &location)) &&
+			(json_PatchAdd(state, &location, node, false)));
+	}
+
+	return false;
+}
+
+// Merge a JSON Merge Patch object (RFC 7396) into an object
+bool json_MergePatch(JSON_PATCH_STATE* state, JSON_NODE* object, JSON_NODE* patch)
+{
+	JSON_PATCH_LOCATION location;
+	const JSON_ALLOCATOR* allocator;
+	JSON_LOOKUP_KEY lookupKey;
+	JSON_NODE* member;
+	JSON_NODE* node;
+
+	if (patch->value == NULL) {
+		return true;
+	}
+
+	if (!json_Unshare(object)) {
+		return false;
+	}
+
+	allocator = json_NodeAllocator(object, state->allocator);
+
+	for (member = (JSON_NODE*)patch->value; member != NULL; member = member->next)
+	{
+		if (!json_NodeKey(member, &lookupKey)) {
+			continue;
+		}
+
+		location.parent = object;
+		location.node = json_FindKey(object, &lookupKey, NULL);
+		location.key = lookupKey.key;
+		location.keyLength = lookupKey.length;
+		location.index = 0;
+
+		// A null value removes the member, an object is merged into an object with the same key
+		if (member->type == JSON_TYPE::NULL_TYPE)
+		{
+			if ((location.node != NULL) && (!json_PatchRemove(state, &location, true, NULL))) {
+				return false;
+			}
+		}
+		else if ((member->type == JSON_TYPE::OBJECT) && (location.node != NULL) && (location.node->type == JSON_TYPE::OBJECT))
+		{
+			if (!json_MergePatch(state, location.node, member)) {
+				return false;
+			}
+		}
+		else
+		{
+			node = json_PatchCopy(member, allocator, true, false);
+			if (node == NULL) {
+				return false;
+			}
+			if (!json_PatchAdd(state, &location, node, true))
+			{
+				json_free_node(node, allocator);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Free the changes and the pointer buffer of a patch
+void json_PatchFree(JSON_PATCH_STATE* state)
+{
+	json_Deallocate(state->allocator, state->changes);
+	json_Deallocate(state->allocator, state->buffer);
+}
+
+bool json_plus::JSON_Patch(JSON_NODE* json_root, JSON_NODE* patch, size_t* pFailedOperation)
+{
+	JSON_PATCH_STATE state;
+	JSON_NODE* operation;
+	size_t i;
+
+	if ((json_root == NULL) || (patch == NULL) || (patch->type != JSON_TYPE::ARRAY)) {
+		return false;
+	}
+
+	memset(&state, 0, sizeof(state));
+	state.allocator = json_NodeAllocator(json_root, NULL);
+
+	i = 0;
+	for (operation = (JSON_NODE*)patch->value; operation != NULL; operation = operation->next)
+	{
+		// The tree is left as it was before the patch when an operation fails
+		if (!json_PatchOperation(&state, json_root, operation))
+		{
+			json_PatchUndo(&state);
+			json_PatchFree(&state);
+			if (pFailedOperation != NULL) {
+				*pFailedOperation = i;
+			}
+			return false;
+		}
+		i++;
+	}
+
+	json_PatchCommit(&state);
+	json_PatchFree(&state);
+
+	return true;
+}
+
+bool json_plus::JSON_MergePatch(JSON_NODE* json_root, JSON_NODE* patch)
+{
+	JSON_PATCH_STATE state;
+	JSON_NODE* object;
+	bool result;
+
+	if ((json_root == NULL) || (patch == NULL)) {
+		return false;
+	}
+
+	memset(&state, 0, sizeof(state));
+	state.allocator = json_NodeAllocator(json_root, NULL);
+
+	// A patch that is not an object replaces the root, a root that is not an object is replaced by an empty object first
+	if (patch->type != JSON_TYPE::OBJECT) {
+		result = json_PatchReplaceRootCopy(&state, json_root, patch, false);
+	}
+	else if (json_root->type != JSON_TYPE::OBJECT)
+	{
+		object = json_AllocateNode(state.allocator, JSON_TYPE::OBJECT, true);
+		result = ((object != NULL) && (json_PatchReplaceRoot(&state, json_root, object)));
+		if ((object != NULL) && (!result)) {
+			json_free_node(object, state.allocator);
+		}
+		result = ((result) && (json_MergePatch(&state, json_root, patch)));
+	}
+	else {
+		result = json_MergePatch(&state, json_root, patch);
+	}
+
+	if (!result)
+	{
+		json_PatchUndo(&state);
+		json_PatchFree(&state);
+		return false;
+	}
+
+	json_PatchCommit(&state);
+	json_PatchFree(&state);
+
+	return true;
+}
+
+// ----------------------------- //
+// **   JSON diff functions   ** //
+// ----------------------------- //
+
+struct JSON_DIFF_STATE
+{
+	// Allocator of the patch
+	const JSON_ALLOCATOR* allocator;
+	// Array of patch operations
+	JSON_NODE* patch;
+	// JSON Pointer of the compared values
+	char* path;
+	size_t pathLength;
+	size_t pathCapacity;
+	// The trees are not changed while they are compared, so their hashes are checked once with the same epoch
+	unsigned long long epoch;
+};
+
+// Slot of the hash table that finds the items of 2 arrays that are unique in both
+struct JSON_DIFF_SLOT
+{
+	unsigned long long hash;
+	size_t countA;
+	size_t countB;
+	size_t indexA;
+	size_t indexB;
+};
+
+// Append a reference token to the path, `/` and `~` in the token are escaped
+bool json_DiffPush(JSON_DIFF_STATE* state, const char* token, size_t length)
+{
+	char* path;
+	size_t capacity;
+	size_t i;
+
+	// Every byte of the token can be escaped, with room for the '/' and the null character
+	if (state->pathLength + (length * 2) + 2 > state->pathCapacity)
+	{
+		capacity = (state->pathLength + (length * 2) + 2) * 2;
+		path = (char*)json_Reallocate(state->allocator, state->path, capacity);
+		if (path == NULL) {
+			return false;
+		}
+		state->path = path;
+		state->pathCapacity = capacity;
+	}
+
+	state->path[state->pathLength++] = '/';
+	for (i = 0; i < length; i++)
+	{
+		if (token[i] == '~')
+		{
+			state->path[state->pathLength++] = '~';
+			state->path[state->pathLength++] = '0';
+		}
+		else if (token[i] == '/')
+		{
+			state->path[state->pathLength++] = '~';
+			state->path[state->pathLength++] = '1';
+		}
+		else {
+			state->path[state->pathLength++] = token[i];
+		}
+	}
+	state->path[state->pathLength] = '\0';
+
+	return true;
+}
+
+// Append an array index to the path
+bool json_DiffPushIndex(JSON_DIFF_STATE* state, size_t index)
+{
+	char token[32];
+
+	snprintf(token, 32, "%llu", (unsigned long long)index);
+
+	return json_DiffPush(state, token, strlen(token));
+}
+
+// Add a member to an object of the patch, the member takes the key and the node
+bool json_DiffMember(JSON_NODE* object, const char* key, JSON_NODE* node, const JSON_ALLOCATOR* allocator)
+{
+	char* keyCopy;
+
+	keyCopy = json_PatchDuplicate(allocator, key, strlen(key));
+	if (keyCopy == NULL) {
+		json_free_node(node, allocator);
+		return false;
+	}
+	json_SetKey(node, keyCopy);
+
+	if (!json_LinkNode(object, node, true)) {
+		json_free_node(node, allocator);
+		return false;
+	}
+
+	return true;
+}
+
+// Add a string member to an object of the patch
+bool json_DiffString(JSON_NODE* object, const char* key, const char* string, size_t length, const JSON_ALLOCATOR* allocator)
+{
+	JSON_NODE* node;
+
+	node = json_AllocateNode(allocator, JSON_TYPE::STRING, false);
+	if (node == NULL) {
+		return false;
+	}
+
+	node->value = json_PatchDuplicate(allocator, string, length);
+	if (node->value == NULL) {
+		json_free_node(node, allocator);
+		return false;
+	}
+
+	return json_DiffMember(object, key, node, allocator);
+}
+
+// Add an operation with the current path to the patch, `value` is copied when it is not NULL
+bool json_DiffOperation(JSON_DIFF_STATE* state, const char* op, JSON_NODE* value)
+{
+	JSON_NODE* operation;
+	JSON_NODE* copy;
+
+	operation = json_AllocateNode(state->allocator, JSON_TYPE::OBJECT, false);
+	if (operation == NULL) {
+		return false;
+	}
+
+	if (!json_LinkNode(state->patch, operation, true)) {
+		json_free_node(operation, state->allocator);
+		return false;
+	}
+
+	if ((!json_DiffString(operation, "op", op, strlen(op), state->allocator)) ||
+		(!json_DiffString(operation, "path", (state->path != NULL) ? state->path : "", state->pathLength, state->allocator))) {
+		return false;
+	}
+
+	if (value == NULL) {
+		return true;
+	}
+
+	copy = json_PatchCopy(value, state->allocator, false, false);
+	if (copy == NULL) {
+		return false;
+	}
+
+	return json_DiffMember(operation, "value", copy, state->allocator);
+}
+
+// Check if 2 values are equal, values with different hashes are not compared
+bool json_DiffEqual(JSON_DIFF_STATE* state, JSON_NODE* a, JSON_NODE* b)
+{
+	if (a->type != b->type) {
+		return false;
+	}
+
+	if ((json_IsContainer(a->type)) && (json_HashValue(a, state->epoch) != json_HashValue(b, state->epoch))) {
+		return false;
+	}
+
+	return json_Equal(a, b, true, state->epoch);
+}
+
+bool json_DiffValue(JSON_DIFF_STATE* state, JSON_NODE* a, JSON_NODE* b);
+
+// Add the operations that change the members of object `a` to the members of object `b`
+bool json_DiffObjects(JSON_DIFF_STATE* state, JSON_NODE* a, JSON_NODE* b)
+{
+	JSON_LOOKUP_KEY lookupKey;
+	JSON_NODE* member;
+	JSON_NODE* other;
+	size_t pathLength;
+
+	pathLength = state->pathLength;
+
+	// Members of `a` are removed or compared with the member of `b` with the same key, then the new members of `b` are added
+	for (member = (JSON_NODE*)a->value; member != NULL; member = member->next)
+	{
+		if (!json_NodeKey(member, &lookupKey)) {
+			continue;
+		}
+
+		if (!json_DiffPush(state, lookupKey.key, lookupKey.length)) {
+			return false;
+		}
+
+		other = json_FindKey(b, &lookupKey, NULL);
+		if (other == NULL)
+		{
+			if (!json_DiffOperation(state, "remove", NULL)) {
+				return false;
+			}
+		}
+		else if (!json_DiffValue(state, member, other)) {
+			return false;
+		}
+
+		state->pathLength = pathLength;
+	}
+
+	for (member = (JSON_NODE*)b->value; member != NULL; member = member->next)
+	{
+		if ((!json_NodeKey(member, &lookupKey)) || (json_FindKey(a, &lookupKey, NULL) != NULL)) {
+			continue;
+		}
+
+		if ((!json_DiffPush(state, lookupKey.key, lookupKey.length)) ||
+			(!json_DiffOperation(state, "add", member))) {
+			return false;
+		}
+
+		state->pathLength = pathLength;
+	}
+
+	if (state->path != NULL) {
+		state->path[pathLength] = '\0';
+	}
+
+	return true;
+}
+
+// Add the operations for the items of 2 arrays between 2 anchors, `index` is the index of the 1st item in the changed array
+// Items are compared in pairs, the items of `a` that are left are removed and the items of `b` that are left are added
+bool json_DiffGap(JSON_DIFF_STATE* state, JSON_NODE** itemsA, size_t countA, JSON_NODE** itemsB, size_t countB, size_t* index)
+{
+	size_t pathLength;
+	size_t i;
+
+	pathLength = state->pathLength;
+
+	for (i = 0; (i < countA) || (i < countB); i++)
+	{
+		if (!json_DiffPushIndex(state, *index)) {
+			return false;
+		}
+
+		if ((i < countA) && (i < countB))
+		{
+			if (!json_DiffValue(state, itemsA[i], itemsB[i])) {
+				return false;
+			}
+			(*index)++;
+		}
+		else if (i < countA)
+		{
+			if (!json_DiffOperation(state, "remove", NULL)) {
+				return false;
+			}
+		}
+		else
+		{
+			if (!json_DiffOperation(state, "add", itemsB[i])) {
+				return false;
+			}
+			(*index)++;
+		}
+
+		state->pathLength = pathLength;
+		state->path[pathLength] = '\0';
+	}
+
+	return true;
+}
+
+// Find the slot of a hash in the hash table of json_DiffArrays, or the empty slot for it
+JSON_DIFF_SLOT* json_DiffSlot(JSON_DIFF_SLOT* slots, size_t capacity, unsigned long long hash)
+{
+	size_t i;
+
+	i = (size_t)hash & (capacity - 1);
+	while (((slots[i].countA != 0) || (slots[i].countB != 0)) && (slots[i].hash != hash)) {
+		i = (i + 1) & (capacity - 1);
+	}
+
+	return &slots[i];
+}
+
+// Add the operations that change the items of array `a` to the items of array `b`
+// The equal items at the start and the end are skipped, then the items that are unique in both arrays and in the same order
+// are kept as anchors (patience diff), so the arrays are compared in O(n log n) and inserted or removed items don't change
+// every item after them
+bool json_DiffArrays(JSON_DIFF_STATE* state, JSON_NODE* a, JSON_NODE* b)
+{
+	JSON_DIFF_SLOT* slots;
+	JSON_DIFF_SLOT* slot;
+	JSON_NODE** items;
+	JSON_NODE** itemsA;
+	JSON_NODE** itemsB;
+	JSON_NODE* node;
+	unsigned long long* hashes;
+	size_t* candidatesA;
+	size_t* candidatesB;
+	size_t* tails;
+	size_t* links;
+	size_t* anchors;
+	size_t countA, countB, prefix, suffix, middleA, middleB, endA, endB;
+	size_t capacity, candidates, length, low, high, mid, i, j, k, index, pathLength;
+	unsigned char* block;
+	bool result;
+
+	countA = json_CountList(a);
+	countB = json_CountList(b);
+
+	items = (JSON_NODE**)json_Allocate(state->allocator, (countA + countB + 1) * sizeof(JSON_NODE*));
+	if (items == NULL) {
+		return false;
+	}
+
+	itemsA = items;
+	itemsB = items + countA;
+
+	i = 0;
+	for (node = (JSON_NODE*)a->value; node != NULL; node = node->next) {
+		itemsA[i++] = node;
+	}
+	i = 0;
+	for (node = (JSON_NODE*)b->value; node != NULL; node = node->next) {
+		itemsB[i++] = node;
+	}
+
+	prefix = 0;
+	while ((prefix < countA) && (prefix < countB) && (json_DiffEqual(state, itemsA[prefix], itemsB[prefix]))) {
+		prefix++;
+	}
+
+	suffix = 0;
+	while ((suffix < countA - prefix) && (suffix < countB - prefix) &&
+		(json_DiffEqual(state, itemsA[countA - 1 - suffix], itemsB[countB - 1 - suffix]))) {
+		suffix++;
+	}
+
+	middleA = countA - prefix - suffix;
+	middleB = countB - prefix - suffix;
+
+	capacity = 16;
+	while (capacity < (middleA + middleB) * 2) {
+		capacity *= 2;
+	}
+
+	// One block for the hashes of the changed items, the hash table and the anchors
+	block = (unsigned char*)json_Allocate(state->allocator,
+		(middleA + middleB) * sizeof(unsigned long long) + capacity * sizeof(JSON_DIFF_SLOT) + (middleA + 1) * 5 * sizeof(size_t));
+	if (block == NULL) {
+		json_Deallocate(state->allocator, items);
+		return false;
+	}
+
+	slots = (JSON_DIFF_SLOT*)block;
+	hashes = (unsigned long long*)(slots + capacity);
+	candidatesA = (size_t*)(hashes + middleA + middleB);
+	candidatesB = candidatesA + middleA + 1;
+	tails = candidatesB + middleA + 1;
+	links = tails + middleA + 1;
+	anchors = links + middleA + 1;
+
+	// Count the hashes of the items in both arrays
+	memset(slots, 0, capacity * sizeof(JSON_DIFF_SLOT));
+	for (k = 0; k < middleA + middleB; k++)
+	{
+		node = (k < middleA) ? itemsA[prefix + k] : itemsB[prefix + k - middleA];
+		hashes[k] = json_HashValue(node, state->epoch);
+
+		slot = json_DiffSlot(slots, capacity, hashes[k]);
+		slot->hash = hashes[k];
+		if (k < middleA)
+		{
+			slot->countA++;
+			slot->indexA = prefix + k;
+		}
+		else
+		{
+			slot->countB++;
+			slot->indexB = prefix + k - middleA;
+		}
+	}
+
+	// The items that are unique in both arrays are the candidates, in the order of `a`
+	candidates = 0;
+	for (k = 0; k < middleA; k++)
+	{
+		slot = json_DiffSlot(slots, capacity, hashes[k]);
+		if ((slot->countA == 1) && (slot->countB == 1))
+		{
+			candidatesA[candidates] = slot->indexA;
+			candidatesB[candidates] = slot->indexB;
+			candidates++;
+		}
+	}
+
+	// The longest run of candidates that is in the order of `b` too (patience sorting)
+	// `tails[l]` is the candidate that ends a run of length l + 1 at the lowest index of `b`, `links` the one in front of it
+	length = 0;
+	for (k = 0; k < candidates; k++)
+	{
+		low = 0;
+		high = length;
+		while (low < high)
+		{
+			mid = (low + high) / 2;
+			if (candidatesB[tails[mid]] < candidatesB[k]) {
+				low = mid + 1;
+			}
+			else {
+				high = mid;
+			}
+		}
+
+		tails[low] = k;
+		links[k] = (low > 0) ? tails[low - 1] : candidates;
+		if (low == length) {
+			length++;
+		}
+	}
+
+	k = (length > 0) ? tails[length - 1] : candidates;
+	for (i = length; i > 0; i--)
+	{
+		anchors[i - 1] = k;
+		k = links[k];
+	}
+
+	// The items between the anchors are changed, the anchors are compared in case their hashes collide
+	result = true;
+	index = prefix;
+	i = prefix;
+	j = prefix;
+	pathLength = state->pathLength;
+	for (k = 0; (result) && (k <= length); k++)
+	{
+		endA = (k < length) ? candidatesA[anchors[k]] : countA - suffix;
+		endB = (k < length) ? candidatesB[anchors[k]] : countB - suffix;
+
+		result = json_DiffGap(state, &itemsA[i], endA - i, &itemsB[j], endB - j, &index);
+
+		if ((result) && (k < length))
+		{
+			result = (json_DiffPushIndex(state, index)) && (json_DiffValue(state, itemsA[endA], itemsB[endB]));
+			state->pathLength = pathLength;
+			index++;
+			i = endA + 1;
+			j = endB + 1;
+		}
+	}
+
+	if (state->path != NULL) {
+		state->path[pathLength] = '\0';
+	}
+
+	json_Deallocate(state->allocator, block);
+	json_Deallocate(state->allocator, items);
+
+	return result;
+}
+
+// Add the operations that change value `a` to value `b`, at the current path
+bool json_DiffValue(JSON_DIFF_STATE* state, JSON_NODE* a, JSON_NODE* b)
+{
+	if (json_DiffEqual(state, a, b)) {
+		return true;
+	}
+
+	if ((a->type == JSON_TYPE::OBJECT) && (b->type == JSON_TYPE::OBJECT)) {
+		return json_DiffObjects(state, a, b);
+	}
+	if ((a->type == JSON_TYPE::ARRAY) && (b->type == JSON_TYPE::ARRAY)) {
+		return json_DiffArrays(state, a, b);
+	}
+
+	return json_DiffOperation(state, "replace", b);
+}
+
+JSON_NODE* json_plus::JSON_Diff(JSON_NODE* old_root, JSON_NODE* new_root, const JSON_ALLOCATOR* allocator)
+{
+	JSON_DIFF_STATE state;
+
+	if ((old_root == NULL) || (new_root == NULL)) {
+		return NULL;
+	}
+
+	state.allocator = allocator;
+	state.path = NULL;
+	state.pathLength = 0;
+	state.pathCapacity = 0;
+	state.epoch = json_HashEpoch();
+
+	state.patch = json_AllocateNode(allocator, JSON_TYPE::ARRAY, true);
+	if (state.patch == NULL) {
+		return NULL;
+	}
+
+	if (!json_DiffValue(&state, old_root, new_root))
+	{
+		json_free_node(state.patch, allocator);
+		state.patch = NULL;
+	}
+
+	json_Deallocate(allocator, state.path);
+
+	return state.patch;
+}
+
+// --------------------------- //
+// **   JSON_PATH methods   ** //
+// --------------------------- //
+
+// Selector of a JSON_PATH step
+enum class JSON_PATH_SELECTOR
+{
+	NAME,
+	WILDCARD,
+	INDEX,
+	SLICE,
+	FILTER
+};
+
+// Operator of a JSON_PATH filter comparison, EXISTS when there is no operator
+enum class JSON_PATH_OPERATOR
+{
+	EXISTS,
+	EQUAL,
+	NOT_EQUAL,
+	LESS,
+	LESS_EQUAL,
+	GREATER,
+	GREATER_EQUAL
+};
+
+// Value compared by a JSON_PATH filter
+// Strings from a JSON string are not unescaped, `escaped` is true when they are compared
+struct JSON_PATH_VALUE
+{
+	JSON_TYPE type;
+	const char* string;
+	size_t length;
+	bool escaped;
+	double number;
+	bool boolean;
+};
+
+struct JSON_PATH::SEGMENT
+{
+	// Key, when the segment is not an index
+	JSON_LOOKUP_KEY key;
+	// Array index, negative indexes count from the end
+	long long index;
+	bool isIndex;
+};
+
+struct JSON_PATH::CONDITION
+{
+	// Relative path of the compared value, the item itself when there are no segments
+	SEGMENT* segments;
+	size_t segmentCount;
+	JSON_PATH_OPERATOR op;
+	// Literal, a STRING, NUMBER, BOOLEAN or NULL_TYPE value
+	JSON_PATH_VALUE literal;
+	// Joined to the next comparison with || instead of &&
+	bool orNext;
+};
+
+struct JSON_PATH::STEP
+{
+	JSON_PATH_SELECTOR selector;
+	// Select from the value and all of its descendants (..)
+	bool descendant;
+	// NAME key
+	JSON_LOOKUP_KEY key;
+	// INDEX, or SLICE start, end and stride, negative values count from the end
+	long long start;
+	long long end;
+	long long stride;
+	bool hasStart;
+	bool hasEnd;
+	// FILTER comparisons
+	CONDITION* conditions;
+	size_t conditionCount;
+};
+
+struct JSON_PATH::STATE
+{
+	JSON_PATH_CALLBACK callback;
+	JSON_PATH_TEXT_CALLBACK textCallback;
+	void* userData;
+	// JSON string of EvaluateText
+	const char* json;
+	// Number of values found
+	size_t matches;
+};
+
+struct JSON_PATH::CURSOR
+{
+	JSON_LEXER lexer;
+	JSON_LEXER_TOKEN token;
+};
+
+// Get the character of an escape sequence, the same escape characters as JSON strings are used
+char json_UnescapeCharacter(char c)
+{
+	switch (c)
+	{
+	case 'n':
+		return 0x0A;
+	case 'r':
+		return 0x0D;
+	case 't':
+		return 0x09;
+	case 'f':
+		return 0x0C;
+	case 'b':
+		return 0x08;
+	}
+
+	return c;
+}
+
+// Skip spaces in a query
+void json_PathSpaces(const char* path, size_t length, size_t* i)
+{
+	while ((*i < length) && ((path[*i] == ' ') || (path[*i] == '\t'))) {
+		(*i)++;
+	}
+}
+
+// Get the number of bytes of a name after a '.' in a query
+size_t json_PathName(const char* path, size_t length, size_t i)
+{
+	size_t start;
+
+	start = i;
+	while ((i < length) && (((path[i] >= 'a') && (path[i] <= 'z')) || ((path[i] >= 'A') && (path[i] <= 'Z')) ||
+		((path[i] >= '0') && (path[i] <= '9')) || (path[i] == '_') || (path[i] == '-') || ((unsigned char)path[i] >= 0x80))) {
+		i++;
+	}
+
+	return i - start;
+}
+
+// Copy a name of `nameLength` bytes in a query to the strings and make a lookup key for it
+void json_PathKey(const char* path, size_t* i, size_t nameLength, char** strings, JSON_LOOKUP_KEY* key)
+{
+	memcpy(*strings, &path[*i], nameLength);
+	json_LookupKey(key, *strings, nameLength);
+	*strings += nameLength;
+	*i += nameLength;
+}
+
+// Read a quoted string in a query and write it unescaped to the strings, in single or double quotes
+bool json_PathQuoted(const char* path, size_t length, size_t* i, char** strings, const char** string, size_t* stringLength)
+{
+	char quote;
+	char c;
+
+	quote = path[(*i)++];
+	*string = *strings;
+	*stringLength = 0;
+
+	while (*i < length)
+	{
+		c = path[(*i)++];
+		if (c == quote)
+		{
+			*strings += *stringLength;
+			return true;
+		}
+		if (c == '\\')
+		{
+			if (*i == length) {
+				return false;
+			}
+			c = json_UnescapeCharacter(path[(*i)++]);
+		}
+		(*strings)[(*stringLength)++] = c;
+	}
+
+	return false;
+}
+
+// Read an integer in a query, `i` is unchanged if there is no integer
+bool json_PathInteger(const char* path, size_t length, size_t* i, long long* value)
+{
+	size_t start, digits;
+
+	start = *i;
+	if ((*i < length) && (path[*i] == '-')) {
+		(*i)++;
+	}
+
+	*value = 0;
+	for (digits = 0; (*i < length) && (path[*i] >= '0') && (path[*i] <= '9'); digits++)
+	{
+		// Larger indexes can't be in an array
+		if (digits == 18) {
+			break;
+		}
+		*value = (*value * 10) + (path[*i] - '0');
+		(*i)++;
+	}
+
+	if ((digits == 0) || (digits == 18))
+	{
+		*i = start;
+		return false;
+	}
+
+	if (path[start] == '-') {
+		*value = -*value;
+	}
+
+	return true;
+}
+
+// Read a number of `length` bytes that doesn't need to be null terminated
+double json_PathNumber(const char* number, size_t length, size_t* used)
+{
+	char buffer[64];
+	char* end;
+	double value;
+
+	if (length >= sizeof(buffer)) {
+		length = sizeof(buffer) - 1;
+	}
+	memcpy(buffer, number, length);
+	buffer[length] = '\0';
+
+	value = strtod(buffer, &end);
+	if (used != NULL) {
+		*used = (size_t)(end - buffer);
+	}
+
+	return value;
+}
+
+// Compare a string value with a literal, the value is unescaped while it is compared
+int json_PathCompareStrings(const JSON_PATH_VALUE* value, const JSON_PATH_VALUE* literal)
+{
+	size_t i, k;
+	unsigned char c;
+	int order;
+
+	if (!value->escaped)
+	{
+		k = (value->length < literal->length) ? value->length : literal->length;
+		order = (k != 0) ? memcmp(value->string, literal->string, k) : 0;
+		if (order != 0) {
+			return order;
+		}
+		return (value->length < literal->length) ? -1 : ((value->length > literal->length) ? 1 : 0);
+	}
+
+	k = 0;
+	for (i = 0; i < value->length; i++)
+	{
+		c = (unsigned char)value->string[i];
+		if ((c == '\\') && (i + 1 < value->length)) {
+			c = (unsigned char)json_UnescapeCharacter(value->string[++i]);
+		}
+		if (k == literal->length) {
+			return 1;
+		}
+		if (c != (unsigned char)literal->string[k]) {
+			return (c < (unsigned char)literal->string[k]) ? -1 : 1;
+		}
+		k++;
+	}
+
+	return (k < literal->length) ? -1 : 0;
+}
+
+// Compare a value with the literal of a filter, `value` is NULL when the relative path found nothing
+// != is true when == is false, <, <=, > and >= are only true for 2 numbers or 2 strings
+bool json_PathCompare(JSON_PATH_OPERATOR op, const JSON_PATH_VALUE* value, const JSON_PATH_VALUE* literal)
+{
+	int order;
+
+	if (op == JSON_PATH_OPERATOR::EXISTS) {
+		return (value != NULL);
+	}
+
+	if ((value == NULL) || (value->type != literal->type)) {
+		return (op == JSON_PATH_OPERATOR::NOT_EQUAL);
+	}
+
+	switch (value->type)
+	{
+	case JSON_TYPE::NUMBER:
+		order = (value->number < literal->number) ? -1 : ((value->number > literal->number) ? 1 : 0);
+		break;
+	case JSON_TYPE::STRING:
+		order = json_PathCompareStrings(value, literal);
+		break;
+	case JSON_TYPE::BOOLEAN:
+		order = (value->boolean == literal->boolean) ? 0 : 2;
+		break;
+	case JSON_TYPE::NULL_TYPE:
+		order = 0;
+		break;
+	default:
+		return (op == JSON_PATH_OPERATOR::NOT_EQUAL);
+	}
+
+	switch (op)
+	{
+	case JSON_PATH_OPERATOR::EQUAL:
+		return (order == 0);
+	case JSON_PATH_OPERATOR::NOT_EQUAL:
+		return (order != 0);
+	default:
+		break;
+	}
+
+	// Booleans and null are not ordered
+	if ((value->type != JSON_TYPE::NUMBER) && (value->type != JSON_TYPE::STRING)) {
+		return false;
+	}
+
+	switch (op)
+	{
+	case JSON_PATH_OPERATOR::LESS:
+		return (order < 0);
+	case JSON_PATH_OPERATOR::LESS_EQUAL:
+		return (order <= 0);
+	case JSON_PATH_OPERATOR::GREATER:
+		return (order > 0);
+	default:
+		return (order >= 0);
+	}
+}
+
+// Get the items selected by a slice of an array with `count` items
+// With a positive stride the items from `lower` to `upper` are selected, `upper` excluded
+// With a negative stride the items from `upper` down to `lower` are selected, `lower` excluded
+void json_PathSlice(bool hasStart, long long start, bool hasEnd, long long end, long long stride, long long count, long long* lower, long long* upper)
+{
+	if (stride > 0)
+	{
+		start = hasStart ? start : 0;
+		end = hasEnd ? end : count;
+	}
+	else
+	{
+		start = hasStart ? start : (count - 1);
+		end = hasEnd ? end : (-count - 1);
+	}
+
+	if (start < 0) {
+		start += count;
+	}
+	if (end < 0) {
+		end += count;
+	}
+
+	if (stride > 0)
+	{
+		*lower = (start < 0) ? 0 : ((start > count) ? count : start);
+		*upper = (end < 0) ? 0 : ((end > count) ? count : end);
+	}
+	else
+	{
+		*upper = (start < -1) ? -1 : ((start > count - 1) ? (count - 1) : start);
+		*lower = (end < -1) ? -1 : ((end > count - 1) ? (count - 1) : end);
+	}
+}
+
+// Get the value of a node for a filter comparison
+void json_PathNodeValue(JSON_NODE* node, JSON_PATH_VALUE* value)
+{
+	value->type = node->type;
+	value->escaped = false;
+
+	if (node->type == JSON_TYPE::STRING)
+	{
+		value->string = (const char*)node->value;
+		value->length = (value->string != NULL) ? strlen(value->string) : 0;
+	}
+	else if (node->type == JSON_TYPE::NUMBER) {
+		value->number = node->Double();
+	}
+	else if (node->type == JSON_TYPE::BOOLEAN) {
+		value->boolean = node->Boolean();
+	}
+}
+
+// Get the array index of a segment or INDEX selector in an array with `count` items, returns false if it is out of range
+bool json_PathIndex(long long index, long long count, unsigned long* i)
+{
+	if (index < 0) {
+		index += count;
+	}
+	if ((index < 0) || (index >= count)) {
+		return false;
+	}
+
+	*i = (unsigned long)index;
+	return true;
+}
+
+// Skip the rest of a value in a JSON string, `token` is the first token of the value
+// Returns false if the JSON string ends in the value, `end` is the offset after the value
+bool json_TextSkipValue(JSON_LEXER* lexer, const JSON_LEXER_TOKEN* token, size_t* end)
+{
+	JSON_LEXER_TOKEN next;
+	size_t depth;
+
+	*end = token->offset + token->length;
+	if ((token->type != JSON_TOKEN::CURLY_OPEN) && (token->type != JSON_TOKEN::ARRAY_OPEN)) {
+		return true;
+	}
+
+	depth = 1;
+	while (lexer->Next(&next))
+	{
+		*end = next.offset + next.length;
+		if ((next.type == JSON_TOKEN::CURLY_OPEN) || (next.type == JSON_TOKEN::ARRAY_OPEN)) {
+			depth++;
+		}
+		else if ((next.type == JSON_TOKEN::CURLY_CLOSE) || (next.type == JSON_TOKEN::ARRAY_CLOSE))
+		{
+			if (--depth == 0) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+// Get the next member of an object or item of an array in a JSON string
+// The lexer is after the opening bracket for the 1st item, after the value before it for the other items
+// Returns false at the end of the object or array, or if the JSON string is not valid
+bool json_TextNextItem(JSON_LEXER* lexer, bool object, bool first, JSON_LEXER_TOKEN* key, JSON_LEXER_TOKEN* value)
+{
+	JSON_LEXER_TOKEN token;
+
+	if (!lexer->Next(&token)) {
+		return false;
+	}
+
+	if (!first)
+	{
+		if ((token.type != JSON_TOKEN::COMMA) || (!lexer->Next(&token))) {
+			return false;
+		}
+	}
+
+	if (object)
+	{
+		if (token.type != JSON_TOKEN::STRING) {
+			return false;
+		}
+		*key = token;
+		if ((!lexer->Next(&token)) || (token.type != JSON_TOKEN::COLON) || (!lexer->Next(&token))) {
+			return false;
+		}
+	}
+
+	if ((token.type != JSON_TOKEN::CURLY_OPEN) && (token.type != JSON_TOKEN::ARRAY_OPEN) && (token.type != JSON_TOKEN::STRING) &&
+		(token.type != JSON_TOKEN::NUMBER) && (token.type != JSON_TOKEN::LITERAL)) {
+		return false;
+	}
+
+	*value = token;
+	return true;
+}
+
+// Check if the key of a member in a JSON string is equal to a key, the escape sequences in the member key are decoded
+bool json_TextKeyEquals(const char* json, const JSON_LEXER_TOKEN* token, const JSON_LOOKUP_KEY* key)
+{
+	JSON_PATH_VALUE value, literal;
+
+	// An unterminated string has no closing double quotes
+	if ((token->length < 2) || (json[token->offset + token->length - 1] != '\"')) {
+		return false;
+	}
+
+	value.string = &json[token->offset + 1];
+	value.length = token->length - 2;
+	value.escaped = true;
+	literal.string = key->key;
+	literal.length = key->length;
+
+	// Without escape sequences the key can't be shorter than the member key
+	if ((value.length < key->length) || ((value.length != key->length) && (memchr(value.string, '\\', value.length) == NULL))) {
+		return false;
+	}
+
+	return (json_PathCompareStrings(&value, &literal) == 0);
+}
+
+// Count the items of an object or array in a JSON string, the lexer is after the opening bracket
+long long json_TextCountItems(JSON_LEXER lexer, bool object)
+{
+	JSON_LEXER_TOKEN key, value;
+	long long count;
+	size_t end;
+
+	count = 0;
+	while (json_TextNextItem(&lexer, object, (count == 0), &key, &value))
+	{
+		count++;
+		if (!json_TextSkipValue(&lexer, &value, &end)) {
+			break;
+		}
+	}
+
+	return count;
+}
+
+// Find the item of an array in a JSON string at `index`, the lexer is after the opening bracket
+// When the item is found the lexer is after the first token of the item
+bool json_TextGetItem(JSON_LEXER* lexer, unsigned long index, JSON_LEXER_TOKEN* value)
+{
+	JSON_LEXER_TOKEN key;
+	unsigned long i;
+	size_t end;
+
+	for (i = 0; json_TextNextItem(lexer, false, (i == 0), &key, value); i++)
+	{
+		if (i == index) {
+			return true;
+		}
+		if (!json_TextSkipValue(lexer, value, &end)) {
+			break;
+		}
+	}
+
+	return false;
+}
+
+// Find a member of an object in a JSON string, the lexer is after the opening bracket
+// When the member is found the lexer is after the first token of its value
+bool json_TextFindKey(JSON_LEXER* lexer, const char* json, const JSON_LOOKUP_KEY* lookupKey, JSON_LEXER_TOKEN* value)
+{
+	JSON_LEXER_TOKEN key;
+	bool first;
+	size_t end;
+
+	for (first = true; json_TextNextItem(lexer, true, first, &key, value); first = false)
+	{
+		if (json_TextKeyEquals(json, &key, lookupKey)) {
+			return true;
+		}
+		if (!json_TextSkipValue(lexer, value, &end)) {
+			break;
+		}
+	}
+
+	return false;
+}
+
+// Get the value of a token in a JSON string for a filter comparison
+void json_TextValue(const char* json, const JSON_LEXER_TOKEN* token, JSON_PATH_VALUE* value)
+{
+	const char* text;
+
+	text = &json[token->offset];
+	value->escaped = true;
+
+	switch (token->type)
+	{
+	case JSON_TOKEN::CURLY_OPEN:
+		value->type = JSON_TYPE::OBJECT;
+		break;
+	case JSON_TOKEN::ARRAY_OPEN:
+		value->type = JSON_TYPE::ARRAY;
+		break;
+	case JSON_TOKEN::STRING:
+		value->type = JSON_TYPE::STRING;
+		value->string = text + 1;
+		value->length = (token->length >= 2) ? (token->length - 2) : 0;
+		break;
+	case JSON_TOKEN::NUMBER:
+		value->type = JSON_TYPE::NUMBER;
+		value->number = json_PathNumber(text, token->length, NULL);
+		break;
+	default:
+		if ((token->length == 4) && (memcmp(text, "true", 4) == 0))
 		{
-			json_GeneratorAppend(context, '"', true);
+			value->type = JSON_TYPE::BOOLEAN;
+			value->boolean = true;
+		}
+		else if ((token->length == 5) && (memcmp(text, "false", 5) == 0))
+		{
+			value->type = JSON_TYPE::BOOLEAN;
+			value->boolean = false;
+		}
+		else {
+			value->type = JSON_TYPE::NULL_TYPE;
+		}
+		break;
+	}
+}
 
-			const char* pKey = node->key;
-			CharUnits = UTF8_Encoding::GetCharacterUnits(*pKey);
-			CodePoint = UTF8_Encoding::Decode(CharUnits, pKey);
+JSON_PATH::JSON_PATH(const JSON_ALLOCATOR* allocator)
+{
+	this->steps = NULL;
+	this->count = 0;
+	this->conditions = NULL;
+	this->conditionCount = 0;
+	this->segments = NULL;
+	this->segmentCount = 0;
+	this->compiled = false;
+	this->allocator = allocator;
+}
 
-			while (CodePoint != '\0')
+JSON_PATH::JSON_PATH(const char* path, const JSON_ALLOCATOR* allocator) : JSON_PATH(allocator)
+{
+	this->Compile(path);
+}
+
+JSON_PATH::~JSON_PATH()
+{
+	json_Deallocate(this->allocator, this->steps);
+}
+
+bool JSON_PATH::Compile(const char* path)
+{
+	return this->Compile(path, (path != NULL) ? strlen(path) : 0);
+}
+
+bool JSON_PATH::Compile(const char* path, size_t length)
+{
+	STEP* step;
+	char* strings;
+	size_t maxSteps, maxConditions;
+	size_t i, nameLength;
+	unsigned char* block;
+
+	json_Deallocate(this->allocator, this->steps);
+	this->steps = NULL;
+	this->count = 0;
+	this->conditions = NULL;
+	this->conditionCount = 0;
+	this->segments = NULL;
+	this->segmentCount = 0;
+	this->compiled = false;
+
+	if (path == NULL) {
+		return false;
+	}
+
+	// Every step and segment starts with '.' or '[' and every comparison with '@'
+	maxSteps = 0;
+	maxConditions = 0;
+	for (i = 0; i < length; i++)
+	{
+		if ((path[i] == '.') || (path[i] == '[')) {
+			maxSteps++;
+		}
+		else if (path[i] == '@') {
+			maxConditions++;
+		}
+	}
+
+	// One block for the steps, the comparisons, the segments and the unescaped keys and strings
+	block = (unsigned char*)json_Allocate(this->allocator,
+		maxSteps * (sizeof(STEP) + sizeof(SEGMENT)) + maxConditions * sizeof(CONDITION) + length + 1);
+	if (block == NULL) {
+		return false;
+	}
+
+	this->steps = (STEP*)block;
+	this->conditions = (CONDITION*)(block + maxSteps * sizeof(STEP));
+	this->segments = (SEGMENT*)(block + maxSteps * sizeof(STEP) + maxConditions * sizeof(CONDITION));
+	strings = (char*)(block + maxSteps * (sizeof(STEP) + sizeof(SEGMENT)) + maxConditions * sizeof(CONDITION));
+
+	i = 0;
+	json_PathSpaces(path, length, &i);
+	if ((i == length) || (path[i] != '$')) {
+		return false;
+	}
+	i++;
+
+	while (true)
+	{
+		json_PathSpaces(path, length, &i);
+		if (i == length) {
+			break;
+		}
+
+		step = &this->steps[this->count];
+		memset(step, 0, sizeof(STEP));
+
+		if (path[i] == '.')
+		{
+			i++;
+			if ((i < length) && (path[i] == '.'))
 			{
-				// Escape special characters
-				switch (CodePoint)
+				step->descendant = true;
+				i++;
+			}
+
+			if ((step->descendant) && (i < length) && (path[i] == '['))
+			{
+				if (!this->CompileBracket(path, length, &i, step, &strings)) {
+					return false;
+				}
+			}
+			else if ((i < length) && (path[i] == '*'))
+			{
+				step->selector = JSON_PATH_SELECTOR::WILDCARD;
+				i++;
+			}
+			else
+			{
+				nameLength = json_PathName(path, length, i);
+				if (nameLength == 0) {
+					return false;
+				}
+				step->selector = JSON_PATH_SELECTOR::NAME;
+				json_PathKey(path, &i, nameLength, &strings, &step->key);
+			}
+		}
+		else if (path[i] == '[')
+		{
+			if (!this->CompileBracket(path, length, &i, step, &strings)) {
+				return false;
+			}
+		}
+		else {
+			return false;
+		}
+
+		this->count++;
+	}
+
+	this->compiled = true;
+
+	return true;
+}
+
+bool JSON_PATH::CompileBracket(const char* path, size_t length, size_t* i, STEP* step, char** strings)
+{
+	const char* key;
+	size_t keyLength;
+
+	// Skip the '['
+	(*i)++;
+	json_PathSpaces(path, length, i);
+	if (*i == length) {
+		return false;
+	}
+
+	if (path[*i] == '*')
+	{
+		step->selector = JSON_PATH_SELECTOR::WILDCARD;
+		(*i)++;
+	}
+	else if ((path[*i] == '\'') || (path[*i] == '\"'))
+	{
+		if (!json_PathQuoted(path, length, i, strings, &key, &keyLength)) {
+			return false;
+		}
+		step->selector = JSON_PATH_SELECTOR::NAME;
+		json_LookupKey(&step->key, key, keyLength);
+	}
+	else if (path[*i] == '?')
+	{
+		(*i)++;
+		if (!this->CompileFilter(path, length, i, step, strings)) {
+			return false;
+		}
+	}
+	else
+	{
+		step->hasStart = json_PathInteger(path, length, i, &step->start);
+		json_PathSpaces(path, length, i);
+
+		if ((*i < length) && (path[*i] == ':'))
+		{
+			step->selector = JSON_PATH_SELECTOR::SLICE;
+			step->stride = 1;
+
+			(*i)++;
+			json_PathSpaces(path, length, i);
+			step->hasEnd = json_PathInteger(path, length, i, &step->end);
+			json_PathSpaces(path, length, i);
+
+			if ((*i < length) && (path[*i] == ':'))
+			{
+				(*i)++;
+				json_PathSpaces(path, length, i);
+				if (!json_PathInteger(path, length, i, &step->stride)) {
+					step->stride = 1;
+				}
+			}
+		}
+		else if (step->hasStart) {
+			step->selector = JSON_PATH_SELECTOR::INDEX;
+		}
+		else {
+			return false;
+		}
+	}
+
+	json_PathSpaces(path, length, i);
+	if ((*i == length) || (path[*i] != ']')) {
+		return false;
+	}
+	(*i)++;
+
+	return true;
+}
+
+bool JSON_PATH::CompileFilter(const char* path, size_t length, size_t* i, STEP* step, char** strings)
+{
+	CONDITION* condition;
+	SEGMENT* segment;
+	const char* key;
+	size_t keyLength, used;
+	bool parenthesis;
+
+	json_PathSpaces(path, length, i);
+	parenthesis = ((*i < length) && (path[*i] == '('));
+	if (parenthesis) {
+		(*i)++;
+	}
+
+	step->selector = JSON_PATH_SELECTOR::FILTER;
+	step->conditions = &this->conditions[this->conditionCount];
+	step->conditionCount = 0;
+
+	while (true)
+	{
+		json_PathSpaces(path, length, i);
+		if ((*i == length) || (path[*i] != '@')) {
+			return false;
+		}
+		(*i)++;
+
+		condition = &this->conditions[this->conditionCount++];
+		memset(condition, 0, sizeof(CONDITION));
+		condition->segments = &this->segments[this->segmentCount];
+		step->conditionCount++;
+
+		// Relative path of the compared value
+		while (*i < length)
+		{
+			segment = &this->segments[this->segmentCount];
+			segment->isIndex = false;
+
+			if (path[*i] == '.')
+			{
+				(*i)++;
+				keyLength = json_PathName(path, length, *i);
+				if (keyLength == 0) {
+					return false;
+				}
+				json_PathKey(path, i, keyLength, strings, &segment->key);
+			}
+			else if (path[*i] == '[')
+			{
+				(*i)++;
+				json_PathSpaces(path, length, i);
+				if ((*i < length) && ((path[*i] == '\'') || (path[*i] == '\"')))
 				{
-				case 0x22: // " quotation mark
-				case 0x5C: // \ reverse solidus
-					json_GeneratorAppend(context, '\\', false);
-					json_GeneratorAppend(context, CodePoint, false);
-					break;
-				case 0x08: // b backspace
-					json_GeneratorAppend(context, '\\', false);
-					if (context->visualEscape) {
-						json_GeneratorAppend(context, 'b', false);
-					}
-					else {
-						json_GeneratorAppend(context, CodePoint, false);
-					}
-					break;
-				case 0x0C: // f form feed
-					json_GeneratorAppend(context, '\\', false);
-					if (context->visualEscape) {
-						json_GeneratorAppend(context, 'f', false);
-					}
-					else {
-						json_GeneratorAppend(context, CodePoint, false);
+					if (!json_PathQuoted(path, length, i, strings, &key, &keyLength)) {
+						return false;
 					}
-					break;
-				case 0x0A: // n line feed
-					json_GeneratorAppend(context, '\\', false);
-					if (context->visualEscape) {
-						json_GeneratorAppend(context, 'n', false);
-					}
-					else {
-						json_GeneratorAppend(context, CodePoint, false);
-					}
-					break;
-				case 0x0D: // r carriage return
-					json_GeneratorAppend(context, '\\', false);
-					if (context->visualEscape) {
-						json_GeneratorAppend(context, 'r', false);
+					json_LookupKey(&segment->key, key, keyLength);
+				}
+				else if (json_PathInteger(path, length, i, &segment->index)) {
+					segment->isIndex = true;
+				}
+				else {
+					return false;
+				}
+				json_PathSpaces(path, length, i);
+				if ((*i == length) || (path[*i] != ']')) {
+					return false;
+				}
+				(*i)++;
+			}
+			else {
+				break;
+			}
+
+			this->segmentCount++;
+			condition->segmentCount++;
+		}
+
+		json_PathSpaces(path, length, i);
+
+		// Operator, a comparison without an operator checks if the value exists
+		condition->op = JSON_PATH_OPERATOR::EXISTS;
+		if (*i + 1 < length)
+		{
+			if ((path[*i] == '=') && (path[*i + 1] == '=')) {
+				condition->op = JSON_PATH_OPERATOR::EQUAL;
+			}
+			else if ((path[*i] == '!') && (path[*i + 1] == '=')) {
+				condition->op = JSON_PATH_OPERATOR::NOT_EQUAL;
+			}
+			else if ((path[*i] == '<') && (path[*i + 1] == '=')) {
+				condition->op = JSON_PATH_OPERATOR::LESS_EQUAL;
+			}
+			else if ((path[*i] == '>') && (path[*i + 1] == '=')) {
+				condition->op = JSON_PATH_OPERATOR::GREATER_EQUAL;
+			}
+		}
+		if (condition->op != JSON_PATH_OPERATOR::EXISTS) {
+			(*i) += 2;
+		}
+		else if ((*i < length) && (path[*i] == '<'))
+		{
+			condition->op = JSON_PATH_OPERATOR::LESS;
+			(*i)++;
+		}
+		else if ((*i < length) && (path[*i] == '>'))
+		{
+			condition->op = JSON_PATH_OPERATOR::GREATER;
+			(*i)++;
+		}
+
+		// Literal
+		if (condition->op != JSON_PATH_OPERATOR::EXISTS)
+		{
+			json_PathSpaces(path, length, i);
+			if (*i == length) {
+				return false;
+			}
+
+			if ((path[*i] == '\'') || (path[*i] == '\"'))
+			{
+				condition->literal.type = JSON_TYPE::STRING;
+				if (!json_PathQuoted(path, length, i, strings, &condition->literal.string, &condition->literal.length)) {
+					return false;
+				}
+			}
+			else if ((length - *i >= 4) && (memcmp(&path[*i], "true", 4) == 0))
+			{
+				condition->literal.type = JSON_TYPE::BOOLEAN;
+				condition->literal.boolean = true;
+				(*i) += 4;
+			}
+			else if ((length - *i >= 5) && (memcmp(&path[*i], "false", 5) == 0))
+			{
+				condition->literal.type = JSON_TYPE::BOOLEAN;
+				condition->literal.boolean = false;
+				(*i) += 5;
+			}
+			else if ((length - *i >= 4) && (memcmp(&path[*i], "null", 4) == 0))
+			{
+				condition->literal.type = JSON_TYPE::NULL_TYPE;
+				(*i) += 4;
+			}
+			else if ((path[*i] == '-') || ((path[*i] >= '0') && (path[*i] <= '9')))
+			{
+				condition->literal.type = JSON_TYPE::NUMBER;
+				condition->literal.number = json_PathNumber(&path[*i], length - *i, &used);
+				(*i) += used;
+			}
+			else {
+				return false;
+			}
+		}
+
+		json_PathSpaces(path, length, i);
+		if ((*i + 1 < length) && (path[*i] == '&') && (path[*i + 1] == '&')) {
+			(*i) += 2;
+		}
+		else if ((*i + 1 < length) && (path[*i] == '|') && (path[*i + 1] == '|'))
+		{
+			condition->orNext = true;
+			(*i) += 2;
+		}
+		else {
+			break;
+		}
+	}
+
+	if (parenthesis)
+	{
+		if ((*i == length) || (path[*i] != ')')) {
+			return false;
+		}
+		(*i)++;
+	}
+
+	return true;
+}
+
+bool JSON_PATH::Test(const STATE* state, const STEP* step, JSON_NODE* node, const CURSOR* cursor)
+{
+	const CONDITION* condition;
+	const SEGMENT* segment;
+	JSON_PATH_VALUE value;
+	JSON_LEXER_TOKEN token;
+	JSON_NODE* target;
+	unsigned long index;
+	bool group, found;
+	size_t c, s;
+
+	// The comparisons joined by && are grouped, the filter is true when one group is true
+	group = true;
+	for (c = 0; c < step->conditionCount; c++)
+	{
+		condition = &step->conditions[c];
+
+		if (group)
+		{
+			if (node != NULL)
+			{
+				target = node;
+				for (s = 0; (s < condition->segmentCount) && (target != NULL); s++)
+				{
+					segment = &condition->segments[s];
+					if ((!segment->isIndex) && (target->type == JSON_TYPE::OBJECT)) {
+						target = json_FindKey(target, &segment->key, NULL);
+					}
+					else if ((segment->isIndex) && (target->type == JSON_TYPE::ARRAY) &&
+						(json_PathIndex(segment->index, (segment->index < 0) ? (long long)json_CountItems(target) : segment->index + 1, &index))) {
+						target = json_GetItem(target, index);
 					}
 					else {
-						json_GeneratorAppend(context, CodePoint, false);
+						target = NULL;
 					}
-					break;
-				case 0x09: // t tab
-					json_GeneratorAppend(context, '\\', false);
-					if (context->visualEscape) {
-						json_GeneratorAppend(context, 't', false);
+				}
+
+				found = (target != NULL);
+				if (found) {
+					json_PathNodeValue(target, &value);
+				}
+			}
+			else
+			{
+				JSON_LEXER lexer = cursor->lexer;
+
+				token = cursor->token;
+				found = true;
+				for (s = 0; (s < condition->segmentCount) && (found); s++)
+				{
+					segment = &condition->segments[s];
+					if ((!segment->isIndex) && (token.type == JSON_TOKEN::CURLY_OPEN)) {
+						found = json_TextFindKey(&lexer, state->json, &segment->key, &token);
+					}
+					else if ((segment->isIndex) && (token.type == JSON_TOKEN::ARRAY_OPEN) &&
+						(json_PathIndex(segment->index, (segment->index < 0) ? json_TextCountItems(lexer, false) : segment->index + 1, &index))) {
+						found = json_TextGetItem(&lexer, index, &token);
 					}
 					else {
-						json_GeneratorAppend(context, CodePoint, false);
+						found = false;
 					}
-					break;
-				default:
-					json_GeneratorAppend(context, CodePoint, false);
-					break;
 				}
 
-				pKey += CharUnits;
-
-				CharUnits = UTF8_Encoding::GetCharacterUnits(*pKey);
-				CodePoint = UTF8_Encoding::Decode(CharUnits, pKey);
+				if (found) {
+					json_TextValue(state->json, &token, &value);
+				}
 			}
 
-			json_GeneratorAppend(context, '"', true);
-			json_GeneratorAppend(context, ':', true);
+			group = json_PathCompare(condition->op, found ? &value : NULL, &condition->literal);
 		}
 
-		if (node->type == JSON_TYPE::OBJECT)
+		if ((condition->orNext) || (c + 1 == step->conditionCount))
 		{
-			format = NULL;
-			if (node->format) {
-				format = context->format;
-				context->format = node->format;
+			if (group) {
+				return true;
 			}
+			group = true;
+		}
+	}
 
-			json_GeneratorAppend(context, '{', true);
-			json_GenerateText((JSON_NODE*)node->value, context);
-			json_GeneratorAppend(context, '}', true);
+	return false;
+}
 
-			if (format) {
-				context->format = format;
-			}
-		}
-		else if (node->type == JSON_TYPE::ARRAY)
+bool JSON_PATH::Match(STATE* state, JSON_NODE* node, size_t step)
+{
+	JSON_NODE* child;
+
+	if (step == this->count)
+	{
+		state->matches++;
+		return state->callback(node, state->userData);
+	}
+
+	if (!this->Select(state, node, step)) {
+		return false;
+	}
+
+	// Recursive descent, select from the objects and arrays below the node as well
+	if ((this->steps[step].descendant) && (json_IsContainer(node->type)))
+	{
+		for (child = (JSON_NODE*)node->value; child != NULL; child = child->next)
 		{
-			format = NULL;
-			if (node->format) {
-				format = context->format;
-				context->format = node->format;
+			if ((json_IsContainer(child->type)) && (!this->Match(state, child, step))) {
+				return false;
 			}
+		}
+	}
 
-			json_GeneratorAppend(context, '[', true);
-			json_GenerateText((JSON_NODE*)node->value, context);
-			json_GeneratorAppend(context, ']', true);
+	return true;
+}
 
-			if (format) {
-				context->format = format;
+bool JSON_PATH::Select(STATE* state, JSON_NODE* node, size_t step)
+{
+	const STEP* s;
+	JSON_NODE* child;
+	long long i, k, lower, upper;
+	unsigned long index;
+
+	s = &this->steps[step];
+
+	if (!json_IsContainer(node->type)) {
+		return true;
+	}
+
+	switch (s->selector)
+	{
+	case JSON_PATH_SELECTOR::NAME:
+		if (node->type == JSON_TYPE::OBJECT)
+		{
+			child = json_FindKey(node, &s->key, NULL);
+			if (child != NULL) {
+				return this->Match(state, child, step + 1);
 			}
 		}
-		else if (node->type == JSON_TYPE::STRING)
+		break;
+	case JSON_PATH_SELECTOR::WILDCARD:
+		for (child = (JSON_NODE*)node->value; child != NULL; child = child->next)
 		{
-			json_GeneratorAppend(context, '"', true);
+			if (!this->Match(state, child, step + 1)) {
+				return false;
+			}
+		}
+		break;
+	case JSON_PATH_SELECTOR::FILTER:
+		for (child = (JSON_NODE*)node->value; child != NULL; child = child->next)
+		{
+			if ((this->Test(state, s, child, NULL)) && (!this->Match(state, child, step + 1))) {
+				return false;
+			}
+		}
+		break;
+	case JSON_PATH_SELECTOR::INDEX:
+		if ((node->type == JSON_TYPE::ARRAY) &&
+			(json_PathIndex(s->start, (s->start < 0) ? (long long)json_CountItems(node) : s->start + 1, &index)))
+		{
+			child = json_GetItem(node, index);
+			if (child != NULL) {
+				return this->Match(state, child, step + 1);
+			}
+		}
+		break;
+	case JSON_PATH_SELECTOR::SLICE:
+		if ((node->type != JSON_TYPE::ARRAY) || (s->stride == 0)) {
+			break;
+		}
 
-			const char* pValue = (const char*)node->value;
-			CharUnits = UTF8_Encoding::GetCharacterUnits(*pValue);
-			CodePoint = UTF8_Encoding::Decode(CharUnits, pValue);
+		json_PathSlice(s->hasStart, s->start, s->hasEnd, s->end, s->stride, (long long)json_CountItems(node), &lower, &upper);
 
-			while (CodePoint != '\0')
+		if (s->stride > 0)
+		{
+			// Walk the items from the 1st selected item
+			child = (lower < upper) ? json_GetItem(node, (unsigned long)lower) : NULL;
+			for (i = lower; (i < upper) && (child != NULL); i += s->stride)
 			{
-				// Escape special characters
-				switch (CodePoint)
-				{
-				case 0x22: // " quotation mark
-				case 0x5C: // \ reverse solidus
-					json_GeneratorAppend(context, '\\', false);
-					json_GeneratorAppend(context, CodePoint, false);
-					break;
-				case 0x08: // b backspace
-					json_GeneratorAppend(context, '\\', false);
-					if (context->visualEscape) {
-						json_GeneratorAppend(context, 'b', false);
-					}
-					else {
-						json_GeneratorAppend(context, CodePoint, false);
-					}
-					break;
-				case 0x0C: // f form feed
-					json_GeneratorAppend(context, '\\', false);
-					if (context->visualEscape) {
-						json_GeneratorAppend(context, 'f', false);
-					}
-					else {
-						json_GeneratorAppend(context, CodePoint, false);
-					}
-					break;
-				case 0x0A: // n line feed
-					json_GeneratorAppend(context, '\\', false);
-					if (context->visualEscape) {
-						json_GeneratorAppend(context, 'n', false);
-					}
-					else {
-						json_GeneratorAppend(context, CodePoint, false);
-					}
-					break;
-				case 0x0D: // r carriage return
-					json_GeneratorAppend(context, '\\', false);
-					if (context->visualEscape) {
-						json_GeneratorAppend(context, 'r', false);
-					}
-					else {
-						json_GeneratorAppend(context, CodePoint, false);
-					}
-					break;
-				case 0x09: // t tab
-					json_GeneratorAppend(context, '\\', false);
-					if (context->visualEscape) {
-						json_GeneratorAppend(context, 't', false);
-					}
-					else {
-						json_GeneratorAppend(context, CodePoint, false);
-					}
-					break;
-				default:
-					json_GeneratorAppend(context, CodePoint, false);
-					break;
+				if (!this->Match(state, child, step + 1)) {
+					return false;
+				}
+				for (k = 0; (k < s->stride) && (child != NULL); k++) {
+					child = child->next;
 				}
-
-				pValue += CharUnits;
-
-				CharUnits = UTF8_Encoding::GetCharacterUnits(*pValue);
-				CodePoint = UTF8_Encoding::Decode(CharUnits, pValue);
 			}
-
-			json_GeneratorAppend(context, '"', true);
 		}
-		else if (node->type == JSON_TYPE::NUMBER)
+		else
 		{
-			const char* pValue = (const char*)node->value;
-			CharUnits = UTF8_Encoding::GetCharacterUnits(*pValue);
-			CodePoint = UTF8_Encoding::Decode(CharUnits, pValue);
-
-			while (CodePoint != '\0')
+			for (i = upper; i > lower; i += s->stride)
 			{
-				json_GeneratorAppend(context, CodePoint, false);
-
-				pValue += CharUnits;
-
-				CharUnits = UTF8_Encoding::GetCharacterUnits(*pValue);
-				CodePoint = UTF8_Encoding::Decode(CharUnits, pValue);
+				child = json_GetItem(node, (unsigned long)i);
+				if ((child != NULL) && (!this->Match(state, child, step + 1))) {
+					return false;
+				}
 			}
 		}
-		else if (node->type == JSON_TYPE::BOOLEAN)
-		{
-			bool bValue = (bool)node->value;
+		break;
+	}
 
-			if (bValue) {
-				json_GeneratorAppend(context, 't', false);
-				json_GeneratorAppend(context, 'r', false);
-				json_GeneratorAppend(context, 'u', false);
-				json_GeneratorAppend(context, 'e', false);
+	return true;
+}
+
+bool JSON_PATH::MatchText(STATE* state, const CURSOR* cursor, size_t step)
+{
+	JSON_POSITION position;
+	JSON_LEXER_TOKEN key;
+	bool object, first;
+	size_t end;
+
+	if (step == this->count)
+	{
+		JSON_LEXER lexer = cursor->lexer;
+
+		json_TextSkipValue(&lexer, &cursor->token, &end);
+		position.offset = cursor->token.offset;
+		position.length = end - cursor->token.offset;
+		position.lineNumber = cursor->token.lineNumber;
+
+		state->matches++;
+		return state->textCallback(&position, state->userData);
+	}
+
+	if (!this->SelectText(state, cursor, step)) {
+		return false;
+	}
+
+	// Recursive descent, select from the objects and arrays below the value as well
+	object = (cursor->token.type == JSON_TOKEN::CURLY_OPEN);
+	if ((this->steps[step].descendant) && ((object) || (cursor->token.type == JSON_TOKEN::ARRAY_OPEN)))
+	{
+		CURSOR child = *cursor;
+
+		for (first = true; json_TextNextItem(&child.lexer, object, first, &key, &child.token); first = false)
+		{
+			if (((child.token.type == JSON_TOKEN::CURLY_OPEN) || (child.token.type == JSON_TOKEN::ARRAY_OPEN)) &&
+				(!this->MatchText(state, &child, step))) {
+				return false;
 			}
-			else {
-				json_GeneratorAppend(context, 'f', false);
-				json_GeneratorAppend(context, 'a', false);
-				json_GeneratorAppend(context, 'l', false);
-				json_GeneratorAppend(context, 's', false);
-				json_GeneratorAppend(context, 'e', false);
+			if (!json_TextSkipValue(&child.lexer, &child.token, &end)) {
+				break;
 			}
 		}
+	}
 
-		node = node->next;
-		if (node != NULL)
+	return true;
+}
+
+bool JSON_PATH::SelectText(STATE* state, const CURSOR* cursor, size_t step)
+{
+	const STEP* s;
+	JSON_LEXER_TOKEN key;
+	long long i, lower, upper;
+	unsigned long index;
+	bool object, first;
+	size_t end;
+
+	s = &this->steps[step];
+	object = (cursor->token.type == JSON_TOKEN::CURLY_OPEN);
+
+	if ((!object) && (cursor->token.type != JSON_TOKEN::ARRAY_OPEN)) {
+		return true;
+	}
+
+	CURSOR child = *cursor;
+
+	switch (s->selector)
+	{
+	case JSON_PATH_SELECTOR::NAME:
+		if ((object) && (json_TextFindKey(&child.lexer, state->json, &s->key, &child.token))) {
+			return this->MatchText(state, &child, step + 1);
+		}
+		break;
+	case JSON_PATH_SELECTOR::WILDCARD:
+	case JSON_PATH_SELECTOR::FILTER:
+		for (first = true; json_TextNextItem(&child.lexer, object, first, &key, &child.token); first = false)
 		{
-			json_GeneratorAppend(context, ',', true);
+			if (((s->selector == JSON_PATH_SELECTOR::WILDCARD) || (this->Test(state, s, NULL, &child))) &&
+				(!this->MatchText(state, &child, step + 1))) {
+				return false;
+			}
+			if (!json_TextSkipValue(&child.lexer, &child.token, &end)) {
+				break;
+			}
+		}
+		break;
+	case JSON_PATH_SELECTOR::INDEX:
+		if ((!object) &&
+			(json_PathIndex(s->start, (s->start < 0) ? json_TextCountItems(child.lexer, false) : s->start + 1, &index)) &&
+			(json_TextGetItem(&child.lexer, index, &child.token))) {
+			return this->MatchText(state, &child, step + 1);
+		}
+		break;
+	case JSON_PATH_SELECTOR::SLICE:
+		if ((object) || (s->stride == 0)) {
+			break;
+		}
 
-			if (p != -1) {
-				n++;
-				if (n >= p) {
-					json_GeneratorAppend(context, '\n', true);
-					json_GeneratorIndentation(context);
+		json_PathSlice(s->hasStart, s->start, s->hasEnd, s->end, s->stride, json_TextCountItems(child.lexer, false), &lower, &upper);
 
-					extraChars = format;
-					while ((*extraChars != '\0') && (*extraChars != 'e')) {
-						json_GeneratorAppend(context, *extraChars, true);
-						extraChars++;
-					}
-					n = 0;
+		if (s->stride > 0)
+		{
+			for (i = 0; (i < upper) && (json_TextNextItem(&child.lexer, false, (i == 0), &key, &child.token)); i++)
+			{
+				if ((i >= lower) && (((i - lower) % s->stride) == 0) && (!this->MatchText(state, &child, step + 1))) {
+					return false;
+				}
+				if (!json_TextSkipValue(&child.lexer, &child.token, &end)) {
+					break;
+				}
+			}
+		}
+		else
+		{
+			// The items are found from the start of the array again for every selected item
+			for (i = upper; i > lower; i += s->stride)
+			{
+				child.lexer = cursor->lexer;
+				if ((json_TextGetItem(&child.lexer, (unsigned long)i, &child.token)) && (!this->MatchText(state, &child, step + 1))) {
+					return false;
 				}
 			}
 		}
+		break;
 	}
 
-	return NULL;
+	return true;
 }
 
-// ------------------------------ //
-// **   Forward declarations   ** //
-// ------------------------------ //
-
-// Parse JSON string
-char* json_ParseString(char** pp_json, JSON_PARSER_CONTEXT* context);
+size_t JSON_PATH::Evaluate(JSON_NODE* root, JSON_PATH_CALLBACK callback, void* userData)
+{
+	STATE state;
 
-// Parse JSON number
-char* json_ParseNumber(char** pp_json, JSON_PARSER_CONTEXT* context);
+	if ((!this->compiled) || (root == NULL) || (callback == NULL)) {
+		return 0;
+	}
 
-// Parse JSON literal
-bool json_ParseLiteral(char** pp_json, JSON_PARSER_CONTEXT* context, JSON_TYPE* pType);
+	state.callback = callback;
+	state.textCallback = NULL;
+	state.userData = userData;
+	state.json = NULL;
+	state.matches = 0;
 
-// Parse JSON array
-JSON_NODE* json_ParseArray(char** pp_json, JSON_PARSER_CONTEXT* context);
+	this->Match(&state, root, 0);
 
-// Parse JSON object
-JSON_NODE* json_ParseObject(char** pp_json, JSON_PARSER_CONTEXT* context);
+	return state.matches;
+}
 
-// --------------------------------------- //
-// **   Internal JSON parse functions   ** //
-// --------------------------------------- //
+// Keep the 1st node found and stop the evaluation
+bool json_PathFirst(JSON_NODE* node, void* userData)
+{
+	*(JSON_NODE**)userData = node;
+	return false;
+}
 
-// Get the next token in the JSON string
-JSON_TOKEN json_GetToken(char** pp_json, JSON_PARSER_CONTEXT* context)
+JSON_NODE* JSON_PATH::First(JSON_NODE* root)
 {
-	const char* pJson;
-	unsigned char CharUnits;
-	unsigned long CodePoint;
-	JSON_TOKEN token;
+	JSON_NODE* node;
 
-	pJson = *pp_json;
-	token = JSON_TOKEN::UNRECOGNIZED_TOKEN;
+	node = NULL;
+	this->Evaluate(root, json_PathFirst, &node);
 
-getCodePoint:
+	return node;
+}
 
-	CharUnits = UTF8_Encoding::GetCharacterUnits(*pJson);
-	CodePoint = UTF8_Encoding::Decode(CharUnits, pJson);
+size_t JSON_PATH::EvaluateText(const char* json, JSON_PATH_TEXT_CALLBACK callback, void* userData)
+{
+	return this->EvaluateText(json, (json != NULL) ? strlen(json) : 0, callback, userData);
+}
 
-	if (CodePoint == ' ')
-	{
-		pJson += CharUnits;
-		context->charNumber++;
-		goto getCodePoint;
-	}
+size_t JSON_PATH::EvaluateText(const char* json, size_t length, JSON_PATH_TEXT_CALLBACK callback, void* userData)
+{
+	STATE state;
 
-	if (CodePoint == '\t')
-	{
-		pJson += CharUnits;
-		context->charNumber++;
-		goto getCodePoint;
+	if ((!this->compiled) || (json == NULL) || (callback == NULL)) {
+		return 0;
 	}
 
-	if (CodePoint == '\n')
-	{
-		pJson += CharUnits;
-		context->lineNumber++;
-		context->charNumber++;
-		goto getCodePoint;
+	CURSOR root = { JSON_LEXER(json, length), JSON_LEXER_TOKEN() };
+	if (!root.lexer.Next(&root.token)) {
+		return 0;
 	}
 
-	if (CodePoint == '\r')
-	{
-		pJson += CharUnits;
-		context->charNumber++;
-		goto getCodePoint;
-	}
+	state.callback = NULL;
+	state.textCallback = callback;
+	state.userData = userData;
+	state.json = json;
+	state.matches = 0;
 
-	if (CodePoint == '\"')
-	{
-		token = JSON_TOKEN::STRING;
-		pJson += CharUnits;
-		context->charNumber++;
-	}
-	else if (CodePoint == '{')
-	{
-		token = JSON_TOKEN::CURLY_OPEN;
-		pJson += CharUnits;
-		context->charNumber++;
-	}
-	else if (CodePoint == '}')
-	{
-		token = JSON_TOKEN::CURLY_CLOSE;
-		pJson += CharUnits;
-		context->charNumber++;
-	}
-	else if ((CodePoint == '-') || ((CodePoint >= '0') && (CodePoint <= '9')))
-	{
-		token = JSON_TOKEN::NUMBER;
-	}
-	else if (((CodePoint >= 'A') && (CodePoint <= 'Z')) || ((CodePoint >= 'a') && (CodePoint <= 'z')))
-	{
-		token = JSON_TOKEN::LITERAL;
-	}
-	else if (CodePoint == '[')
-	{
-		token = JSON_TOKEN::ARRAY_OPEN;
-		pJson += CharUnits;
-		context->charNumber++;
-	}
-	else if (CodePoint == ']')
-	{
-		token = JSON_TOKEN::ARRAY_CLOSE;
-		pJson += CharUnits;
-		context->charNumber++;
+	this->MatchText(&state, &root, 0);
+
+	return state.matches;
+}
+
+size_t JSON_PATH::Count()
+{
+	return this->count;
+}
+
+// ----------------------------- //
+// **   JSON_PACKED methods   ** //
+// ----------------------------- //
+
+// Number of bits of the type in JSON_PACKED_NODE::typeAndLength, the number of items or the length is stored above them
+#define JSON_PACKED_TYPE_BITS 3
+#define JSON_PACKED_TYPE_MASK 0x7U
+
+// Largest number of items of an object or array, or length of a string or number, in a packed document
+#define JSON_PACKED_MAX_LENGTH (0xFFFFFFFFU >> JSON_PACKED_TYPE_BITS)
+
+struct JSON_PACKED::FORMAT
+{
+	unsigned int node;
+	unsigned int format;
+};
+
+// Number of nodes, formats and bytes of strings of a packed document
+struct JSON_PACKED_SIZES
+{
+	unsigned long long nodes;
+	unsigned long long formats;
+	unsigned long long strings;
+};
+
+// Count the nodes, formats and strings of a tree before it is packed
+// Returns false if an object, array, string or number is too large for a packed node
+bool json_PackedCount(JSON_NODE* node, JSON_PACKED_SIZES* sizes)
+{
+	JSON_NODE* item;
+	size_t length;
+
+	sizes->nodes++;
+
+	if (node->key != NULL) {
+		sizes->strings += ((node->flags & JSON_NODE_FLAG_KEY) ? node->keyLength : strlen(node->key)) + 1;
 	}
-	else if (CodePoint == ':')
+
+	if (node->format != NULL)
 	{
-		token = JSON_TOKEN::COLON;
-		pJson += CharUnits;
-		context->charNumber++;
+		sizes->formats++;
+		sizes->strings += strlen(node->format) + 1;
 	}
-	else if (CodePoint == ',')
+
+	if (json_IsContainer(node->type))
 	{
-		token = JSON_TOKEN::COMMA;
-		pJson += CharUnits;
-		context->charNumber++;
+		length = 0;
+		for (item = (JSON_NODE*)node->value; item != NULL; item = item->next)
+		{
+			if (!json_PackedCount(item, sizes)) {
+				return false;
+			}
+			length++;
+		}
 	}
-	else if (CodePoint == 0)
+	else if ((node->type == JSON_TYPE::STRING) || (node->type == JSON_TYPE::NUMBER))
 	{
-		token = JSON_TOKEN::JSON_END;
+		length = (node->value != NULL) ? strlen((const char*)node->value) : 0;
+		sizes->strings += length + 1;
 	}
-	else
-	{
-		context->charNumber++;
+	else {
+		length = 0;
 	}
 
-	*pp_json = (char*)pJson;
-
-	return token;
+	return (length <= JSON_PACKED_MAX_LENGTH);
 }
 
-// Parse a JSON string (key or value)
-char* json_ParseString(char** pp_json, JSON_PARSER_CONTEXT* context)
+// Copy a string to the end of the strings of a packed document, returns its offset
+unsigned int json_PackedString(char* strings, const char* string, size_t length, size_t* pStrings)
 {
-	size_t i;
-	unsigned char CharUnits;
-	unsigned long CodePoint;
-	const char* pJson;
-	bool bEscape;
-	char* buffer;
-	size_t bufferLength;
-	char* pNewBuffer;
+	unsigned int offset;
 
-	pJson = *pp_json;
-	bEscape = false;
+	offset = (unsigned int)*pStrings;
+	memcpy(&strings[offset], string, length);
+	strings[offset + length] = '\0';
+	*pStrings += length + 1;
 
-	// bufferLength = 0;
-	// buffer = NULL;
+	return offset;
+}
 
-	// Allocating here makes the compiler happy but is not actually needed
-	bufferLength = JSON_PARSER_BUFFER_INCREASE;
-	buffer = (char*)malloc(bufferLength);
-	if (buffer == NULL) {
-		context->errorCode = JSON_ERROR_CODE::OUT_OF_MEMORY;
-		context->errorDescription = JSON_ERROR_STRINGS[(int)context->errorCode];
+// Create a node tree from a packed node, the root gets a header that stores the allocator
+JSON_NODE* json_UnpackNode(JSON_PACKED* packed, const JSON_PACKED_NODE* packedNode, const JSON_ALLOCATOR* allocator, bool hasHeader)
+{
+	JSON_NODE* node;
+	JSON_NODE* item;
+	JSON_NODE* tail;
+	const char* text;
+	char* format;
+	size_t count, length, i;
+
+	node = json_AllocateNode(allocator, packed->Type(packedNode), hasHeader);
+	if (node == NULL) {
 		return NULL;
 	}
 
-	i = 0;
+	text = packed->Key(packedNode);
+	if ((text != NULL) && (!json_CopyKey(node, text, allocator))) {
+		json_free_node(node, allocator);
+		return NULL;
+	}
 
-	while (true)
+	text = packed->Format(packedNode);
+	if (text != NULL)
 	{
-		context->beginIndex = context->charNumber;
-
-		CharUnits = UTF8_Encoding::GetCharacterUnits(*pJson);
-		CodePoint = UTF8_Encoding::Decode(CharUnits, pJson);
+		length = strlen(text) + 1;
+		format = (char*)json_Allocate(allocator, length);
+		if (format == NULL) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
+		memcpy(format, text, length);
+		node->format = format;
+	}
 
-		if (!bEscape)
+	switch (node->type)
+	{
+	case JSON_TYPE::OBJECT:
+	case JSON_TYPE::ARRAY:
+		tail = NULL;
+		count = packed->Count(packedNode);
+		for (i = 0; i < count; i++)
 		{
-			// Escape character?
-			if (CodePoint == '\\')
-			{
-				bEscape = true;
-				pJson += CharUnits;
-				context->charNumber++;
-				continue;
+			item = json_UnpackNode(packed, packed->Item(packedNode, i), allocator, false);
+			if (item == NULL) {
+				json_free_node(node, allocator);
+				return NULL;
 			}
-
-			// End of string?
-			if (CodePoint == '\"')
-			{
-				pJson += CharUnits;
-				context->charNumber++;
-				break;
+			if (tail == NULL) {
+				node->value = item;
 			}
-
-			// All Unicode characters may be placed within the
-			//	 quotation marks, except for the characters that MUST be escaped :
-			// quotation mark, reverse solidus, and the control characters(U + 0000
-			//	 through U + 001F).
-
-			if (((CodePoint >= 0x0000) && (CodePoint <= 0x001F)) ||
-				(CodePoint == '"') || (CodePoint == '\\'))
-			{
-				context->errorCode = JSON_ERROR_CODE::STRING_CHARACTERS_MUST_BE_ESCAPED;
-				context->charNumber++;
-				break;
+			else {
+				tail->next = item;
 			}
+			tail = item;
 		}
-		else
-		{
-			// Convert visual representation of control characters
-			if (CodePoint == 'n') {
-				CodePoint = 0x0A; // line feed
-			}
-			else if (CodePoint == 'r') {
-				CodePoint = 0x0D; // carriage return
-			}
-			else if (CodePoint == 't') {
-				CodePoint = 0x09; // tab
-			}
-			else if (CodePoint == 'f') {
-				CodePoint = 0x0C; // form feed
-			}
-			else if (CodePoint == 'b') {
-				CodePoint = 0x08; // backspace
-			}
-			else
-			{
-				// Force strict string escaping for code editor?
-				if (context->visualEscapeOnly == true)
-				{
-					if ((CodePoint == 0x0A) || (CodePoint == 0x0D) ||
-						(CodePoint == 0x09) || (CodePoint == 0x0C) || (CodePoint == 0x08)) {
-						context->errorCode = JSON_ERROR_CODE::STRING_FORCED_STRICT_ESCAPING;
-						context->charNumber++;
-						break;
-					}
-				}
-				// Must be a quotation mark, reverse solidus, or control character
-				if ((CodePoint > 0x001F) && (CodePoint != '"') && (CodePoint != '\\')) {
-					context->errorCode = JSON_ERROR_CODE::STRING_UNUSED_ESCAPE_CHARACTER;
-					context->charNumber++;
-					break;
-				}
-			}
-			bEscape = false;
+		break;
+	case JSON_TYPE::STRING:
+	case JSON_TYPE::NUMBER:
+		if (!json_CopyValue(node, packed->String(packedNode), allocator)) {
+			json_free_node(node, allocator);
+			return NULL;
 		}
+		break;
+	case JSON_TYPE::BOOLEAN:
+		node->value = (void*)packed->Boolean(packedNode);
+		break;
+	default:
+		break;
+	}
+
+	return node;
+}
+
+JSON_PACKED::JSON_PACKED(const JSON_ALLOCATOR* allocator)
+{
+	this->nodes = NULL;
+	this->count = 0;
+	this->formats = NULL;
+	this->formatCount = 0;
+	this->strings = NULL;
+	this->size = 0;
+	this->allocator = allocator;
+}
+
+JSON_PACKED::~JSON_PACKED()
+{
+	this->Clear();
+}
 
-		if (CodePoint == '\0') {
-			context->errorCode = JSON_ERROR_CODE::EXPECTED_DOUBLE_QUOTES_ENCOUNTERED_JSON_END;
-			context->charNumber++;
-			break;
-		}
+void JSON_PACKED::PackNode(JSON_NODE* node, size_t index, size_t* pStrings)
+{
+	JSON_PACKED_NODE* packed;
+	JSON_NODE* item;
+	size_t length;
 
-		// buffer big enough for CodePoint + NULL character ?
-		if ((i + CharUnits + 1) > bufferLength)
-		{
-			bufferLength += JSON_PARSER_BUFFER_INCREASE;
-			pNewBuffer = (char*)realloc(buffer, bufferLength);
-			if (pNewBuffer != NULL) {
-				buffer = pNewBuffer;
-			}
-			else {
-				context->errorCode = JSON_ERROR_CODE::OUT_OF_MEMORY;
-				break;
-			}
+	packed = &this->nodes[index];
+	packed->key = 0;
+	packed->keyHash = 0;
+	packed->value = 0;
+
+	if (node->key != NULL)
+	{
+		length = (node->flags & JSON_NODE_FLAG_KEY) ? node->keyLength : strlen(node->key);
+		packed->key = json_PackedString(this->strings, node->key, length, pStrings);
+		packed->keyHash = (node->flags & JSON_NODE_FLAG_KEY) ? node->keyHash : json_HashKey(node->key, length);
+	}
+
+	// Nodes are written in the order of their index, so the side table of formats stays sorted
+	if (node->format != NULL)
+	{
+		this->formats[this->formatCount].node = (unsigned int)index;
+		this->formats[this->formatCount].format = json_PackedString(this->strings, node->format, strlen(node->format), pStrings);
+		this->formatCount++;
+	}
+
+	length = 0;
+	if (json_IsContainer(node->type))
+	{
+		for (item = (JSON_NODE*)node->value; item != NULL; item = item->next) {
+			length++;
 		}
+	}
+	else if ((node->type == JSON_TYPE::STRING) || (node->type == JSON_TYPE::NUMBER))
+	{
+		length = (node->value != NULL) ? strlen((const char*)node->value) : 0;
+		packed->value = json_PackedString(this->strings, (node->value != NULL) ? (const char*)node->value : "", length, pStrings);
+	}
+	else if (node->type == JSON_TYPE::BOOLEAN) {
+		packed->value = (node->value != NULL) ? 1 : 0;
+	}
 
-		UTF8_Encoding::EncodeUnsafe(&buffer[i], CodePoint);
+	packed->typeAndLength = (unsigned int)node->type | (unsigned int)(length << JSON_PACKED_TYPE_BITS);
+}
 
-		pJson += CharUnits;
-		context->charNumber++;
-		i += CharUnits;
+void JSON_PACKED::PackItems(JSON_NODE* container, size_t index, size_t* pNext, size_t* pStrings)
+{
+	JSON_NODE* item;
+	size_t first, i;
+
+	first = *pNext;
+	*pNext += this->nodes[index].typeAndLength >> JSON_PACKED_TYPE_BITS;
+	if (*pNext != first) {
+		this->nodes[index].value = (unsigned int)first;
 	}
 
-	if (context->errorCode != JSON_ERROR_CODE::NONE) {
-		if (buffer != NULL) {
-			free(buffer);
+	i = first;
+	for (item = (JSON_NODE*)container->value; item != NULL; item = item->next) {
+		this->PackNode(item, i++, pStrings);
+	}
+
+	// The items of each object and array follow the object or array they are in, before the items of the next one
+	i = first;
+	for (item = (JSON_NODE*)container->value; item != NULL; item = item->next)
+	{
+		if (json_IsContainer(item->type)) {
+			this->PackItems(item, i, pNext, pStrings);
 		}
+		i++;
+	}
+}
+
+bool JSON_PACKED::Pack(JSON_NODE* json_root)
+{
+	JSON_PACKED_SIZES sizes;
+	unsigned long long size;
+	size_t next, stringsEnd;
+	char* block;
+
+	this->Clear();
+
+	if (json_root == NULL) {
+		return false;
+	}
+
+	// The strings start with an empty string, so a key at offset 0 is no key
+	sizes.nodes = 0;
+	sizes.formats = 0;
+	sizes.strings = 1;
+	if ((!json_PackedCount(json_root, &sizes)) || (sizes.nodes > 0xFFFFFFFFULL) || (sizes.strings > 0xFFFFFFFFULL)) {
+		return false;
+	}
+
+	size = (sizes.nodes * sizeof(JSON_PACKED_NODE)) + (sizes.formats * sizeof(FORMAT)) + sizes.strings;
+	if (size != (size_t)size) {
+		return false;
+	}
+
+	block = (char*)json_Allocate(this->allocator, (size_t)size);
+	if (block == NULL) {
+		return false;
+	}
+
+	this->nodes = (JSON_PACKED_NODE*)block;
+	this->count = (size_t)sizes.nodes;
+	this->formats = (FORMAT*)(this->nodes + this->count);
+	this->formatCount = 0;
+	this->strings = (char*)(this->formats + sizes.formats);
+	this->size = (size_t)size;
+
+	this->strings[0] = '\0';
+	stringsEnd = 1;
+	next = 1;
+
+	this->PackNode(json_root, 0, &stringsEnd);
+	if (json_IsContainer(json_root->type)) {
+		this->PackItems(json_root, 0, &next, &stringsEnd);
+	}
+
+	return true;
+}
+
+JSON_NODE* JSON_PACKED::Unpack(const JSON_ALLOCATOR* allocator)
+{
+	if (this->count == 0) {
 		return NULL;
 	}
 
-	buffer[i] = '\0';
-	*pp_json = (char*)pJson;
+	return json_UnpackNode(this, this->nodes, allocator, true);
+}
 
-	return buffer;
+void JSON_PACKED::Clear()
+{
+	if (this->nodes != NULL) {
+		json_Deallocate(this->allocator, this->nodes);
+	}
+
+	this->nodes = NULL;
+	this->count = 0;
+	this->formats = NULL;
+	this->formatCount = 0;
+	this->strings = NULL;
+	this->size = 0;
 }
 
-// Parse a JSON number, we return the number as an individual string to avoid type assumptions
-char* json_ParseNumber(char** pp_json, JSON_PARSER_CONTEXT* context)
+size_t JSON_PACKED::Count()
 {
-	unsigned char CharUnits;
-	unsigned long CodePoint;
-	const char* pJson;
-	size_t strLen;
-	char* result;
+	return this->count;
+}
 
-	pJson = *pp_json;
-	context->beginIndex = context->charNumber;
+size_t JSON_PACKED::Size()
+{
+	return this->size;
+}
 
-	CharUnits = UTF8_Encoding::GetCharacterUnits(*pJson);
-	CodePoint = UTF8_Encoding::Decode(CharUnits, pJson);
+const JSON_PACKED_NODE* JSON_PACKED::Root()
+{
+	return (this->count != 0) ? this->nodes : NULL;
+}
 
-	strLen = 0;
-	while ((CodePoint == '-') || ((CodePoint >= '0') && (CodePoint <= '9')) || (CodePoint == '.'))
-	{
-		pJson += CharUnits;
-		CharUnits = UTF8_Encoding::GetCharacterUnits(*pJson);
-		CodePoint = UTF8_Encoding::Decode(CharUnits, pJson);
-		strLen += CharUnits;
-		context->charNumber++;
+JSON_TYPE JSON_PACKED::Type(const JSON_PACKED_NODE* node)
+{
+	return (JSON_TYPE)(node->typeAndLength & JSON_PACKED_TYPE_MASK);
+}
+
+const char* JSON_PACKED::Key(const JSON_PACKED_NODE* node)
+{
+	return (node->key != 0) ? &this->strings[node->key] : NULL;
+}
+
+const char* JSON_PACKED::String(const JSON_PACKED_NODE* node, size_t* pLength)
+{
+	JSON_TYPE type;
+
+	type = this->Type(node);
+	if ((type != JSON_TYPE::STRING) && (type != JSON_TYPE::NUMBER)) {
+		return NULL;
+	}
+
+	if (pLength != NULL) {
+		*pLength = node->typeAndLength >> JSON_PACKED_TYPE_BITS;
 	}
 
-	result = (char*)malloc(strLen + 1);
-	if (result == 0) {
+	return &this->strings[node->value];
+}
+
+bool JSON_PACKED::Boolean(const JSON_PACKED_NODE* node)
+{
+	return (this->Type(node) == JSON_TYPE::BOOLEAN) && (node->value != 0);
+}
+
+size_t JSON_PACKED::Count(const JSON_PACKED_NODE* node)
+{
+	if (!json_IsContainer(this->Type(node))) {
 		return 0;
 	}
 
-	memcpy(result, *pp_json, strLen);
-	result[strLen] = 0;
+	return node->typeAndLength >> JSON_PACKED_TYPE_BITS;
+}
 
-	*pp_json += strLen;
+const JSON_PACKED_NODE* JSON_PACKED::Item(const JSON_PACKED_NODE* node, size_t i)
+{
+	if (i >= this->Count(node)) {
+		return NULL;
+	}
 
-	return result;
+	return &this->nodes[node->value + i];
 }
 
-// JSON literal names are: "false", "null" and "true"
-// The literal names MUST be lowercase.  No other literal names are allowed.
-bool json_ParseLiteral(char** pp_json, JSON_PARSER_CONTEXT* context, JSON_TYPE* pType)
+const JSON_PACKED_NODE* JSON_PACKED::Find(const JSON_PACKED_NODE* object, const char* key)
 {
-	const char* pJson;
-	unsigned char CharUnits;
-	unsigned long CodePoint;
-	size_t wordLength;
+	return this->Find(object, key, json_KeyLength(key));
+}
 
-	pJson = *pp_json;
-	context->beginIndex = context->charNumber;
+const JSON_PACKED_NODE* JSON_PACKED::Find(const JSON_PACKED_NODE* object, const char* key, size_t keyLength)
+{
+	const JSON_PACKED_NODE* item;
+	const JSON_PACKED_NODE* end;
+	unsigned int hash;
 
-	wordLength = 0;
-	bool bValue = false;
+	if ((key == NULL) || (this->Type(object) != JSON_TYPE::OBJECT)) {
+		return NULL;
+	}
 
-	while (true)
+	hash = json_HashKey(key, keyLength);
+
+	// Keys are null terminated, so a key with the same bytes that ends after `keyLength` bytes is equal
+	item = &this->nodes[object->value];
+	end = item + this->Count(object);
+	for (; item < end; item++)
 	{
-		CharUnits = UTF8_Encoding::GetCharacterUnits(*pJson);
-		CodePoint = UTF8_Encoding::Decode(CharUnits, pJson);
+		if ((item->keyHash == hash) && (item->key != 0) && (memcmp(&this->strings[item->key], key, keyLength) == 0) &&
+			(this->strings[item->key + keyLength] == '\0')) {
+			return item;
+		}
+	}
 
-		if (((CodePoint >= 'A') && (CodePoint <= 'Z')) ||
-			((CodePoint >= 'a') && (CodePoint <= 'z')) ||
-			((CodePoint >= '0') && (CodePoint <= '9')) ||
-			(CodePoint == '_'))
-		{
-			wordLength += CharUnits;
+	return NULL;
+}
 
-			context->charNumber++;
-			pJson += CharUnits;
+const char* JSON_PACKED::Format(const JSON_PACKED_NODE* node)
+{
+	size_t low, high, middle;
+	unsigned int index;
+
+	// Binary search of the side table, it is sorted by node index
+	index = (unsigned int)(node - this->nodes);
+	low = 0;
+	high = this->formatCount;
+	while (low < high)
+	{
+		middle = low + ((high - low) / 2);
+		if (this->formats[middle].node < index) {
+			low = middle + 1;
 		}
 		else {
-			break;
+			high = middle;
 		}
 	}
 
-	if (strncmp(*pp_json, "false", wordLength) == 0) {
-		*pType = JSON_TYPE::BOOLEAN;
-	}
-	else if (strncmp(*pp_json, "true", wordLength) == 0) {
-		*pType = JSON_TYPE::BOOLEAN;
-		bValue = true;
-	}
-	else if (strncmp(*pp_json, "null", wordLength) == 0) {
-		*pType = JSON_TYPE::NULL_TYPE;
+	if ((low < this->formatCount) && (this->formats[low].node == index)) {
+		return &this->strings[this->formats[low].format];
 	}
-	else {
-		context->errorCode = JSON_ERROR_CODE::INVALID_LITERAL_NAME;
-	}
-
-	*pp_json = (char*)pJson;
 
-	return bValue;
+	return NULL;
 }
 
-// Parse a JSON array
-JSON_NODE* json_ParseArray(char** pp_json, JSON_PARSER_CONTEXT* context)
-{
-	JSON_TOKEN token;
-	JSON_NODE* root, * node, * prev_node;
-	const char* pJson;
-	bool hasCompleted;
+// ------------------------------ //
+// **   JSON_COLUMNS methods   ** //
+// ------------------------------ //
 
-	root = node = prev_node = 0;
-	hasCompleted = false;
+// Initial number of rows in the buffers of the columns, the buffers double in size when they are full
+#define JSON_COLUMNS_MIN_CAPACITY 64
 
-	pJson = *pp_json;
+struct JSON_COLUMNS::COLUMN
+{
+	// Key of the member, with its length and hash
+	JSON_LOOKUP_KEY key;
+	JSON_COLUMN_TYPE type;
+	// A long long, double or bool for each row, or the offsets of the strings with one more offset than rows
+	void* values;
+	// Bytes of the strings and the size of their buffer
+	char* strings;
+	size_t stringsCapacity;
+	// Bit for each row, set when the value is null
+	unsigned char* nulls;
+	// Number of rows when the column was last written, only the 1st member with the key is written like in key lookups
+	size_t filled;
+};
 
-	while (!hasCompleted)
+struct JSON_COLUMNS::VALUE
+{
+	JSON_TYPE type;
+	// String or number, from a JSON string they are not null terminated and strings have escape sequences
+	const char* text;
+	size_t length;
+	bool json;
+	bool boolean;
+};
+
+// Get the size of a value of a column in bytes
+size_t json_ColumnSize(JSON_COLUMN_TYPE type)
+{
+	switch (type)
 	{
-		context->beginIndex = context->charNumber;
-		token = json_GetToken((char**)&pJson, context);
+	case JSON_COLUMN_TYPE::INT64:
+		return sizeof(long long);
+	case JSON_COLUMN_TYPE::DOUBLE:
+		return sizeof(double);
+	case JSON_COLUMN_TYPE::BOOLEAN:
+		return sizeof(bool);
+	default:
+		return sizeof(size_t);
+	}
+}
 
-		switch (token)
-		{
-		case JSON_TOKEN::CURLY_CLOSE:
-			context->errorCode = JSON_ERROR_CODE::UNEXPECTED_CLOSING_CURLY_BRACKET;
-			break;
-		case JSON_TOKEN::COLON:
-			context->errorCode = JSON_ERROR_CODE::UNEXPECTED_PAIR_COLON_TOKEN;
-			break;
-		case JSON_TOKEN::CURLY_OPEN:
-			if (node)
-			{
-				context->errorCode = JSON_ERROR_CODE::UNEXPECTED_ARRAY_VALUE;
-				break;
-			}
-			else
-			{
-				node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-				if (!node)
-				{
-					context->errorCode = JSON_ERROR_CODE::OUT_OF_MEMORY;
-					break;
-				}
+JSON_COLUMNS::JSON_COLUMNS(const JSON_ALLOCATOR* allocator)
+{
+	this->columns = NULL;
+	this->count = 0;
+	this->rows = 0;
+	this->capacity = 0;
+	this->hint = 0;
+	this->allocator = allocator;
+}
 
-				memset(node, 0, sizeof(JSON_NODE));
-				node->type = JSON_TYPE::OBJECT;
-				node->value = json_ParseObject((char**)&pJson, context);
-				node->format = NULL;
+JSON_COLUMNS::~JSON_COLUMNS()
+{
+	size_t i;
 
-				if (prev_node) {
-					prev_node->next = node;
-				}
-			}
-			break;
-		case JSON_TOKEN::STRING:
-			if (node)
-			{
-				context->errorCode = JSON_ERROR_CODE::UNEXPECTED_ARRAY_VALUE;
-				break;
-			}
-			else
-			{
-				node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-				if (!node)
-				{
-					context->errorCode = JSON_ERROR_CODE::OUT_OF_MEMORY;
-					break;
-				}
+	for (i = 0; i < this->count; i++)
+	{
+		json_Deallocate(this->allocator, (void*)this->columns[i].key.key);
+		json_Deallocate(this->allocator, this->columns[i].values);
+		json_Deallocate(this->allocator, this->columns[i].strings);
+		json_Deallocate(this->allocator, this->columns[i].nulls);
+	}
 
-				memset(node, 0, sizeof(JSON_NODE));
-				node->type = JSON_TYPE::STRING;
-				node->value = json_ParseString((char**)&pJson, context);
-				node->format = NULL;
+	json_Deallocate(this->allocator, this->columns);
+}
 
-				if (prev_node) {
-					prev_node->next = node;
-				}
-			}
-			break;
-		case JSON_TOKEN::NUMBER:
-			if (node)
-			{
-				context->errorCode = JSON_ERROR_CODE::UNEXPECTED_ARRAY_VALUE;
-				break;
-			}
-			else
-			{
-				node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-				if (!node)
-				{
-					context->errorCode = JSON_ERROR_CODE::OUT_OF_MEMORY;
-					break;
-				}
+bool JSON_COLUMNS::GrowColumn(COLUMN* column, size_t capacity)
+{
+	void* values;
+	unsigned char* nulls;
 
-				memset(node, 0, sizeof(JSON_NODE));
-				node->type = JSON_TYPE::NUMBER;
-				node->value = json_ParseNumber((char**)&pJson, context);
-				node->format = NULL;
+	// String columns have one more offset than rows
+	values = json_Reallocate(this->allocator, column->values, json_ColumnSize(column->type) * (capacity + 1));
+	if (values == NULL) {
+		return false;
+	}
+	if (column->values == NULL) {
+		memset(values, 0, json_ColumnSize(column->type));
+	}
+	column->values = values;
 
-				if (prev_node) {
-					prev_node->next = node;
-				}
-			}
-			break;
-		case JSON_TOKEN::LITERAL:
-			if (node)
-			{
-				context->errorCode = JSON_ERROR_CODE::UNEXPECTED_ARRAY_VALUE;
-				break;
-			}
-			else
-			{
-				node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-				if (!node)
-				{
-					context->errorCode = JSON_ERROR_CODE::OUT_OF_MEMORY;
-					break;
-				}
+	nulls = (unsigned char*)json_Reallocate(this->allocator, column->nulls, (capacity + 7) / 8);
+	if (nulls == NULL) {
+		return false;
+	}
+	column->nulls = nulls;
 
-				memset(node, 0, sizeof(JSON_NODE));
-				node->value = (void*)json_ParseLiteral((char**)&pJson, context, &node->type);
-				node->format = NULL;
+	return true;
+}
 
-				if (prev_node) {
-					prev_node->next = node;
-				}
-			}
-			break;
-		case JSON_TOKEN::ARRAY_OPEN:
-			if (node)
-			{
-				context->errorCode = JSON_ERROR_CODE::UNEXPECTED_ARRAY_VALUE;
-				break;
+bool JSON_COLUMNS::AddRow()
+{
+	COLUMN* column;
+	size_t capacity, row, i;
+
+	if (this->rows == this->capacity)
+	{
+		capacity = (this->capacity != 0) ? this->capacity * 2 : JSON_COLUMNS_MIN_CAPACITY;
+		for (i = 0; i < this->count; i++)
+		{
+			if (!this->GrowColumn(&this->columns[i], capacity)) {
+				return false;
 			}
-			else
-			{
-				node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-				if (!node)
-				{
-					context->errorCode = JSON_ERROR_CODE::OUT_OF_MEMORY;
-					break;
-				}
+		}
+		this->capacity = capacity;
+	}
 
-				memset(node, 0, sizeof(JSON_NODE));
-				node->type = JSON_TYPE::ARRAY;
-				node->value = json_ParseArray((char**)&pJson, context);
-				node->format = NULL;
+	row = this->rows++;
 
-				if (prev_node) {
-					prev_node->next = node;
-				}
-			}
-			break;
-		case JSON_TOKEN::ARRAY_CLOSE:
-			hasCompleted = true;
-			break;
-		case JSON_TOKEN::COMMA:
-			prev_node = node;
-			node = 0;
+	for (i = 0; i < this->count; i++)
+	{
+		column = &this->columns[i];
+		column->nulls[row / 8] |= (unsigned char)(1 << (row % 8));
+
+		switch (column->type)
+		{
+		case JSON_COLUMN_TYPE::INT64:
+			((long long*)column->values)[row] = 0;
 			break;
-		case JSON_TOKEN::JSON_END:
-			context->errorCode = JSON_ERROR_CODE::EXPECTED_SQUARE_BRACKET_ENCOUNTERED_JSON_END;
+		case JSON_COLUMN_TYPE::DOUBLE:
+			((double*)column->values)[row] = 0.0;
 			break;
-		case JSON_TOKEN::UNRECOGNIZED_TOKEN:
-			context->errorCode = JSON_ERROR_CODE::UNRECOGNIZED_TOKEN;
+		case JSON_COLUMN_TYPE::BOOLEAN:
+			((bool*)column->values)[row] = false;
 			break;
-		default:
+		case JSON_COLUMN_TYPE::STRING:
+			((size_t*)column->values)[row + 1] = ((size_t*)column->values)[row];
 			break;
 		}
+	}
 
-		if ((!root) && (node)) {
-			root = node;
+	return true;
+}
+
+JSON_COLUMNS::COLUMN* JSON_COLUMNS::Find(const char* key, size_t keyLength, unsigned int hash)
+{
+	COLUMN* column;
+	size_t i, k;
+
+	// Start after the last column that was found, so members in the order of the columns are found at once
+	for (k = 0; k < this->count; k++)
+	{
+		i = this->hint + k;
+		if (i >= this->count) {
+			i -= this->count;
 		}
 
-		if (context->errorCode != JSON_ERROR_CODE::NONE) {
-			context->errorDescription = JSON_ERROR_STRINGS[(int)context->errorCode];
-			context->errorLength = context->charNumber - context->beginIndex;
-			break;
+		column = &this->columns[i];
+		if ((column->key.hash == hash) && (column->key.length == keyLength) && (memcmp(column->key.key, key, keyLength) == 0))
+		{
+			this->hint = i + 1;
+			return column;
 		}
 	}
 
-	*pp_json = (char*)pJson;
-
-	return root;
+	return NULL;
 }
 
-// Parse a JSON object
-JSON_NODE* json_ParseObject(char** pp_json, JSON_PARSER_CONTEXT* context)
+bool JSON_COLUMNS::SetValue(COLUMN* column, const VALUE* value)
 {
-	JSON_TOKEN token;
-	JSON_NODE* root, * node, * prev_node;
-	const char* pJson;
-	bool isKey;
-	bool hasCompleted;
+	char number[64];
+	const char* text;
+	size_t* offsets;
+	char* strings;
+	size_t row, length, capacity, i;
 
-	root = node = prev_node = 0;
-	isKey = true;
-	hasCompleted = false;
+	if (column->filled == this->rows) {
+		return true;
+	}
+	column->filled = this->rows;
 
-	pJson = *pp_json;
+	row = this->rows - 1;
 
-	while (!hasCompleted)
+	switch (column->type)
 	{
-		context->beginIndex = context->charNumber;
-		token = json_GetToken((char**)&pJson, context);
-
-		switch (token)
+	case JSON_COLUMN_TYPE::INT64:
+	case JSON_COLUMN_TYPE::DOUBLE:
+		if ((value->type != JSON_TYPE::NUMBER) || (value->text == NULL)) {
+			return true;
+		}
+		text = value->text;
+		if (value->json)
 		{
-		case JSON_TOKEN::CURLY_CLOSE:
-			hasCompleted = true;
-			break;
-		case JSON_TOKEN::COLON:
-			isKey = false;
-			break;
-		case JSON_TOKEN::CURLY_OPEN:
-			if (!node)
-			{
-				context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_KEY_NOT_DEFINED;
-				break;
+			length = (value->length < sizeof(number)) ? value->length : sizeof(number) - 1;
+			memcpy(number, text, length);
+			number[length] = '\0';
+			text = number;
+		}
+		if (column->type == JSON_COLUMN_TYPE::INT64) {
+			((long long*)column->values)[row] = json_NumberInt64(text);
+		}
+		else {
+			((double*)column->values)[row] = json_NumberValue(text);
+		}
+		break;
+	case JSON_COLUMN_TYPE::BOOLEAN:
+		if (value->type != JSON_TYPE::BOOLEAN) {
+			return true;
+		}
+		((bool*)column->values)[row] = value->boolean;
+		break;
+	case JSON_COLUMN_TYPE::STRING:
+		if ((value->type != JSON_TYPE::STRING) || (value->text == NULL)) {
+			return true;
+		}
+		offsets = (size_t*)column->values;
+		if (offsets[row] + value->length > column->stringsCapacity)
+		{
+			capacity = (column->stringsCapacity != 0) ? column->stringsCapacity * 2 : JSON_COLUMNS_MIN_CAPACITY * 8;
+			while (capacity < offsets[row] + value->length) {
+				capacity *= 2;
 			}
-			else
+			strings = (char*)json_Reallocate(this->allocator, column->strings, capacity);
+			if (strings == NULL) {
+				return false;
+			}
+			column->strings = strings;
+			column->stringsCapacity = capacity;
+		}
+		strings = &column->strings[offsets[row]];
+		if (value->json)
+		{
+			// Decode the escape sequences, the string gets shorter
+			length = 0;
+			for (i = 0; i < value->length; i++)
 			{
-				if (isKey) {
-					context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_EXPECTED_COLON;
-					break;
+				if ((value->text[i] == '\\') && (i + 1 < value->length)) {
+					strings[length++] = json_UnescapeCharacter(value->text[++i]);
+				}
+				else {
+					strings[length++] = value->text[i];
 				}
-				node->type = JSON_TYPE::OBJECT;
-				node->value = json_ParseObject((char**)&pJson, context);
 			}
-			break;
-		case JSON_TOKEN::STRING:
-			if (!isKey)
-			{
-				node->type = JSON_TYPE::STRING;
-				node->value = json_ParseString((char**)&pJson, context);
+		}
+		else
+		{
+			// The buffer is not allocated yet when every string so far is empty
+			length = value->length;
+			if (length != 0) {
+				memcpy(strings, value->text, length);
 			}
-			else
-			{
-				if (node)
-				{
-					context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_KEY_ALREADY_DEFINED;
-					break;
-				}
-				else
-				{
-					node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-					if (!node)
-					{
-						context->errorCode = JSON_ERROR_CODE::OUT_OF_MEMORY;
-						break;
-					}
+		}
+		offsets[row + 1] = offsets[row] + length;
+		break;
+	}
 
-					memset(node, 0, sizeof(JSON_NODE));
-					node->key = json_ParseString((char**)&pJson, context);
-					node->format = NULL;
+	column->nulls[row / 8] &= (unsigned char)~(1 << (row % 8));
 
-					if (prev_node) {
-						prev_node->next = node;
-					}
-				}
+	return true;
+}
+
+bool JSON_COLUMNS::LoadTextObject(JSON_LEXER* lexer, const char* json)
+{
+	JSON_LEXER_TOKEN key, token;
+	COLUMN* column;
+	VALUE value;
+	const char* name;
+	size_t length, end, i;
+	bool isKeyOnly;
+
+	if (!lexer->Next(&token)) {
+		return false;
+	}
+	if (token.type == JSON_TOKEN::CURLY_CLOSE) {
+		return true;
+	}
+
+	while (true)
+	{
+		key = token;
+		if ((key.type != JSON_TOKEN::STRING) || (key.length < 2) || (json[key.offset + key.length - 1] != '\"')) {
+			return false;
+		}
+		if (!lexer->Next(&token)) {
+			return false;
+		}
+
+		// A key without a value is an empty object, like the key-only members of the parser
+		isKeyOnly = ((token.type == JSON_TOKEN::COMMA) || (token.type == JSON_TOKEN::CURLY_CLOSE));
+		if (!isKeyOnly)
+		{
+			if ((token.type != JSON_TOKEN::COLON) || (!lexer->Next(&token))) {
+				return false;
 			}
-			break;
-		case JSON_TOKEN::NUMBER:
-			if (!node)
-			{
-				context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_KEY_NOT_DEFINED;
-				break;
+			if ((token.type != JSON_TOKEN::CURLY_OPEN) && (token.type != JSON_TOKEN::ARRAY_OPEN) && (token.type != JSON_TOKEN::STRING) &&
+				(token.type != JSON_TOKEN::NUMBER) && (token.type != JSON_TOKEN::LITERAL)) {
+				return false;
 			}
-			else
+		}
+
+		// Keys with escape sequences are decoded while they are compared
+		name = &json[key.offset + 1];
+		length = key.length - 2;
+		column = NULL;
+		if (memchr(name, '\\', length) == NULL) {
+			column = this->Find(name, length, json_HashKey(name, length));
+		}
+		else
+		{
+			for (i = 0; (i < this->count) && (column == NULL); i++)
 			{
-				if (isKey) {
-					context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_EXPECTED_COLON;
-					break;
+				if (json_TextKeyEquals(json, &key, &this->columns[i].key)) {
+					column = &this->columns[i];
 				}
-				node->type = JSON_TYPE::NUMBER;
-				node->value = json_ParseNumber((char**)&pJson, context);
-			}
-			break;
-		case JSON_TOKEN::LITERAL:
-			if (!node)
-			{
-				context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_KEY_NOT_DEFINED;
-				break;
 			}
-			else
+		}
+
+		if (column != NULL)
+		{
+			value.text = &json[token.offset];
+			value.length = token.length;
+			value.json = true;
+			value.boolean = false;
+			switch ((isKeyOnly) ? JSON_TOKEN::CURLY_OPEN : token.type)
 			{
-				if (isKey) {
-					context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_EXPECTED_COLON;
-					break;
+			case JSON_TOKEN::STRING:
+				if ((token.length < 2) || (json[token.offset + token.length - 1] != '\"')) {
+					return false;
 				}
-				node->value = (void*)json_ParseLiteral((char**)&pJson, context, &node->type);
-			}
-			break;
-		case JSON_TOKEN::ARRAY_OPEN:
-			if (!node)
-			{
-				context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_KEY_NOT_DEFINED;
+				value.type = JSON_TYPE::STRING;
+				value.text++;
+				value.length -= 2;
+				break;
+			case JSON_TOKEN::NUMBER:
+				value.type = JSON_TYPE::NUMBER;
+				break;
+			case JSON_TOKEN::LITERAL:
+				value.boolean = (token.length == 4) && (memcmp(value.text, "true", 4) == 0);
+				value.type = ((value.boolean) || ((token.length == 5) && (memcmp(value.text, "false", 5) == 0))) ? JSON_TYPE::BOOLEAN : JSON_TYPE::NULL_TYPE;
+				break;
+			default:
+				value.type = (token.type == JSON_TOKEN::CURLY_OPEN) ? JSON_TYPE::OBJECT : JSON_TYPE::ARRAY;
 				break;
 			}
-			else
-			{
-				if (isKey) {
-					context->errorCode = JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_EXPECTED_COLON;
-					break;
-				}
-				node->type = JSON_TYPE::ARRAY;
-				node->value = json_ParseArray((char**)&pJson, context);
+			if (!this->SetValue(column, &value)) {
+				return false;
 			}
-			break;
-		case JSON_TOKEN::ARRAY_CLOSE:
-			context->errorCode = JSON_ERROR_CODE::UNEXPECTED_CLOSING_SQUARE_BRACKET;
-			break;
-		case JSON_TOKEN::COMMA:
-			prev_node = node;
-			node = 0;
-			isKey = true;
-			break;
-		case JSON_TOKEN::JSON_END:
-			context->errorCode = JSON_ERROR_CODE::EXPECTED_CURLY_BRACKET_ENCOUNTERED_JSON_END;
-			break;
-		case JSON_TOKEN::UNRECOGNIZED_TOKEN:
-			context->errorCode = JSON_ERROR_CODE::UNRECOGNIZED_TOKEN;
-			break;
-		default:
-			break;
 		}
 
-		if ((!root) && (node)) {
-			root = node;
+		if ((!isKeyOnly) && ((!json_TextSkipValue(lexer, &token, &end)) || (!lexer->Next(&token)))) {
+			return false;
+		}
+		if (token.type == JSON_TOKEN::CURLY_CLOSE) {
+			return true;
+		}
+		if ((token.type != JSON_TOKEN::COMMA) || (!lexer->Next(&token))) {
+			return false;
+		}
+	}
+}
+
+void JSON_COLUMNS::Rollback(size_t rows)
+{
+	size_t i;
+
+	this->rows = rows;
+
+	for (i = 0; i < this->count; i++) {
+		this->columns[i].filled = 0;
+	}
+}
+
+bool JSON_COLUMNS::Add(const char* key, JSON_COLUMN_TYPE type)
+{
+	COLUMN* columns;
+	COLUMN* column;
+	char* copy;
+	size_t length;
+
+	if ((key == NULL) || (this->rows != 0)) {
+		return false;
+	}
+
+	columns = (COLUMN*)json_Reallocate(this->allocator, this->columns, (this->count + 1) * sizeof(COLUMN));
+	if (columns == NULL) {
+		return false;
+	}
+	this->columns = columns;
+
+	length = strlen(key);
+	copy = (char*)json_Allocate(this->allocator, length + 1);
+	if (copy == NULL) {
+		return false;
+	}
+	memcpy(copy, key, length + 1);
+
+	column = &this->columns[this->count];
+	json_LookupKey(&column->key, copy, length);
+	column->type = type;
+	column->values = NULL;
+	column->strings = NULL;
+	column->stringsCapacity = 0;
+	column->nulls = NULL;
+	column->filled = 0;
+
+	// The other columns already have buffers after Clear
+	if ((this->capacity != 0) && (!this->GrowColumn(column, this->capacity)))
+	{
+		json_Deallocate(this->allocator, column->values);
+		json_Deallocate(this->allocator, column->nulls);
+		json_Deallocate(this->allocator, copy);
+		return false;
+	}
+
+	this->count++;
+
+	return true;
+}
+
+bool JSON_COLUMNS::Load(JSON_NODE* array)
+{
+	JSON_NODE* item;
+	JSON_NODE* member;
+	COLUMN* column;
+	VALUE value;
+	size_t rows, length;
+
+	if ((array == NULL) || (array->type != JSON_TYPE::ARRAY)) {
+		return false;
+	}
+
+	rows = this->rows;
+
+	for (item = (JSON_NODE*)array->value; item != NULL; item = item->next)
+	{
+		if (!this->AddRow()) {
+			this->Rollback(rows);
+			return false;
+		}
+
+		// Items that are not objects are rows with null values
+		if (item->type != JSON_TYPE::OBJECT) {
+			continue;
 		}
 
-		if (context->errorCode != JSON_ERROR_CODE::NONE) {
-			context->errorDescription = JSON_ERROR_STRINGS[(int)context->errorCode];
-			context->errorLength = context->charNumber - context->beginIndex;
-			break;
+		for (member = (JSON_NODE*)item->value; member != NULL; member = member->next)
+		{
+			if (member->key == NULL) {
+				continue;
+			}
+
+			if (member->flags & JSON_NODE_FLAG_KEY) {
+				column = this->Find(member->key, member->keyLength, member->keyHash);
+			}
+			else
+			{
+				length = strlen(member->key);
+				column = this->Find(member->key, length, json_HashKey(member->key, length));
+			}
+			if (column == NULL) {
+				continue;
+			}
+
+			value.type = member->type;
+			value.text = ((member->type == JSON_TYPE::STRING) || (member->type == JSON_TYPE::NUMBER)) ? (const char*)member->value : NULL;
+			value.length = ((member->type == JSON_TYPE::STRING) && (value.text != NULL)) ? strlen(value.text) : 0;
+			value.json = false;
+			value.boolean = (member->type == JSON_TYPE::BOOLEAN) && (member->value != NULL);
+			if (!this->SetValue(column, &value)) {
+				this->Rollback(rows);
+				return false;
+			}
 		}
 	}
 
-	*pp_json = (char*)pJson;
-
-	return root;
+	return true;
 }
 
-// ------------------------ //
-// **   JSON functions   ** //
-// ------------------------ //
+bool JSON_COLUMNS::LoadText(const char* json)
+{
+	return this->LoadText(json, (json != NULL) ? strlen(json) : 0);
+}
 
-char* json_plus::JSON_Generate(JSON_NODE* json_root, const char* format)
+bool JSON_COLUMNS::LoadText(const char* json, size_t length)
 {
-	JSON_GENERATOR_CONTEXT context = { 0 };
+	JSON_LEXER_TOKEN token;
+	size_t rows, end;
 
-	if (json_root == NULL) {
-		return NULL;
+	if (json == NULL) {
+		return false;
 	}
 
-	context.error = false;
-	context.buffer = NULL;
-	context.bufferLength = 0;
-	context.index = 0;
-	context.visualEscape = false;
-	context.format = format;
-	context.indentation = 0;
-
-	if (format != NULL) {
-		if (*format == 'c') {
-			context.visualEscape = true;
-		}
+	JSON_LEXER lexer(json, length);
+	if ((!lexer.Next(&token)) || (token.type != JSON_TOKEN::ARRAY_OPEN) || (!lexer.Next(&token))) {
+		return false;
+	}
+	if (token.type == JSON_TOKEN::ARRAY_CLOSE) {
+		return true;
 	}
 
-	if (setjmp(context.env) == 0)
+	rows = this->rows;
+
+	while (true)
 	{
-		if (json_root->type == JSON_TYPE::OBJECT)
+		if (!this->AddRow()) {
+			this->Rollback(rows);
+			return false;
+		}
+
+		// Items that are not objects are rows with null values
+		if (token.type == JSON_TOKEN::CURLY_OPEN)
 		{
-			json_GeneratorAppend(&context, '{', true);
-			json_GenerateText((JSON_NODE*)json_root->value, &context);
-			json_GeneratorAppend(&context, '}', true);
-			json_GeneratorAppend(&context, '\0', false);
+			if (!this->LoadTextObject(&lexer, json)) {
+				this->Rollback(rows);
+				return false;
+			}
 		}
-		else if (json_root->type == JSON_TYPE::ARRAY)
+		else if (((token.type != JSON_TOKEN::ARRAY_OPEN) && (token.type != JSON_TOKEN::STRING) && (token.type != JSON_TOKEN::NUMBER) &&
+			(token.type != JSON_TOKEN::LITERAL)) || (!json_TextSkipValue(&lexer, &token, &end)))
 		{
-			json_GeneratorAppend(&context, '[', true);
-			json_GenerateText((JSON_NODE*)json_root->value, &context);
-			json_GeneratorAppend(&context, ']', true);
-			json_GeneratorAppend(&context, '\0', false);
+			this->Rollback(rows);
+			return false;
+		}
+
+		if (!lexer.Next(&token)) {
+			this->Rollback(rows);
+			return false;
+		}
+		if (token.type == JSON_TOKEN::ARRAY_CLOSE) {
+			return true;
+		}
+		if ((token.type != JSON_TOKEN::COMMA) || (!lexer.Next(&token))) {
+			this->Rollback(rows);
+			return false;
 		}
 	}
+}
 
-	return context.buffer;
+void JSON_COLUMNS::Clear()
+{
+	this->Rollback(0);
 }
 
-JSON_NODE* json_plus::JSON_Parse(const char* pJson, JSON_PARSER_CONTEXT* context)
+size_t JSON_COLUMNS::Rows()
 {
-	JSON_TOKEN token;
-	JSON_NODE* root, * node, * prev_node;
-	bool hasCompleted;
+	return this->rows;
+}
 
-	if (context == 0) {
-		return 0;
+size_t JSON_COLUMNS::Count()
+{
+	return this->count;
+}
+
+JSON_COLUMN_TYPE JSON_COLUMNS::Type(size_t column)
+{
+	return this->columns[column].type;
+}
+
+const long long* JSON_COLUMNS::Int64s(size_t column)
+{
+	if ((column >= this->count) || (this->columns[column].type != JSON_COLUMN_TYPE::INT64)) {
+		return NULL;
 	}
 
-	context->lineNumber = 1;
-	context->charNumber = 0;
-	context->beginIndex = 0;
-	context->errorLength = 0;
+	return (const long long*)this->columns[column].values;
+}
 
-	if (pJson == 0)
-	{
-		context->errorCode = JSON_ERROR_CODE::INVALID_PARAMETER;
-		context->errorDescription = JSON_ERROR_STRINGS[(int)JSON_ERROR_CODE::INVALID_PARAMETER];
-		return 0;
+const double* JSON_COLUMNS::Doubles(size_t column)
+{
+	if ((column >= this->count) || (this->columns[column].type != JSON_COLUMN_TYPE::DOUBLE)) {
+		return NULL;
 	}
 
-	context->errorCode = JSON_ERROR_CODE::NONE;
-	context->errorDescription = JSON_ERROR_STRINGS[(int)JSON_ERROR_CODE::NONE];
+	return (const double*)this->columns[column].values;
+}
 
-	root = node = prev_node = 0;
-	hasCompleted = false;
+const bool* JSON_COLUMNS::Booleans(size_t column)
+{
+	if ((column >= this->count) || (this->columns[column].type != JSON_COLUMN_TYPE::BOOLEAN)) {
+		return NULL;
+	}
 
-	while (!hasCompleted)
-	{
-		context->beginIndex = context->charNumber;
-		token = json_GetToken((char**)&pJson, context);
+	return (const bool*)this->columns[column].values;
+}
 
-		switch (token)
-		{
-		case JSON_TOKEN::CURLY_OPEN:
-			node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-			if (!node)
-			{
-				context->errorCode = JSON_ERROR_CODE::OUT_OF_MEMORY;
-				break;
-			}
+const size_t* JSON_COLUMNS::Offsets(size_t column)
+{
+	static const size_t empty = 0;
+
+	if ((column >= this->count) || (this->columns[column].type != JSON_COLUMN_TYPE::STRING)) {
+		return NULL;
+	}
 
-			memset(node, 0, sizeof(JSON_NODE));
-			node->type = JSON_TYPE::OBJECT;
-			node->value = json_ParseObject((char**)&pJson, context);
-			node->format = NULL;
+	// Before the 1st row there is only the 1st offset
+	if (this->columns[column].values == NULL) {
+		return &empty;
+	}
 
-			if (prev_node) {
-				prev_node->next = node;
-			}
-			break;
-		case JSON_TOKEN::ARRAY_OPEN:
-			node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-			if (!node)
-			{
-				context->errorCode = JSON_ERROR_CODE::OUT_OF_MEMORY;
-				break;
-			}
+	return (const size_t*)this->columns[column].values;
+}
 
-			memset(node, 0, sizeof(JSON_NODE));
-			node->type = JSON_TYPE::ARRAY;
-			node->value = json_ParseArray((char**)&pJson, context);
-			node->format = NULL;
+const char* JSON_COLUMNS::Strings(size_t column)
+{
+	if ((column >= this->count) || (this->columns[column].type != JSON_COLUMN_TYPE::STRING)) {
+		return NULL;
+	}
 
-			if (prev_node) {
-				prev_node->next = node;
-			}
-			break;
-		case JSON_TOKEN::JSON_END:
-			hasCompleted = true;
-			break;
-		case JSON_TOKEN::UNRECOGNIZED_TOKEN:
-			context->errorCode = JSON_ERROR_CODE::UNRECOGNIZED_TOKEN;
-			break;
-		default:
-			context->errorCode = JSON_ERROR_CODE::UNEXPECTED_START_TOKEN;
-			break;
-		}
+	return (this->columns[column].strings != NULL) ? this->columns[column].strings : "";
+}
 
-		if ((!root) && (node)) {
-			root = node;
-		}
+const unsigned char* JSON_COLUMNS::Nulls(size_t column)
+{
+	if (column >= this->count) {
+		return NULL;
+	}
 
-		if (node) {
-			prev_node = node;
-			node = 0;
-		}
+	return this->columns[column].nulls;
+}
 
-		if (context->errorCode != JSON_ERROR_CODE::NONE) {
-			context->errorDescription = JSON_ERROR_STRINGS[(int)context->errorCode];
-			context->errorLength = context->charNumber - context->beginIndex;
-			break;
-		}
+bool JSON_COLUMNS::IsNull(size_t column, size_t row)
+{
+	if ((column >= this->count) || (row >= this->rows)) {
+		return true;
 	}
 
-	return root;
+	return (this->columns[column].nulls[row / 8] & (1 << (row % 8))) != 0;
 }
 
-void json_plus::JSON_Free(JSON_NODE* json_root)
+// --------------------------- //
+// **   JSON_ITEM methods   ** //
+// --------------------------- //
+
+#ifdef JSON_PLUS_STRING_VIEW
+
+std::string_view JSON_ITEM::Key() const
 {
-	JSON_NODE* node, * nextNode;
+	return this->node->KeyView();
+}
 
-	if (json_root == NULL) {
-		return;
+#endif // JSON_PLUS_STRING_VIEW
+
+const char* JSON_ITEM::String() const
+{
+	return this->node->String();
+}
+
+long long JSON_ITEM::Int64() const
+{
+	return this->node->Int64();
+}
+
+double JSON_ITEM::Double() const
+{
+	return this->node->Double();
+}
+
+bool JSON_ITEM::Boolean() const
+{
+	return this->node->Boolean();
+}
+
+JSON_OBJECT JSON_ITEM::Object() const
+{
+	if (this->node->type == JSON_TYPE::OBJECT) {
+		return JSON_OBJECT(this->node);
 	}
 
-	node = json_root;
-	while (node)
-	{
-		nextNode = node->next;
+	return JSON_OBJECT();
+}
 
-		if (node->type == JSON_TYPE::OBJECT) {
-			JSON_Free((JSON_NODE*)node->value);
-		}
-		else if (node->type == JSON_TYPE::ARRAY) {
-			JSON_Free((JSON_NODE*)node->value);
-		}
-		else
-		{
-			if (node->type != JSON_TYPE::BOOLEAN) {
-				if (node->value) {
-					free(node->value);
-				}
-			}
-		}
+JSON_ARRAY JSON_ITEM::Array() const
+{
+	if (this->node->type == JSON_TYPE::ARRAY) {
+		return JSON_ARRAY(this->node);
+	}
+
+	return JSON_ARRAY();
+}
+
+// ----------------------------- //
+// **   JSON_OBJECT methods   ** //
+// ----------------------------- //
+
+JSON_OBJECT::JSON_OBJECT() {
+	this->json_root = NULL;
+}
+
+JSON_OBJECT::JSON_OBJECT(JSON_NODE* root) {
+	this->json_root = root;
+}
+
+JSON_OBJECT::JSON_OBJECT(const char* json, JSON_PARSER_CONTEXT* context)
+{
+	this->json_root = JSON_Parse(json, context);
+}
+
+JSON_OBJECT& JSON_OBJECT::operator=(const JSON_OBJECT& other)
+{
+	this->json_root = other.json_root;
+	return *this;
+}
+
+JSON_OBJECT::operator JSON_NODE* () const
+{
+	return this->json_root;
+}
+
+JSON_NODE* JSON_OBJECT::MakeRoot(const JSON_ALLOCATOR* allocator)
+{
+	return this->json_root = JSON_CreateNode(JSON_TYPE::OBJECT, NULL, NULL, allocator);
+}
+
+void JSON_OBJECT::Free()
+{
+	JSON_Free(this->json_root);
+	this->json_root = NULL;
+}
+
+bool JSON_OBJECT::Empty() {
+	if (this->json_root) {
+		return false;
+	}
+	else {
+		return true;
+	}
+}
 
-		if (node->key) {
-			free(node->key);
-		}
+unsigned long JSON_OBJECT::Count()
+{
+	JSON_OBJECT_INDEX* index;
 
-		if (node->format) {
-			free((void*)node->format);
-		}
+	if (this->json_root == NULL) {
+		return 0;
+	}
 
-		free(node);
-		node = nextNode;
+	// Every member is in the index when there are no duplicate keys
+	index = json_GetIndex(this->json_root);
+	if ((index != NULL) && (!index->hasDuplicateKeys)) {
+		return (unsigned long)index->count;
 	}
+
+	return json_CountList(this->json_root);
 }
 
-JSON_NODE* json_plus::JSON_GetObject(JSON_NODE* object, const char* key)
+JSON_NODE* JSON_OBJECT::First()
 {
-	JSON_NODE* node;
-
-	if (object == NULL) {
-		return NULL;
+	if (this->json_root != NULL) {
+		return (JSON_NODE*)this->json_root->value;
 	}
 
-	node = (JSON_NODE*)object->value;
-	while (node != NULL)
-	{
-		if (node->type == JSON_TYPE::OBJECT)
-		{
-			if (UTF8_Encoding::CompareStrings(node->key, key) == 0) {
-				return node;
-			}
-		}
-		node = node->next;
+	return NULL;
+}
+
+JSON_ITERATOR JSON_OBJECT::begin()
+{
+	if (this->json_root == NULL) {
+		return JSON_ITERATOR();
 	}
 
-	return NULL;
+	return JSON_ITERATOR((JSON_NODE*)this->json_root->value);
 }
 
-JSON_NODE* json_plus::JSON_GetArray(JSON_NODE* object, const char* key)
+JSON_ITERATOR JSON_OBJECT::end()
 {
-	JSON_NODE* node;
+	return JSON_ITERATOR();
+}
 
-	if (object == NULL) {
+JSON_OBJECT JSON_OBJECT::Object(const char* key)
+{
+	return this->Object(key, json_KeyLength(key));
+}
+
+JSON_OBJECT JSON_OBJECT::Object(const char* key, size_t keyLength)
+{
+	JSON_TYPE type;
+
+	// The object can be changed, so it must not be shared with a clone
+	if ((this->json_root == NULL) || (!json_Unshare(this->json_root))) {
 		return NULL;
 	}
 
-	node = (JSON_NODE*)object->value;
-	while (node != NULL)
-	{
-		if (node->type == JSON_TYPE::ARRAY)
-		{
-			if (UTF8_Encoding::CompareStrings(node->key, key) == 0) {
-				return node;
-			}
-		}
-		node = node->next;
-	}
+	type = JSON_TYPE::OBJECT;
 
-	return NULL;
+	return json_FindMember(this->json_root, key, keyLength, &type);
 }
 
-char* json_plus::JSON_GetString(JSON_NODE* object, const char* key)
+JSON_ARRAY JSON_OBJECT::Array(const char* key)
 {
-	JSON_NODE* node;
+	return this->Array(key, json_KeyLength(key));
+}
 
-	if (object == NULL) {
+JSON_ARRAY JSON_OBJECT::Array(const char* key, size_t keyLength)
+{
+	JSON_TYPE type;
+
+	// The array can be changed, so it must not be shared with a clone
+	if ((this->json_root == NULL) || (!json_Unshare(this->json_root))) {
 		return NULL;
 	}
 
-	node = (JSON_NODE*)object->value;
-	while (node != NULL)
-	{
-		if (node->type == JSON_TYPE::STRING)
-		{
-			if (UTF8_Encoding::CompareStrings(node->key, key) == 0) {
-				return (char*)node->value;
-			}
-		}
-		node = node->next;
-	}
+	type = JSON_TYPE::ARRAY;
 
-	return NULL;
+	return json_FindMember(this->json_root, key, keyLength, &type);
 }
 
-char* json_plus::JSON_GetNumber(JSON_NODE* object, const char* key)
+const char* JSON_OBJECT::String(const char* key)
+{
+	return this->String(key, json_KeyLength(key));
+}
+
+const char* JSON_OBJECT::String(const char* key, size_t keyLength)
 {
 	JSON_NODE* node;
+	JSON_TYPE type;
 
-	if (object == NULL) {
-		return NULL;
-	}
+	type = JSON_TYPE::STRING;
 
-	node = (JSON_NODE*)object->value;
-	while (node != NULL)
-	{
-		if (node->type == JSON_TYPE::NUMBER)
-		{
-			if (UTF8_Encoding::CompareStrings(node->key, key) == 0) {
-				return (char*)node->value;
-			}
-		}
-		node = node->next;
+	node = json_FindMember(this->json_root, key, keyLength, &type);
+	if (node != NULL) {
+		return (const char*)node->value;
 	}
 
 	return NULL;
 }
 
-bool json_plus::JSON_GetBoolean(JSON_NODE* object, const char* key)
+bool JSON_OBJECT::Boolean(const char* key)
+{
+	return this->Boolean(key, json_KeyLength(key));
+}
+
+bool JSON_OBJECT::Boolean(const char* key, size_t keyLength)
 {
 	JSON_NODE* node;
+	JSON_TYPE type;
 
-	if (object == NULL) {
-		return false;
-	}
+	type = JSON_TYPE::BOOLEAN;
 
-	node = (JSON_NODE*)object->value;
-	while (node != NULL)
-	{
-		if (node->type == JSON_TYPE::BOOLEAN)
-		{
-			if (UTF8_Encoding::CompareStrings(node->key, key) == 0) {
-				return (bool)node->value;
-			}
-		}
-		node = node->next;
+	node = json_FindMember(this->json_root, key, keyLength, &type);
+	if (node != NULL) {
+		return (bool)node->value;
 	}
 
 	return false;
 }
 
-JSON_NODE* json_plus::JSON_CreateNode(JSON_TYPE type, const char* key, void* value)
+const JSON_POSITION* JSON_OBJECT::Position(JSON_POSITION_MAP* positions, const char* key)
 {
-	JSON_NODE* node;
-
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-	if (node != NULL)
-	{
-		char* node_key;
-		void* node_value;
+	return this->Position(positions, key, json_KeyLength(key));
+}
 
-		node_key = NULL;
+const JSON_POSITION* JSON_OBJECT::Position(JSON_POSITION_MAP* positions, const char* key, size_t keyLength)
+{
+	if ((this->json_root == NULL) || (positions == NULL)) {
+		return NULL;
+	}
 
-		if (key != NULL)
-		{
-			size_t keyLength = UTF8_Encoding::GetStringUnits(key) + 1;
-			node_key = (char*)malloc(keyLength);
-			if (node_key == NULL) {
-				free(node);
-				return NULL;
-			}
+	return positions->Find(json_FindMember(this->json_root, key, keyLength, NULL));
+}
 
-			UTF8_Encoding::StringCopy(node_key, keyLength, key);
-		}
+JSON_OBJECT::Number::Number(JSON_OBJECT& parent) : parent(parent) {}
 
-		if ((type == JSON_TYPE::STRING) && (value != NULL))
-		{
-			size_t valueLength = UTF8_Encoding::GetStringUnits((const char*)value) + 1;
-			node_value = malloc(valueLength);
-			if (node_value == NULL)
-			{
-				if (node_key != NULL) {
-					free(node_key);
-				}
-				free(node);
-				return NULL;
-			}
+double JSON_OBJECT::Number::Double(const char* key)
+{
+	return this->Double(key, json_KeyLength(key));
+}
 
-			UTF8_Encoding::StringCopy((char*)node_value, valueLength, (const char*)value);
-		}
-		else {
-			node_value = value;
-		}
+double JSON_OBJECT::Number::Double(const char* key, size_t keyLength)
+{
+	const char* number;
 
-		node->next = NULL;
-		node->key = node_key;
-		node->value = node_value;
-		node->type = type;
-		node->format = NULL;
+	number = JSON_GetNumber(this->parent.json_root, key, keyLength);
+	if (number != NULL) {
+		return atof(number);
 	}
 
-	return node;
+	return 0.0f;
 }
 
-// ------------------------------- //
-// **   UTF8_Encoding methods   ** //
-// ------------------------------- //
+int JSON_OBJECT::Number::Int(const char* key)
+{
+	return this->Int(key, json_KeyLength(key));
+}
 
-unsigned char UTF8_Encoding::GetCharacterUnits(char Code)
+int JSON_OBJECT::Number::Int(const char* key, size_t keyLength)
 {
-	if ((Code & 0x80) == 0) {
-		return 1;
-	}
-	else if ((Code & 0xE0) == 0xC0) {
-		return 2;
-	}
-	else if ((Code & 0xF0) == 0xE0) {
-		return 3;
-	}
-	else if ((Code & 0xF8) == 0xF0) {
-		return 4;
-	}
-	else {
-		return 0;
+	const char* number;
+
+	number = JSON_GetNumber(this->parent.json_root, key, keyLength);
+	if (number != NULL) {
+		return atoi(number);
 	}
+
+	return 0;
 }
 
-unsigned char UTF8_Encoding::Encode(char* pBuffer, size_t Length, unsigned long CodePoint)
+long JSON_OBJECT::Number::Long(const char* key)
 {
-	if (CodePoint < 0x80)
-	{
-		if ((pBuffer != NULL) && (Length >= 2))
-		{
-			pBuffer[0] = (char)CodePoint & 0x7F;
-			pBuffer[1] = 0;
-		}
-		return 1;
-	}
-	else if (CodePoint < 0x800)
-	{
-		if ((pBuffer != NULL) && (Length >= 3))
-		{
-			pBuffer[0] = (char)(CodePoint >> 6) | 0xC0;
-			pBuffer[1] = (char)(CodePoint & 0x3F) | 0x80;
-			pBuffer[2] = 0;
-		}
-		return 2;
-	}
-	else if (CodePoint < 0x10000)
-	{
-		if ((pBuffer != NULL) && (Length >= 4))
-		{
-			pBuffer[0] = (char)(CodePoint >> 12) | 0xE0;
-			pBuffer[1] = (char)((CodePoint >> 6) & 0x3F) | 0x80;
-			pBuffer[2] = (char)(CodePoint & 0x3F) | 0x80;
-			pBuffer[3] = 0;
-		}
-		return 3;
-	}
-	else if (CodePoint < 0x110000)
-	{
-		if ((pBuffer != NULL) && (Length >= 5))
-		{
-			pBuffer[0] = (char)(CodePoint >> 18) | 0xF0;
-			pBuffer[1] = (char)((CodePoint >> 12) & 0x3F) | 0x80;
-			pBuffer[2] = (char)((CodePoint >> 6) & 0x3F) | 0x80;
-			pBuffer[3] = (char)(CodePoint & 0x3F) | 0x80;
-			pBuffer[4] = 0;
-		}
-		return 4;
+	return this->Long(key, json_KeyLength(key));
+}
+
+long JSON_OBJECT::Number::Long(const char* key, size_t keyLength)
+{
+	const char* number;
+
+	number = JSON_GetNumber(this->parent.json_root, key, keyLength);
+	if (number != NULL) {
+		return atol(number);
 	}
 
 	return 0;
 }
 
-unsigned char UTF8_Encoding::EncodeUnsafe(char* pBuffer, unsigned long CodePoint)
+long long JSON_OBJECT::Number::Int64(const char* key)
 {
-	if (CodePoint < 0x80)
-	{
-		if (pBuffer != NULL)
-		{
-			pBuffer[0] = (char)CodePoint & 0x7F;
-		}
-		return 1;
-	}
-	else if (CodePoint < 0x800)
-	{
-		if (pBuffer != NULL)
-		{
-			pBuffer[0] = (char)(CodePoint >> 6) | 0xC0;
-			pBuffer[1] = (char)(CodePoint & 0x3F) | 0x80;
-		}
-		return 2;
-	}
-	else if (CodePoint < 0x10000)
-	{
-		if (pBuffer != NULL)
-		{
-			pBuffer[0] = (char)(CodePoint >> 12) | 0xE0;
-			pBuffer[1] = (char)((CodePoint >> 6) & 0x3F) | 0x80;
-			pBuffer[2] = (char)(CodePoint & 0x3F) | 0x80;
-		}
-		return 3;
-	}
-	else if (CodePoint < 0x110000)
-	{
-		if (pBuffer != NULL)
-		{
-			pBuffer[0] = (char)(CodePoint >> 18) | 0xF0;
-			pBuffer[1] = (char)((CodePoint >> 12) & 0x3F) | 0x80;
-			pBuffer[2] = (char)((CodePoint >> 6) & 0x3F) | 0x80;
-			pBuffer[3] = (char)(CodePoint & 0x3F) | 0x80;
-		}
-		return 4;
+	return this->Int64(key, json_KeyLength(key));
+}
+
+long long JSON_OBJECT::Number::Int64(const char* key, size_t keyLength)
+{
+	const char* number;
+
+	number = JSON_GetNumber(this->parent.json_root, key, keyLength);
+	if (number != NULL) {
+		return atoll(number);
 	}
 
 	return 0;
 }
 
-unsigned long UTF8_Encoding::Decode(unsigned char Units, const char* String)
+const char* JSON_OBJECT::Number::String(const char* key)
+{
+	return this->String(key, json_KeyLength(key));
+}
+
+const char* JSON_OBJECT::Number::String(const char* key, size_t keyLength)
 {
-	unsigned long CodePoint;
-
-	switch (Units)
-	{
-	case 1:
-		CodePoint = String[0];
-		break;
-	case 2:
-		CodePoint = (String[0] << 6 | (String[1] & 0x3F)) & 0x7FF;
-		break;
-	case 3:
-		CodePoint = (String[0] << 12 | ((String[1] & 0x3F) << 6) | (String[2] & 0x3F)) & 0xFFFF;
-		break;
-	case 4:
-		CodePoint = (String[0] << 18 | ((String[1] & 0x3F) << 12) | ((String[2] & 0x3F) << 6) | (String[3] & 0x3F)) & 0x1FFFFF;
-		break;
-	default:
-		return 0;
-	}
-
-	return CodePoint;
+	return JSON_GetNumber(parent.json_root, key, keyLength);
 }
 
-size_t UTF8_Encoding::GetStringUnits(const char* String)
+JSON_OBJECT::Insert::Insert(JSON_OBJECT& parent, bool append) : parent(parent), append(append) {}
+
+JSON_OBJECT JSON_OBJECT::Insert::Object(const char* key)
 {
-	size_t TotalUnits, CharUnits;
+	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-	if (String == NULL) return -1;
-	TotalUnits = 0;
+	allocator = json_NodeAllocator(this->parent.json_root, NULL);
 
-	while (*String != 0)
+	node = json_AllocateNode(allocator, JSON_TYPE::OBJECT, false);
+	if (node != NULL)
 	{
-		CharUnits = UTF8_Encoding::GetCharacterUnits(*String);
-		if (CharUnits == 0) return TotalUnits;
-		String += CharUnits;
-		TotalUnits += CharUnits;
+		if (!json_CopyKey(node, key, allocator)) {
+			json_DeallocateNode(node, allocator);
+			return NULL;
+		}
+
+		node->value = 0;
+		node->type = JSON_TYPE::OBJECT;
+		node->format = NULL;
+
+		if (!json_LinkNode(this->parent.json_root, node, this->append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 	}
 
-	return TotalUnits;
+	return node;
 }
 
-size_t UTF8_Encoding::StringCopy(char* Destination, size_t Length, const char* Source)
+JSON_ARRAY JSON_OBJECT::Insert::Array(const char* key)
 {
-	unsigned char CharUnits;
-	size_t Len;
+	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-	if ((Destination == NULL) || (Source == NULL) || (Length == 0)) return -1;
-	Len = 0;
+	allocator = json_NodeAllocator(this->parent.json_root, NULL);
 
-	while (*Source != 0)
+	node = json_AllocateNode(allocator, JSON_TYPE::ARRAY, false);
+	if (node != NULL)
 	{
-		CharUnits = UTF8_Encoding::GetCharacterUnits(*Source);
-		if (CharUnits == 0) break;
-		Len += CharUnits;
-		if (Len >= Length)
-		{
-			*Destination = 0;
-			return Length;
+		if (!json_CopyKey(node, key, allocator)) {
+			json_DeallocateNode(node, allocator);
+			return NULL;
 		}
-		switch (CharUnits)
-		{
-		case 1:
-			Destination[0] = Source[0];
-			break;
-		case 2:
-			Destination[0] = Source[0];
-			Destination[1] = Source[1];
-			break;
-		case 3:
-			Destination[0] = Source[0];
-			Destination[1] = Source[1];
-			Destination[2] = Source[2];
-			break;
-		case 4:
-			Destination[0] = Source[0];
-			Destination[1] = Source[1];
-			Destination[2] = Source[2];
-			Destination[3] = Source[3];
-			break;
-		default:
-			break;
+
+		node->value = 0;
+		node->type = JSON_TYPE::ARRAY;
+		node->format = NULL;
+
+		if (!json_LinkNode(this->parent.json_root, node, this->append)) {
+			json_free_node(node, allocator);
+			return NULL;
 		}
-		Destination += CharUnits;
-		Source += CharUnits;
 	}
-	*Destination = 0;
 
-	return Len;
+	return node;
 }
 
-long UTF8_Encoding::CompareStrings(const char* String1, const char* String2)
+JSON_NODE* JSON_OBJECT::Insert::String(const char* key, const char* value)
 {
-	unsigned char CharUnits1, CharUnits2;
-	unsigned long CodePoint1, CodePoint2;
+	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-	if ((String1 == 0) || (String2 == 0)) {
-		return 0x7FFFFFFF;
-	}
+	allocator = json_NodeAllocator(this->parent.json_root, NULL);
 
-	while ((*String1 != 0) && (*String2 != 0))
+	node = json_AllocateNode(allocator, JSON_TYPE::STRING, false);
+	if (node != NULL)
 	{
-		CharUnits1 = UTF8_Encoding::GetCharacterUnits(*String1);
-		CharUnits2 = UTF8_Encoding::GetCharacterUnits(*String2);
-
-		if (CharUnits1 == 0) {
-			return 0x7FFFFFFF;
+		if (!json_CopyKey(node, key, allocator)) {
+			json_DeallocateNode(node, allocator);
+			return NULL;
 		}
 
-		if (CharUnits2 == 0) {
-			return 0x7FFFFFFF;
+		if (!json_CopyValue(node, value, allocator)) {
+			json_free_node(node, allocator);
+			return NULL;
 		}
 
-		CodePoint1 = UTF8_Encoding::Decode(CharUnits1, String1);
-		CodePoint2 = UTF8_Encoding::Decode(CharUnits2, String2);
+		node->type = JSON_TYPE::STRING;
+		node->format = NULL;
 
-		if (CodePoint1 != CodePoint2)
-		{
-			if (CodePoint1 > CodePoint2) {
-				return 1;
-			}
-			else {
-				return -1;
-			}
-		}
-		String1 += CharUnits1;
-		String2 += CharUnits2;
-	}
-	if ((*String1 == 0) && (*String2 == 0)) {
-		return 0;
-	}
-	else
-	{
-		if (*String1 != 0) {
-			return 1;
-		}
-		else {
-			return -1;
+		if (!json_LinkNode(this->parent.json_root, node, this->append)) {
+			json_free_node(node, allocator);
+			return NULL;
 		}
 	}
+
+	return node;
 }
 
-long UTF8_Encoding::CompareStringsInsensitive(const char* String1, const char* String2)
+JSON_NODE* JSON_OBJECT::Insert::Boolean(const char* key, bool value)
 {
-	unsigned char CharUnits1, CharUnits2;
-	unsigned long CodePoint1, CodePoint2;
+	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-	if ((String1 == 0) || (String2 == 0)) {
-		return 0x7FFFFFFF;
-	}
+	allocator = json_NodeAllocator(this->parent.json_root, NULL);
 
-	while ((*String1 != 0) && (*String2 != 0))
+	node = json_AllocateNode(allocator, JSON_TYPE::BOOLEAN, false);
+	if (node != NULL)
 	{
-		CharUnits1 = UTF8_Encoding::GetCharacterUnits(*String1);
-		CharUnits2 = UTF8_Encoding::GetCharacterUnits(*String2);
-
-		if (CharUnits1 == 0) {
-			return 0x7FFFFFFF;
+		if (!json_CopyKey(node, key, allocator)) {
+			json_DeallocateNode(node, allocator);
+			return NULL;
 		}
 
-		if (CharUnits2 == 0) {
-			return 0x7FFFFFFF;
+		node->value = (void*)value;
+		node->type = JSON_TYPE::BOOLEAN;
+		node->format = NULL;
+
+		if (!json_LinkNode(this->parent.json_root, node, this->append)) {
+			json_free_node(node, allocator);
+			return NULL;
 		}
+	}
 
-		CodePoint1 = UTF8_Encoding::Decode(CharUnits1, String1);
-		CodePoint2 = UTF8_Encoding::Decode(CharUnits2, String2);
+	return node;
+}
 
-		if ((CodePoint1 > 0x40) && (CodePoint1 < 0x5B)) {
-			CodePoint1 += 0x20;
-		}
-		else if ((CodePoint1 > 0xFF20) && (CodePoint1 < 0xFF3B)) {
-			CodePoint1 -= 0xFEE0;
-		}
-		else if ((CodePoint1 > 0xFF40) && (CodePoint1 < 0xFF5B)) {
-			CodePoint1 -= 0xFF00;
-		}
+JSON_OBJECT::Insert::Number::Number(Insert& parent) : parent(parent) {}
 
-		if ((CodePoint2 > 0x40) && (CodePoint2 < 0x5B)) {
-			CodePoint2 += 0x20;
-		}
-		else if ((CodePoint2 > 0xFF20) && (CodePoint2 < 0xFF3B)) {
-			CodePoint2 -= 0xFEE0;
-		}
-		else if ((CodePoint2 > 0xFF40) && (CodePoint2 < 0xFF5B)) {
-			CodePoint2 -= 0xFF00;
-		}
+JSON_NODE* JSON_OBJECT::Insert::Number::Double(const char* key, double value)
+{
+	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-		if (CodePoint1 != CodePoint2)
-		{
-			if (CodePoint1 > CodePoint2) {
-				return 1;
-			}
-			else {
-				return -1;
-			}
-		}
-		String1 += CharUnits1;
-		String2 += CharUnits2;
-	}
-	if ((*String1 == 0) && (*String2 == 0)) {
-		return 0;
-	}
-	else
+	allocator = json_NodeAllocator(this->parent.parent.json_root, NULL);
+
+	node = json_AllocateNode(allocator, JSON_TYPE::NUMBER, false);
+	if (node != NULL)
 	{
-		if (*String1 != 0) {
-			return 1;
+		if (!json_CopyKey(node, key, allocator)) {
+			json_DeallocateNode(node, allocator);
+			return NULL;
 		}
-		else {
-			return -1;
+
+		char number_value[128];
+		snprintf(number_value, 128, "%f", value);
+		if (!json_CopyValue(node, number_value, allocator)) {
+			json_free_node(node, allocator);
+			return NULL;
 		}
-	}
-}
 
-// ----------------------------- //
-// **   JSON_OBJECT methods   ** //
-// ----------------------------- //
+		node->type = JSON_TYPE::NUMBER;
+		node->format = NULL;
 
-JSON_OBJECT::JSON_OBJECT() {
-	this->json_root = NULL;
-}
+		if (!json_LinkNode(this->parent.parent.json_root, node, this->parent.append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
+	}
 
-JSON_OBJECT::JSON_OBJECT(JSON_NODE* root) {
-	this->json_root = root;
+	return node;
 }
 
-JSON_OBJECT::JSON_OBJECT(const char* json, JSON_PARSER_CONTEXT* context)
+JSON_NODE* JSON_OBJECT::Insert::Number::Int(const char* key, int value)
 {
-	this->json_root = JSON_Parse(json, context);
-}
+	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-JSON_OBJECT& JSON_OBJECT::operator=(const JSON_OBJECT& other)
-{
-	this->json_root = other.json_root;
-	return *this;
-}
+	allocator = json_NodeAllocator(this->parent.parent.json_root, NULL);
 
-JSON_OBJECT::operator JSON_NODE* () const
-{
-	return this->json_root;
-}
+	node = json_AllocateNode(allocator, JSON_TYPE::NUMBER, false);
+	if (node != NULL)
+	{
+		if (!json_CopyKey(node, key, allocator)) {
+			json_DeallocateNode(node, allocator);
+			return NULL;
+		}
 
-JSON_NODE* JSON_OBJECT::MakeRoot()
-{
-	return this->json_root = JSON_CreateNode(JSON_TYPE::OBJECT, NULL, NULL);
-}
+		char number_value[32];
+		snprintf(number_value, 32, "%d", value);
+		if (!json_CopyValue(node, number_value, allocator)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 
-void JSON_OBJECT::Free()
-{
-	JSON_Free(this->json_root);
-	this->json_root = NULL;
-}
+		node->type = JSON_TYPE::NUMBER;
+		node->format = NULL;
 
-bool JSON_OBJECT::Empty() {
-	if (this->json_root) {
-		return false;
-	}
-	else {
-		return true;
+		if (!json_LinkNode(this->parent.parent.json_root, node, this->parent.append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 	}
+
+	return node;
 }
 
-unsigned long JSON_OBJECT::Count()
+JSON_NODE* JSON_OBJECT::Insert::Number::Long(const char* key, long value)
 {
-	unsigned long count;
+	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-	count = 0;
-	if (this->json_root != NULL)
+	allocator = json_NodeAllocator(this->parent.parent.json_root, NULL);
+
+	node = json_AllocateNode(allocator, JSON_TYPE::NUMBER, false);
+	if (node != NULL)
 	{
-		JSON_NODE* node;
+		if (!json_CopyKey(node, key, allocator)) {
+			json_DeallocateNode(node, allocator);
+			return NULL;
+		}
 
-		node = (JSON_NODE*)this->json_root->value;
-		while (node != NULL)
-		{
-			node = node->next;
-			count++;
+		char number_value[32];
+		snprintf(number_value, 32, "%ld", value);
+		if (!json_CopyValue(node, number_value, allocator)) {
+			json_free_node(node, allocator);
+			return NULL;
 		}
-	}
 
-	return count;
-}
+		node->type = JSON_TYPE::NUMBER;
+		node->format = NULL;
 
-JSON_NODE* JSON_OBJECT::First()
-{
-	if (this->json_root != NULL) {
-		return (JSON_NODE*)this->json_root->value;
+		if (!json_LinkNode(this->parent.parent.json_root, node, this->parent.append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 	}
 
-	return NULL;
+	return node;
 }
 
-JSON_OBJECT JSON_OBJECT::Object(const char* key)
+JSON_NODE* JSON_OBJECT::Insert::Number::Int64(const char* key, long long value)
 {
 	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-	if (this->json_root == NULL) {
-		return NULL;
-	}
+	allocator = json_NodeAllocator(this->parent.parent.json_root, NULL);
 
-	node = (JSON_NODE*)this->json_root->value;
-	while (node != NULL)
+	node = json_AllocateNode(allocator, JSON_TYPE::NUMBER, false);
+	if (node != NULL)
 	{
-		if (node->type == JSON_TYPE::OBJECT)
-		{
-			if (UTF8_Encoding::CompareStrings(node->key, key) == 0) {
-				return node;
-			}
+		if (!json_CopyKey(node, key, allocator)) {
+			json_DeallocateNode(node, allocator);
+			return NULL;
+		}
+
+		char number_value[64];
+		snprintf(number_value, 64, "%lld", value);
+		if (!json_CopyValue(node, number_value, allocator)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
+
+		node->type = JSON_TYPE::NUMBER;
+		node->format = NULL;
+
+		if (!json_LinkNode(this->parent.parent.json_root, node, this->parent.append)) {
+			json_free_node(node, allocator);
+			return NULL;
 		}
-		node = node->next;
 	}
 
-	return NULL;
+	return node;
 }
 
-JSON_ARRAY JSON_OBJECT::Array(const char* key)
+JSON_NODE* JSON_OBJECT::Insert::Number::String(const char* key, const char* value)
 {
 	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-	if (this->json_root == NULL) {
-		return NULL;
-	}
+	allocator = json_NodeAllocator(this->parent.parent.json_root, NULL);
 
-	node = (JSON_NODE*)this->json_root->value;
-	while (node != NULL)
+	node = json_AllocateNode(allocator, JSON_TYPE::NUMBER, false);
+	if (node != NULL)
 	{
-		if (node->type == JSON_TYPE::ARRAY)
-		{
-			if (UTF8_Encoding::CompareStrings(node->key, key) == 0) {
-				return node;
-			}
+		if (!json_CopyKey(node, key, allocator)) {
+			json_DeallocateNode(node, allocator);
+			return NULL;
+		}
+
+		if (!json_CopyValue(node, value, allocator)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
+
+		node->type = JSON_TYPE::NUMBER;
+		node->format = NULL;
+
+		if (!json_LinkNode(this->parent.parent.json_root, node, this->parent.append)) {
+			json_free_node(node, allocator);
+			return NULL;
 		}
-		node = node->next;
 	}
 
-	return NULL;
+	return node;
 }
 
-const char* JSON_OBJECT::String(const char* key)
+bool JSON_OBJECT::Delete(const char* key)
+{
+	return this->Delete(key, json_KeyLength(key));
+}
+
+bool JSON_OBJECT::Delete(const char* key, size_t keyLength)
 {
 	JSON_NODE* node;
 
 	if (this->json_root == NULL) {
-		return NULL;
+		return false;
 	}
 
-	node = (JSON_NODE*)this->json_root->value;
-	while (node != NULL)
-	{
-		if (node->type == JSON_TYPE::STRING)
-		{
-			if (UTF8_Encoding::CompareStrings(node->key, key) == 0) {
-				return (const char*)node->value;
-			}
-		}
-		node = node->next;
+	node = json_FindMember(this->json_root, key, keyLength, NULL);
+	if (node == NULL) {
+		return false;
 	}
 
-	return NULL;
+	return this->Delete(node);
 }
 
-bool JSON_OBJECT::Boolean(const char* key)
+bool JSON_OBJECT::Delete(JSON_NODE* reference)
 {
-	JSON_NODE* node;
+	JSON_NODE* prev_node, * node;
 
-	if (this->json_root == NULL) {
+	prev_node = node = NULL;
+
+	if ((this->json_root == NULL) || (reference == NULL)) {
+		return false;
+	}
+
+	// The items shared with a clone are copied, the copy of the reference is deleted
+	reference = json_UnshareItem(this->json_root, reference);
+	if (reference == NULL) {
 		return false;
 	}
 
 	node = (JSON_NODE*)this->json_root->value;
 	while (node != NULL)
 	{
-		if (node->type == JSON_TYPE::BOOLEAN)
+		if (node == reference)
 		{
-			if (UTF8_Encoding::CompareStrings(node->key, key) == 0) {
-				return (bool)node->value;
-			}
+			json_UnlinkNode(this->json_root, node, prev_node, 0);
+			json_free_node(node, json_NodeAllocator(this->json_root, NULL));
+			return true;
 		}
+		prev_node = node;
 		node = node->next;
 	}
-
 	return false;
 }
 
-JSON_OBJECT::Number::Number(JSON_OBJECT& parent) : parent(parent) {}
-
-double JSON_OBJECT::Number::Double(const char* key)
+JSON_OBJECT JSON_OBJECT::Clone()
 {
-	const char* number;
-
-	number = JSON_GetNumber(this->parent.json_root, key);
-	if (number != NULL) {
-		return atof(number);
-	}
-
-	return 0.0f;
+	return JSON_Clone(this->json_root);
 }
 
-int JSON_OBJECT::Number::Int(const char* key)
+bool JSON_OBJECT::Equal(JSON_NODE* other, bool ignoreKeyOrder)
 {
-	const char* number;
-
-	number = JSON_GetNumber(this->parent.json_root, key);
-	if (number != NULL) {
-		return atoi(number);
-	}
-
-	return 0;
+	return JSON_Equal(this->json_root, other, ignoreKeyOrder);
 }
 
-long JSON_OBJECT::Number::Long(const char* key)
+unsigned long long JSON_OBJECT::Hash()
 {
-	const char* number;
-
-	number = JSON_GetNumber(this->parent.json_root, key);
-	if (number != NULL) {
-		return atol(number);
-	}
-
-	return 0;
+	return JSON_Hash(this->json_root);
 }
 
-long long JSON_OBJECT::Number::Int64(const char* key)
+bool JSON_OBJECT::Patch(JSON_NODE* patch, size_t* pFailedOperation)
 {
-	const char* number;
-
-	number = JSON_GetNumber(this->parent.json_root, key);
-	if (number != NULL) {
-		return atoll(number);
-	}
-
-	return 0;
+	return JSON_Patch(this->json_root, patch, pFailedOperation);
 }
 
-const char* JSON_OBJECT::Number::String(const char* key)
+bool JSON_OBJECT::MergePatch(JSON_NODE* patch)
 {
-	return JSON_GetNumber(parent.json_root, key);
+	return JSON_MergePatch(this->json_root, patch);
 }
 
-JSON_OBJECT::Insert::Insert(JSON_OBJECT& parent) : parent(parent) {}
+char* JSON_OBJECT::Generate(const char* format, const JSON_ALLOCATOR* allocator)
+{
+	return JSON_Generate(this->json_root, format, allocator);
+}
 
-JSON_OBJECT JSON_OBJECT::Insert::Object(const char* key)
+char* JSON_OBJECT::GenerateCanonical(const JSON_ALLOCATOR* allocator)
 {
-	JSON_NODE* node;
+	return JSON_GenerateCanonical(this->json_root, allocator);
+}
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-	if (node != NULL)
-	{
-		size_t keyLength = UTF8_Encoding::GetStringUnits(key) + 1;
-		char* object_key = (char*)malloc(keyLength);
-		if (object_key == NULL) {
-			free(node);
-			return NULL;
+bool JSON_OBJECT::Format(const char* format)
+{
+	if (this->json_root) {
+		const JSON_ALLOCATOR* allocator = json_NodeAllocator(this->json_root, NULL);
+		if (json_root->format) {
+			json_Deallocate(allocator, (void*)json_root->format);
+		}
+		if (format == NULL) {
+			this->json_root->format = NULL;
+		}
+		else
+		{
+			size_t blockLen = strlen(format) + 1;
+			this->json_root->format = (const char*)json_Allocate(allocator, blockLen);
+			if (this->json_root->format == NULL) {
+				return false;
+			}
+			memcpy((void*)this->json_root->format, format, blockLen);
 		}
 
-		UTF8_Encoding::StringCopy(object_key, keyLength, key);
-
-		node->key = object_key;
-		node->value = 0;
-		node->type = JSON_TYPE::OBJECT;
-		node->next = (JSON_NODE*)this->parent.json_root->value;
-		node->format = NULL;
-
-		this->parent.json_root->value = node;
+		return true;
 	}
 
-	return node;
+	return false;
 }
 
-JSON_ARRAY JSON_OBJECT::Insert::Array(const char* key)
+JSON_NODE* JSON_OBJECT::Parse(const char* json, JSON_PARSER_CONTEXT* context)
 {
-	JSON_NODE* node;
-
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-	if (node != NULL)
-	{
-		size_t keyLength = UTF8_Encoding::GetStringUnits(key) + 1;
-		char* array_key = (char*)malloc(keyLength);
-		if (array_key == NULL) {
-			free(node);
-			return NULL;
-		}
-
-		UTF8_Encoding::StringCopy(array_key, keyLength, key);
-
-		node->key = array_key;
-		node->value = 0;
-		node->type = JSON_TYPE::ARRAY;
-		node->next = (JSON_NODE*)this->parent.json_root->value;
-		node->format = NULL;
-
-		this->parent.json_root->value = node;
+	if (this->json_root) {
+		JSON_Free(this->json_root);
 	}
 
-	return node;
+	return this->json_root = JSON_Parse(json, context);
 }
 
-JSON_NODE* JSON_OBJECT::Insert::String(const char* key, const char* value)
+JSON_NODE* JSON_OBJECT::ParseInto(const char* json, JSON_PARSER_CONTEXT* context)
 {
-	JSON_NODE* node;
+	return this->json_root = JSON_ParseInto(this->json_root, json, context);
+}
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-	if (node != NULL)
-	{
-		size_t keyLength = UTF8_Encoding::GetStringUnits(key) + 1;
-		char* string_key = (char*)malloc(keyLength);
-		if (string_key == NULL) {
-			free(node);
-			return NULL;
-		}
+JSON_NODE* JSON_OBJECT::Reparse(const char* old_json, size_t offset, size_t removedLength, const char* insertedText, JSON_PARSER_CONTEXT* context)
+{
+	return this->json_root = JSON_Reparse(this->json_root, old_json, offset, removedLength, insertedText, context);
+}
 
-		size_t valueLength = UTF8_Encoding::GetStringUnits(value) + 1;
-		char* string_value = (char*)malloc(valueLength);
-		if (string_value == NULL) {
-			free(string_key);
-			free(node);
-			return NULL;
-		}
+#ifdef JSON_PLUS_STRING_VIEW
 
-		UTF8_Encoding::StringCopy(string_key, keyLength, key);
-		UTF8_Encoding::StringCopy(string_value, valueLength, value);
+JSON_OBJECT JSON_OBJECT::Object(std::string_view key)
+{
+	return this->Object(key.data(), key.size());
+}
 
-		node->key = string_key;
-		node->value = string_value;
-		node->type = JSON_TYPE::STRING;
-		node->next = (JSON_NODE*)this->parent.json_root->value;
-		node->format = NULL;
+JSON_ARRAY JSON_OBJECT::Array(std::string_view key)
+{
+	return this->Array(key.data(), key.size());
+}
 
-		this->parent.json_root->value = node;
-	}
+const char* JSON_OBJECT::String(std::string_view key)
+{
+	return this->String(key.data(), key.size());
+}
 
-	return node;
+bool JSON_OBJECT::Boolean(std::string_view key)
+{
+	return this->Boolean(key.data(), key.size());
 }
 
-JSON_NODE* JSON_OBJECT::Insert::Boolean(const char* key, bool value)
+const JSON_POSITION* JSON_OBJECT::Position(JSON_POSITION_MAP* positions, std::string_view key)
 {
-	JSON_NODE* node;
+	return this->Position(positions, key.data(), key.size());
+}
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-	if (node != NULL)
-	{
-		size_t keyLength = UTF8_Encoding::GetStringUnits(key) + 1;
-		char* boolean_key = (char*)malloc(keyLength);
-		if (boolean_key == NULL) {
-			free(node);
-			return NULL;
-		}
+double JSON_OBJECT::Number::Double(std::string_view key)
+{
+	return this->Double(key.data(), key.size());
+}
 
-		UTF8_Encoding::StringCopy(boolean_key, keyLength, key);
+int JSON_OBJECT::Number::Int(std::string_view key)
+{
+	return this->Int(key.data(), key.size());
+}
 
-		node->key = boolean_key;
-		node->value = (void*)value;
-		node->type = JSON_TYPE::BOOLEAN;
-		node->next = (JSON_NODE*)this->parent.json_root->value;
-		node->format = NULL;
+long JSON_OBJECT::Number::Long(std::string_view key)
+{
+	return this->Long(key.data(), key.size());
+}
 
-		this->parent.json_root->value = node;
-	}
+long long JSON_OBJECT::Number::Int64(std::string_view key)
+{
+	return this->Int64(key.data(), key.size());
+}
 
-	return node;
+const char* JSON_OBJECT::Number::String(std::string_view key)
+{
+	return this->String(key.data(), key.size());
 }
 
-JSON_OBJECT::Insert::Number::Number(Insert& parent) : parent(parent) {}
+bool JSON_OBJECT::Delete(std::string_view key)
+{
+	return this->Delete(key.data(), key.size());
+}
 
-JSON_NODE* JSON_OBJECT::Insert::Number::Double(const char* key, double value)
+std::optional<std::string_view> JSON_OBJECT::GetString(std::string_view key)
 {
 	JSON_NODE* node;
+	JSON_TYPE type;
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-	if (node != NULL)
-	{
-		size_t keyLength = UTF8_Encoding::GetStringUnits(key) + 1;
-		char* number_key = (char*)malloc(keyLength);
-		if (number_key == NULL) {
-			free(node);
-			return NULL;
-		}
+	type = JSON_TYPE::STRING;
 
-		char* number_value = (char*)malloc(128);
-		if (number_value == NULL) {
-			free(number_key);
-			free(node);
-			return NULL;
-		}
+	node = json_FindMember(this->json_root, key.data(), key.size(), &type);
+	if (node != NULL) {
+		return json_ValueView(node);
+	}
 
-		UTF8_Encoding::StringCopy(number_key, keyLength, key);
-		snprintf(number_value, 128, "%f", value);
+	return std::nullopt;
+}
 
-		node->key = number_key;
-		node->value = number_value;
-		node->type = JSON_TYPE::NUMBER;
-		node->next = (JSON_NODE*)this->parent.parent.json_root->value;
-		node->format = NULL;
+std::optional<std::string_view> JSON_OBJECT::GetNumber(std::string_view key)
+{
+	JSON_NODE* node;
+	JSON_TYPE type;
 
-		this->parent.parent.json_root->value = node;
+	type = JSON_TYPE::NUMBER;
+
+	node = json_FindMember(this->json_root, key.data(), key.size(), &type);
+	if (node != NULL) {
+		return json_ValueView(node);
 	}
 
-	return node;
+	return std::nullopt;
 }
 
-JSON_NODE* JSON_OBJECT::Insert::Number::Int(const char* key, int value)
+std::optional<double> JSON_OBJECT::GetDouble(std::string_view key)
 {
 	JSON_NODE* node;
+	JSON_TYPE type;
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-	if (node != NULL)
-	{
-		size_t keyLength = UTF8_Encoding::GetStringUnits(key) + 1;
-		char* number_key = (char*)malloc(keyLength);
-		if (number_key == NULL) {
-			free(node);
-			return NULL;
-		}
+	type = JSON_TYPE::NUMBER;
 
-		char* number_value = (char*)malloc(32);
-		if (number_value == NULL) {
-			free(number_key);
-			free(node);
-			return NULL;
-		}
+	node = json_FindMember(this->json_root, key.data(), key.size(), &type);
+	if ((node != NULL) && (node->value != NULL)) {
+		return atof((const char*)node->value);
+	}
 
-		UTF8_Encoding::StringCopy(number_key, keyLength, key);
-		snprintf(number_value, 32, "%d", value);
+	return std::nullopt;
+}
 
-		node->key = number_key;
-		node->value = number_value;
-		node->type = JSON_TYPE::NUMBER;
-		node->next = (JSON_NODE*)this->parent.parent.json_root->value;
-		node->format = NULL;
+std::optional<long long> JSON_OBJECT::GetInt64(std::string_view key)
+{
+	JSON_NODE* node;
+	JSON_TYPE type;
 
-		this->parent.parent.json_root->value = node;
+	type = JSON_TYPE::NUMBER;
+
+	node = json_FindMember(this->json_root, key.data(), key.size(), &type);
+	if ((node != NULL) && (node->value != NULL)) {
+		return atoll((const char*)node->value);
 	}
 
-	return node;
+	return std::nullopt;
 }
 
-JSON_NODE* JSON_OBJECT::Insert::Number::Long(const char* key, long value)
+std::optional<bool> JSON_OBJECT::GetBoolean(std::string_view key)
 {
 	JSON_NODE* node;
+	JSON_TYPE type;
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-	if (node != NULL)
-	{
-		size_t keyLength = UTF8_Encoding::GetStringUnits(key) + 1;
-		char* number_key = (char*)malloc(keyLength);
-		if (number_key == NULL) {
-			free(node);
-			return NULL;
-		}
+	type = JSON_TYPE::BOOLEAN;
 
-		char* number_value = (char*)malloc(32);
-		if (number_value == NULL) {
-			free(number_key);
-			free(node);
-			return NULL;
-		}
+	node = json_FindMember(this->json_root, key.data(), key.size(), &type);
+	if (node != NULL) {
+		return (bool)node->value;
+	}
 
-		UTF8_Encoding::StringCopy(number_key, keyLength, key);
-		snprintf(number_value, 32, "%ld", value);
+	return std::nullopt;
+}
 
-		node->key = number_key;
-		node->value = number_value;
-		node->type = JSON_TYPE::NUMBER;
-		node->next = (JSON_NODE*)this->parent.parent.json_root->value;
-		node->format = NULL;
+#endif // JSON_PLUS_STRING_VIEW
 
-		this->parent.parent.json_root->value = node;
+#ifdef JSON_PLUS_CONSTEXPR_KEY
+
+JSON_OBJECT JSON_OBJECT::Object(const JSON_KEY& key)
+{
+	if ((this->json_root == NULL) || (!json_Unshare(this->json_root))) {
+		return NULL;
 	}
 
-	return node;
+	return JSON_GetObject(this->json_root, key);
 }
 
-JSON_NODE* JSON_OBJECT::Insert::Number::Int64(const char* key, long long value)
+JSON_ARRAY JSON_OBJECT::Array(const JSON_KEY& key)
 {
-	JSON_NODE* node;
-
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-	if (node != NULL)
-	{
-		size_t keyLength = UTF8_Encoding::GetStringUnits(key) + 1;
-		char* number_key = (char*)malloc(keyLength);
-		if (number_key == NULL) {
-			free(node);
-			return NULL;
-		}
+	if ((this->json_root == NULL) || (!json_Unshare(this->json_root))) {
+		return NULL;
+	}
 
-		char* number_value = (char*)malloc(64);
-		if (number_value == NULL) {
-			free(number_key);
-			free(node);
-			return NULL;
-		}
+	return JSON_GetArray(this->json_root, key);
+}
 
-		UTF8_Encoding::StringCopy(number_key, keyLength, key);
-		snprintf(number_value, 64, "%lld", value);
+const char* JSON_OBJECT::String(const JSON_KEY& key)
+{
+	return JSON_GetString(this->json_root, key);
+}
 
-		node->key = number_key;
-		node->value = number_value;
-		node->type = JSON_TYPE::NUMBER;
-		node->next = (JSON_NODE*)this->parent.parent.json_root->value;
-		node->format = NULL;
+bool JSON_OBJECT::Boolean(const JSON_KEY& key)
+{
+	return JSON_GetBoolean(this->json_root, key);
+}
 
-		this->parent.parent.json_root->value = node;
+const JSON_POSITION* JSON_OBJECT::Position(JSON_POSITION_MAP* positions, const JSON_KEY& key)
+{
+	if ((this->json_root == NULL) || (positions == NULL)) {
+		return NULL;
 	}
 
-	return node;
+	return positions->Find(json_FindMember(this->json_root, key, NULL));
 }
 
-JSON_NODE* JSON_OBJECT::Insert::Number::String(const char* key, const char* value)
+double JSON_OBJECT::Number::Double(const JSON_KEY& key)
 {
-	JSON_NODE* node;
-
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
-	if (node != NULL)
-	{
-		size_t keyLength = UTF8_Encoding::GetStringUnits(key) + 1;
-		char* number_key = (char*)malloc(keyLength);
-		if (number_key == NULL) {
-			free(node);
-			return NULL;
-		}
+	const char* number;
 
-		size_t valueLength = UTF8_Encoding::GetStringUnits(value) + 1;
-		char* number_value = (char*)malloc(valueLength);
-		if (number_value == NULL) {
-			free(number_key);
-			free(node);
-			return NULL;
-		}
+	number = JSON_GetNumber(this->parent.json_root, key);
+	if (number != NULL) {
+		return atof(number);
+	}
 
-		UTF8_Encoding::StringCopy(number_key, keyLength, key);
-		UTF8_Encoding::StringCopy(number_value, valueLength, value);
+	return 0.0f;
+}
 
-		node->key = number_key;
-		node->value = number_value;
-		node->type = JSON_TYPE::NUMBER;
-		node->next = (JSON_NODE*)this->parent.parent.json_root->value;
-		node->format = NULL;
+int JSON_OBJECT::Number::Int(const JSON_KEY& key)
+{
+	const char* number;
 
-		this->parent.parent.json_root->value = node;
+	number = JSON_GetNumber(this->parent.json_root, key);
+	if (number != NULL) {
+		return atoi(number);
 	}
 
-	return node;
+	return 0;
 }
 
-bool JSON_OBJECT::Delete(const char* key)
+long JSON_OBJECT::Number::Long(const JSON_KEY& key)
 {
-	JSON_NODE* prev_node, * node;
-
-	prev_node = node = NULL;
+	const char* number;
 
-	node = (JSON_NODE*)this->json_root->value;
-	if (UTF8_Encoding::CompareStrings(node->key, key) == 0)
-	{
-		this->json_root->value = node->next;
-		json_free_node(node);
-		return true;
+	number = JSON_GetNumber(this->parent.json_root, key);
+	if (number != NULL) {
+		return atol(number);
 	}
-	else
-	{
-		prev_node = node;
-		node = node->next;
 
-		while (node != NULL)
-		{
-			if (UTF8_Encoding::CompareStrings(node->key, key) == 0)
-			{
-				prev_node->next = node->next;
-				json_free_node(node);
-				return true;
-			}
-			prev_node = node;
-			node = node->next;
-		}
-	}
-	return false;
+	return 0;
 }
 
-bool JSON_OBJECT::Delete(JSON_NODE* reference)
+long long JSON_OBJECT::Number::Int64(const JSON_KEY& key)
 {
-	JSON_NODE* prev_node, * node;
-
-	prev_node = node = NULL;
+	const char* number;
 
-	node = (JSON_NODE*)this->json_root->value;
-	if (node == reference)
-	{
-		this->json_root->value = node->next;
-		json_free_node(node);
-		return true;
+	number = JSON_GetNumber(this->parent.json_root, key);
+	if (number != NULL) {
+		return atoll(number);
 	}
-	else
-	{
-		prev_node = node;
-		node = node->next;
 
-		while (node != NULL)
-		{
-			if (node == reference)
-			{
-				prev_node->next = node->next;
-				json_free_node(node);
-				return true;
-			}
-			prev_node = node;
-			node = node->next;
-		}
-	}
-	return false;
+	return 0;
 }
 
-char* JSON_OBJECT::Generate(const char* format)
+const char* JSON_OBJECT::Number::String(const JSON_KEY& key)
 {
-	return JSON_Generate(this->json_root, format);
+	return JSON_GetNumber(this->parent.json_root, key);
 }
 
-bool JSON_OBJECT::Format(const char* format)
+bool JSON_OBJECT::Delete(const JSON_KEY& key)
 {
-	if (this->json_root) {
-		if (json_root->format) {
-			free((void*)json_root->format);
-		}
-		if (format == NULL) {
-			this->json_root->format = NULL;
-		}
-		else
-		{
-			size_t blockLen = strlen(format) + 1;
-			this->json_root->format = (const char*)malloc(blockLen);
-			if (this->json_root->format == NULL) {
-				return false;
-			}
-			memcpy((void*)this->json_root->format, format, blockLen);
-		}
+	JSON_NODE* node;
 
-		return true;
+	if (this->json_root == NULL) {
+		return false;
 	}
 
-	return false;
-}
-
-JSON_NODE* JSON_OBJECT::Parse(const char* json, JSON_PARSER_CONTEXT* context)
-{
-	if (this->json_root) {
-		JSON_Free(this->json_root);
+	node = json_FindMember(this->json_root, key, NULL);
+	if (node == NULL) {
+		return false;
 	}
 
-	return this->json_root = JSON_Parse(json, context);
+	return this->Delete(node);
 }
 
+#endif // JSON_PLUS_CONSTEXPR_KEY
+
 // ---------------------------- //
 // **   JSON_ARRAY methods   ** //
 // ---------------------------- //
@@ -2634,9 +11032,9 @@ JSON_ARRAY::operator JSON_NODE* () const
 	return this->json_root;
 }
 
-JSON_NODE* JSON_ARRAY::MakeRoot()
+JSON_NODE* JSON_ARRAY::MakeRoot(const JSON_ALLOCATOR* allocator)
 {
-	return this->json_root = JSON_CreateNode(JSON_TYPE::ARRAY, NULL, NULL);
+	return this->json_root = JSON_CreateNode(JSON_TYPE::ARRAY, NULL, NULL, allocator);
 }
 
 void JSON_ARRAY::Free()
@@ -2656,22 +11054,7 @@ bool JSON_ARRAY::Empty() {
 
 unsigned long JSON_ARRAY::Count()
 {
-	unsigned long count;
-
-	count = 0;
-	if (this->json_root != NULL)
-	{
-		JSON_NODE* node;
-
-		node = (JSON_NODE*)this->json_root->value;
-		while (node != NULL)
-		{
-			node = node->next;
-			count++;
-		}
-	}
-
-	return count;
+	return json_CountItems(this->json_root);
 }
 
 JSON_NODE* JSON_ARRAY::First()
@@ -2683,55 +11066,47 @@ JSON_NODE* JSON_ARRAY::First()
 	return NULL;
 }
 
-JSON_OBJECT JSON_ARRAY::Object(unsigned long i)
+JSON_ITERATOR JSON_ARRAY::begin()
 {
-	JSON_NODE* node;
-	unsigned long ci = 0;
+	if (this->json_root == NULL) {
+		return JSON_ITERATOR();
+	}
 
-	node = (JSON_NODE*)this->json_root->value;
-	while (node != NULL)
-	{
-		if (ci == i) {
-			return node;
-		}
-		node = node->next;
-		ci++;
+	return JSON_ITERATOR((JSON_NODE*)this->json_root->value);
+}
+
+JSON_ITERATOR JSON_ARRAY::end()
+{
+	return JSON_ITERATOR();
+}
+
+JSON_OBJECT JSON_ARRAY::Object(unsigned long i)
+{
+	// The object can be changed, so it must not be shared with a clone
+	if ((this->json_root == NULL) || (!json_Unshare(this->json_root))) {
+		return NULL;
 	}
 
-	return NULL;
+	return json_GetItem(this->json_root, i);
 }
 
 JSON_ARRAY JSON_ARRAY::Array(unsigned long i)
 {
-	JSON_NODE* node;
-	unsigned long ci = 0;
-
-	node = (JSON_NODE*)this->json_root->value;
-	while (node != NULL)
-	{
-		if (ci == i) {
-			return node;
-		}
-		node = node->next;
-		ci++;
+	// The array can be changed, so it must not be shared with a clone
+	if ((this->json_root == NULL) || (!json_Unshare(this->json_root))) {
+		return NULL;
 	}
 
-	return NULL;
+	return json_GetItem(this->json_root, i);
 }
 
 const char* JSON_ARRAY::String(unsigned long i)
 {
 	JSON_NODE* node;
-	unsigned long ci = 0;
 
-	node = (JSON_NODE*)this->json_root->value;
-	while (node != NULL)
-	{
-		if (ci == i) {
-			return (char*)node->value;
-		}
-		node = node->next;
-		ci++;
+	node = json_GetItem(this->json_root, i);
+	if (node != NULL) {
+		return (char*)node->value;
 	}
 
 	return NULL;
@@ -2740,129 +11115,170 @@ const char* JSON_ARRAY::String(unsigned long i)
 bool JSON_ARRAY::Boolean(unsigned long i)
 {
 	JSON_NODE* node;
-	unsigned long ci = 0;
 
-	node = (JSON_NODE*)this->json_root->value;
-	while (node != NULL)
-	{
-		if (ci == i) {
-			return (bool)node->value;
-		}
-		node = node->next;
-		ci++;
+	node = json_GetItem(this->json_root, i);
+	if (node != NULL) {
+		return (bool)node->value;
 	}
 
 	return NULL;
 }
 
+const JSON_POSITION* JSON_ARRAY::Position(JSON_POSITION_MAP* positions, unsigned long i)
+{
+	if ((this->json_root == NULL) || (positions == NULL)) {
+		return NULL;
+	}
+
+	return positions->Find(json_GetItem(this->json_root, i));
+}
+
 JSON_ARRAY::Number::Number(JSON_ARRAY& parent) : parent(parent) {}
 
 double JSON_ARRAY::Number::Double(unsigned long i)
 {
 	JSON_NODE* node;
-	unsigned long ci = 0;
 
-	node = (JSON_NODE*)this->parent.json_root->value;
-	while (node != NULL)
-	{
-		if (ci == i) {
-			return atof((const char*)node->value);
-		}
-		node = node->next;
-		ci++;
+	node = json_GetItem(this->parent.json_root, i);
+	if (node != NULL) {
+		return atof((const char*)node->value);
+	}
+
+	return 0.0f;
+}
+
+int JSON_ARRAY::Number::Int(unsigned long i)
+{
+	JSON_NODE* node;
+
+	node = json_GetItem(this->parent.json_root, i);
+	if (node != NULL) {
+		return atoi((const char*)node->value);
+	}
+
+	return 0;
+}
+
+long JSON_ARRAY::Number::Long(unsigned long i)
+{
+	JSON_NODE* node;
+
+	node = json_GetItem(this->parent.json_root, i);
+	if (node != NULL) {
+		return atol((const char*)node->value);
+	}
+
+	return 0;
+}
+
+long long JSON_ARRAY::Number::Int64(unsigned long i)
+{
+	JSON_NODE* node;
+
+	node = json_GetItem(this->parent.json_root, i);
+	if (node != NULL) {
+		return atoll((const char*)node->value);
 	}
 
-	return 0.0f;
+	return 0;
 }
 
-int JSON_ARRAY::Number::Int(unsigned long i)
+size_t JSON_ARRAY::ToDoubles(double* values, size_t count)
 {
 	JSON_NODE* node;
-	unsigned long ci = 0;
+	size_t i;
 
-	node = (JSON_NODE*)this->parent.json_root->value;
-	while (node != NULL)
+	if (this->json_root == NULL) {
+		return 0;
+	}
+
+	i = 0;
+	for (node = (JSON_NODE*)this->json_root->value; (node != NULL) && (i < count); node = node->next)
 	{
-		if (ci == i) {
-			return atoi((const char*)node->value);
+		if (node->type != JSON_TYPE::NUMBER) {
+			break;
 		}
-		node = node->next;
-		ci++;
+		values[i++] = json_NumberValue((const char*)node->value);
 	}
 
-	return 0;
+	return i;
 }
 
-long JSON_ARRAY::Number::Long(unsigned long i)
+size_t JSON_ARRAY::ToFloats(float* values, size_t count)
 {
 	JSON_NODE* node;
-	unsigned long ci = 0;
+	size_t i;
 
-	node = (JSON_NODE*)this->parent.json_root->value;
-	while (node != NULL)
+	if (this->json_root == NULL) {
+		return 0;
+	}
+
+	i = 0;
+	for (node = (JSON_NODE*)this->json_root->value; (node != NULL) && (i < count); node = node->next)
 	{
-		if (ci == i) {
-			return atol((const char*)node->value);
+		if (node->type != JSON_TYPE::NUMBER) {
+			break;
 		}
-		node = node->next;
-		ci++;
+		values[i++] = (float)json_NumberValue((const char*)node->value);
 	}
 
-	return 0;
+	return i;
 }
 
-long long JSON_ARRAY::Number::Int64(unsigned long i)
+size_t JSON_ARRAY::ToInt64s(long long* values, size_t count)
 {
 	JSON_NODE* node;
-	unsigned long ci = 0;
+	size_t i;
 
-	node = (JSON_NODE*)this->parent.json_root->value;
-	while (node != NULL)
+	if (this->json_root == NULL) {
+		return 0;
+	}
+
+	i = 0;
+	for (node = (JSON_NODE*)this->json_root->value; (node != NULL) && (i < count); node = node->next)
 	{
-		if (ci == i) {
-			return atoll((const char*)node->value);
+		if (node->type != JSON_TYPE::NUMBER) {
+			break;
 		}
-		node = node->next;
-		ci++;
+		values[i++] = json_NumberInt64((const char*)node->value);
 	}
 
-	return 0;
+	return i;
 }
 
 const char* JSON_ARRAY::Number::String(unsigned long i)
 {
 	JSON_NODE* node;
-	unsigned long ci = 0;
 
-	node = (JSON_NODE*)this->parent.json_root->value;
-	while (node != NULL)
-	{
-		if (ci == i) {
-			return (const char*)node->value;
-		}
-		node = node->next;
-		ci++;
+	node = json_GetItem(this->parent.json_root, i);
+	if (node != NULL) {
+		return (const char*)node->value;
 	}
 
 	return 0;
 }
 
-JSON_ARRAY::Insert::Insert(JSON_ARRAY& parent) : parent(parent) {}
+JSON_ARRAY::Insert::Insert(JSON_ARRAY& parent, bool append) : parent(parent), append(append) {}
 
 JSON_OBJECT JSON_ARRAY::Insert::Object()
 {
 	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
+	allocator = json_NodeAllocator(this->parent.json_root, NULL);
+
+	node = json_AllocateNode(allocator, JSON_TYPE::OBJECT, false);
 	if (node != NULL)
 	{
 		node->key = NULL;
 		node->value = 0;
 		node->type = JSON_TYPE::OBJECT;
-		node->next = (JSON_NODE*)this->parent.json_root->value;
 		node->format = NULL;
 
-		this->parent.json_root->value = node;
+		if (!json_LinkNode(this->parent.json_root, node, this->append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 	}
 
 	return node;
@@ -2871,17 +11287,22 @@ JSON_OBJECT JSON_ARRAY::Insert::Object()
 JSON_ARRAY JSON_ARRAY::Insert::Array()
 {
 	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
+
+	allocator = json_NodeAllocator(this->parent.json_root, NULL);
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
+	node = json_AllocateNode(allocator, JSON_TYPE::ARRAY, false);
 	if (node != NULL)
 	{
 		node->key = NULL;
 		node->value = 0;
 		node->type = JSON_TYPE::ARRAY;
-		node->next = (JSON_NODE*)this->parent.json_root->value;
 		node->format = NULL;
 
-		this->parent.json_root->value = node;
+		if (!json_LinkNode(this->parent.json_root, node, this->append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 	}
 
 	return node;
@@ -2890,26 +11311,26 @@ JSON_ARRAY JSON_ARRAY::Insert::Array()
 JSON_NODE* JSON_ARRAY::Insert::String(const char* value)
 {
 	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
+	allocator = json_NodeAllocator(this->parent.json_root, NULL);
+
+	node = json_AllocateNode(allocator, JSON_TYPE::STRING, false);
 	if (node != NULL)
 	{
-		size_t valueLength = UTF8_Encoding::GetStringUnits(value) + 1;
-		char* string_value = (char*)malloc(valueLength);
-		if (string_value == NULL) {
-			free(node);
+		if (!json_CopyValue(node, value, allocator)) {
+			json_free_node(node, allocator);
 			return NULL;
 		}
 
-		UTF8_Encoding::StringCopy(string_value, valueLength, value);
-
 		node->key = NULL;
-		node->value = string_value;
 		node->type = JSON_TYPE::STRING;
-		node->next = (JSON_NODE*)this->parent.json_root->value;
 		node->format = NULL;
 
-		this->parent.json_root->value = node;
+		if (!json_LinkNode(this->parent.json_root, node, this->append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 	}
 
 	return node;
@@ -2918,17 +11339,22 @@ JSON_NODE* JSON_ARRAY::Insert::String(const char* value)
 JSON_NODE* JSON_ARRAY::Insert::Boolean(bool value)
 {
 	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
+	allocator = json_NodeAllocator(this->parent.json_root, NULL);
+
+	node = json_AllocateNode(allocator, JSON_TYPE::BOOLEAN, false);
 	if (node != NULL)
 	{
 		node->key = NULL;
 		node->value = (void*)value;
 		node->type = JSON_TYPE::BOOLEAN;
-		node->next = (JSON_NODE*)this->parent.json_root->value;
 		node->format = NULL;
 
-		this->parent.json_root->value = node;
+		if (!json_LinkNode(this->parent.json_root, node, this->append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 	}
 
 	return node;
@@ -2939,25 +11365,29 @@ JSON_ARRAY::Insert::Number::Number(Insert& parent) : parent(parent) {}
 JSON_NODE* JSON_ARRAY::Insert::Number::Double(double value)
 {
 	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
+
+	allocator = json_NodeAllocator(this->parent.parent.json_root, NULL);
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
+	node = json_AllocateNode(allocator, JSON_TYPE::NUMBER, false);
 	if (node != NULL)
 	{
-		char* number_value = (char*)malloc(128);
-		if (number_value == NULL) {
-			free(node);
-			return NULL;
-		}
 
+		char number_value[128];
 		snprintf(number_value, 128, "%f", value);
+		if (!json_CopyValue(node, number_value, allocator)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 
 		node->key = NULL;
-		node->value = number_value;
 		node->type = JSON_TYPE::NUMBER;
-		node->next = (JSON_NODE*)this->parent.parent.json_root->value;
 		node->format = NULL;
 
-		this->parent.parent.json_root->value = node;
+		if (!json_LinkNode(this->parent.parent.json_root, node, this->parent.append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 	}
 
 	return node;
@@ -2966,25 +11396,29 @@ JSON_NODE* JSON_ARRAY::Insert::Number::Double(double value)
 JSON_NODE* JSON_ARRAY::Insert::Number::Int(int value)
 {
 	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
+	allocator = json_NodeAllocator(this->parent.parent.json_root, NULL);
+
+	node = json_AllocateNode(allocator, JSON_TYPE::NUMBER, false);
 	if (node != NULL)
 	{
-		char* number_value = (char*)malloc(32);
-		if (number_value == NULL) {
-			free(node);
-			return NULL;
-		}
 
+		char number_value[32];
 		snprintf(number_value, 32, "%d", value);
+		if (!json_CopyValue(node, number_value, allocator)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 
 		node->key = NULL;
-		node->value = number_value;
 		node->type = JSON_TYPE::NUMBER;
-		node->next = (JSON_NODE*)this->parent.parent.json_root->value;
 		node->format = NULL;
 
-		this->parent.parent.json_root->value = node;
+		if (!json_LinkNode(this->parent.parent.json_root, node, this->parent.append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 	}
 
 	return node;
@@ -2993,25 +11427,29 @@ JSON_NODE* JSON_ARRAY::Insert::Number::Int(int value)
 JSON_NODE* JSON_ARRAY::Insert::Number::Long(long value)
 {
 	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
+
+	allocator = json_NodeAllocator(this->parent.parent.json_root, NULL);
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
+	node = json_AllocateNode(allocator, JSON_TYPE::NUMBER, false);
 	if (node != NULL)
 	{
-		char* number_value = (char*)malloc(32);
-		if (number_value == NULL) {
-			free(node);
-			return NULL;
-		}
 
+		char number_value[32];
 		snprintf(number_value, 32, "%ld", value);
+		if (!json_CopyValue(node, number_value, allocator)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 
 		node->key = NULL;
-		node->value = number_value;
 		node->type = JSON_TYPE::NUMBER;
-		node->next = (JSON_NODE*)this->parent.parent.json_root->value;
 		node->format = NULL;
 
-		this->parent.parent.json_root->value = node;
+		if (!json_LinkNode(this->parent.parent.json_root, node, this->parent.append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 	}
 
 	return node;
@@ -3020,25 +11458,29 @@ JSON_NODE* JSON_ARRAY::Insert::Number::Long(long value)
 JSON_NODE* JSON_ARRAY::Insert::Number::Int64(long long value)
 {
 	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
+	allocator = json_NodeAllocator(this->parent.parent.json_root, NULL);
+
+	node = json_AllocateNode(allocator, JSON_TYPE::NUMBER, false);
 	if (node != NULL)
 	{
-		char* number_value = (char*)malloc(64);
-		if (number_value == NULL) {
-			free(node);
-			return NULL;
-		}
 
+		char number_value[64];
 		snprintf(number_value, 64, "%lld", value);
+		if (!json_CopyValue(node, number_value, allocator)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 
 		node->key = NULL;
-		node->value = number_value;
 		node->type = JSON_TYPE::NUMBER;
-		node->next = (JSON_NODE*)this->parent.parent.json_root->value;
 		node->format = NULL;
 
-		this->parent.parent.json_root->value = node;
+		if (!json_LinkNode(this->parent.parent.json_root, node, this->parent.append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 	}
 
 	return node;
@@ -3047,26 +11489,26 @@ JSON_NODE* JSON_ARRAY::Insert::Number::Int64(long long value)
 JSON_NODE* JSON_ARRAY::Insert::Number::String(const char* value)
 {
 	JSON_NODE* node;
+	const JSON_ALLOCATOR* allocator;
+
+	allocator = json_NodeAllocator(this->parent.parent.json_root, NULL);
 
-	node = (JSON_NODE*)malloc(sizeof(JSON_NODE));
+	node = json_AllocateNode(allocator, JSON_TYPE::NUMBER, false);
 	if (node != NULL)
 	{
-		size_t valueLength = UTF8_Encoding::GetStringUnits(value) + 1;
-		char* number_value = (char*)malloc(valueLength);
-		if (number_value == NULL) {
-			free(node);
+		if (!json_CopyValue(node, value, allocator)) {
+			json_free_node(node, allocator);
 			return NULL;
 		}
 
-		UTF8_Encoding::StringCopy(number_value, valueLength, value);
-
 		node->key = NULL;
-		node->value = number_value;
 		node->type = JSON_TYPE::NUMBER;
-		node->next = (JSON_NODE*)this->parent.parent.json_root->value;
 		node->format = NULL;
 
-		this->parent.parent.json_root->value = node;
+		if (!json_LinkNode(this->parent.parent.json_root, node, this->parent.append)) {
+			json_free_node(node, allocator);
+			return NULL;
+		}
 	}
 
 	return node;
@@ -3074,83 +11516,96 @@ JSON_NODE* JSON_ARRAY::Insert::Number::String(const char* value)
 
 bool JSON_ARRAY::Delete(unsigned long i)
 {
-	unsigned long index;
 	JSON_NODE* prev_node, * node;
 
-	prev_node = node = NULL;
-
-	node = (JSON_NODE*)this->json_root->value;
-	if (i == 0)
-	{
-		this->json_root->value = node->next;
-		json_free_node(node);
-		return true;
+	if ((this->json_root == NULL) || (!json_Unshare(this->json_root))) {
+		return false;
 	}
-	else
-	{
-		index = 1;
-		prev_node = node;
-		node = node->next;
 
-		while (node != NULL)
-		{
-			if (index == i)
-			{
-				prev_node->next = node->next;
-				json_free_node(node);
-				return true;
-			}
-			prev_node = node;
-			node = node->next;
-			index++;
-		}
+	node = json_GetItem(this->json_root, i);
+	if (node == NULL) {
+		return false;
 	}
-	return false;
+
+	prev_node = (i > 0) ? json_GetItem(this->json_root, i - 1) : NULL;
+
+	json_UnlinkNode(this->json_root, node, prev_node, i);
+	json_free_node(node, json_NodeAllocator(this->json_root, NULL));
+
+	return true;
 }
 
 bool JSON_ARRAY::Delete(JSON_NODE* reference)
 {
 	JSON_NODE* prev_node, * node;
+	size_t i;
 
-	prev_node = node = NULL;
+	if ((this->json_root == NULL) || (reference == NULL)) {
+		return false;
+	}
 
-	node = (JSON_NODE*)this->json_root->value;
-	if (node == reference)
-	{
-		this->json_root->value = node->next;
-		json_free_node(node);
-		return true;
+	// The items shared with a clone are copied, the copy of the reference is deleted
+	reference = json_UnshareItem(this->json_root, reference);
+	if (reference == NULL) {
+		return false;
 	}
-	else
-	{
-		prev_node = node;
-		node = node->next;
 
-		while (node != NULL)
+	prev_node = NULL;
+	i = 0;
+
+	node = (JSON_NODE*)this->json_root->value;
+	while (node != NULL)
+	{
+		if (node == reference)
 		{
-			if (node == reference)
-			{
-				prev_node->next = node->next;
-				json_free_node(node);
-				return true;
-			}
-			prev_node = node;
-			node = node->next;
+			json_UnlinkNode(this->json_root, node, prev_node, i);
+			json_free_node(node, json_NodeAllocator(this->json_root, NULL));
+			return true;
 		}
+		prev_node = node;
+		node = node->next;
+		i++;
 	}
+
 	return false;
 }
 
-char* JSON_ARRAY::Generate(const char* format)
+JSON_ARRAY JSON_ARRAY::Clone()
+{
+	return JSON_Clone(this->json_root);
+}
+
+bool JSON_ARRAY::Equal(JSON_NODE* other, bool ignoreKeyOrder)
+{
+	return JSON_Equal(this->json_root, other, ignoreKeyOrder);
+}
+
+unsigned long long JSON_ARRAY::Hash()
+{
+	return JSON_Hash(this->json_root);
+}
+
+bool JSON_ARRAY::Patch(JSON_NODE* patch, size_t* pFailedOperation)
+{
+	return JSON_Patch(this->json_root, patch, pFailedOperation);
+}
+
+char* JSON_ARRAY::Generate(const char* format, const JSON_ALLOCATOR* allocator)
 {
-	return JSON_Generate(this->json_root, format);
+	return JSON_Generate(this->json_root, format, allocator);
+}
+
+char* JSON_ARRAY::GenerateCanonical(const JSON_ALLOCATOR* allocator)
+{
+	return JSON_GenerateCanonical(this->json_root, allocator);
 }
 
 bool JSON_ARRAY::Format(const char* format)
 {
 	if (this->json_root) {
+		const JSON_ALLOCATOR* allocator = json_NodeAllocator(this->json_root, NULL);
 		if (json_root->format) {
-			free((void*)json_root->format);
+			json_Deallocate(allocator, (void*)json_root->format);
 		}
 		if (format == NULL) {
 			this->json_root->format = NULL;
@@ -3158,7 +11613,7 @@ bool JSON_ARRAY::Format(const char* format)
 		else
 		{
 			size_t blockLen = strlen(format) + 1;
-			this->json_root->format = (const char*)malloc(blockLen);
+			this->json_root->format = (const char*)json_Allocate(allocator, blockLen);
 			if (this->json_root->format == NULL) {
 				return false;
 			}
@@ -3179,3 +11634,174 @@ JSON_NODE* JSON_ARRAY::Parse(const char* json, JSON_PARSER_CONTEXT* context)
 
 	return this->json_root = JSON_Parse(json, context);
 }
+
+JSON_NODE* JSON_ARRAY::ParseInto(const char* json, JSON_PARSER_CONTEXT* context)
+{
+	return this->json_root = JSON_ParseInto(this->json_root, json, context);
+}
+
+JSON_NODE* JSON_ARRAY::Reparse(const char* old_json, size_t offset, size_t removedLength, const char* insertedText, JSON_PARSER_CONTEXT* context)
+{
+	return this->json_root = JSON_Reparse(this->json_root, old_json, offset, removedLength, insertedText, context);
+}
+
+#ifdef JSON_PLUS_STRING_VIEW
+
+std::optional<std::string_view> JSON_ARRAY::GetString(unsigned long i)
+{
+	JSON_NODE* node;
+
+	node = json_GetItem(this->json_root, i);
+	if ((node != NULL) && (node->type == JSON_TYPE::STRING)) {
+		return json_ValueView(node);
+	}
+
+	return std::nullopt;
+}
+
+std::optional<std::string_view> JSON_ARRAY::GetNumber(unsigned long i)
+{
+	JSON_NODE* node;
+
+	node = json_GetItem(this->json_root, i);
+	if ((node != NULL) && (node->type == JSON_TYPE::NUMBER)) {
+		return json_ValueView(node);
+	}
+
+	return std::nullopt;
+}
+
+std::optional<double> JSON_ARRAY::GetDouble(unsigned long i)
+{
+	JSON_NODE* node;
+
+	node = json_GetItem(this->json_root, i);
+	if ((node != NULL) && (node->type == JSON_TYPE::NUMBER) && (node->value != NULL)) {
+		return atof((const char*)node->value);
+	}
+
+	return std::nullopt;
+}
+
+std::optional<long long> JSON_ARRAY::GetInt64(unsigned long i)
+{
+	JSON_NODE* node;
+
+	node = json_GetItem(this->json_root, i);
+	if ((node != NULL) && (node->type == JSON_TYPE::NUMBER) && (node->value != NULL)) {
+		return atoll((const char*)node->value);
+	}
+
+	return std::nullopt;
+}
+
+std::optional<bool> JSON_ARRAY::GetBoolean(unsigned long i)
+{
+	JSON_NODE* node;
+
+	node = json_GetItem(this->json_root, i);
+	if ((node != NULL) && (node->type == JSON_TYPE::BOOLEAN)) {
+		return (bool)node->value;
+	}
+
+	return std::nullopt;
+}
+
+#endif // JSON_PLUS_STRING_VIEW
+
+// ------------------------------- //
+// **   JSON_DOCUMENT methods   ** //
+// ------------------------------- //
+
+JSON_DOCUMENT::JSON_DOCUMENT() {
+	this->json_root = NULL;
+}
+
+JSON_DOCUMENT::JSON_DOCUMENT(JSON_NODE* root) {
+	this->json_root = root;
+}
+
+JSON_DOCUMENT::JSON_DOCUMENT(const char* json, JSON_PARSER_CONTEXT* context)
+{
+	this->json_root = JSON_Parse(json, context);
+}
+
+JSON_DOCUMENT::JSON_DOCUMENT(JSON_DOCUMENT&& other) noexcept
+{
+	this->json_root = other.json_root;
+	other.json_root = NULL;
+}
+
+JSON_DOCUMENT& JSON_DOCUMENT::operator=(JSON_DOCUMENT&& other) noexcept
+{
+	if (this != &other)
+	{
+		JSON_Free(this->json_root);
+		this->json_root = other.json_root;
+		other.json_root = NULL;
+	}
+
+	return *this;
+}
+
+JSON_DOCUMENT::~JSON_DOCUMENT()
+{
+	JSON_Free(this->json_root);
+}
+
+JSON_NODE* JSON_DOCUMENT::Root() const
+{
+	return this->json_root;
+}
+
+bool JSON_DOCUMENT::Empty() const
+{
+	return (this->json_root == NULL);
+}
+
+JSON_OBJECT JSON_DOCUMENT::Object() const
+{
+	if ((this->json_root != NULL) && (this->json_root->type == JSON_TYPE::OBJECT)) {
+		return JSON_OBJECT(this->json_root);
+	}
+
+	return JSON_OBJECT();
+}
+
+JSON_ARRAY JSON_DOCUMENT::Array() const
+{
+	if ((this->json_root != NULL) && (this->json_root->type == JSON_TYPE::ARRAY)) {
+		return JSON_ARRAY(this->json_root);
+	}
+
+	return JSON_ARRAY();
+}
+
+JSON_NODE* JSON_DOCUMENT::Parse(const char* json, JSON_PARSER_CONTEXT* context)
+{
+	return this->json_root = JSON_ParseInto(this->json_root, json, context);
+}
+
+JSON_NODE* JSON_DOCUMENT::Compact()
+{
+	return this->json_root = JSON_Compact(this->json_root);
+}
+
+void JSON_DOCUMENT::Reset(JSON_NODE* root)
+{
+	if (root != this->json_root) {
+		JSON_Free(this->json_root);
+	}
+
+	this->json_root = root;
+}
+
+JSON_NODE* JSON_DOCUMENT::Release()
+{
+	JSON_NODE* root;
+
+	root = this->json_root;
+	this->json_root = NULL;
+
+	return root;
+}
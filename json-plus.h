@@ -15,6 +15,34 @@
 #define JSON_PLUS_H
 
 #include <cstdlib>
+#include <cstddef>
+#include <iterator>
+
+// Key lookups also take a std::string_view when compiling with C++17 or later, values can be read as std::optional
+#if (__cplusplus >= 201703L) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L))
+#include <string_view>
+#include <optional>
+#define JSON_PLUS_STRING_VIEW
+#endif
+
+// Prefetch the memory at an address into the cache, used to load the next node while iterating
+#if defined(__GNUC__) || defined(__clang__)
+#define JSON_PLUS_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define JSON_PLUS_PREFETCH(address) ((void)0)
+#endif
+
+// Key lookups also take a JSON_KEY with a hash computed at compile time when compiling with C++14 or later
+#if (__cplusplus >= 201402L) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 201402L))
+#define JSON_PLUS_CONSTEXPR_KEY
+#endif
+
+// The number of bytes in a node for a short key and a short string or number value, with their null characters
+// Keys and values that fit are stored in the node instead of their own allocation, every file must use the same size
+// 0 by default, every node grows by this size, so define it (e.g. as 16) for trees with many short keys and values
+#ifndef JSON_NODE_INLINE_SIZE
+#define JSON_NODE_INLINE_SIZE 0
+#endif
 
 namespace json_plus
 {
@@ -47,7 +75,7 @@ namespace json_plus
 	}
 
 	// JSON element types
-	enum class JSON_TYPE
+	enum class JSON_TYPE : unsigned char
 	{
 		OBJECT,
 		ARRAY,
@@ -57,6 +85,38 @@ namespace json_plus
 		NULL_TYPE
 	};
 
+	// JSON token types
+	enum class JSON_TOKEN
+	{
+		CURLY_OPEN,
+		CURLY_CLOSE,
+		COLON,
+		STRING,
+		NUMBER,
+		ARRAY_OPEN,
+		ARRAY_CLOSE,
+		COMMA,
+		LITERAL,
+		JSON_END,
+		UNRECOGNIZED_TOKEN,
+		// A string without its closing double quotes, only returned by JSON_LEXER
+		UNTERMINATED_STRING
+	};
+
+	// Memory allocator, used for every allocation of a node tree
+	typedef struct _JSON_ALLOCATOR JSON_ALLOCATOR;
+	struct _JSON_ALLOCATOR
+	{
+		// Allocate a memory block
+		void* (*allocate)(void* userData, size_t size);
+		// Resize a memory block
+		void* (*reallocate)(void* userData, void* block, size_t size);
+		// Free a memory block
+		void (*deallocate)(void* userData, void* block);
+		// User data passed to the allocator functions
+		void* userData;
+	};
+
 	// JSON node, for the parsed tree
 	typedef struct _JSON_NODE JSON_NODE;
 	struct _JSON_NODE
@@ -69,8 +129,17 @@ namespace json_plus
 		void* value;
 		// JSON node type
 		JSON_TYPE type;
+		// Internal storage flags for the node
+		unsigned char flags;
+		// Length of the key in bytes and hash of the key, set by json-plus together with keys shorter than 64 KB
+		unsigned short keyLength;
+		unsigned int keyHash;
 		// Format override for the node
 		const char* format;
+#if JSON_NODE_INLINE_SIZE > 0
+		// Storage for a short key and value, `key` and `value` point into it when they are stored in the node
+		char inlineData[JSON_NODE_INLINE_SIZE];
+#endif
 		// Get value as a char* string
 		const char* String();
 		// Get value as a double
@@ -83,6 +152,12 @@ namespace json_plus
 		long long Int64();
 		// Get value as a boolean
 		bool Boolean();
+#ifdef JSON_PLUS_STRING_VIEW
+		// Get the key as a string view, empty if the node has no key
+		std::string_view KeyView();
+		// Get value as a string view, empty if the value is not a string, the length is measured with strlen (O(n))
+		std::string_view StringView();
+#endif
 	};
 
 	// JSON error codes
@@ -104,6 +179,7 @@ namespace json_plus
 		OBJECT_SYNTAX_ERROR_EXPECTED_COLON,
 		OBJECT_SYNTAX_ERROR_KEY_ALREADY_DEFINED,
 		OBJECT_SYNTAX_ERROR_KEY_NOT_DEFINED,
+		OBJECT_SYNTAX_ERROR_UNEXPECTED_VALUE,
 		UNEXPECTED_CLOSING_SQUARE_BRACKET,
 		EXPECTED_CURLY_BRACKET_ENCOUNTERED_JSON_END,
 		EXPECTED_PAIR_ENCOUNTERED_OBJECT_END,
@@ -126,8 +202,59 @@ namespace json_plus
 		// parse literal name errors:
 
 		INVALID_LITERAL_NAME,
+
+		// parse memory errors:
+
+		MEMORY_LIMIT_EXCEEDED,
 	} JSON_ERROR_CODE;
 
+	// Source position of a parsed value, the offset and length are in bytes
+	typedef struct _JSON_POSITION JSON_POSITION;
+	struct _JSON_POSITION
+	{
+		// Byte offset of the value in the JSON string
+		size_t offset;
+		// Number of bytes in the value
+		size_t length;
+		// Line number of the value, the first line is 1
+		unsigned long lineNumber;
+	};
+
+	// Table of source positions for parsed nodes, the parser fills it when it is set in the parser context
+	// The nodes themselves don't store positions, so the table only costs memory when it is used
+	class JSON_POSITION_MAP
+	{
+	private:
+		// Hash table entry
+		struct ENTRY;
+		// Hash table, keyed by node pointer
+		ENTRY* entries;
+		// Number of entries in the hash table, a power of 2
+		size_t capacity;
+		// Number of positions
+		size_t count;
+		// Allocator for the hash table
+		const JSON_ALLOCATOR* allocator;
+	public:
+		// JSON string of the last parse, the offsets are relative to it, NULL after JSON_Reparse
+		const char* json;
+		// Initializer, NULL to use malloc, realloc and free
+		JSON_POSITION_MAP(const JSON_ALLOCATOR* allocator = NULL);
+		// Free the hash table
+		~JSON_POSITION_MAP();
+		// The hash table can't be copied
+		JSON_POSITION_MAP(const JSON_POSITION_MAP&) = delete;
+		JSON_POSITION_MAP& operator=(const JSON_POSITION_MAP&) = delete;
+		// Get the position of a node, NULL if the node has no position
+		const JSON_POSITION* Find(JSON_NODE* node);
+		// Add or replace the position of a node
+		bool Insert(JSON_NODE* node, size_t offset, size_t length, unsigned long lineNumber);
+		// Remove all positions
+		void Clear();
+		// Get the number of positions
+		size_t Count();
+	};
+
 	// JSON parsing context
 	class JSON_PARSER_CONTEXT
 	{
@@ -148,17 +275,105 @@ namespace json_plus
 		unsigned long beginIndex;
 		// Number of characters from beginIndex
 		unsigned long errorLength;
+		// Allocator for the node tree, NULL to use malloc, realloc and free
+		const JSON_ALLOCATOR* allocator;
+		// Record the source position of every parsed value, NULL to not record positions
+		JSON_POSITION_MAP* positions;
+		// Most bytes the parser may use, 0 for no limit, the parse fails with MEMORY_LIMIT_EXCEEDED when it needs more
+		// The bytes are counted from the tree that is parsed into, so the limit is on how much the tree may grow
+		size_t memoryLimit;
+		// Number of allocations and reallocations made by the last parse
+		size_t allocations;
+		// Number of bytes allocated by the last parse, a reallocation counts the bytes it added
+		size_t bytesAllocated;
+		// Most bytes in use at one time during the last parse, counted like `memoryLimit`
+		size_t peakMemory;
+		// Bytes in use now, allocated bytes minus freed bytes, can go below 0 when the tree that is parsed into shrinks
+		long long memoryUsed;
 	};
 
 	// Create JSON string from node tree
-	char* JSON_Generate(JSON_NODE* json_root, const char* format);
+	char* JSON_Generate(JSON_NODE* json_root, const char* format, const JSON_ALLOCATOR* allocator = NULL);
+
+	// Create canonical JSON (RFC 8785) from a node tree, with sorted keys and the shortest form of every number
+	char* JSON_GenerateCanonical(JSON_NODE* json_root, const JSON_ALLOCATOR* allocator = NULL);
 
 	// Parse a JSON string and create a node tree
 	JSON_NODE* JSON_Parse(const char* json, JSON_PARSER_CONTEXT* context);
 
+	// Parse a JSON string into an existing node tree, reusing its nodes and buffers
+	JSON_NODE* JSON_ParseInto(JSON_NODE* json_root, const char* json, JSON_PARSER_CONTEXT* context);
+
+	// Parse an edited JSON string, only the smallest object or array that encloses the edit is parsed again
+	JSON_NODE* JSON_Reparse(JSON_NODE* json_root, const char* old_json, size_t offset, size_t removedLength, const char* insertedText, JSON_PARSER_CONTEXT* context);
+
 	// Free a JSON node tree
 	void JSON_Free(JSON_NODE* json_root);
 
+	// Clone a JSON node tree, the clone shares the child nodes until they are changed, free it with JSON_Free
+	// Insert, Append, Delete and the Object and Array accessors of JSON_OBJECT and JSON_ARRAY copy shared items first
+	// Nodes found with the JSON_Get*** functions, First, iterators, JSON_POINTER or JSON_PATH can still be shared, only read them
+	JSON_NODE* JSON_Clone(JSON_NODE* json_root);
+
+	// Move a JSON node tree into a single memory block, with the nodes in depth-first order followed by the strings
+	// The old tree is freed, the returned tree is used and freed like any other tree
+	JSON_NODE* JSON_Compact(JSON_NODE* json_root);
+
+	// Compare 2 JSON node trees, objects with the same members in another order are equal when `ignoreKeyOrder` is true
+	bool JSON_Equal(JSON_NODE* a, JSON_NODE* b, bool ignoreKeyOrder = false);
+
+	// Get the 64-bit hash of a JSON node tree, equal trees have the same hash in any key order and on every platform
+	unsigned long long JSON_Hash(JSON_NODE* node);
+
+	// Apply a JSON Patch (RFC 6902) array to a tree in place, the tree is unchanged if an operation fails
+	// `pFailedOperation` receives the index of the operation that failed
+	bool JSON_Patch(JSON_NODE* json_root, JSON_NODE* patch, size_t* pFailedOperation = NULL);
+
+	// Apply a JSON Merge Patch (RFC 7396) to a tree in place, the tree is unchanged if the patch fails
+	bool JSON_MergePatch(JSON_NODE* json_root, JSON_NODE* patch);
+
+	// Compute a JSON Patch (RFC 6902) array that changes one tree into another, free it with JSON_Free
+	JSON_NODE* JSON_Diff(JSON_NODE* old_root, JSON_NODE* new_root, const JSON_ALLOCATOR* allocator = NULL);
+
+#ifdef JSON_PLUS_CONSTEXPR_KEY
+	// Key with its length and hash, computed at compile time for string literals
+	// The hash is the same hash json-plus stores with the keys of nodes, so most lookups compare the hash only
+	class JSON_KEY
+	{
+	public:
+		// Key string, it does not need to be null terminated
+		const char* key;
+		// Length of the key in bytes
+		size_t length;
+		// Hash of the key
+		unsigned int hash;
+		// Key from a string literal or null terminated char array
+		template <size_t N>
+		constexpr JSON_KEY(const char(&key)[N]) : key(key), length(Length(key, N)), hash(Hash(key, Length(key, N))) {}
+		// Key of `length` bytes
+		constexpr JSON_KEY(const char* key, size_t length) : key(key), length(length), hash(Hash(key, length)) {}
+		// Hash `length` bytes of a key (FNV-1a)
+		static constexpr unsigned int Hash(const char* key, size_t length)
+		{
+			unsigned int hash = 2166136261U;
+			for (size_t i = 0; i < length; i++) {
+				hash = (hash ^ (unsigned char)key[i]) * 16777619U;
+			}
+			return hash;
+		}
+	private:
+		// Length of the string in a char array of `size` chars
+		static constexpr size_t Length(const char* key, size_t size)
+		{
+			size_t length = 0;
+			while ((length + 1 < size) && (key[length] != 0)) {
+				length++;
+			}
+			return length;
+		}
+	};
+#endif
+
 	// Get a JSON object from an object
 	JSON_NODE* JSON_GetObject(JSON_NODE* object, const char* key);
 
@@ -174,8 +389,385 @@ namespace json_plus
 	// Get a JSON bool value from an object
 	bool JSON_GetBoolean(JSON_NODE* object, const char* key);
 
+	// Get a JSON object from an object using a key of `keyLength` bytes, the key does not need to be null terminated
+	JSON_NODE* JSON_GetObject(JSON_NODE* object, const char* key, size_t keyLength);
+
+	// Get a JSON array from an object using a key of `keyLength` bytes, the key does not need to be null terminated
+	JSON_NODE* JSON_GetArray(JSON_NODE* object, const char* key, size_t keyLength);
+
+	// Get a JSON string from an object using a key of `keyLength` bytes, the key does not need to be null terminated
+	char* JSON_GetString(JSON_NODE* object, const char* key, size_t keyLength);
+
+	// Get a JSON number from an object using a key of `keyLength` bytes, the key does not need to be null terminated
+	char* JSON_GetNumber(JSON_NODE* object, const char* key, size_t keyLength);
+
+	// Get a JSON bool value from an object using a key of `keyLength` bytes, the key does not need to be null terminated
+	bool JSON_GetBoolean(JSON_NODE* object, const char* key, size_t keyLength);
+
+#ifdef JSON_PLUS_STRING_VIEW
+	// Get a JSON object from an object using a string view key
+	JSON_NODE* JSON_GetObject(JSON_NODE* object, std::string_view key);
+
+	// Get a JSON array from an object using a string view key
+	JSON_NODE* JSON_GetArray(JSON_NODE* object, std::string_view key);
+
+	// Get a JSON string from an object using a string view key
+	char* JSON_GetString(JSON_NODE* object, std::string_view key);
+
+	// Get a JSON number from an object using a string view key
+	char* JSON_GetNumber(JSON_NODE* object, std::string_view key);
+
+	// Get a JSON bool value from an object using a string view key
+	bool JSON_GetBoolean(JSON_NODE* object, std::string_view key);
+#endif
+
+#ifdef JSON_PLUS_CONSTEXPR_KEY
+	// Get a JSON object from an object using a JSON_KEY
+	JSON_NODE* JSON_GetObject(JSON_NODE* object, const JSON_KEY& key);
+
+	// Get a JSON array from an object using a JSON_KEY
+	JSON_NODE* JSON_GetArray(JSON_NODE* object, const JSON_KEY& key);
+
+	// Get a JSON string from an object using a JSON_KEY
+	char* JSON_GetString(JSON_NODE* object, const JSON_KEY& key);
+
+	// Get a JSON number from an object using a JSON_KEY
+	char* JSON_GetNumber(JSON_NODE* object, const JSON_KEY& key);
+
+	// Get a JSON bool value from an object using a JSON_KEY
+	bool JSON_GetBoolean(JSON_NODE* object, const JSON_KEY& key);
+#endif
+
 	// Create a JSON node
-	JSON_NODE* JSON_CreateNode(JSON_TYPE type, const char* key, void* value);
+	JSON_NODE* JSON_CreateNode(JSON_TYPE type, const char* key, void* value, const JSON_ALLOCATOR* allocator = NULL);
+
+	// Get the allocator that owns a node and its child nodes
+	const JSON_ALLOCATOR* JSON_GetAllocator(JSON_NODE* node);
+
+	// Memory used by a node tree in bytes, blocks that are stored in a node are part of the node
+	typedef struct _JSON_MEMORY_USAGE JSON_MEMORY_USAGE;
+	struct _JSON_MEMORY_USAGE
+	{
+		// Nodes, with the headers of objects and arrays
+		size_t nodes;
+		// Key indexes of objects and item vectors of arrays, with the side blocks of objects and arrays that have them
+		size_t indexes;
+		// Keys that are not stored in their node
+		size_t keys;
+		// String values that are not stored in their node
+		size_t strings;
+		// Numbers that are not stored in their node
+		size_t numbers;
+		// Formats set on objects and arrays
+		size_t formats;
+		// All of the above
+		size_t total;
+	};
+
+	// Get the memory used by a node tree, nodes after the root are counted like JSON_Free frees them
+	JSON_MEMORY_USAGE JSON_MemoryUsage(JSON_NODE* json_root);
+
+	// JSON lexer token, the offset and length are in bytes
+	typedef struct _JSON_LEXER_TOKEN JSON_LEXER_TOKEN;
+	struct _JSON_LEXER_TOKEN
+	{
+		// Token type
+		JSON_TOKEN type;
+		// Byte offset of the token in the JSON string
+		size_t offset;
+		// Number of bytes in the token
+		size_t length;
+		// Line number of the token, the first line is 1
+		unsigned long lineNumber;
+	};
+
+	// JSON lexer, splits a JSON string into tokens without allocating memory or creating nodes
+	class JSON_LEXER
+	{
+	private:
+		// Start of the JSON string
+		const char* json;
+		// End of the JSON string
+		const char* end;
+		// Position of the next token
+		const char* position;
+		// Line number at the position
+		unsigned long lineNumber;
+	public:
+		// Lex a null terminated JSON string
+		JSON_LEXER(const char* json);
+		// Lex a buffer of `length` bytes, the buffer doesn't need to be null terminated
+		JSON_LEXER(const char* json, size_t length);
+		// Get the next token, returns false when the JSON_END token is reached
+		bool Next(JSON_LEXER_TOKEN* token);
+		// Start again at the beginning of the JSON string
+		void Reset();
+	};
+
+	// Compiled JSON Pointer (RFC 6901), the pointer is parsed once and can be resolved against many trees
+	class JSON_POINTER
+	{
+	private:
+		// Reference token of the pointer
+		struct TOKEN;
+		// Reference tokens, followed by the unescaped keys
+		TOKEN* tokens;
+		// Number of reference tokens
+		size_t count;
+		// The pointer was compiled without errors
+		bool compiled;
+		// Objects and arrays walked by the last resolve with their change stamps, and the node that was found
+		JSON_NODE** path;
+		unsigned long long* stamps;
+		size_t pathLength;
+		JSON_NODE* result;
+		// Allocator for the tokens
+		const JSON_ALLOCATOR* allocator;
+	public:
+		// Initializer, NULL to use malloc, realloc and free
+		JSON_POINTER(const JSON_ALLOCATOR* allocator = NULL);
+		// Compile a pointer, NULL to use malloc, realloc and free
+		JSON_POINTER(const char* pointer, const JSON_ALLOCATOR* allocator = NULL);
+		// Free the tokens
+		~JSON_POINTER();
+		// The tokens can't be copied
+		JSON_POINTER(const JSON_POINTER&) = delete;
+		JSON_POINTER& operator=(const JSON_POINTER&) = delete;
+		// Compile a pointer such as "/users/0/name", returns false if it is not a valid JSON Pointer
+		bool Compile(const char* pointer);
+		// Compile a pointer of `length` bytes, the pointer does not need to be null terminated
+		bool Compile(const char* pointer, size_t length);
+		// Find the node the pointer refers to in a tree, NULL if there is no such node
+		// With `useCache` the result is reused while the objects and arrays on the path are unchanged
+		JSON_NODE* Resolve(JSON_NODE* root, bool useCache = true);
+		// Get the number of reference tokens
+		size_t Count();
+	};
+
+	// Callback for the nodes found by a JSON_PATH, return false to stop the evaluation
+	typedef bool (*JSON_PATH_CALLBACK)(JSON_NODE* node, void* userData);
+
+	// Callback for the values found by a JSON_PATH in a JSON string, return false to stop the evaluation
+	typedef bool (*JSON_PATH_TEXT_CALLBACK)(const JSON_POSITION* position, void* userData);
+
+	// Compiled JSONPath query, a subset with names, wildcards, indexes, slices, recursive descent and simple filters
+	// The query is compiled once and evaluated against trees or JSON strings without allocating memory
+	class JSON_PATH
+	{
+	private:
+		// Selector applied to the children, or descendants, of the values found by the step before it
+		struct STEP;
+		// Comparison in a filter selector
+		struct CONDITION;
+		// Key or index in the relative path of a comparison
+		struct SEGMENT;
+		// Callback and number of matches of an evaluation
+		struct STATE;
+		// Value in a JSON string, the lexer is after the first token of the value
+		struct CURSOR;
+		// Steps, comparisons and segments, followed by the unescaped keys and strings
+		STEP* steps;
+		size_t count;
+		CONDITION* conditions;
+		size_t conditionCount;
+		SEGMENT* segments;
+		size_t segmentCount;
+		// The query was compiled without errors
+		bool compiled;
+		// Allocator for the steps
+		const JSON_ALLOCATOR* allocator;
+		// Compile a bracket selector or a filter
+		bool CompileBracket(const char* path, size_t length, size_t* i, STEP* step, char** strings);
+		bool CompileFilter(const char* path, size_t length, size_t* i, STEP* step, char** strings);
+		// Evaluate the steps from `step` on a node of a tree
+		bool Match(STATE* state, JSON_NODE* node, size_t step);
+		bool Select(STATE* state, JSON_NODE* node, size_t step);
+		// Evaluate the steps from `step` on a value in a JSON string
+		bool MatchText(STATE* state, const CURSOR* cursor, size_t step);
+		bool SelectText(STATE* state, const CURSOR* cursor, size_t step);
+		// Check the comparisons of a filter on a node, or on a value in a JSON string
+		bool Test(const STATE* state, const STEP* step, JSON_NODE* node, const CURSOR* cursor);
+	public:
+		// Initializer, NULL to use malloc, realloc and free
+		JSON_PATH(const JSON_ALLOCATOR* allocator = NULL);
+		// Compile a query, NULL to use malloc, realloc and free
+		JSON_PATH(const char* path, const JSON_ALLOCATOR* allocator = NULL);
+		// Free the steps
+		~JSON_PATH();
+		// The steps can't be copied
+		JSON_PATH(const JSON_PATH&) = delete;
+		JSON_PATH& operator=(const JSON_PATH&) = delete;
+		// Compile a query such as "$.orders[*].items[?(@.qty > 10)].sku", returns false if the query is not supported
+		bool Compile(const char* path);
+		// Compile a query of `length` bytes, the query does not need to be null terminated
+		bool Compile(const char* path, size_t length);
+		// Call `callback` for every node found in a tree, step by step in pre-order, returns the number of nodes found
+		size_t Evaluate(JSON_NODE* root, JSON_PATH_CALLBACK callback, void* userData);
+		// Get the 1st node found in a tree, NULL if no node is found
+		JSON_NODE* First(JSON_NODE* root);
+		// Call `callback` with the position of every value found in a JSON string, returns the number of values found
+		size_t EvaluateText(const char* json, JSON_PATH_TEXT_CALLBACK callback, void* userData);
+		// Evaluate a JSON string of `length` bytes, the string doesn't need to be null terminated
+		size_t EvaluateText(const char* json, size_t length, JSON_PATH_TEXT_CALLBACK callback, void* userData);
+		// Get the number of steps
+		size_t Count();
+	};
+
+	// Node of a JSON_PACKED document, 16 bytes with 32-bit offsets into the document instead of pointers
+	typedef struct _JSON_PACKED_NODE JSON_PACKED_NODE;
+	struct _JSON_PACKED_NODE
+	{
+		// Offset of the key in the strings of the document, 0 if the node has no key
+		unsigned int key;
+		// Hash of the key, the same hash as JSON_KEY
+		unsigned int keyHash;
+		// Index of the 1st item of an object or array, offset of a string or number in the strings, 1 for true
+		unsigned int value;
+		// JSON_TYPE in the low 3 bits, the number of items of an object or array or the length of a string or number above them
+		unsigned int typeAndLength;
+	};
+
+	// Read-only copy of a node tree in a single allocation, for large documents that are kept in memory
+	// The items of an object or array are stored next to each other, so items are found by index without a list walk
+	// Keys, strings and numbers are packed after the nodes, formats are kept in a side table
+	class JSON_PACKED
+	{
+	private:
+		// Format of a node, sorted by node index
+		struct FORMAT;
+		// Nodes, followed by the formats and the strings in the same memory block
+		JSON_PACKED_NODE* nodes;
+		size_t count;
+		FORMAT* formats;
+		size_t formatCount;
+		char* strings;
+		size_t size;
+		// Allocator for the memory block
+		const JSON_ALLOCATOR* allocator;
+		// Write a node, `pStrings` is the end of the strings
+		void PackNode(JSON_NODE* node, size_t index, size_t* pStrings);
+		// Write the items of an object or array next to each other from `pNext`, then the items of their objects and arrays
+		void PackItems(JSON_NODE* container, size_t index, size_t* pNext, size_t* pStrings);
+	public:
+		// Initializer, NULL to use malloc, realloc and free
+		JSON_PACKED(const JSON_ALLOCATOR* allocator = NULL);
+		// Free the document
+		~JSON_PACKED();
+		// The document can't be copied
+		JSON_PACKED(const JSON_PACKED&) = delete;
+		JSON_PACKED& operator=(const JSON_PACKED&) = delete;
+		// Pack a node tree, the tree is not changed and can be freed after it is packed
+		// Returns false if there is not enough memory or the tree is too large for 32-bit offsets, the document is empty then
+		bool Pack(JSON_NODE* json_root);
+		// Create a node tree from the document, NULL to use malloc, realloc and free, free the tree with JSON_Free
+		JSON_NODE* Unpack(const JSON_ALLOCATOR* allocator = NULL);
+		// Free the document
+		void Clear();
+		// Get the number of nodes
+		size_t Count();
+		// Get the size of the document in bytes
+		size_t Size();
+		// Get the root node, NULL if the document is empty
+		const JSON_PACKED_NODE* Root();
+		// Get the type of a node
+		JSON_TYPE Type(const JSON_PACKED_NODE* node);
+		// Get the key of a node, NULL if the node has no key
+		const char* Key(const JSON_PACKED_NODE* node);
+		// Get a string or number as a null terminated string, `pLength` receives the length in bytes, NULL for other types
+		const char* String(const JSON_PACKED_NODE* node, size_t* pLength = NULL);
+		// Get a boolean
+		bool Boolean(const JSON_PACKED_NODE* node);
+		// Get the number of items of an object or array
+		size_t Count(const JSON_PACKED_NODE* node);
+		// Get an item of an object or array by index, NULL if there is no such item
+		const JSON_PACKED_NODE* Item(const JSON_PACKED_NODE* node, size_t i);
+		// Find a member of an object by key, NULL if there is no such member
+		const JSON_PACKED_NODE* Find(const JSON_PACKED_NODE* object, const char* key);
+		const JSON_PACKED_NODE* Find(const JSON_PACKED_NODE* object, const char* key, size_t keyLength);
+		// Get the format of a node from the side table, NULL if the node has no format
+		const char* Format(const JSON_PACKED_NODE* node);
+	};
+
+	// Type of the values in a column of a JSON_COLUMNS table
+	enum class JSON_COLUMN_TYPE
+	{
+		INT64,
+		DOUBLE,
+		BOOLEAN,
+		STRING
+	};
+
+	// Columns of the members of an array of objects, the values of each key are stored next to each other with a null bitmap
+	// The rows are read in one pass over an array node, or over a JSON string without creating nodes
+	class JSON_COLUMNS
+	{
+	private:
+		// Column, with the key of its member and its buffers
+		struct COLUMN;
+		// Value of a member that is written into a column
+		struct VALUE;
+		// Columns
+		COLUMN* columns;
+		size_t count;
+		// Number of rows, and the number of rows the buffers of the columns have room for
+		size_t rows;
+		size_t capacity;
+		// Column after the last column that was found, members of objects with the same keys are found in order
+		size_t hint;
+		// Allocator for the columns and their buffers
+		const JSON_ALLOCATOR* allocator;
+		// Resize the value buffer and the null bitmap of a column
+		bool GrowColumn(COLUMN* column, size_t capacity);
+		// Add a row with a null value in every column
+		bool AddRow();
+		// Find the column of a member key
+		COLUMN* Find(const char* key, size_t keyLength, unsigned int hash);
+		// Write a value into the last row of a column
+		bool SetValue(COLUMN* column, const VALUE* value);
+		// Read the members of an object in a JSON string into the last row, the lexer is after the opening bracket
+		bool LoadTextObject(JSON_LEXER* lexer, const char* json);
+		// Remove the rows after `rows`, after an error
+		void Rollback(size_t rows);
+	public:
+		// Initializer, NULL to use malloc, realloc and free
+		JSON_COLUMNS(const JSON_ALLOCATOR* allocator = NULL);
+		// Free the columns
+		~JSON_COLUMNS();
+		// The columns can't be copied
+		JSON_COLUMNS(const JSON_COLUMNS&) = delete;
+		JSON_COLUMNS& operator=(const JSON_COLUMNS&) = delete;
+		// Add a column that is filled with the values of the member `key`, columns can only be added while there are no rows
+		bool Add(const char* key, JSON_COLUMN_TYPE type);
+		// Read a row from each item of an array of objects, the rows are added after the rows that were read before
+		// Returns false if `array` is not an array or there is not enough memory, the rows of this call are removed then
+		bool Load(JSON_NODE* array);
+		// Read a row from each item of a JSON string with an array of objects, without creating nodes
+		// Returns false if the JSON string is not an array of values or there is not enough memory, the rows of this call are removed then
+		bool LoadText(const char* json);
+		bool LoadText(const char* json, size_t length);
+		// Remove the rows, the columns and their buffers are kept
+		void Clear();
+		// Get the number of rows
+		size_t Rows();
+		// Get the number of columns
+		size_t Count();
+		// Get the type of a column
+		JSON_COLUMN_TYPE Type(size_t column);
+		// Get the values of an INT64 column, NULL for other columns
+		const long long* Int64s(size_t column);
+		// Get the values of a DOUBLE column, NULL for other columns
+		const double* Doubles(size_t column);
+		// Get the values of a BOOLEAN column, NULL for other columns
+		const bool* Booleans(size_t column);
+		// Get the offsets of the strings of a STRING column, Rows() + 1 offsets, string `i` is from offset `i` to offset `i + 1`
+		const size_t* Offsets(size_t column);
+		// Get the bytes of the strings of a STRING column, the strings are not null terminated
+		const char* Strings(size_t column);
+		// Get the null bitmap of a column, bit `row % 8` of byte `row / 8` is set if the value is null, missing or of a different type
+		const unsigned char* Nulls(size_t column);
+		// Check if a value is null, missing or of a different type
+		bool IsNull(size_t column, size_t row);
+	};
 
 	// Forward declaration of JSON_OBJECT
 	class JSON_OBJECT;
@@ -183,6 +775,89 @@ namespace json_plus
 	// Forward declaration of JSON_ARRAY
 	class JSON_ARRAY;
 
+	// Item of an object or array yielded by JSON_ITERATOR, a small view of the item node with typed accessors
+	// It converts to the JSON_NODE* of the item, so loops over JSON_NODE* still work
+	class JSON_ITEM
+	{
+	private:
+		// Item node
+		JSON_NODE* node;
+	public:
+		// Item view of `node`
+		JSON_ITEM(JSON_NODE* node) : node(node) {}
+		// Get the item node
+		JSON_NODE* Node() const { return this->node; }
+		// Get the item node
+		operator JSON_NODE* () const { return this->node; }
+		// Access the item node
+		JSON_NODE* operator->() const { return this->node; }
+		// Get the type of the item
+		JSON_TYPE Type() const { return this->node->type; }
+#ifdef JSON_PLUS_STRING_VIEW
+		// Get the key of the item, empty for array items, uses the key length stored in the node
+		std::string_view Key() const;
+#else
+		// Get the key of the item, NULL for array items
+		const char* Key() const { return this->node->key; }
+#endif
+		// Get the item as a string, NULL if it is not a string
+		const char* String() const;
+		// Get the item as a 64-bit int, 0 if it is not a number
+		long long Int64() const;
+		// Get the item as a double, 0 if it is not a number
+		double Double() const;
+		// Get the item as a boolean, false if it is not a boolean
+		bool Boolean() const;
+		// Get the item as an object, empty if it is not an object
+		// The item is not copied when it is shared with a clone, only read it then
+		JSON_OBJECT Object() const;
+		// Get the item as an array, empty if it is not an array
+		// The item is not copied when it is shared with a clone, only read it then
+		JSON_ARRAY Array() const;
+	};
+
+	// Forward iterator over the items of an object or array, it yields a JSON_ITEM for each item
+	// Defined in the header so loops are inlined, the node after the current node is prefetched
+	class JSON_ITERATOR
+	{
+	private:
+		// Current item, NULL at the end
+		JSON_NODE* node;
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef JSON_ITEM value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef JSON_NODE* pointer;
+		typedef JSON_ITEM reference;
+		// End iterator
+		JSON_ITERATOR() : node(NULL) {}
+		// Iterator at `node` and the items after it
+		JSON_ITERATOR(JSON_NODE* node) : node(node) {}
+		// Get the current item
+		reference operator*() const { return JSON_ITEM(this->node); }
+		// Access the current item
+		JSON_NODE* operator->() const { return this->node; }
+		// Move to the next item
+		JSON_ITERATOR& operator++()
+		{
+			this->node = this->node->next;
+			if (this->node != NULL) {
+				JSON_PLUS_PREFETCH(this->node->next);
+			}
+			return *this;
+		}
+		// Move to the next item, returns the iterator at the current item
+		JSON_ITERATOR operator++(int)
+		{
+			JSON_ITERATOR current = *this;
+			++(*this);
+			return current;
+		}
+		// Compare iterators
+		bool operator==(const JSON_ITERATOR& other) const { return this->node == other.node; }
+		bool operator!=(const JSON_ITERATOR& other) const { return this->node != other.node; }
+	};
+
 	// JSON object
 	class JSON_OBJECT
 	{
@@ -201,7 +876,7 @@ namespace json_plus
 		// Assigment operator overload
 		operator JSON_NODE* () const;
 		// Create a root object node and assign it to this object
-		JSON_NODE* MakeRoot();
+		JSON_NODE* MakeRoot(const JSON_ALLOCATOR* allocator = NULL);
 		// Free JSON node tree
 		void Free();
 		// Check if the root object exists
@@ -210,14 +885,73 @@ namespace json_plus
 		unsigned long Count();
 		// Get the first node item in the object
 		JSON_NODE* First();
-		// Get an object from the object using a key
+		// Iterator at the first item in the object, for range-based for loops
+		JSON_ITERATOR begin();
+		// Iterator after the last item in the object
+		JSON_ITERATOR end();
+		// Get an object from the object using a key, the object can be changed
+		// Items shared with a clone are copied first, empty if there is no such object or not enough memory to copy them
 		JSON_OBJECT Object(const char* key);
-		// Get an array from the object using a key
+		// Get an array from the object using a key, the array can be changed
+		// Items shared with a clone are copied first, empty if there is no such array or not enough memory to copy them
 		JSON_ARRAY Array(const char* key);
 		// Get a string from the object using a key
 		const char* String(const char* key);
 		// Get a boolean from the object using a key
 		bool Boolean(const char* key);
+		// Get the source position of a value in the object using a key
+		const JSON_POSITION* Position(JSON_POSITION_MAP* positions, const char* key);
+		// Get an object from the object using a key of `keyLength` bytes, the key does not need to be null terminated
+		// Shared items are copied first like Object(const char*), empty if there is not enough memory
+		JSON_OBJECT Object(const char* key, size_t keyLength);
+		// Get an array from the object using a key of `keyLength` bytes
+		// Shared items are copied first like Array(const char*), empty if there is not enough memory
+		JSON_ARRAY Array(const char* key, size_t keyLength);
+		// Get a string from the object using a key of `keyLength` bytes
+		const char* String(const char* key, size_t keyLength);
+		// Get a boolean from the object using a key of `keyLength` bytes
+		bool Boolean(const char* key, size_t keyLength);
+		// Get the source position of a value in the object using a key of `keyLength` bytes
+		const JSON_POSITION* Position(JSON_POSITION_MAP* positions, const char* key, size_t keyLength);
+#ifdef JSON_PLUS_STRING_VIEW
+		// Get an object from the object using a string view key
+		// Shared items are copied first like Object(const char*), empty if there is not enough memory
+		JSON_OBJECT Object(std::string_view key);
+		// Get an array from the object using a string view key
+		// Shared items are copied first like Array(const char*), empty if there is not enough memory
+		JSON_ARRAY Array(std::string_view key);
+		// Get a string from the object using a string view key
+		const char* String(std::string_view key);
+		// Get a boolean from the object using a string view key
+		bool Boolean(std::string_view key);
+		// Get the source position of a value in the object using a string view key
+		const JSON_POSITION* Position(JSON_POSITION_MAP* positions, std::string_view key);
+		// Get a string from the object using a key, std::nullopt if there is no string with the key
+		// The length of the view is measured with strlen (O(n)), values don't store their length
+		std::optional<std::string_view> GetString(std::string_view key);
+		// Get a number as a string from the object using a key, std::nullopt if there is no number with the key
+		std::optional<std::string_view> GetNumber(std::string_view key);
+		// Get a double from the object using a key, std::nullopt if there is no number with the key
+		std::optional<double> GetDouble(std::string_view key);
+		// Get a 64-bit int from the object using a key, std::nullopt if there is no number with the key
+		std::optional<long long> GetInt64(std::string_view key);
+		// Get a boolean from the object using a key, std::nullopt if there is no boolean with the key
+		std::optional<bool> GetBoolean(std::string_view key);
+#endif
+#ifdef JSON_PLUS_CONSTEXPR_KEY
+		// Get an object from the object using a JSON_KEY
+		// Shared items are copied first like Object(const char*), empty if there is not enough memory
+		JSON_OBJECT Object(const JSON_KEY& key);
+		// Get an array from the object using a JSON_KEY
+		// Shared items are copied first like Array(const char*), empty if there is not enough memory
+		JSON_ARRAY Array(const JSON_KEY& key);
+		// Get a string from the object using a JSON_KEY
+		const char* String(const JSON_KEY& key);
+		// Get a boolean from the object using a JSON_KEY
+		bool Boolean(const JSON_KEY& key);
+		// Get the source position of a value in the object using a JSON_KEY
+		const JSON_POSITION* Position(JSON_POSITION_MAP* positions, const JSON_KEY& key);
+#endif
 		// Nested Number class
 		class Number
 		{
@@ -237,6 +971,40 @@ namespace json_plus
 			long long Int64(const char* key);
 			// Get a number from the object as a string using a key
 			const char* String(const char* key);
+			// Get a double from the object using a key of `keyLength` bytes
+			double Double(const char* key, size_t keyLength);
+			// Get a int from the object using a key of `keyLength` bytes
+			int Int(const char* key, size_t keyLength);
+			// Get a long from the object using a key of `keyLength` bytes
+			long Long(const char* key, size_t keyLength);
+			// Get a 64-bit int from the object using a key of `keyLength` bytes
+			long long Int64(const char* key, size_t keyLength);
+			// Get a number from the object as a string using a key of `keyLength` bytes
+			const char* String(const char* key, size_t keyLength);
+#ifdef JSON_PLUS_STRING_VIEW
+			// Get a double from the object using a string view key
+			double Double(std::string_view key);
+			// Get a int from the object using a string view key
+			int Int(std::string_view key);
+			// Get a long from the object using a string view key
+			long Long(std::string_view key);
+			// Get a 64-bit int from the object using a string view key
+			long long Int64(std::string_view key);
+			// Get a number from the object as a string using a string view key
+			const char* String(std::string_view key);
+#endif
+#ifdef JSON_PLUS_CONSTEXPR_KEY
+			// Get a double from the object using a JSON_KEY
+			double Double(const JSON_KEY& key);
+			// Get a int from the object using a JSON_KEY
+			int Int(const JSON_KEY& key);
+			// Get a long from the object using a JSON_KEY
+			long Long(const JSON_KEY& key);
+			// Get a 64-bit int from the object using a JSON_KEY
+			long long Int64(const JSON_KEY& key);
+			// Get a number from the object as a string using a JSON_KEY
+			const char* String(const JSON_KEY& key);
+#endif
 		};
 		// Get a number from the object
 		Number Number{ *this };
@@ -246,9 +1014,11 @@ namespace json_plus
 		private:
 			// Parent reference
 			JSON_OBJECT& parent;
+			// Add items after the last item instead of in front of the 1st item
+			bool append;
 		public:
 			// Constructor for the Insert class, which is a nested class inside the JSON_OBJECT class.
-			Insert(JSON_OBJECT& parent);
+			Insert(JSON_OBJECT& parent, bool append = false);
 			// Insert an object with a key
 			JSON_OBJECT Object(const char* key);
 			// Insert an array with a key
@@ -282,16 +1052,44 @@ namespace json_plus
 		};
 		// Insert a JSON object, array or key-value pair
 		Insert Insert{ *this };
+		// Append a JSON object, array or key-value pair after the last item, items keep the order they are appended in
+		class Insert Append{ *this, true };
 		// Delete a key-value pair using a key
 		bool Delete(const char* key);
+		// Delete a key-value pair using a key of `keyLength` bytes
+		bool Delete(const char* key, size_t keyLength);
+#ifdef JSON_PLUS_STRING_VIEW
+		// Delete a key-value pair using a string view key
+		bool Delete(std::string_view key);
+#endif
+#ifdef JSON_PLUS_CONSTEXPR_KEY
+		// Delete a key-value pair using a JSON_KEY
+		bool Delete(const JSON_KEY& key);
+#endif
 		// Delete a key-value pair using a reference
 		bool Delete(JSON_NODE* reference);
+		// Clone the object, the clone shares the child nodes until they are changed
+		JSON_OBJECT Clone();
+		// Compare the object with another JSON node tree
+		bool Equal(JSON_NODE* other, bool ignoreKeyOrder = false);
+		// Get the 64-bit hash of the object
+		unsigned long long Hash();
+		// Apply a JSON Patch to the object in place
+		bool Patch(JSON_NODE* patch, size_t* pFailedOperation = NULL);
+		// Apply a JSON Merge Patch to the object in place
+		bool MergePatch(JSON_NODE* patch);
 		// Create JSON from object
-		char* Generate(const char* format);
+		char* Generate(const char* format, const JSON_ALLOCATOR* allocator = NULL);
+		// Create canonical JSON from object
+		char* GenerateCanonical(const JSON_ALLOCATOR* allocator = NULL);
 		// Format for the object, this will override the format parameter passed to JSON_Generate
 		bool Format(const char* format);
 		// Parse a JSON string and create a node tree
 		JSON_NODE* Parse(const char* json, JSON_PARSER_CONTEXT* context);
+		// Parse a JSON string into the existing node tree, reusing its nodes and buffers
+		JSON_NODE* ParseInto(const char* json, JSON_PARSER_CONTEXT* context);
+		// Parse an edited JSON string, only the smallest object or array that encloses the edit is parsed again
+		JSON_NODE* Reparse(const char* old_json, size_t offset, size_t removedLength, const char* insertedText, JSON_PARSER_CONTEXT* context);
 	};
 
 	// JSON array
@@ -312,7 +1110,7 @@ namespace json_plus
 		// Assignment operator overload
 		operator JSON_NODE* () const;
 		// Create a root array node and assign it to this array
-		JSON_NODE* MakeRoot();
+		JSON_NODE* MakeRoot(const JSON_ALLOCATOR* allocator = NULL);
 		// Free JSON node tree
 		void Free();
 		// Check if the root array exists
@@ -321,14 +1119,35 @@ namespace json_plus
 		unsigned long Count();
 		// Get the first node item in the array
 		JSON_NODE* First();
-		// Get an object from the array using an index
+		// Iterator at the first item in the array, for range-based for loops
+		JSON_ITERATOR begin();
+		// Iterator after the last item in the array
+		JSON_ITERATOR end();
+		// Get an object from the array using an index, the object can be changed
+		// Items shared with a clone are copied first, empty if there is no such object or not enough memory to copy them
 		JSON_OBJECT Object(unsigned long i);
-		// Get an array from the array using an index
+		// Get an array from the array using an index, the array can be changed
+		// Items shared with a clone are copied first, empty if there is no such array or not enough memory to copy them
 		JSON_ARRAY Array(unsigned long i);
 		// Get a string from the array using an index
 		const char* String(unsigned long i);
 		// Get a boolean from the array using an index
 		bool Boolean(unsigned long i);
+		// Get the source position of a value in the array using an index
+		const JSON_POSITION* Position(JSON_POSITION_MAP* positions, unsigned long i);
+#ifdef JSON_PLUS_STRING_VIEW
+		// Get a string from the array using an index, std::nullopt if the item is not a string
+		// The length of the view is measured with strlen (O(n)), values don't store their length
+		std::optional<std::string_view> GetString(unsigned long i);
+		// Get a number as a string from the array using an index, std::nullopt if the item is not a number
+		std::optional<std::string_view> GetNumber(unsigned long i);
+		// Get a double from the array using an index, std::nullopt if the item is not a number
+		std::optional<double> GetDouble(unsigned long i);
+		// Get a 64-bit int from the array using an index, std::nullopt if the item is not a number
+		std::optional<long long> GetInt64(unsigned long i);
+		// Get a boolean from the array using an index, std::nullopt if the item is not a boolean
+		std::optional<bool> GetBoolean(unsigned long i);
+#endif
 		// Nested Number class
 		class Number
 		{
@@ -351,15 +1170,24 @@ namespace json_plus
 		};
 		// Get a number from the array
 		Number Number{ *this };
+		// Convert the numbers in the array to doubles, the items are walked once
+		// Returns the number of values written, conversion stops at `count` values or at the 1st item that is not a number
+		size_t ToDoubles(double* values, size_t count);
+		// Convert the numbers in the array to floats, returns the number of values written
+		size_t ToFloats(float* values, size_t count);
+		// Convert the numbers in the array to 64-bit ints, the fraction is cut off, returns the number of values written
+		size_t ToInt64s(long long* values, size_t count);
 		// Nested Insert class
 		class Insert
 		{
 		private:
 			// Parent reference
 			JSON_ARRAY& parent;
+			// Add items after the last item instead of in front of the 1st item
+			bool append;
 		public:
 			// Constructor for the Insert class, which is a nested class inside the JSON_ARRAY class.
-			Insert(JSON_ARRAY& parent);
+			Insert(JSON_ARRAY& parent, bool append = false);
 			// Insert an object
 			JSON_OBJECT Object();
 			// Insert an array
@@ -393,16 +1221,72 @@ namespace json_plus
 		};
 		// Insert a JSON object, array or key-value pair
 		Insert Insert{ *this };
+		// Append a JSON object, array or value after the last item, items keep the order they are appended in
+		class Insert Append{ *this, true };
 		// Delete a key-value pair using a index
 		bool Delete(unsigned long i);
 		// Delete a key-value pair using a reference
 		bool Delete(JSON_NODE* reference);
+		// Clone the array, the clone shares the child nodes until they are changed
+		JSON_ARRAY Clone();
+		// Compare the array with another JSON node tree
+		bool Equal(JSON_NODE* other, bool ignoreKeyOrder = false);
+		// Get the 64-bit hash of the array
+		unsigned long long Hash();
+		// Apply a JSON Patch to the array in place
+		bool Patch(JSON_NODE* patch, size_t* pFailedOperation = NULL);
 		// Create JSON from array
-		char* Generate(const char* format);
+		char* Generate(const char* format, const JSON_ALLOCATOR* allocator = NULL);
+		// Create canonical JSON from array
+		char* GenerateCanonical(const JSON_ALLOCATOR* allocator = NULL);
 		// Format for the array, this will override the format parameter passed to JSON_Generate
 		bool Format(const char* format);
 		// Parse a JSON string and create a node tree
 		JSON_NODE* Parse(const char* json, JSON_PARSER_CONTEXT* context);
+		// Parse a JSON string into the existing node tree, reusing its nodes and buffers
+		JSON_NODE* ParseInto(const char* json, JSON_PARSER_CONTEXT* context);
+		// Parse an edited JSON string, only the smallest object or array that encloses the edit is parsed again
+		JSON_NODE* Reparse(const char* old_json, size_t offset, size_t removedLength, const char* insertedText, JSON_PARSER_CONTEXT* context);
+	};
+
+	// JSON document, owns a node tree and frees it when it is destroyed
+	// A document can be moved but not copied, so the tree always has exactly one owner
+	class JSON_DOCUMENT
+	{
+	private:
+		// Document root node
+		JSON_NODE* json_root;
+	public:
+		// Default initializer, the document is empty
+		JSON_DOCUMENT();
+		// Take ownership of a node tree, the tree must not be freed with JSON_Free
+		explicit JSON_DOCUMENT(JSON_NODE* root);
+		// Parse a JSON string and create a node tree
+		JSON_DOCUMENT(const char* json, JSON_PARSER_CONTEXT* context);
+		// Move the tree of another document, the other document is empty then
+		JSON_DOCUMENT(JSON_DOCUMENT&& other) noexcept;
+		JSON_DOCUMENT& operator=(JSON_DOCUMENT&& other) noexcept;
+		// The document can't be copied, use JSON_Clone to copy the tree
+		JSON_DOCUMENT(const JSON_DOCUMENT&) = delete;
+		JSON_DOCUMENT& operator=(const JSON_DOCUMENT&) = delete;
+		// Free the node tree
+		~JSON_DOCUMENT();
+		// Get the root node, the document still owns it
+		JSON_NODE* Root() const;
+		// Check if the document has a node tree
+		bool Empty() const;
+		// Get the root as an object, an empty object if the root is not an object
+		JSON_OBJECT Object() const;
+		// Get the root as an array, an empty array if the root is not an array
+		JSON_ARRAY Array() const;
+		// Parse a JSON string into the document, reusing the nodes and buffers of the old tree
+		JSON_NODE* Parse(const char* json, JSON_PARSER_CONTEXT* context);
+		// Move the node tree into a single memory block with JSON_Compact
+		JSON_NODE* Compact();
+		// Free the node tree and take ownership of another one
+		void Reset(JSON_NODE* root = NULL);
+		// Give up ownership of the node tree, the caller must free it with JSON_Free
+		JSON_NODE* Release();
 	};
 }
 
@@ -0,0 +1,89 @@
+
+//
+// append.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for Append, which keeps items in the order they are appended in.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+void test_AppendOrder()
+{
+	JSON_PARSER_CONTEXT context;
+	JSON_OBJECT object;
+	JSON_ARRAY array;
+	JSON_NODE* node;
+	long long i;
+
+	// Appended items are in order and counted
+	array.MakeRoot();
+	for (i = 0; i < 100000; i++) {
+		CHECK(array.Append.Number.Int64(i) != NULL);
+	}
+	CHECK(array.Count() == 100000);
+	i = 0;
+	for (node = array.First(); node != NULL; node = node->next)
+	{
+		if (node->Int64() != i) {
+			break;
+		}
+		i++;
+	}
+	CHECK(i == 100000);
+	array.Free();
+
+	// Insert puts items in front, Append after the last item
+	array.MakeRoot();
+	CHECK(array.Append.Number.Int(2) != NULL);
+	CHECK(array.Insert.Number.Int(1) != NULL);
+	CHECK(array.Append.Number.Int(3) != NULL);
+	CHECK(array.Insert.Number.Int(0) != NULL);
+	CHECK(array.Append.String("4") != NULL);
+	CHECK(array.Append.Boolean(false) != NULL);
+	CHECK(test_Generate(array) == "[0,1,2,3,\"4\",false]");
+
+	// Deleting the last item moves the tail back
+	CHECK(array.Delete((unsigned long)array.Count() - 1));
+	CHECK(array.Delete((unsigned long)array.Count() - 1));
+	CHECK(array.Append.Boolean(true) != NULL);
+	CHECK(test_Generate(array) == "[0,1,2,3,true]");
+
+	// Deleting every item leaves an empty list to append to
+	while (array.Count() != 0) {
+		CHECK(array.Delete(0UL));
+	}
+	CHECK(array.Append.Number.Int(5) != NULL);
+	CHECK(array.Append.Number.Int(6) != NULL);
+	CHECK(test_Generate(array) == "[5,6]");
+	array.Free();
+
+	// Objects keep the order too, also when the object was parsed
+	object = JSON_Parse("{\"a\":1,\"b\":[]}", &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	CHECK(object.Append.String("c", "x") != NULL);
+	CHECK(object.Insert.Boolean("z", false) != NULL);
+	CHECK(object.Array("b").Append.Number.Int(1) != NULL);
+	CHECK(object.Array("b").Append.Object() != NULL);
+	CHECK(object.Append.Array("d") != NULL);
+	CHECK(object.Count() == 5);
+	CHECK(test_Generate(object) == "{\"z\":false,\"a\":1,\"b\":[1,{}],\"c\":\"x\",\"d\":[]}");
+
+	CHECK(object.Delete("d"));
+	CHECK(object.Append.String("e", "y") != NULL);
+	CHECK(test_Generate(object) == "{\"z\":false,\"a\":1,\"b\":[1,{}],\"c\":\"x\",\"e\":\"y\"}");
+
+	// A parse into the tree sets the tail to the last parsed member
+	object.ParseInto("{\"a\":2,\"b\":[]}", &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	CHECK(object.Append.Number.Int("c", 3) != NULL);
+	CHECK(test_Generate(object) == "{\"a\":2,\"b\":[],\"c\":3}");
+	object.Free();
+}
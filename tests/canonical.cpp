@@ -0,0 +1,63 @@
+
+//
+// canonical.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_GenerateCanonical.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Check the canonical string of a JSON string
+static void CheckCanonical(const char* json, const char* expected)
+{
+	JSON_NODE* root;
+	char* canonical;
+
+	root = test_Parse(json);
+	canonical = JSON_GenerateCanonical(root);
+	CHECK((canonical != NULL) && (strcmp(canonical, expected) == 0));
+	if ((canonical != NULL) && (strcmp(canonical, expected) != 0)) {
+		printf("expected %s\n     got %s\n", expected, canonical);
+	}
+
+	free(canonical);
+	JSON_Free(root);
+}
+
+void test_Canonical()
+{
+	const char* numbers[] = { "-0", "0.0", "1E30", "1.5e2", "1e21", "1e20", "1.50", "0.000001", "1e-7", "-12.5e-1", "123456789012345" };
+	JSON_ARRAY array;
+	char* canonical;
+	size_t i;
+
+	// Empty objects have no members to sort
+	CheckCanonical("{}", "{}");
+	CheckCanonical("{ \"a\" : { } , \"b\" : [ { } ] }", "{\"a\":{},\"b\":[{}]}");
+	CheckCanonical("[{},{},[]]", "[{},{},[]]");
+
+	// Members are sorted by key in every object, by UTF-16 code units
+	CheckCanonical("{\"b\":1,\"a\":{\"d\":2,\"c\":3},\"aa\":[{\"z\":0,\"y\":0}]}", "{\"a\":{\"c\":3,\"d\":2},\"aa\":[{\"y\":0,\"z\":0}],\"b\":1}");
+	CheckCanonical("{\"\xEF\xAC\x80\":1,\"\xF0\x9F\x98\x80\":2,\"\xC3\xA9\":3}", "{\"\xC3\xA9\":3,\"\xF0\x9F\x98\x80\":2,\"\xEF\xAC\x80\":1}");
+
+	// Numbers are written the way ECMAScript writes them, the parser doesn't read exponents so they are inserted
+	array.MakeRoot();
+	for (i = 0; i < sizeof(numbers) / sizeof(numbers[0]); i++) {
+		CHECK(array.Append.Number.String(numbers[i]) != NULL);
+	}
+	canonical = array.GenerateCanonical();
+	CHECK((canonical != NULL) && (strcmp(canonical, "[0,0,1e+30,150,1e+21,100000000000000000000,1.5,0.000001,1e-7,-1.25,123456789012345]") == 0));
+	free(canonical);
+	array.Free();
+
+	// Strings only escape what they must
+	CheckCanonical("[\"tab\\there\",\"quote\\\"\"]", "[\"tab\\there\",\"quote\\\"\"]");
+}
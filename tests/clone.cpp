@@ -0,0 +1,73 @@
+
+//
+// clone.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_Clone and the copy-on-write item lists of clones.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+void test_CloneIsolation()
+{
+	const char* json = "{\"header\":{\"to\":\"consumer-1\",\"tags\":[1,2,3]},\"body\":[{\"a\":1},{\"b\":2}]}";
+	JSON_OBJECT original;
+	JSON_OBJECT copy;
+	JSON_OBJECT second;
+	JSON_OBJECT third;
+	JSON_NODE* patch;
+
+	original = JSON_OBJECT(test_Parse(json));
+	copy = original.Clone();
+	CHECK(!copy.Empty());
+	CHECK(JSON_Equal(original, copy));
+
+	// Changes to the clone don't change the original
+	CHECK(copy.Object("header").Delete("to"));
+	CHECK(copy.Object("header").Insert.String("to", "consumer-2") != NULL);
+	CHECK(copy.Object("header").Array("tags").Append.Number.Int(4) != NULL);
+	CHECK(copy.Array("body").Delete(0UL));
+	CHECK(test_SameJson(original, json));
+	CHECK(test_SameJson(copy, "{\"header\":{\"to\":\"consumer-2\",\"tags\":[1,2,3,4]},\"body\":[{\"b\":2}]}"));
+
+	// Changes to the original don't change the clone
+	second = original.Clone();
+	CHECK(original.Array("body").Object(1).Insert.Boolean("c", true) != NULL);
+	CHECK(original.Delete("header"));
+	CHECK(test_SameJson(second, json));
+	CHECK(test_SameJson(original, "{\"body\":[{\"a\":1},{\"c\":true,\"b\":2}]}"));
+
+	// A patch on a clone leaves the other clones alone
+	patch = test_Parse("[{\"op\":\"replace\",\"path\":\"/header/tags/0\",\"value\":9},{\"op\":\"remove\",\"path\":\"/body/1\"}]");
+	CHECK(JSON_Patch(second, patch));
+	CHECK(test_SameJson(second, "{\"header\":{\"to\":\"consumer-1\",\"tags\":[9,2,3]},\"body\":[{\"a\":1}]}"));
+	CHECK(test_SameJson(original, "{\"body\":[{\"a\":1},{\"c\":true,\"b\":2}]}"));
+	CHECK(test_SameJson(copy, "{\"header\":{\"to\":\"consumer-2\",\"tags\":[1,2,3,4]},\"body\":[{\"b\":2}]}"));
+	JSON_Free(patch);
+
+	// JSON_GetArray doesn't copy shared items, it finds the same node as in the original
+	third = original.Clone();
+	CHECK(JSON_GetArray(third, "body") == JSON_GetArray(original, "body"));
+
+	// After Array the node belongs to the clone and can be changed through JSON_GetArray
+	CHECK(!third.Array("body").Empty());
+	CHECK(JSON_GetArray(third, "body") != JSON_GetArray(original, "body"));
+	CHECK(JSON_ARRAY(JSON_GetArray(third, "body")).Append.Number.Int(3) != NULL);
+	CHECK(test_SameJson(third, "{\"body\":[{\"a\":1},{\"c\":true,\"b\":2},3]}"));
+	CHECK(test_SameJson(original, "{\"body\":[{\"a\":1},{\"c\":true,\"b\":2}]}"));
+	third.Free();
+
+	// Clones can be freed in any order, the shared items are freed with the last one
+	original.Free();
+	CHECK(test_SameJson(copy, "{\"header\":{\"to\":\"consumer-2\",\"tags\":[1,2,3,4]},\"body\":[{\"b\":2}]}"));
+	second.Free();
+	CHECK(copy.Object("header").Array("tags").Count() == 4);
+	copy.Free();
+}
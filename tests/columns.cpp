@@ -0,0 +1,196 @@
+
+//
+// columns.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_COLUMNS, Load on a tree and LoadText on the JSON string must give the same columns.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Number of allocations the failing allocator makes before it fails
+static size_t allocations_left = 0;
+
+static void* FailAllocate(void*, size_t size)
+{
+	if (allocations_left == 0) {
+		return NULL;
+	}
+	allocations_left--;
+	return malloc(size);
+}
+
+static void* FailReallocate(void*, void* block, size_t size)
+{
+	if (allocations_left == 0) {
+		return NULL;
+	}
+	allocations_left--;
+	return realloc(block, size);
+}
+
+static void FailDeallocate(void*, void* block)
+{
+	free(block);
+}
+
+static const JSON_ALLOCATOR fail_allocator = { FailAllocate, FailReallocate, FailDeallocate, NULL };
+
+// Add the columns of the tests
+static void AddColumns(JSON_COLUMNS& columns)
+{
+	CHECK(columns.Add("id", JSON_COLUMN_TYPE::INT64));
+	CHECK(columns.Add("score", JSON_COLUMN_TYPE::DOUBLE));
+	CHECK(columns.Add("ok", JSON_COLUMN_TYPE::BOOLEAN));
+	CHECK(columns.Add("name", JSON_COLUMN_TYPE::STRING));
+}
+
+// Check that 2 tables have the same rows, values and null bitmaps
+static void CheckSameColumns(JSON_COLUMNS& a, JSON_COLUMNS& b)
+{
+	size_t column, row;
+
+	CHECK(a.Rows() == b.Rows());
+	CHECK(a.Count() == b.Count());
+	if ((a.Rows() != b.Rows()) || (a.Count() != b.Count())) {
+		return;
+	}
+
+	for (column = 0; column < a.Count(); column++)
+	{
+		CHECK(a.Type(column) == b.Type(column));
+
+		for (row = 0; row < a.Rows(); row++)
+		{
+			CHECK(a.IsNull(column, row) == b.IsNull(column, row));
+			CHECK(((a.Nulls(column)[row / 8] >> (row % 8)) & 1) == ((b.Nulls(column)[row / 8] >> (row % 8)) & 1));
+
+			switch (a.Type(column))
+			{
+			case JSON_COLUMN_TYPE::INT64:
+				CHECK(a.Int64s(column)[row] == b.Int64s(column)[row]);
+				break;
+			case JSON_COLUMN_TYPE::DOUBLE:
+				CHECK(a.Doubles(column)[row] == b.Doubles(column)[row]);
+				break;
+			case JSON_COLUMN_TYPE::BOOLEAN:
+				CHECK(a.Booleans(column)[row] == b.Booleans(column)[row]);
+				break;
+			case JSON_COLUMN_TYPE::STRING:
+				CHECK(a.Offsets(column)[row + 1] - a.Offsets(column)[row] == b.Offsets(column)[row + 1] - b.Offsets(column)[row]);
+				CHECK(std::string(a.Strings(column) + a.Offsets(column)[row], a.Offsets(column)[row + 1] - a.Offsets(column)[row]) ==
+					std::string(b.Strings(column) + b.Offsets(column)[row], b.Offsets(column)[row + 1] - b.Offsets(column)[row]));
+				break;
+			}
+		}
+	}
+}
+
+// Load a JSON string with Load and LoadText and check that the columns are the same
+static void CheckLoad(const char* json)
+{
+	JSON_COLUMNS tree;
+	JSON_COLUMNS text;
+	JSON_NODE* root;
+
+	AddColumns(tree);
+	AddColumns(text);
+
+	root = test_Parse(json);
+	CHECK(tree.Load(root));
+	CHECK(text.LoadText(json));
+	CheckSameColumns(tree, text);
+
+	// Loading again adds the rows after the rows that were read before
+	CHECK(tree.Load(root));
+	CHECK(text.LoadText(json, strlen(json)));
+	CheckSameColumns(tree, text);
+
+	JSON_Free(root);
+}
+
+void test_ColumnsLoad()
+{
+	const char* json =
+		"[{\"id\":1,\"score\":2.5,\"ok\":true,\"name\":\"ann\"},"
+		"{\"name\":\"bob\",\"ok\":false,\"score\":-1,\"id\":-2},"
+		"{\"id\":3.9,\"extra\":{\"id\":4},\"name\":\"tab\\tquote\\\"\"},"
+		"{},"
+		"{\"id\":null,\"score\":null,\"ok\":null,\"name\":null},"
+		"{\"id\":\"5\",\"score\":true,\"ok\":1,\"name\":7},"
+		"{\"id\":[1],\"score\":{},\"ok\":\"true\",\"name\":[\"x\"]},"
+		"{\"id\":6,\"id\":7,\"name\":\"first\",\"name\":\"second\"},"
+		"5, \"text\", null, true, [1,2], [],"
+		"{\"key only\",\"id\":8},{\"id\",\"id\":9,\"name\"}]";
+	JSON_COLUMNS columns(&fail_allocator);
+	JSON_COLUMNS expected;
+	JSON_NODE* root;
+	JSON_NODE* more;
+	JSON_ARRAY big;
+	size_t rows;
+	size_t i;
+
+	// Missing members, values of another type, nulls, duplicate keys, key-only members and items that are not objects
+	CheckLoad(json);
+	CheckLoad("[]");
+	CheckLoad("[{\"id\":1}]");
+
+	// Nine rows so the null bitmap has more than one byte
+	CheckLoad("[{\"id\":1},{\"ok\":true},{},{\"id\":2},null,{\"name\":\"\"},{\"score\":0.5},{},{\"id\":3},{\"name\":\"x\"}]");
+
+	// A JSON string that is not an array of values is rejected and the rows of the call are removed
+	AddColumns(expected);
+	root = test_Parse(json);
+	CHECK(expected.Load(root));
+	CHECK(!expected.LoadText("[{\"id\":9},{\"id\":10"));
+	CHECK(!expected.LoadText("[{\"id\":9} {\"id\":10}]"));
+	CHECK(!expected.LoadText("{\"id\":9}"));
+	CHECK(!expected.Load(JSON_GetArray(root, "missing")));
+	CHECK(!expected.Load(JSON_GetObject(root, "missing")));
+
+	JSON_COLUMNS again;
+	AddColumns(again);
+	CHECK(again.LoadText(json));
+	CheckSameColumns(expected, again);
+
+	// Rows that are loaded after an error follow the rows before it
+	more = test_Parse("[{\"id\":11,\"name\":\"after\"}]");
+	CHECK(expected.Load(more));
+	CHECK(!again.LoadText("[{\"id\":9},{\"id\":10"));
+	CHECK(again.Rows() == expected.Rows() - 1);
+	CHECK(again.LoadText("[{\"id\":11,\"name\":\"after\"}]"));
+	CheckSameColumns(expected, again);
+
+	// Out of memory in the middle of a load removes the rows of the load, the rows before it are kept
+	big.MakeRoot();
+	for (i = 0; i < 1000; i++) {
+		CHECK(big.Append.Object().Append.Number.Int64("id", (long long)i) != NULL);
+	}
+
+	allocations_left = 1000;
+	AddColumns(columns);
+	CHECK(columns.Load(root));
+	rows = columns.Rows();
+
+	allocations_left = 2;
+	CHECK(!columns.Load(big));
+	CHECK(columns.Rows() == rows);
+	allocations_left = 2;
+	CHECK(!columns.LoadText(test_Generate(big).c_str()));
+	CHECK(columns.Rows() == rows);
+
+	allocations_left = 1000;
+	CHECK(columns.Load(more));
+	CheckSameColumns(expected, columns);
+
+	big.Free();
+	JSON_Free(more);
+	JSON_Free(root);
+}
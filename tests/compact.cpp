@@ -0,0 +1,110 @@
+
+//
+// compact.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_Compact and the trees it creates.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+void test_CompactTree()
+{
+	const char* json = "{\"name\":\"a string that is longer than a node\",\"list\":[1,2.5,true,null,{\"k\":\"v\"},[]],\"empty\":{},\"key only\"}";
+	JSON_PARSER_CONTEXT defaultContext;
+	JSON_PARSER_CONTEXT context;
+	std::string expected;
+	JSON_OBJECT object;
+	JSON_OBJECT copy;
+	const JSON_ALLOCATOR* allocator;
+	JSON_NODE* root;
+	void* memory;
+	size_t i;
+
+	// The compacted tree is one block and the same document
+	context.allocator = &test_live_allocator;
+	root = JSON_Parse(json, &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	expected = test_Generate(root);
+	root = JSON_Compact(root);
+	CHECK(test_live_blocks == 1);
+	CHECK(test_Generate(root) == expected);
+
+	// The compacted tree can be changed, new nodes and strings are allocated outside the block
+	object = JSON_OBJECT(root);
+	CHECK(object.Delete("name"));
+	CHECK(object.Array("list").Delete(4UL));
+	CHECK(object.Array("list").Append.String("added") != NULL);
+	CHECK(object.Insert.String("name", "changed") != NULL);
+	CHECK(object.Object("empty").Append.Number.Int("n", 1) != NULL);
+	CHECK(test_SameJson(object, "{\"name\":\"changed\",\"list\":[1,2.5,true,null,[],\"added\"],\"empty\":{\"n\":1},\"key only\"}"));
+	CHECK(test_live_blocks > 1);
+
+	// Compacting again moves the nodes of the old block and the new nodes into a new block
+	expected = test_Generate(object);
+	root = JSON_Compact(object);
+	CHECK(test_live_blocks == 1);
+	CHECK(test_Generate(root) == expected);
+	root = JSON_Compact(root);
+	CHECK(test_live_blocks == 1);
+	CHECK(test_Generate(root) == expected);
+
+	// The block is freed with the last node that uses it
+	object = JSON_OBJECT(root);
+	while (object.Count() != 0) {
+		CHECK(object.Delete(object.First()->key));
+	}
+	CHECK(test_live_blocks == 1);
+	object.Free();
+	CHECK(test_live_blocks == 0);
+
+	// Memory allocated with the allocator of a compacted node keeps the block alive
+	root = JSON_Compact(JSON_Parse(json, &context));
+	allocator = JSON_GetAllocator(root);
+	memory = allocator->allocate(allocator->userData, 16);
+	CHECK(memory != NULL);
+	JSON_Free(root);
+	CHECK(test_live_blocks != 0);
+	allocator->deallocate(allocator->userData, memory);
+	CHECK(test_live_blocks == 0);
+
+	// A clone keeps its items when the tree is compacted, the trees can be freed in any order
+	for (i = 0; i < 2; i++)
+	{
+		object = JSON_OBJECT(JSON_Parse(json, &context));
+		expected = test_Generate(object);
+		copy = object.Clone();
+		object = JSON_OBJECT(JSON_Compact(object));
+		CHECK(object.Array("list").Append.Number.Int(7) != NULL);
+		CHECK(test_Generate(copy) == expected);
+		copy = JSON_OBJECT(JSON_Compact(copy));
+		CHECK(test_Generate(copy) == expected);
+		CHECK(copy.Delete("list"));
+		CHECK(object.Array("list").Count() == 7);
+		if (i == 0) {
+			object.Free();
+			copy.Free();
+		}
+		else {
+			copy.Free();
+			object.Free();
+		}
+		CHECK(test_live_blocks == 0);
+	}
+
+	// A tree with the default allocator
+	root = JSON_Parse(json, &defaultContext);
+	root = JSON_Compact(root);
+	CHECK(test_SameJson(root, json));
+	root = JSON_Compact(root);
+	CHECK(JSON_OBJECT(root).Append.String("x", "y") != NULL);
+	JSON_Free(root);
+	CHECK(JSON_Compact(NULL) == NULL);
+}
@@ -0,0 +1,121 @@
+
+//
+// document.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for the ownership of the node tree of JSON_DOCUMENT.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include <utility>
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Parse a JSON string with the live allocator
+static JSON_NODE* ParseLive(const char* json)
+{
+	JSON_PARSER_CONTEXT context;
+	JSON_NODE* root;
+
+	context.allocator = &test_live_allocator;
+	root = JSON_Parse(json, &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+
+	return root;
+}
+
+// Create a document in a function and return it
+static JSON_DOCUMENT LoadDocument(const char* json)
+{
+	JSON_PARSER_CONTEXT context;
+
+	context.allocator = &test_live_allocator;
+
+	return JSON_DOCUMENT(json, &context);
+}
+
+void test_DocumentOwnership()
+{
+	JSON_PARSER_CONTEXT context;
+	JSON_NODE* root;
+	JSON_NODE* other;
+
+	// The tree is freed when the document is destroyed
+	{
+		JSON_DOCUMENT document(ParseLive("{\"a\":[1,2,3],\"b\":\"text\"}"));
+		CHECK(!document.Empty());
+		CHECK(test_live_blocks != 0);
+		CHECK(document.Object().Array("a").Count() == 3);
+		CHECK(document.Array().Empty());
+	}
+	CHECK(test_live_blocks == 0);
+
+	// A moved document is empty and the tree is freed once, by the document it was moved to
+	{
+		JSON_DOCUMENT document = LoadDocument("[1,2,3]");
+		root = document.Root();
+		CHECK(root != NULL);
+
+		JSON_DOCUMENT moved(std::move(document));
+		CHECK(document.Empty());
+		CHECK(document.Root() == NULL);
+		CHECK(document.Object().Empty());
+		CHECK(moved.Root() == root);
+
+		// Moving into a document frees its old tree
+		JSON_DOCUMENT target(ParseLive("{\"old\":true}"));
+		target = std::move(moved);
+		CHECK(moved.Empty());
+		CHECK(target.Root() == root);
+		CHECK(target.Array().Count() == 3);
+
+		// Moving a document into itself keeps the tree
+		JSON_DOCUMENT& same = target;
+		target = std::move(same);
+		CHECK(target.Root() == root);
+	}
+	CHECK(test_live_blocks == 0);
+
+	// Reset frees the old tree and owns the new one, resetting to the same tree keeps it
+	{
+		JSON_DOCUMENT document(ParseLive("{\"a\":1}"));
+		other = ParseLive("{\"b\":2}");
+		document.Reset(other);
+		CHECK(document.Root() == other);
+		document.Reset(other);
+		CHECK(document.Root() == other);
+		CHECK(document.Object().Number.Int("b") == 2);
+		document.Reset();
+		CHECK(document.Empty());
+		CHECK(test_live_blocks == 0);
+	}
+
+	// Release gives the tree to the caller, the document doesn't free it
+	{
+		JSON_DOCUMENT document(ParseLive("[true]"));
+		root = document.Release();
+		CHECK(document.Empty());
+		CHECK(document.Release() == NULL);
+	}
+	CHECK(test_live_blocks != 0);
+	JSON_Free(root);
+	CHECK(test_live_blocks == 0);
+
+	// Parse and Compact replace the tree the document owns
+	{
+		JSON_DOCUMENT document(ParseLive("{\"a\":[1,2]}"));
+		CHECK(document.Parse("{\"a\":[1,2,3],\"b\":{}}", &context) == document.Root());
+		CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+		CHECK(test_SameJson(document.Root(), "{\"a\":[1,2,3],\"b\":{}}"));
+		CHECK(document.Compact() == document.Root());
+		CHECK(document.Root() != NULL);
+		CHECK(test_SameJson(document.Root(), "{\"a\":[1,2,3],\"b\":{}}"));
+	}
+	CHECK(test_live_blocks == 0);
+}
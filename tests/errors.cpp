@@ -0,0 +1,54 @@
+
+//
+// errors.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for the error codes and error positions of JSON_Parse.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Parse a JSON string that has an error and check the error code and where the error is
+static void CheckError(const char* json, JSON_ERROR_CODE errorCode, unsigned long beginIndex, unsigned long errorLength)
+{
+	JSON_PARSER_CONTEXT context;
+	JSON_NODE* root;
+
+	root = JSON_Parse(json, &context);
+	CHECK(context.errorCode == errorCode);
+	CHECK(context.beginIndex == beginIndex);
+	CHECK(context.errorLength == errorLength);
+	if (context.errorCode != errorCode) {
+		printf("%s: error %d %s\n", json, (int)context.errorCode, (context.errorDescription != NULL) ? context.errorDescription : "");
+	}
+
+	JSON_Free(root);
+}
+
+void test_ParseErrors()
+{
+	// A value after the value of a member, the error begins after the value
+	CheckError("{\"a\":1 2}", JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_UNEXPECTED_VALUE, 6, 1);
+	CheckError("{\"a\":1 \"x\"}", JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_UNEXPECTED_VALUE, 6, 2);
+	CheckError("{\"a\":{} []}", JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_UNEXPECTED_VALUE, 7, 2);
+	CheckError("{\"a\":1 true}", JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_UNEXPECTED_VALUE, 7, 4);
+
+	// A literal that is not valid keeps its own error, even right after a number
+	CheckError("{\"a\":1e5}", JSON_ERROR_CODE::INVALID_LITERAL_NAME, 6, 2);
+	CheckError("{\"a\":nil}", JSON_ERROR_CODE::INVALID_LITERAL_NAME, 5, 3);
+
+	// Key errors are not changed
+	CheckError("{\"a\" \"b\"}", JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_KEY_ALREADY_DEFINED, 4, 2);
+	CheckError("{\"a\" 1}", JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_EXPECTED_COLON, 4, 1);
+	CheckError("{:1}", JSON_ERROR_CODE::OBJECT_SYNTAX_ERROR_KEY_NOT_DEFINED, 2, 0);
+
+	// Arrays have their own error for a value after a value
+	CheckError("[1 2]", JSON_ERROR_CODE::UNEXPECTED_ARRAY_VALUE, 2, 1);
+}
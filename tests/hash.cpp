@@ -0,0 +1,85 @@
+
+//
+// hash.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_Hash and the hashes kept in objects and arrays.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Hash of a JSON string, parsed into a new tree
+static unsigned long long HashOf(const char* json)
+{
+	unsigned long long hash;
+	JSON_NODE* root;
+
+	root = test_Parse(json);
+	hash = JSON_Hash(root);
+	JSON_Free(root);
+
+	return hash;
+}
+
+void test_HashStability()
+{
+	const char* json = "{\"a\":1,\"b\":[true,null,\"x\"]}";
+	JSON_PARSER_CONTEXT context;
+	unsigned long long hash;
+	JSON_OBJECT object;
+	JSON_OBJECT copy;
+
+	// The hash is the same in every run and build, so it can be stored
+	CHECK(HashOf(json) == 0x1e3d44dbdd829030ULL);
+	CHECK(HashOf("[1,2]") == 0xb27b5c323e67c152ULL);
+	CHECK(HashOf("{}") == 0x7e4f2fd80103545aULL);
+	CHECK(HashOf("[]") == 0xab52c7c8a7bbf642ULL);
+	CHECK(JSON_Hash(NULL) == 0);
+
+	// Member order doesn't change the hash, item order and values do
+	CHECK(HashOf("{\"b\":[true,null,\"x\"],\"a\":1}") == HashOf(json));
+	CHECK(HashOf("[2,1]") != HashOf("[1,2]"));
+	CHECK(HashOf("{\"a\":\"1\"}") != HashOf("{\"a\":1}"));
+	CHECK(HashOf("{\"a\":[]}") != HashOf("{\"a\":{}}"));
+	CHECK(HashOf("[[1],[2]]") != HashOf("[[1,2]]"));
+
+	// Hashing again gives the same hash
+	object = JSON_OBJECT(test_Parse(json));
+	hash = JSON_Hash(object);
+	CHECK(JSON_Hash(object) == hash);
+
+	// A change deep in the tree is noticed and the hash is the hash of the new tree
+	CHECK(object.Array("b").Append.Number.Int(5) != NULL);
+	CHECK(JSON_Hash(object) == HashOf("{\"a\":1,\"b\":[true,null,\"x\",5]}"));
+	CHECK(object.Array("b").Delete(3UL));
+	CHECK(JSON_Hash(object) == hash);
+	CHECK(object.Array("b").Insert.Object() != NULL);
+	CHECK(JSON_Hash(object) == HashOf("{\"a\":1,\"b\":[{},true,null,\"x\"]}"));
+	CHECK(object.Array("b").Object(0).Insert.String("k", "v") != NULL);
+	CHECK(JSON_Hash(object) == HashOf("{\"a\":1,\"b\":[{\"k\":\"v\"},true,null,\"x\"]}"));
+	CHECK(JSON_Hash(JSON_GetArray(object, "b")) == HashOf("[{\"k\":\"v\"},true,null,\"x\"]"));
+	CHECK(object.Array("b").Delete(0UL));
+	CHECK(JSON_Hash(object) == hash);
+
+	// A parse into the tree is noticed
+	object.ParseInto("{\"a\":2}", &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	CHECK(JSON_Hash(object) == HashOf("{\"a\":2}"));
+
+	// A clone has the same hash, a change to it doesn't change the hash of the original
+	copy = object.Clone();
+	CHECK(JSON_Hash(copy) == JSON_Hash(object));
+	CHECK(copy.Append.Boolean("c", true) != NULL);
+	CHECK(JSON_Hash(copy) == HashOf("{\"a\":2,\"c\":true}"));
+	CHECK(JSON_Hash(object) == HashOf("{\"a\":2}"));
+	copy.Free();
+
+	object.Free();
+}
@@ -0,0 +1,163 @@
+
+//
+// index.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for the hash index of large objects and the item vector of large arrays.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include <vector>
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Check that every key in `keys` is found with its value and the object has no other members
+static void CheckMembers(JSON_OBJECT& object, const std::vector<std::string>& keys)
+{
+	size_t i;
+
+	CHECK(object.Count() == keys.size());
+
+	for (i = 0; i < keys.size(); i++)
+	{
+		const char* value = object.String(keys[i].c_str());
+		CHECK((value != NULL) && (keys[i] == value));
+	}
+
+	CHECK(object.String("missing") == NULL);
+}
+
+void test_ObjectIndex()
+{
+	std::vector<std::string> keys;
+	std::vector<std::string> kept;
+	JSON_MEMORY_USAGE usage;
+	JSON_OBJECT object;
+	std::string key;
+	size_t i;
+
+	object.MakeRoot();
+
+	// Enough members to build the index on the first lookup
+	for (i = 0; i < 40; i++)
+	{
+		key = "key" + std::to_string(i);
+		CHECK(object.Append.String(key.c_str(), key.c_str()) != NULL);
+		keys.push_back(key);
+	}
+
+	CheckMembers(object, keys);
+	usage = JSON_MemoryUsage(object);
+	CHECK(usage.indexes != 0);
+
+	// Members inserted in front, appended and deleted are found through the index
+	CHECK(object.Insert.String("front", "front") != NULL);
+	keys.push_back("front");
+	CHECK(object.Append.String("back", "back") != NULL);
+	keys.push_back("back");
+	CheckMembers(object, keys);
+
+	kept.clear();
+	for (i = 0; i < keys.size(); i++)
+	{
+		if (i % 3 == 0) {
+			CHECK(object.Delete(keys[i].c_str()));
+		}
+		else {
+			kept.push_back(keys[i]);
+		}
+	}
+	keys = kept;
+	CheckMembers(object, keys);
+	CHECK(!object.Delete("key0"));
+
+	// Deleting every member leaves an empty object that still works
+	for (i = 0; i < keys.size(); i++) {
+		CHECK(object.Delete(keys[i].c_str()));
+	}
+	keys.clear();
+	CheckMembers(object, keys);
+
+	CHECK(object.Append.String("again", "again") != NULL);
+	keys.push_back("again");
+	CheckMembers(object, keys);
+
+	object.Free();
+}
+
+// Check that the array has the items in `values` in the same order
+static void CheckItems(JSON_ARRAY& array, const std::vector<long long>& values)
+{
+	JSON_NODE* node;
+	size_t i;
+
+	CHECK(array.Count() == values.size());
+
+	for (i = 0; i < values.size(); i++) {
+		CHECK(array.Number.Int64((unsigned long)i) == values[i]);
+	}
+
+	// The item list has the same order as the item vector
+	i = 0;
+	for (node = array.First(); node != NULL; node = node->next)
+	{
+		CHECK((i < values.size()) && (node->Int64() == values[i]));
+		i++;
+	}
+	CHECK(i == values.size());
+}
+
+void test_ArrayItems()
+{
+	std::vector<long long> values;
+	JSON_MEMORY_USAGE usage;
+	JSON_ARRAY array;
+	long long i;
+
+	array.MakeRoot();
+
+	for (i = 0; i < 40; i++)
+	{
+		CHECK(array.Append.Number.Int64(i) != NULL);
+		values.push_back(i);
+	}
+
+	CheckItems(array, values);
+	usage = JSON_MemoryUsage(array);
+	CHECK(usage.indexes != 0);
+
+	// Items inserted in front, appended and deleted at any index keep their indexes right
+	for (i = 100; i < 110; i++)
+	{
+		CHECK(array.Insert.Number.Int64(i) != NULL);
+		values.insert(values.begin(), i);
+		CHECK(array.Append.Number.Int64(i + 100) != NULL);
+		values.push_back(i + 100);
+	}
+	CheckItems(array, values);
+
+	CHECK(array.Delete(0UL));
+	values.erase(values.begin());
+	CHECK(array.Delete((unsigned long)values.size() - 1));
+	values.pop_back();
+	CHECK(array.Delete(25UL));
+	values.erase(values.begin() + 25);
+	CheckItems(array, values);
+
+	CHECK(!array.Delete((unsigned long)values.size()));
+
+	while (!values.empty())
+	{
+		CHECK(array.Delete((unsigned long)values.size() / 2));
+		values.erase(values.begin() + values.size() / 2);
+	}
+	CheckItems(array, values);
+
+	array.Free();
+}
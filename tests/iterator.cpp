@@ -0,0 +1,112 @@
+
+//
+// iterator.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_ITERATOR and the JSON_ITEM it yields.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include <algorithm>
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Check if the key of an item is `key`
+static bool HasKey(const JSON_ITEM& item, const char* key)
+{
+#ifdef JSON_PLUS_STRING_VIEW
+	return (item.Key() == key);
+#else
+	return ((item.Key() != NULL) && (strcmp(item.Key(), key) == 0));
+#endif
+}
+
+void test_IteratorItems()
+{
+	const char* keys[] = { "a", "b", "c", "e", "f", "g" };
+	JSON_OBJECT object;
+	JSON_ARRAY array;
+	JSON_ITERATOR it;
+	long long sum;
+	size_t count;
+
+	object = JSON_OBJECT(test_Parse("{\"a\":1,\"b\":\"x\",\"c\":{\"d\":true},\"e\":[1,2],\"f\":2.5,\"g\":null}"));
+
+	// Every member is yielded in order with typed accessors
+	count = 0;
+	for (JSON_ITEM item : object)
+	{
+		CHECK((count < 6) && HasKey(item, keys[count]));
+		count++;
+
+		if (HasKey(item, "a")) {
+			CHECK(item.Type() == JSON_TYPE::NUMBER);
+			CHECK(item.Int64() == 1);
+			CHECK(item.String() == NULL);
+			CHECK(item.Object().Empty());
+		}
+		else if (HasKey(item, "b")) {
+			CHECK((item.String() != NULL) && (strcmp(item.String(), "x") == 0));
+			CHECK(item.Int64() == 0);
+		}
+		else if (HasKey(item, "c")) {
+			CHECK(item.Object().Boolean("d"));
+			CHECK(item.Array().Empty());
+		}
+		else if (HasKey(item, "e")) {
+			CHECK(item.Array().Count() == 2);
+		}
+		else if (HasKey(item, "f")) {
+			CHECK(item.Double() == 2.5);
+		}
+		else if (HasKey(item, "g")) {
+			CHECK(item.Type() == JSON_TYPE::NULL_TYPE);
+			CHECK(!item.Boolean());
+		}
+	}
+	CHECK(count == 6);
+
+	// Items convert to their node, so loops over JSON_NODE* still work
+	count = 0;
+	for (JSON_NODE* node : object)
+	{
+		CHECK(node->key != NULL);
+		count++;
+	}
+	CHECK(count == 6);
+
+	it = object.begin();
+	CHECK(it->type == JSON_TYPE::NUMBER);
+	CHECK((*it).Node() == object.First());
+	CHECK((it++) == object.begin());
+	CHECK(HasKey(*it, "b"));
+	CHECK(std::count_if(object.begin(), object.end(), [](JSON_ITEM item) { return (item.Type() == JSON_TYPE::NUMBER); }) == 2);
+
+	// Array items have no key
+	array = object.Array("e");
+	sum = 0;
+	for (JSON_ITEM item : array)
+	{
+		sum += item.Int64();
+#ifdef JSON_PLUS_STRING_VIEW
+		CHECK(item.Key().empty());
+#else
+		CHECK(item.Key() == NULL);
+#endif
+	}
+	CHECK(sum == 3);
+
+	// Empty containers have no items
+	CHECK(object.Object("c").Array("d").begin() == object.Object("c").Array("d").end());
+	array = object.Array("missing");
+	CHECK(array.begin() == array.end());
+	CHECK(object.Object("c").begin() != object.Object("c").end());
+
+	object.Free();
+}
@@ -0,0 +1,112 @@
+
+//
+// key.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_KEY lookups.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+#ifdef JSON_PLUS_CONSTEXPR_KEY
+
+// Check that a JSON_KEY lookup finds the same member as a null terminated key lookup
+static void CheckSameMember(JSON_OBJECT& object, const std::string& key)
+{
+	JSON_KEY jsonKey(key.c_str(), key.size());
+
+	CHECK(JSON_GetString(object, jsonKey) == JSON_GetString(object, key.c_str()));
+	CHECK(JSON_GetObject(object, jsonKey) == JSON_GetObject(object, key.c_str()));
+	CHECK(JSON_GetArray(object, jsonKey) == JSON_GetArray(object, key.c_str()));
+	CHECK(JSON_GetNumber(object, jsonKey) == JSON_GetNumber(object, key.c_str()));
+	CHECK(object.String(jsonKey) == object.String(key.c_str()));
+}
+
+// Check lookups of an object with `count` short members and some long keys
+static void CheckObject(size_t count)
+{
+	std::string longKey(70000, 'k');
+	std::string otherKey(70000, 'k');
+	std::string json;
+	JSON_PARSER_CONTEXT context;
+	JSON_OBJECT object;
+	size_t i;
+
+	// The long keys only differ in the last byte, beyond what fits in the stored key length
+	otherKey.back() = 'x';
+
+	object.MakeRoot();
+	for (i = 0; i < count; i++) {
+		CHECK(object.Append.String(("key" + std::to_string(i)).c_str(), std::to_string(i).c_str()) != NULL);
+	}
+	CHECK(object.Append.String(longKey.c_str(), "long") != NULL);
+	CHECK(object.Append.Number.Int(otherKey.c_str(), 1) != NULL);
+	CHECK(object.Append.Object("obj") != NULL);
+	CHECK(object.Append.Array("arr") != NULL);
+
+	for (i = 0; i < count; i++) {
+		CheckSameMember(object, "key" + std::to_string(i));
+	}
+	CheckSameMember(object, longKey);
+	CheckSameMember(object, otherKey);
+	CheckSameMember(object, "obj");
+	CheckSameMember(object, "arr");
+	CheckSameMember(object, "missing");
+	CheckSameMember(object, longKey.substr(1));
+
+	CHECK(strcmp(object.String(JSON_KEY(longKey.c_str(), longKey.size())), "long") == 0);
+	CHECK(object.Number.Int(JSON_KEY(otherKey.c_str(), otherKey.size())) == 1);
+	CHECK(JSON_GetObject(object, JSON_KEY("obj")) != NULL);
+	CHECK(JSON_GetArray(object, JSON_KEY("obj")) == NULL);
+
+	// A key does not need to be null terminated and a prefix of a key is another key
+	CHECK(JSON_GetObject(object, JSON_KEY("objects", 3)) != NULL);
+	CHECK(JSON_GetObject(object, JSON_KEY("ob", 2)) == NULL);
+	CHECK(object.String(JSON_KEY(longKey.c_str(), 65536)) == NULL);
+
+	// Deleting with a JSON_KEY removes the member it finds
+	CHECK(object.Delete(JSON_KEY(longKey.c_str(), longKey.size())));
+	CHECK(object.String(longKey.c_str()) == NULL);
+	CHECK(object.Number.Int(JSON_KEY(otherKey.c_str(), otherKey.size())) == 1);
+	object.Free();
+
+	// Long keys that are parsed have the same fallback
+	json = "{\"" + longKey + "\":\"long\",\"" + otherKey + "\":1";
+	for (i = 0; i < count; i++) {
+		json += ",\"key" + std::to_string(i) + "\":\"" + std::to_string(i) + "\"";
+	}
+	json += "}";
+
+	object = JSON_Parse(json.c_str(), &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	CheckSameMember(object, longKey);
+	CheckSameMember(object, otherKey);
+	for (i = 0; i < count; i++) {
+		CheckSameMember(object, "key" + std::to_string(i));
+	}
+	CHECK(strcmp(object.String(JSON_KEY(longKey.c_str(), longKey.size())), "long") == 0);
+	object.Free();
+}
+
+#endif
+
+void test_KeyLookup()
+{
+#ifdef JSON_PLUS_CONSTEXPR_KEY
+	constexpr JSON_KEY key("username");
+
+	static_assert(key.length == 8, "the length of a JSON_KEY is known at compile time");
+	static_assert(key.hash == JSON_KEY::Hash("username", 8), "the hash of a JSON_KEY is known at compile time");
+
+	// A small object is searched in order, a large object through its hash index
+	CheckObject(4);
+	CheckObject(100);
+#endif
+}
@@ -0,0 +1,129 @@
+
+//
+// lexer.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_LEXER.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Expected token of a lexer test
+struct EXPECTED_TOKEN
+{
+	JSON_TOKEN type;
+	size_t offset;
+	size_t length;
+	unsigned long lineNumber;
+};
+
+// Lex `length` bytes of a JSON string and check every token, the JSON_END token is expected last
+static void CheckTokens(const char* json, size_t length, const EXPECTED_TOKEN* expected, size_t count)
+{
+	JSON_LEXER lexer(json, length);
+	JSON_LEXER_TOKEN token;
+	size_t i;
+	bool more;
+
+	for (i = 0; i < count; i++)
+	{
+		more = lexer.Next(&token);
+		CHECK(more == (expected[i].type != JSON_TOKEN::JSON_END));
+		CHECK(token.type == expected[i].type);
+		CHECK(token.offset == expected[i].offset);
+		CHECK(token.length == expected[i].length);
+		CHECK(token.lineNumber == expected[i].lineNumber);
+		if ((token.type != expected[i].type) || (token.offset != expected[i].offset) || (token.length != expected[i].length)) {
+			printf("token %zu: type %d offset %zu length %zu line %lu\n", i, (int)token.type, token.offset, token.length, token.lineNumber);
+		}
+	}
+
+	// The JSON_END token is returned again after the end
+	CHECK(!lexer.Next(&token));
+	CHECK(token.type == JSON_TOKEN::JSON_END);
+}
+
+void test_Lexer()
+{
+	const char* json = "{\"a\": [1, -2.5, true],\n \"b\\\"c\": null,\r\n\t\"long string with \\\\ escapes\\\"\" : {}}";
+	const EXPECTED_TOKEN tokens[] =
+	{
+		{ JSON_TOKEN::CURLY_OPEN, 0, 1, 1 },
+		{ JSON_TOKEN::STRING, 1, 3, 1 },
+		{ JSON_TOKEN::COLON, 4, 1, 1 },
+		{ JSON_TOKEN::ARRAY_OPEN, 6, 1, 1 },
+		{ JSON_TOKEN::NUMBER, 7, 1, 1 },
+		{ JSON_TOKEN::COMMA, 8, 1, 1 },
+		{ JSON_TOKEN::NUMBER, 10, 4, 1 },
+		{ JSON_TOKEN::COMMA, 14, 1, 1 },
+		{ JSON_TOKEN::LITERAL, 16, 4, 1 },
+		{ JSON_TOKEN::ARRAY_CLOSE, 20, 1, 1 },
+		{ JSON_TOKEN::COMMA, 21, 1, 1 },
+		{ JSON_TOKEN::STRING, 24, 6, 2 },
+		{ JSON_TOKEN::COLON, 30, 1, 2 },
+		{ JSON_TOKEN::LITERAL, 32, 4, 2 },
+		{ JSON_TOKEN::COMMA, 36, 1, 2 },
+		{ JSON_TOKEN::STRING, 40, 31, 3 },
+		{ JSON_TOKEN::COLON, 72, 1, 3 },
+		{ JSON_TOKEN::CURLY_OPEN, 74, 1, 3 },
+		{ JSON_TOKEN::CURLY_CLOSE, 75, 1, 3 },
+		{ JSON_TOKEN::CURLY_CLOSE, 76, 1, 3 },
+		{ JSON_TOKEN::JSON_END, 77, 0, 3 }
+	};
+	const EXPECTED_TOKEN unterminated[] =
+	{
+		{ JSON_TOKEN::ARRAY_OPEN, 0, 1, 1 },
+		{ JSON_TOKEN::STRING, 1, 4, 1 },
+		{ JSON_TOKEN::COMMA, 5, 1, 1 },
+		{ JSON_TOKEN::UNTERMINATED_STRING, 7, 22, 1 },
+		{ JSON_TOKEN::JSON_END, 29, 0, 1 }
+	};
+	const EXPECTED_TOKEN unrecognized[] =
+	{
+		{ JSON_TOKEN::ARRAY_OPEN, 0, 1, 1 },
+		{ JSON_TOKEN::UNRECOGNIZED_TOKEN, 1, 1, 1 },
+		{ JSON_TOKEN::UNRECOGNIZED_TOKEN, 3, 1, 2 },
+		{ JSON_TOKEN::ARRAY_CLOSE, 4, 1, 2 },
+		{ JSON_TOKEN::JSON_END, 5, 0, 2 }
+	};
+	const EXPECTED_TOKEN buffer[] =
+	{
+		{ JSON_TOKEN::ARRAY_OPEN, 0, 1, 1 },
+		{ JSON_TOKEN::NUMBER, 1, 2, 1 },
+		{ JSON_TOKEN::COMMA, 3, 1, 1 },
+		{ JSON_TOKEN::UNTERMINATED_STRING, 4, 3, 1 },
+		{ JSON_TOKEN::JSON_END, 7, 0, 1 }
+	};
+	JSON_LEXER_TOKEN token;
+	size_t i;
+
+	CheckTokens(json, strlen(json), tokens, sizeof(tokens) / sizeof(tokens[0]));
+
+	// A string without its closing double quotes ends at the end of the JSON string, escaped quotes don't close it
+	CheckTokens("[\"ok\", \"escaped \\\" quote \\\\\\\"", strlen("[\"ok\", \"escaped \\\" quote \\\\\\\""), unterminated, sizeof(unterminated) / sizeof(unterminated[0]));
+
+	// Characters that are not part of a token are single tokens
+	CheckTokens("[#\n?]", 5, unrecognized, sizeof(unrecognized) / sizeof(unrecognized[0]));
+
+	// A buffer with a length stops at the length, not at the null character
+	CheckTokens("[12,\"ab\"]", 7, buffer, sizeof(buffer) / sizeof(buffer[0]));
+
+	// The null terminated constructor gives the same tokens and Reset starts again
+	JSON_LEXER lexer(json);
+	for (i = 0; i < 3; i++) {
+		CHECK(lexer.Next(&token));
+	}
+	lexer.Reset();
+	for (i = 0; lexer.Next(&token); i++)
+	{
+		CHECK((i < sizeof(tokens) / sizeof(tokens[0])) && (token.type == tokens[i].type) && (token.offset == tokens[i].offset));
+	}
+	CHECK(i == sizeof(tokens) / sizeof(tokens[0]) - 1);
+}
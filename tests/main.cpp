@@ -0,0 +1,178 @@
+
+//
+// main.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Runs the json-plus tests, pass the name of a test to run only that test.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+int test_failures = 0;
+
+struct TEST
+{
+	const char* name;
+	void (*run)();
+};
+
+static const TEST tests[] =
+{
+	{ "ParseInto", test_ParseInto },
+	{ "Reparse", test_Reparse },
+	{ "ObjectIndex", test_ObjectIndex },
+	{ "ArrayItems", test_ArrayItems },
+	{ "CloneIsolation", test_CloneIsolation },
+	{ "PatchRollback", test_PatchRollback },
+	{ "MergePatch", test_MergePatch },
+	{ "DiffRoundTrip", test_DiffRoundTrip },
+	{ "Canonical", test_Canonical },
+	{ "ParseErrors", test_ParseErrors },
+	{ "Lexer", test_Lexer },
+	{ "PositionMap", test_PositionMap },
+	{ "AppendOrder", test_AppendOrder },
+	{ "KeyLookup", test_KeyLookup },
+	{ "IteratorItems", test_IteratorItems },
+	{ "PointerResolve", test_PointerResolve },
+	{ "PathEvaluate", test_PathEvaluate },
+	{ "HashStability", test_HashStability },
+	{ "PackedRoundTrip", test_PackedRoundTrip },
+	{ "DocumentOwnership", test_DocumentOwnership },
+	{ "NumberConversions", test_NumberConversions },
+	{ "ColumnsLoad", test_ColumnsLoad },
+	{ "MemoryLimit", test_MemoryLimit },
+	{ "CompactTree", test_CompactTree }
+};
+
+size_t test_allocations = 0;
+
+static void* CountAllocate(void*, size_t size)
+{
+	test_allocations++;
+	return malloc(size);
+}
+
+static void* CountReallocate(void*, void* block, size_t size)
+{
+	test_allocations++;
+	return realloc(block, size);
+}
+
+static void CountDeallocate(void*, void* block)
+{
+	free(block);
+}
+
+JSON_ALLOCATOR test_allocator = { CountAllocate, CountReallocate, CountDeallocate, NULL };
+
+size_t test_live_blocks = 0;
+
+static void* LiveAllocate(void*, size_t size)
+{
+	test_live_blocks++;
+	return malloc(size);
+}
+
+static void* LiveReallocate(void*, void* block, size_t size)
+{
+	if (block == NULL) {
+		test_live_blocks++;
+	}
+	return realloc(block, size);
+}
+
+static void LiveDeallocate(void*, void* block)
+{
+	if (block != NULL) {
+		test_live_blocks--;
+	}
+	free(block);
+}
+
+JSON_ALLOCATOR test_live_allocator = { LiveAllocate, LiveReallocate, LiveDeallocate, NULL };
+
+JSON_NODE* test_Parse(const char* json)
+{
+	JSON_PARSER_CONTEXT context;
+	JSON_NODE* root;
+
+	root = JSON_Parse(json, &context);
+	if (context.errorCode != JSON_ERROR_CODE::NONE)
+	{
+		printf("parse error: %s in %s\n", context.errorDescription, json);
+		test_failures++;
+	}
+
+	return root;
+}
+
+std::string test_Generate(JSON_NODE* node)
+{
+	std::string result;
+	char* json;
+
+	json = JSON_Generate(node, NULL);
+	if (json == NULL) {
+		return "(null)";
+	}
+
+	result = json;
+	free(json);
+
+	return result;
+}
+
+bool test_SameJson(JSON_NODE* node, const char* json)
+{
+	JSON_NODE* expected;
+	bool same;
+
+	expected = test_Parse(json);
+	same = JSON_Equal(node, expected);
+	if (!same) {
+		printf("expected %s\n     got %s\n", json, test_Generate(node).c_str());
+	}
+	JSON_Free(expected);
+
+	return same;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t i;
+	int failed;
+	bool found;
+
+	failed = 0;
+	found = false;
+
+	for (i = 0; i < sizeof(tests) / sizeof(tests[0]); i++)
+	{
+		if ((argc > 1) && (strcmp(argv[1], tests[i].name) != 0)) {
+			continue;
+		}
+
+		found = true;
+		test_failures = 0;
+		tests[i].run();
+		printf("%s: %s\n", tests[i].name, (test_failures == 0) ? "passed" : "FAILED");
+		if (test_failures != 0) {
+			failed++;
+		}
+	}
+
+	if (!found)
+	{
+		printf("no test named %s\n", argv[1]);
+		return 1;
+	}
+
+	return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+
+//
+// memory.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for the memory counters and the memory limit of the parser context.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Parse a JSON string and check that the counters of the context match the memory of the tree
+static void CheckCounters(const char* json)
+{
+	JSON_PARSER_CONTEXT context;
+	JSON_MEMORY_USAGE usage;
+	JSON_NODE* root;
+	size_t before;
+
+	context.allocator = &test_allocator;
+	before = test_allocations;
+	root = JSON_Parse(json, &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+
+	usage = JSON_MemoryUsage(root);
+	CHECK(context.memoryUsed == (long long)usage.total);
+	CHECK(context.peakMemory >= usage.total);
+	CHECK(context.bytesAllocated >= usage.total);
+	CHECK(context.allocations == test_allocations - before);
+	if (context.memoryUsed != (long long)usage.total) {
+		printf("%s: memoryUsed %lld, JSON_MemoryUsage %zu\n", json, context.memoryUsed, usage.total);
+	}
+
+	JSON_Free(root);
+}
+
+// Parse a JSON string with a memory limit, returns the error code
+static JSON_ERROR_CODE ParseWithLimit(const char* json, size_t memoryLimit, JSON_PARSER_CONTEXT* context)
+{
+	JSON_NODE* root;
+
+	context->memoryLimit = memoryLimit;
+	root = JSON_Parse(json, context);
+	if (context->errorCode == JSON_ERROR_CODE::MEMORY_LIMIT_EXCEEDED) {
+		CHECK(context->peakMemory <= memoryLimit);
+	}
+	JSON_Free(root);
+
+	return context->errorCode;
+}
+
+void test_MemoryLimit()
+{
+	const char* json = "{\"name\":\"a string that is longer than a node\",\"list\":[1,2.5,true,null,{\"k\":\"v\"},[]],\"empty\":{}}";
+	JSON_PARSER_CONTEXT context;
+	JSON_NODE* root;
+	std::string large;
+	std::string nested;
+	size_t total;
+	size_t i;
+
+	// A fresh parse uses what JSON_MemoryUsage counts for the tree
+	CheckCounters(json);
+	CheckCounters("[]");
+	CheckCounters("{\"a\":{\"b\":{\"c\":[[[\"deep\"]]]}}}");
+	CheckCounters("{\"key\",\"a key that is longer than a node\":\"x\"}");
+
+	large = "[";
+	for (i = 0; i < 1000; i++)
+	{
+		if (i != 0) {
+			large += ",";
+		}
+		large += "{\"id\":" + std::to_string(i) + ",\"name\":\"item " + std::to_string(i) + "\"}";
+	}
+	large += "]";
+	CheckCounters(large.c_str());
+
+	// The limit is the most memory the parse may use, a limit of the peak is enough
+	root = JSON_Parse(json, &context);
+	total = JSON_MemoryUsage(root).total;
+	JSON_Free(root);
+	CHECK(ParseWithLimit(json, context.peakMemory, &context) == JSON_ERROR_CODE::NONE);
+	CHECK(ParseWithLimit(json, total - 1, &context) == JSON_ERROR_CODE::MEMORY_LIMIT_EXCEEDED);
+	CHECK((context.errorDescription != NULL) && (strcmp(context.errorDescription, "none") != 0));
+
+	// A small limit stops a large payload early, before it allocates much
+	CHECK(ParseWithLimit(large.c_str(), 1024, &context) == JSON_ERROR_CODE::MEMORY_LIMIT_EXCEEDED);
+	CHECK(context.bytesAllocated <= 1024);
+	CHECK(context.allocations < 100);
+	CHECK(ParseWithLimit(large.c_str(), 1, &context) == JSON_ERROR_CODE::MEMORY_LIMIT_EXCEEDED);
+
+	// A deeply nested payload is stopped too
+	nested = std::string(10000, '[') + std::string(10000, ']');
+	CHECK(ParseWithLimit(nested.c_str(), 4096, &context) == JSON_ERROR_CODE::MEMORY_LIMIT_EXCEEDED);
+	CHECK(ParseWithLimit(nested.c_str(), 0, &context) == JSON_ERROR_CODE::NONE);
+
+	// A parse into a tree counts from the old tree, a smaller tree frees memory
+	context.memoryLimit = 0;
+	root = JSON_Parse(large.c_str(), &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	root = JSON_ParseInto(root, "[{\"id\":0}]", &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	CHECK(context.memoryUsed < 0);
+
+	// The limit is on how much the tree may grow
+	context.memoryLimit = 1024;
+	root = JSON_ParseInto(root, "[{\"id\":1}]", &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	root = JSON_ParseInto(root, large.c_str(), &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::MEMORY_LIMIT_EXCEEDED);
+	JSON_Free(root);
+}
@@ -0,0 +1,155 @@
+
+//
+// numbers.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for ToDoubles, ToFloats and ToInt64s of JSON_ARRAY.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include <vector>
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Check that the numbers of an array convert like strtod and atoll
+static void CheckConversions(const std::vector<std::string>& numbers)
+{
+	std::vector<long long> int64s(numbers.size());
+	std::vector<double> doubles(numbers.size());
+	std::vector<float> floats(numbers.size());
+	JSON_ARRAY array;
+	double expected;
+	float expectedFloat;
+	size_t i;
+
+	array.MakeRoot();
+	for (i = 0; i < numbers.size(); i++) {
+		CHECK(array.Append.Number.String(numbers[i].c_str()) != NULL);
+	}
+
+	CHECK(array.ToDoubles(doubles.data(), doubles.size()) == numbers.size());
+	CHECK(array.ToFloats(floats.data(), floats.size()) == numbers.size());
+	CHECK(array.ToInt64s(int64s.data(), int64s.size()) == numbers.size());
+
+	// The values must have the same bits, so -0 is not 0
+	for (i = 0; i < numbers.size(); i++)
+	{
+		expected = strtod(numbers[i].c_str(), NULL);
+		expectedFloat = (float)expected;
+		CHECK(memcmp(&doubles[i], &expected, sizeof(double)) == 0);
+		CHECK(memcmp(&floats[i], &expectedFloat, sizeof(float)) == 0);
+		CHECK(int64s[i] == atoll(numbers[i].c_str()));
+		if (memcmp(&doubles[i], &expected, sizeof(double)) != 0) {
+			printf("%s: %.17g, strtod %.17g\n", numbers[i].c_str(), doubles[i], expected);
+		}
+	}
+
+	array.Free();
+}
+
+void test_NumberConversions()
+{
+	std::vector<std::string> numbers;
+	unsigned long long random;
+	std::string digits;
+	double values[4];
+	long long int64s[4];
+	float floats[4];
+	JSON_ARRAY array;
+	size_t length;
+	size_t point;
+	size_t i;
+	int power;
+
+	// 15 digit values and values next to them
+	numbers = {
+		"0", "-0", "0.0", "-0.0", "1", "-1", "0.5", "0.1", "0.2", "0.3", "-0.7",
+		"123456789012345", "-123456789012345", "999999999999999", "1000000000000000", "9999999999999999",
+		"0.123456789012345", "1.23456789012345", "12345678.9012345", "99999999999999.9", "9.99999999999999",
+		"1.00000000000001", "0.999999999999999", "0.000000000000001", "0.00000000000001", "4.35", "2.675",
+		"1.7976931348623157", "9007199254740993", "123.4500", "00012", "-00.5"
+	};
+
+	// Values near every power of 10 that has a fast conversion
+	for (power = 0; power <= 15; power++)
+	{
+		digits = "1" + std::string(power, '0');
+		numbers.push_back(digits);
+		numbers.push_back(std::string(power + 1, '9'));
+		numbers.push_back("0." + std::string(power, '0') + "1");
+		numbers.push_back("0." + std::string(power, '9'));
+		if (power < 14) {
+			numbers.push_back(digits + ".5");
+			numbers.push_back(std::string(power + 1, '9') + ".9");
+		}
+	}
+
+	// Numbers that are converted with strtod
+	numbers.push_back("1e5");
+	numbers.push_back("1.5E-300");
+	numbers.push_back("-2e308");
+	numbers.push_back("0.1234567890123456789");
+	numbers.push_back("123456789012345678");
+	numbers.push_back("9223372036854775807");
+	numbers.push_back("-9223372036854775808");
+
+	CheckConversions(numbers);
+
+	// Random numbers of 1 to 15 digits with the point anywhere
+	numbers.clear();
+	random = 88172645463325252ULL;
+	for (i = 0; i < 20000; i++)
+	{
+		random ^= random << 13;
+		random ^= random >> 7;
+		random ^= random << 17;
+
+		length = 1 + (size_t)(random % 15);
+		digits = std::to_string(random >> 8).substr(0, length);
+		point = (size_t)((random >> 4) % (length + 1));
+		if ((point != 0) && (point != length)) {
+			digits.insert(point, ".");
+		}
+		else if (point == 0) {
+			digits = "0." + digits.substr(0, 14);
+		}
+		if (random & 1) {
+			digits = "-" + digits;
+		}
+		numbers.push_back(digits);
+	}
+	CheckConversions(numbers);
+
+	// The conversion stops at the 1st item that is not a number and after `count` values
+	array = JSON_ARRAY(test_Parse("[1.5, 2, \"3\", 4]"));
+	values[2] = values[3] = 7.0;
+	CHECK(array.ToDoubles(values, 4) == 2);
+	CHECK((values[0] == 1.5) && (values[1] == 2.0) && (values[2] == 7.0));
+	floats[1] = 7.0f;
+	CHECK(array.ToFloats(floats, 1) == 1);
+	CHECK((floats[0] == 1.5f) && (floats[1] == 7.0f));
+	int64s[0] = 7;
+	CHECK(array.ToInt64s(int64s, 0) == 0);
+	CHECK(int64s[0] == 7);
+	CHECK(array.ToInt64s(int64s, 4) == 2);
+	CHECK((int64s[0] == 1) && (int64s[1] == 2));
+	CHECK(array.Delete(2UL));
+	CHECK(array.ToInt64s(int64s, 4) == 3);
+	CHECK(int64s[2] == 4);
+	array.Free();
+
+	// Empty arrays and arrays that don't start with a number have no values
+	array = JSON_ARRAY(test_Parse("[null, 1]"));
+	CHECK(array.ToDoubles(values, 4) == 0);
+	array.Free();
+	array = JSON_ARRAY(test_Parse("[]"));
+	CHECK(array.ToFloats(floats, 4) == 0);
+	array.Free();
+	CHECK(array.ToDoubles(values, 4) == 0);
+}
@@ -0,0 +1,112 @@
+
+//
+// packed.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_PACKED.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+void test_PackedRoundTrip()
+{
+	const char* json = "{\"users\":[{\"name\":\"ann\",\"age\":31,\"admin\":true},{\"name\":\"bob\",\"age\":-2.5,\"admin\":false,\"tags\":[]}],"
+		"\"empty\":{},\"nothing\":null,\"name\":\"root\",\"a long key that does not fit in a node\":\"a long value that does not fit in a node\"}";
+	const JSON_PACKED_NODE* root;
+	const JSON_PACKED_NODE* users;
+	const JSON_PACKED_NODE* node;
+	JSON_PACKED packed(&test_allocator);
+	JSON_OBJECT object;
+	JSON_NODE* unpacked;
+	std::string key;
+	size_t length;
+	size_t i;
+
+	// An empty document has nothing
+	CHECK(packed.Root() == NULL);
+	CHECK(packed.Unpack() == NULL);
+	CHECK(packed.Count() == 0);
+
+	object = JSON_OBJECT(test_Parse(json));
+	CHECK(object.Array("users").Format("[\\n\\t\\i,\\n]"));
+	CHECK(packed.Pack(object));
+	CHECK(packed.Count() == 15);
+
+	// Unpacking gives the same tree, with the formats
+	unpacked = packed.Unpack();
+	CHECK(JSON_Equal(unpacked, object));
+	CHECK(test_Generate(unpacked) == test_Generate(object));
+	CHECK((JSON_GetArray(unpacked, "users") != NULL) && (JSON_GetArray(unpacked, "users")->format != NULL) &&
+		(strcmp(JSON_GetArray(unpacked, "users")->format, "[\\n\\t\\i,\\n]") == 0));
+
+	// The unpacked tree can be changed and doesn't change the document
+	CHECK(JSON_OBJECT(unpacked).Array("users").Append.Number.Int(3) != NULL);
+	JSON_Free(unpacked);
+	unpacked = packed.Unpack(&test_allocator);
+	CHECK(JSON_Equal(unpacked, object));
+	JSON_Free(unpacked);
+
+	// Members are found by key and items by index
+	root = packed.Root();
+	CHECK((root != NULL) && (packed.Type(root) == JSON_TYPE::OBJECT));
+	CHECK(packed.Count(root) == 5);
+	CHECK(packed.Key(root) == NULL);
+
+	users = packed.Find(root, "users");
+	CHECK((users != NULL) && (packed.Type(users) == JSON_TYPE::ARRAY) && (packed.Count(users) == 2));
+	CHECK(packed.Format(users) != NULL);
+	CHECK(packed.Format(root) == NULL);
+	CHECK(packed.Item(users, 2) == NULL);
+
+	node = packed.Find(packed.Item(users, 1), "age");
+	CHECK((node != NULL) && (packed.Type(node) == JSON_TYPE::NUMBER));
+	CHECK((packed.String(node, &length) != NULL) && (strcmp(packed.String(node), "-2.5") == 0) && (length == 4));
+	CHECK(packed.Boolean(packed.Find(packed.Item(users, 0), "admin")));
+	CHECK(!packed.Boolean(packed.Find(packed.Item(users, 1), "admin")));
+	CHECK(packed.Count(packed.Find(packed.Item(users, 1), "tags")) == 0);
+	CHECK(packed.Type(packed.Find(root, "nothing")) == JSON_TYPE::NULL_TYPE);
+	CHECK(packed.Count(packed.Find(root, "empty")) == 0);
+	CHECK(strcmp(packed.String(packed.Find(root, "name")), "root") == 0);
+	CHECK(strcmp(packed.String(packed.Find(root, "a long key that does not fit in a node")), "a long value that does not fit in a node") == 0);
+	CHECK(strcmp(packed.Key(packed.Item(root, 0)), "users") == 0);
+
+	// Keys are compared by length and bytes, not only by hash
+	CHECK(packed.Find(root, "name", 4) == packed.Find(root, "name"));
+	CHECK(packed.Find(root, "names", 4) == packed.Find(root, "name"));
+	CHECK(packed.Find(root, "nam") == NULL);
+	CHECK(packed.Find(root, "missing") == NULL);
+	CHECK(packed.Find(users, "name") == NULL);
+
+	// A large object is found by key as well
+	object.Free();
+	object.MakeRoot();
+	for (i = 0; i < 1000; i++)
+	{
+		key = "key" + std::to_string(i);
+		CHECK(object.Append.Number.Int64(key.c_str(), (long long)i) != NULL);
+	}
+	CHECK(packed.Pack(object));
+	root = packed.Root();
+	CHECK(packed.Count(root) == 1000);
+	for (i = 0; i < 1000; i++)
+	{
+		key = "key" + std::to_string(i);
+		node = packed.Find(root, key.c_str());
+		CHECK((node != NULL) && (node == packed.Item(root, i)) && (strcmp(packed.String(node), std::to_string(i).c_str()) == 0));
+	}
+	unpacked = packed.Unpack();
+	CHECK(JSON_Equal(unpacked, object));
+	JSON_Free(unpacked);
+	object.Free();
+
+	packed.Clear();
+	CHECK(packed.Root() == NULL);
+	CHECK(packed.Size() == 0);
+}
@@ -0,0 +1,78 @@
+
+//
+// parse_into.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_ParseInto.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Parse `json` into `root` and check that the result is the same as a new parse
+// Returns the number of allocations that were made
+static size_t ParseIntoAndCompare(JSON_NODE** root, const char* json)
+{
+	JSON_PARSER_CONTEXT context;
+	size_t before;
+
+	context.allocator = &test_allocator;
+	before = test_allocations;
+
+	*root = JSON_ParseInto(*root, json, &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	CHECK(test_SameJson(*root, json));
+
+	return test_allocations - before;
+}
+
+void test_ParseInto()
+{
+	JSON_PARSER_CONTEXT context;
+	JSON_NODE* root;
+	std::string json;
+	std::string changed;
+	int i;
+
+	json = "{";
+	for (i = 0; i < 40; i++)
+	{
+		if (i != 0) {
+			json += ",";
+		}
+		json += "\"key" + std::to_string(i) + "\":{\"name\":\"value " + std::to_string(i) + "\",\"list\":[1,2,3]}";
+	}
+	json += "}";
+
+	context.allocator = &test_allocator;
+	root = JSON_Parse(json.c_str(), &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+
+	// The same document reuses every node and buffer
+	CHECK(ParseIntoAndCompare(&root, json.c_str()) == 0);
+
+	// A new member only allocates its own nodes, the other members are found by key
+	changed = "{\"new\":{\"q\":[1]}," + json.substr(1);
+	CHECK(ParseIntoAndCompare(&root, changed.c_str()) <= 8);
+
+	// Removing it again allocates nothing
+	CHECK(ParseIntoAndCompare(&root, json.c_str()) == 0);
+
+	// A value that changes type gets a new node
+	changed = json;
+	changed.replace(changed.find("\"list\":[1,2,3]"), 14, "\"list\":\"text\"");
+	ParseIntoAndCompare(&root, changed.c_str());
+
+	// Documents with a different shape are still parsed correctly
+	ParseIntoAndCompare(&root, "[1,\"two\",{\"three\":3},[4]]");
+	ParseIntoAndCompare(&root, "{\"a\":{\"b\":{\"c\":null}},\"d\":true}");
+	ParseIntoAndCompare(&root, "{\"d\":false,\"a\":{\"b\":{\"c\":\"a longer string than before\"}}}");
+
+	JSON_Free(root);
+}
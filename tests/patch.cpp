@@ -0,0 +1,162 @@
+
+//
+// patch.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_Patch, JSON_MergePatch and JSON_Diff.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Apply a patch that fails at `failedOperation` and check that the document is unchanged
+static void CheckRollback(const char* json, const char* patchJson, size_t failedOperation)
+{
+	JSON_NODE* root;
+	JSON_NODE* patch;
+	std::string before;
+	size_t failed;
+
+	root = test_Parse(json);
+	patch = test_Parse(patchJson);
+	before = test_Generate(root);
+
+	failed = (size_t)-1;
+	CHECK(!JSON_Patch(root, patch, &failed));
+	CHECK(failed == failedOperation);
+
+	// The members are back in the same order, not only equal
+	CHECK(test_Generate(root) == before);
+	CHECK(test_SameJson(root, json));
+
+	JSON_Free(root);
+	JSON_Free(patch);
+}
+
+void test_PatchRollback()
+{
+	const char* json = "{\"a\":{\"b\":[1,2,3],\"c\":\"text\"},\"d\":[{\"e\":true}],\"f\":null}";
+	JSON_NODE* root;
+	JSON_NODE* patch;
+
+	// Every kind of operation is undone when a later operation fails
+	CheckRollback(json,
+		"[{\"op\":\"add\",\"path\":\"/a/b/1\",\"value\":9},"
+		"{\"op\":\"remove\",\"path\":\"/a/c\"},"
+		"{\"op\":\"replace\",\"path\":\"/d/0/e\",\"value\":{\"x\":[1]}},"
+		"{\"op\":\"move\",\"from\":\"/f\",\"path\":\"/a/f\"},"
+		"{\"op\":\"copy\",\"from\":\"/a/b\",\"path\":\"/g\"},"
+		"{\"op\":\"test\",\"path\":\"/a/b/0\",\"value\":2}]", 5);
+	CheckRollback(json,
+		"[{\"op\":\"replace\",\"path\":\"\",\"value\":[1,2]},"
+		"{\"op\":\"remove\",\"path\":\"/5\"}]", 1);
+	CheckRollback(json,
+		"[{\"op\":\"remove\",\"path\":\"/a/b/0\"},"
+		"{\"op\":\"add\",\"path\":\"/missing/x\",\"value\":1}]", 1);
+	CheckRollback(json,
+		"[{\"op\":\"move\",\"from\":\"/a\",\"path\":\"/a/b/0\"}]", 0);
+
+	// The same operations apply when nothing fails
+	root = test_Parse(json);
+	patch = test_Parse(
+		"[{\"op\":\"add\",\"path\":\"/a/b/1\",\"value\":9},"
+		"{\"op\":\"remove\",\"path\":\"/a/c\"},"
+		"{\"op\":\"move\",\"from\":\"/f\",\"path\":\"/a/f\"},"
+		"{\"op\":\"copy\",\"from\":\"/a/b\",\"path\":\"/g\"},"
+		"{\"op\":\"test\",\"path\":\"/g/1\",\"value\":9}]");
+	CHECK(JSON_Patch(root, patch));
+	CHECK(test_SameJson(root, "{\"a\":{\"b\":[1,9,2,3],\"f\":null},\"d\":[{\"e\":true}],\"g\":[1,9,2,3]}"));
+	JSON_Free(root);
+	JSON_Free(patch);
+}
+
+void test_MergePatch()
+{
+	JSON_NODE* root;
+	JSON_NODE* patch;
+
+	root = test_Parse("{\"a\":\"b\",\"c\":{\"d\":\"e\",\"f\":\"g\"}}");
+	patch = test_Parse("{\"a\":\"z\",\"c\":{\"f\":null},\"h\":[1]}");
+	CHECK(JSON_MergePatch(root, patch));
+	CHECK(test_SameJson(root, "{\"a\":\"z\",\"c\":{\"d\":\"e\"},\"h\":[1]}"));
+	JSON_Free(patch);
+
+	// A patch that is not an object replaces the root in place
+	patch = test_Parse("[1,{\"x\":null}]");
+	CHECK(JSON_MergePatch(root, patch));
+	CHECK(test_SameJson(root, "[1,{\"x\":null}]"));
+	JSON_Free(patch);
+
+	// A root that is not an object becomes an object before the patch is merged
+	patch = test_Parse("{\"k\":{\"l\":null,\"m\":1}}");
+	CHECK(JSON_MergePatch(root, patch));
+	CHECK(test_SameJson(root, "{\"k\":{\"m\":1}}"));
+	JSON_Free(patch);
+
+	JSON_Free(root);
+}
+
+// Diff 2 documents, apply the diff to the old document and check that it is the new document
+static void CheckDiff(const char* oldJson, const char* newJson)
+{
+	JSON_NODE* oldRoot;
+	JSON_NODE* newRoot;
+	JSON_NODE* diff;
+
+	oldRoot = test_Parse(oldJson);
+	newRoot = test_Parse(newJson);
+
+	diff = JSON_Diff(oldRoot, newRoot);
+	CHECK(diff != NULL);
+	CHECK(JSON_Patch(oldRoot, diff));
+	CHECK(test_SameJson(oldRoot, newJson));
+
+	JSON_Free(oldRoot);
+	JSON_Free(newRoot);
+	JSON_Free(diff);
+}
+
+void test_DiffRoundTrip()
+{
+	std::string oldJson;
+	std::string newJson;
+	int i;
+
+	CheckDiff("{}", "{}");
+	CheckDiff("{\"a\":1}", "{\"a\":1}");
+	CheckDiff("{\"a\":1,\"b\":2}", "{\"b\":3,\"c\":[4]}");
+	CheckDiff("{\"a\":{\"b\":{\"c\":[1,2,3]}}}", "{\"a\":{\"b\":{\"c\":[1,3,4]},\"d\":null}}");
+	CheckDiff("[1,2,3,4,5]", "[0,1,3,5,6]");
+	CheckDiff("[1,2,3]", "{\"a\":[1,2,3]}");
+	CheckDiff("{\"a\":[{\"id\":1},{\"id\":2}]}", "{\"a\":[{\"id\":2},{\"id\":1,\"x\":true}]}");
+	CheckDiff("{\"a/b\":1,\"c~d\":2}", "{\"a/b\":2,\"c~d\":[]}");
+
+	// Large arrays with items moved, removed and inserted
+	oldJson = "[";
+	newJson = "[";
+	for (i = 0; i < 200; i++)
+	{
+		if (i != 0) {
+			oldJson += ",";
+		}
+		oldJson += std::to_string(i);
+
+		if (i % 7 == 3) {
+			continue;
+		}
+		if (newJson.size() > 1) {
+			newJson += ",";
+		}
+		newJson += std::to_string((i % 11 == 5) ? i * 1000 : i);
+	}
+	oldJson += "]";
+	newJson += ",\"end\"]";
+	CheckDiff(oldJson.c_str(), newJson.c_str());
+	CheckDiff(newJson.c_str(), oldJson.c_str());
+}
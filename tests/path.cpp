@@ -0,0 +1,133 @@
+
+//
+// path.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_PATH, Evaluate on a tree and EvaluateText on the JSON string must find the same values.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include <vector>
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Values found by an evaluation, as the text of the value in the JSON string
+struct PATH_RESULTS
+{
+	const char* json;
+	JSON_POSITION_MAP* positions;
+	std::vector<std::string> values;
+};
+
+static bool AddNode(JSON_NODE* node, void* userData)
+{
+	PATH_RESULTS* results = (PATH_RESULTS*)userData;
+	const JSON_POSITION* position;
+
+	position = results->positions->Find(node);
+	CHECK(position != NULL);
+	if (position != NULL) {
+		results->values.push_back(std::string(results->json + position->offset, position->length));
+	}
+
+	return true;
+}
+
+static bool AddText(const JSON_POSITION* position, void* userData)
+{
+	PATH_RESULTS* results = (PATH_RESULTS*)userData;
+
+	results->values.push_back(std::string(results->json + position->offset, position->length));
+
+	return true;
+}
+
+// Evaluate a query on the tree and on the JSON string, both must find `expected` in the same order
+static void CheckQuery(JSON_NODE* root, JSON_POSITION_MAP* positions, const char* json, const char* query, const std::vector<std::string>& expected)
+{
+	PATH_RESULTS tree = { json, positions, {} };
+	PATH_RESULTS text = { json, positions, {} };
+	JSON_PATH path;
+	size_t i;
+
+	CHECK(path.Compile(query));
+	CHECK(path.Evaluate(root, AddNode, &tree) == expected.size());
+	CHECK(path.EvaluateText(json, AddText, &text) == expected.size());
+	CHECK(tree.values == expected);
+	CHECK(text.values == expected);
+
+	if ((tree.values != expected) || (text.values != expected))
+	{
+		printf("%s\n    tree:", query);
+		for (i = 0; i < tree.values.size(); i++) {
+			printf(" %s", tree.values[i].c_str());
+		}
+		printf("\n    text:");
+		for (i = 0; i < text.values.size(); i++) {
+			printf(" %s", text.values[i].c_str());
+		}
+		printf("\n");
+	}
+
+	// First is the first value Evaluate finds
+	tree.values.clear();
+	if (path.First(root) != NULL) {
+		AddNode(path.First(root), &tree);
+	}
+	CHECK(tree.values == std::vector<std::string>(expected.begin(), expected.begin() + (expected.empty() ? 0 : 1)));
+}
+
+void test_PathEvaluate()
+{
+	const char* json =
+		"{\"a\":[0,1,2,3,4,5,6],\n"
+		" \"b\":{\"q\":5,\"s\":\"x\",\"c\":[{\"q\":20,\"s\":\"y\"},{\"q\":11,\"s\":\"x\"}]},\n"
+		" \"d\":[{\"q\":3},{\"s\":\"x\",\"q\":\"12\"},{\"q\":30,\"e\":{\"q\":40}}],\n"
+		" \"e\":\"str\"}";
+	JSON_POSITION_MAP positions;
+	JSON_PARSER_CONTEXT context;
+	JSON_NODE* root;
+	JSON_PATH path;
+
+	context.positions = &positions;
+	root = JSON_Parse(json, &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+
+	// Slices with negative starts and steps
+	CheckQuery(root, &positions, json, "$.a[5:1:-2]", { "5", "3" });
+	CheckQuery(root, &positions, json, "$.a[::-1]", { "6", "5", "4", "3", "2", "1", "0" });
+	CheckQuery(root, &positions, json, "$.a[-2:]", { "5", "6" });
+	CheckQuery(root, &positions, json, "$.a[1:6:2]", { "1", "3", "5" });
+	CheckQuery(root, &positions, json, "$.a[-1]", { "6" });
+	CheckQuery(root, &positions, json, "$.a[10:]", {});
+
+	// A step of 0 selects nothing
+	CheckQuery(root, &positions, json, "$.a[::0]", {});
+	CheckQuery(root, &positions, json, "$.a[1:5:0]", {});
+
+	// Recursive descent visits a value before the values below it
+	CheckQuery(root, &positions, json, "$..q", { "5", "20", "11", "3", "\"12\"", "30", "40" });
+	CheckQuery(root, &positions, json, "$.d..q", { "3", "\"12\"", "30", "40" });
+
+	// Filters compare numbers as numbers and strings by their bytes
+	CheckQuery(root, &positions, json, "$..[?(@.q > 10)]", { "{\"q\":20,\"s\":\"y\"}", "{\"q\":11,\"s\":\"x\"}", "{\"q\":30,\"e\":{\"q\":40}}", "{\"q\":40}" });
+	CheckQuery(root, &positions, json, "$.d[?(@.q > 10)].q", { "30" });
+	CheckQuery(root, &positions, json, "$..[?(@.s == 'x')].q", { "5", "11", "\"12\"" });
+	CheckQuery(root, &positions, json, "$.b.c[?(@.s == \"x\" && @.q >= 11)].q", { "11" });
+	CheckQuery(root, &positions, json, "$.d[?(@.e)].q", { "30" });
+
+	// Unions are not supported, nothing is found
+	CHECK(!path.Compile("$['a','e']"));
+	CHECK(path.Evaluate(root, AddNode, NULL) == 0);
+	CHECK(path.EvaluateText(json, AddText, NULL) == 0);
+	CHECK(path.First(root) == NULL);
+	CHECK(!path.Compile("$.a[0,1]"));
+
+	JSON_Free(root);
+}
@@ -0,0 +1,127 @@
+
+//
+// pointer.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_POINTER and its resolve cache.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Check that a pointer resolves to a string, or to nothing when `expected` is NULL
+static void CheckString(JSON_POINTER& pointer, JSON_NODE* root, const char* expected)
+{
+	JSON_NODE* node;
+
+	node = pointer.Resolve(root);
+	if (expected == NULL) {
+		CHECK(node == NULL);
+	}
+	else {
+		CHECK((node != NULL) && (node->type == JSON_TYPE::STRING) && (strcmp((const char*)node->value, expected) == 0));
+	}
+
+	// The cached result is the same as a resolve without the cache
+	CHECK(pointer.Resolve(root) == node);
+	CHECK(pointer.Resolve(root, false) == node);
+}
+
+void test_PointerResolve()
+{
+	JSON_PARSER_CONTEXT context;
+	JSON_POINTER pointer;
+	JSON_OBJECT root;
+	JSON_OBJECT user;
+	JSON_NODE* node;
+
+	root = test_Parse("{\"users\":[{\"name\":\"ann\"},{\"name\":\"bob\"}],\"a/b\":\"slash\",\"m~n\":\"tilde\",\"~1\":\"escaped\",\"a\":[\"zero\",\"one\"],\"\":\"empty\"}");
+
+	// ~1 is unescaped to / and ~0 to ~, in that order
+	CHECK(pointer.Compile("/a~1b"));
+	CheckString(pointer, root, "slash");
+	CHECK(pointer.Compile("/m~0n"));
+	CheckString(pointer, root, "tilde");
+	CHECK(pointer.Compile("/~01"));
+	CheckString(pointer, root, "escaped");
+	CHECK(pointer.Compile("/"));
+	CheckString(pointer, root, "empty");
+	CHECK(pointer.Compile("/a~1b/x", 5));
+	CHECK(pointer.Count() == 1);
+	CheckString(pointer, root, "slash");
+
+	// Array indexes are 0 or numbers without leading zeros
+	CHECK(pointer.Compile("/a/1"));
+	CheckString(pointer, root, "one");
+	CHECK(pointer.Compile("/a/0"));
+	CheckString(pointer, root, "zero");
+	CHECK(pointer.Compile("/a/01"));
+	CheckString(pointer, root, NULL);
+	CHECK(pointer.Compile("/a/00"));
+	CheckString(pointer, root, NULL);
+	CHECK(pointer.Compile("/a/-"));
+	CheckString(pointer, root, NULL);
+	CHECK(pointer.Compile("/a/2"));
+	CheckString(pointer, root, NULL);
+
+	// Pointers that are not valid never resolve
+	CHECK(!pointer.Compile("users"));
+	CHECK(pointer.Resolve(root) == NULL);
+	CHECK(!pointer.Compile("/a~2b"));
+	CHECK(pointer.Resolve(root) == NULL);
+	CHECK(pointer.Compile(""));
+	CHECK(pointer.Resolve(root) == (JSON_NODE*)root);
+
+	// Changes to an object or array on the path are noticed by the cache
+	CHECK(pointer.Compile("/users/1/name"));
+	CheckString(pointer, root, "bob");
+
+	CHECK(root.Array("users").Insert.Object().Insert.String("name", "cat") != NULL);
+	CheckString(pointer, root, "ann");
+
+	CHECK(root.Array("users").Delete(0UL));
+	CheckString(pointer, root, "bob");
+
+	user = root.Array("users").Object(1);
+	CHECK(user.Delete("name"));
+	CheckString(pointer, root, NULL);
+	CHECK(user.Append.String("name", "dan") != NULL);
+	CheckString(pointer, root, "dan");
+
+	CHECK(root.Array("users").Delete(1UL));
+	CheckString(pointer, root, NULL);
+	CHECK(root.Array("users").Append.Object().Append.String("name", "eve") != NULL);
+	CheckString(pointer, root, "eve");
+
+	// Replacing the container on the path is noticed too
+	CHECK(root.Delete("users"));
+	CheckString(pointer, root, NULL);
+	CHECK(root.Append.Array("users").Append.Object() != NULL);
+	CheckString(pointer, root, NULL);
+	CHECK(root.Array("users").Append.Object().Append.String("name", "fay") != NULL);
+	CheckString(pointer, root, "fay");
+
+	// A parse into the tree is noticed
+	root.ParseInto("{\"users\":[{\"name\":\"gus\"},{\"name\":\"hal\"}]}", &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	CheckString(pointer, root, "hal");
+
+	// A tree that is freed and parsed again is noticed
+	root.Free();
+	root = test_Parse("{\"users\":[{\"name\":\"ivy\"},{\"name\":\"jon\"}]}");
+	CheckString(pointer, root, "jon");
+
+	// Another tree is not mixed up with the cached one
+	node = test_Parse("{\"users\":[{},{\"name\":\"kim\"}]}");
+	CheckString(pointer, node, "kim");
+	CheckString(pointer, root, "jon");
+	JSON_Free(node);
+
+	root.Free();
+}
@@ -0,0 +1,97 @@
+
+//
+// positions.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_POSITION_MAP.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Check that a position is on `lineNumber` and covers `text` in the JSON string of the map
+static void CheckPosition(JSON_POSITION_MAP& positions, const JSON_POSITION* position, const char* text, unsigned long lineNumber)
+{
+	CHECK(position != NULL);
+	if (position == NULL) {
+		return;
+	}
+
+	CHECK(position->lineNumber == lineNumber);
+	CHECK(std::string(positions.json + position->offset, position->length) == text);
+}
+
+void test_PositionMap()
+{
+	const char* json = "{\n\t\"name\": \"json\",\n\t\"list\": [1, {\"x\": true}, null],\n\t\"empty\": {},\n\t\"key\"\n}";
+	const char* edited = "{\n\t\"name\": \"json-plus\",\n\t\"list\": [1, {\"x\": true}, null],\n\t\"empty\": {},\n\t\"key\"\n}";
+	JSON_POSITION_MAP positions;
+	JSON_PARSER_CONTEXT context;
+	JSON_OBJECT root;
+	JSON_NODE* node;
+	std::string big;
+	size_t i;
+
+	context.positions = &positions;
+	root = JSON_Parse(json, &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	CHECK(positions.json == json);
+
+	CheckPosition(positions, root.Position(&positions, "name"), "\"json\"", 2);
+	CheckPosition(positions, root.Position(&positions, "list"), "[1, {\"x\": true}, null]", 3);
+	CheckPosition(positions, root.Array("list").Position(&positions, 0UL), "1", 3);
+	CheckPosition(positions, root.Array("list").Position(&positions, 1UL), "{\"x\": true}", 3);
+	CheckPosition(positions, root.Array("list").Object(1).Position(&positions, "x"), "true", 3);
+	CheckPosition(positions, root.Array("list").Position(&positions, 2UL), "null", 3);
+	CheckPosition(positions, root.Position(&positions, "empty"), "{}", 4);
+
+	// Key-only members and missing members have no position
+	CHECK(root.Position(&positions, "key") == NULL);
+	CHECK(root.Position(&positions, "missing") == NULL);
+
+	// A reparse records the positions in the edited JSON string, which only the caller still has
+	root = JSON_Reparse(root, json, strlen("{\n\t\"name\": \"json"), 0, "-plus", &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	CHECK(positions.json == NULL);
+	positions.json = edited;
+	CheckPosition(positions, root.Position(&positions, "name"), "\"json-plus\"", 2);
+	CheckPosition(positions, root.Array("list").Object(1).Position(&positions, "x"), "true", 3);
+
+	// Nodes added after parsing have no position until they are inserted
+	node = root.Append.Number.Int("added", 5);
+	CHECK(positions.Find(node) == NULL);
+	CHECK(positions.Insert(node, 1, 2, 7));
+	CHECK((positions.Find(node) != NULL) && (positions.Find(node)->offset == 1) && (positions.Find(node)->length == 2) && (positions.Find(node)->lineNumber == 7));
+	CHECK(positions.Insert(node, 3, 4, 8));
+	CHECK((positions.Find(node) != NULL) && (positions.Find(node)->offset == 3) && (positions.Find(node)->lineNumber == 8));
+
+	positions.Clear();
+	CHECK(positions.Count() == 0);
+	CHECK(root.Position(&positions, "name") == NULL);
+	root.Free();
+
+	// The hash table grows to hold every value of a large document
+	big = "[";
+	for (i = 0; i < 1000; i++)
+	{
+		if (i != 0) {
+			big += ",\n";
+		}
+		big += std::to_string(i);
+	}
+	big += "]";
+
+	JSON_ARRAY array = JSON_Parse(big.c_str(), &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	CHECK(positions.Count() >= 1000);
+	for (i = 0; i < 1000; i++) {
+		CheckPosition(positions, array.Position(&positions, (unsigned long)i), std::to_string(i).c_str(), (unsigned long)i + 1);
+	}
+	array.Free();
+}
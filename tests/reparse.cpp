@@ -0,0 +1,89 @@
+
+//
+// reparse.cpp
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Tests for JSON_Reparse.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#include "tests.h"
+
+using namespace json_plus;
+
+// Edit `json` at `offset` and check that JSON_Reparse gives the same tree as parsing the edited string
+static void ReparseAndCompare(const char* json, size_t offset, size_t removedLength, const char* insertedText)
+{
+	JSON_PARSER_CONTEXT context;
+	JSON_PARSER_CONTEXT expectedContext;
+	JSON_NODE* root;
+	JSON_NODE* expected;
+	std::string edited;
+
+	edited = std::string(json, offset) + insertedText + std::string(json + offset + removedLength);
+
+	root = test_Parse(json);
+	root = JSON_Reparse(root, json, offset, removedLength, insertedText, &context);
+	expected = JSON_Parse(edited.c_str(), &expectedContext);
+
+	CHECK(context.errorCode == expectedContext.errorCode);
+	if (expectedContext.errorCode == JSON_ERROR_CODE::NONE) {
+		CHECK(test_SameJson(root, edited.c_str()));
+	}
+	else {
+		CHECK(context.charNumber == expectedContext.charNumber);
+	}
+
+	JSON_Free(root);
+	JSON_Free(expected);
+}
+
+void test_Reparse()
+{
+	const char* json = "{\"a\":[1,2,3],\"b\":{\"c\":\"text\",\"d\":[true,null]},\"e\":4.5}";
+	std::string big;
+	JSON_PARSER_CONTEXT context;
+	JSON_NODE* root;
+	size_t offset;
+	size_t before;
+	int i;
+
+	// Change a number, a string, a whole member and the root
+	ReparseAndCompare(json, 7, 1, "42");
+	ReparseAndCompare(json, 20, 4, "changed");
+	ReparseAndCompare(json, 13, 0, "\"x\":{},");
+	ReparseAndCompare(json, 0, strlen(json), "[1]");
+
+	// Edits that break the container are found by the enclosing container or the root
+	ReparseAndCompare(json, 10, 1, "");
+	ReparseAndCompare(json, 10, 1, "]");
+	ReparseAndCompare(json, 5, 0, "{");
+	ReparseAndCompare(json, strlen(json) - 1, 1, "");
+
+	// A small edit in a large document only reparses the array around it
+	big = "{\"a\":[";
+	for (i = 0; i < 1000; i++)
+	{
+		if (i != 0) {
+			big += ",";
+		}
+		big += "{\"x\":" + std::to_string(i) + "}";
+	}
+	big += "],\"b\":{\"c\":[1,2,3]}}";
+
+	context.allocator = &test_allocator;
+	root = JSON_Parse(big.c_str(), &context);
+	offset = big.find("\"c\":[1,2") + 7;
+
+	before = test_allocations;
+	root = JSON_Reparse(root, big.c_str(), offset, 1, "42", &context);
+	CHECK(context.errorCode == JSON_ERROR_CODE::NONE);
+	CHECK(test_allocations - before <= 3);
+	CHECK(test_SameJson(JSON_GetObject(root, "b"), "{\"c\":[1,42,3]}"));
+
+	JSON_Free(root);
+}
@@ -0,0 +1,79 @@
+
+//
+// tests.h
+//
+// Author:
+//     Brian Sullender
+//     SULLE WAREHOUSE LLC
+//
+// Description:
+//     Checks and helpers shared by the json-plus tests.
+//     https://github.com/sullewarehouse/json-plus
+//
+
+#ifndef JSON_PLUS_TESTS_H
+#define JSON_PLUS_TESTS_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "../json-plus.h"
+
+// Number of failed checks in the test that is running
+extern int test_failures;
+
+// Check a condition, a failed check is printed and the test goes on
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			test_failures++; \
+		} \
+	} while (0)
+
+// Allocator that counts its allocations and reallocations in test_allocations
+extern json_plus::JSON_ALLOCATOR test_allocator;
+extern size_t test_allocations;
+
+// Allocator that counts the memory blocks that are not freed in test_live_blocks
+extern json_plus::JSON_ALLOCATOR test_live_allocator;
+extern size_t test_live_blocks;
+
+// Parse a JSON string, a parse error fails the check
+json_plus::JSON_NODE* test_Parse(const char* json);
+
+// Generate a JSON string without formatting, "(null)" if there is no node
+std::string test_Generate(json_plus::JSON_NODE* node);
+
+// Check if 2 JSON strings are the same document
+bool test_SameJson(json_plus::JSON_NODE* node, const char* json);
+
+// Tests, every test is a ctest test of its own
+void test_ParseInto();
+void test_Reparse();
+void test_ObjectIndex();
+void test_ArrayItems();
+void test_CloneIsolation();
+void test_PatchRollback();
+void test_MergePatch();
+void test_DiffRoundTrip();
+void test_Canonical();
+void test_ParseErrors();
+void test_Lexer();
+void test_PositionMap();
+void test_AppendOrder();
+void test_KeyLookup();
+void test_IteratorItems();
+void test_PointerResolve();
+void test_PathEvaluate();
+void test_HashStability();
+void test_PackedRoundTrip();
+void test_DocumentOwnership();
+void test_NumberConversions();
+void test_ColumnsLoad();
+void test_MemoryLimit();
+void test_CompactTree();
+
+#endif // JSON_PLUS_TESTS_H